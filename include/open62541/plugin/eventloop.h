@@ -527,6 +527,13 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName);
  *    becomes an upper bound for the message size. If undefined a fresh buffer
  *    is allocated for every `allocNetworkBuffer` (default: no buffer).
  *
+ * 0:recv-batch [uint16]
+ *    Maximum number of datagrams received with a single syscall (recvmmsg).
+ *    A receive buffer of recv-bufsize is allocated for each. If the buffers
+ *    are large enough, datagrams coalesced by the kernel (UDP GRO) are
+ *    received as well. They are handed to the application one by one. Only
+ *    used on Linux (default: 8).
+ *
  * **Open Connection Parameters:**
  *
  * 0:listen [boolean]
@@ -577,7 +584,11 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName);
  *
  * **Send Parameters:**
  *
- * No additional parameters for sending over an UDP connection defined. */
+ * 0:segment-size [uint16]
+ *    Split the buffer into datagrams of this size (the last one can be
+ *    shorter). On Linux they are sent with a single syscall. Using the
+ *    segmentation offload (UDP GSO) if available or sendmmsg otherwise
+ *    (default: send the buffer as one datagram). */
 UA_EXPORT UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
 
@@ -638,6 +649,51 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
  *    creating any connection but solely validating the provided parameters
  *    (default: false)
  *
+ * On Linux, frames can be exchanged with the kernel through a PACKET_MMAP ring
+ * buffer instead of a system call per frame. Listen connections use a
+ * TPACKET_V3 receive ring and pass the frames to the application directly from
+ * the ring memory. Send connections use a TPACKET_V2 send ring. Frames in the
+ * send ring are limited to standard Ethernet frames (up to 2016 bytes). The
+ * send ring is not used together with txtime.
+ *
+ * 0:packet-mmap [bool]
+ *    Exchange frames through a PACKET_MMAP ring (default: false).
+ *
+ * 0:ring-size [uint32]
+ *    Size of the ring in bytes, rounded up to blocks of 64kB (default: 1MB).
+ *
+ * 0:ring-timeout [uint32]
+ *    Milliseconds after which a partially filled block of the receive ring is
+ *    handed to the application. For the send ring, the maximum time to wait
+ *    for a free frame when the ring is full. Then the frame is dropped
+ *    (default: 1).
+ *
+ * Listen connections can also receive through an AF_XDP socket (Linux 5.9 and
+ * later). An XDP program attached to the interface redirects the frames of the
+ * EtherType (or all frames) arriving on the receive queue into memory shared
+ * with the socket (UMEM). The frames bypass the network stack and are passed
+ * to the application directly from the UMEM. The XDP program and the socket
+ * use the native and zero-copy mode of the driver if it supports them.
+ * Otherwise they fall back to the generic and copy mode (e.g. for veth
+ * interfaces). Only one XDP program can be attached to an interface at a time.
+ * The ring-size parameter sets the size of the UMEM. The multicast address (and
+ * the promiscuous mode) is registered with an additional AF_PACKET socket that
+ * does not receive frames itself.
+ *
+ * 0:xdp [bool]
+ *    Receive through an AF_XDP socket (default: false).
+ *
+ * 0:xdp-queue [uint32]
+ *    Receive queue of the interface (default: 0).
+ *
+ * 0:xdp-flags [uint32]
+ *    XDP_FLAGS_* for attaching the XDP program (default: 0, native mode if
+ *    supported and generic mode otherwise).
+ *
+ * 0:xdp-bind-flags [uint32]
+ *    XDP_COPY or XDP_ZEROCOPY for binding the socket (default: 0, zero-copy if
+ *    supported and copy mode otherwise).
+ *
  * Sending with a txtime (for Time-Sensitive Networking) is possible on recent
  * Linux kernels, If enabled for the socket, then a txtime parameters can be
  * passed to `sendWithConnection`. Note that the clock source for txtime sending
@@ -720,6 +776,51 @@ UA_ConnectionManager_new_POSIX_Ethernet(const UA_String eventSourceName);
 UA_EXPORT UA_ConnectionManager *
 UA_ConnectionManager_new_MQTT(const UA_String eventSourceName);
 
+/**
+ * In-Memory Connection Manager
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Connects applications within the same process without going through the
+ * network stack. Every connection consists of two lock-free byte rings (one
+ * for each direction). Received data is handed to the application directly
+ * from the ring memory. The ConnectionManagers of both sides can be registered
+ * in different EventLoops (and threads). Listen-connections are registered
+ * with a name that is unique in the process. The server and the client select
+ * this ConnectionManager for EndpointUrls of the form "opc.mem://<name>".
+ *
+ * **Configuration parameters for the ConnectionManager (set before start)**
+ *
+ * 0:ring-size [uint32]
+ *    Size of the ring for received data in bytes. Rounded up to the next power
+ *    of two (default: 256kB).
+ *
+ * **Open Connection Parameters:**
+ *
+ * 0:address [string]
+ *    Name to listen on or to connect to (required). Can also be given as an
+ *    array with a single element.
+ *
+ * 0:port [uint16]
+ *    Ignored. Accepted so that the same parameters as for TCP can be used.
+ *
+ * 0:listen [bool]
+ *    Use the connection for listening or for initiating a connection
+ *    (default: false).
+ *
+ * 0:validate [boolean]
+ *    If true, the connection setup will act as a dry-run without actually
+ *    creating any connection but solely validating the provided parameters
+ *    (default: false)
+ *
+ * **Connection Callback Parameters:**
+ *
+ * No additional parameters are defined.
+ *
+ * **Send Parameters:**
+ *
+ * No additional parameters for sending over an in-memory connection defined. */
+UA_EXPORT UA_ConnectionManager *
+UA_ConnectionManager_new_Memory(const UA_String eventSourceName);
+
 /**
  * Signal Interrupt Manager
  * ~~~~~~~~~~~~~~~~~~~~~~~~
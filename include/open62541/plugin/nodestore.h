@@ -568,11 +568,93 @@ typedef struct {
                                const UA_DataValue *data);
 } UA_ExternalValueCallback;
 
+/**
+ * .. _shared-memory-value-backend:
+ *
+ * Shared Memory Value Backend
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * A shared memory region holds the current values of variables that are
+ * produced by a separate process on the same host (e.g. a PLC runtime). The
+ * server reads the values without callbacks and without locks. The producer is
+ * never blocked by the readers.
+ *
+ * The region starts with a header, followed by the table of entries. Each
+ * entry has two buffers. The producer writes into the inactive buffer and then
+ * increases the sequence counter of the entry by two. This activates the
+ * buffer. A reader copies from the active buffer and retries if the sequence
+ * counter has changed in the meantime. Every entry has a single producer.
+ *
+ * Values are stored in the in-memory representation of the host. Only scalars
+ * and fixed-length arrays of pointer-free types from ``UA_TYPES`` (numbers,
+ * DateTime, Guid, ...) are supported. All offsets are relative to the start of
+ * the region, so that the region can be mapped at different addresses in the
+ * producer and the server process.
+ *
+ * The content of the region is not trusted. Every access validates the entry
+ * against the size of the mapping in the accessing process. The regionSize
+ * field in the header is only used by the producer for the allocation. */
+
+#define UA_SHAREDMEMORY_MAGIC 0x4D485355 /* "USHM" */
+#define UA_SHAREDMEMORY_VERSION 1
+
+typedef struct {
+    UA_UInt32 magic;
+    UA_UInt32 version;
+    UA_UInt32 entriesSize;
+    UA_UInt32 entriesCapacity;
+    UA_UInt64 regionSize;
+    UA_UInt64 usedSize; /* Size of the region that is already allocated */
+    /* Followed by UA_SharedMemoryEntry[entriesCapacity] */
+} UA_SharedMemoryHeader;
+
+typedef struct {
+    UA_UInt32 sequence;    /* The active buffer is (sequence >> 1) & 1 */
+    UA_UInt16 typeIndex;   /* Index of the type in UA_TYPES */
+    UA_UInt16 isArray;
+    UA_UInt32 arrayLength; /* Number of elements (1 for scalars) */
+    UA_UInt32 reserved;
+    UA_UInt64 offset[2];   /* Offset of the buffers */
+} UA_SharedMemoryEntry;
+
+typedef struct {
+    UA_DateTime sourceTimestamp;
+    UA_StatusCode status;
+    UA_UInt32 reserved;
+    /* Followed by the value */
+} UA_SharedMemoryBuffer;
+
+/* Initialize the header of a shared memory region with space for the given
+ * number of entries */
+UA_EXPORT UA_StatusCode
+UA_SharedMemory_init(void *region, size_t regionSize, UA_UInt32 entriesCapacity);
+
+/* Allocate an entry in the region. The type must be pointer-free and from
+ * UA_TYPES. For scalars, set isArray to false and arrayLength to one. */
+UA_EXPORT UA_StatusCode
+UA_SharedMemory_addEntry(void *region, const UA_DataType *type,
+                         UA_Boolean isArray, UA_UInt32 arrayLength,
+                         UA_UInt32 *outEntry);
+
+/* Write a new value for the entry (called from the producer). The data must
+ * have the type and length defined for the entry. The regionSize is the size
+ * of the mapping in the calling process. */
+UA_EXPORT UA_StatusCode
+UA_SharedMemory_write(void *region, size_t regionSize, UA_UInt32 entry,
+                      const void *data, UA_StatusCode status,
+                      UA_DateTime sourceTimestamp);
+
+/* Read a consistent copy of the current value of the entry. The regionSize is
+ * the size of the mapping in the calling process. */
+UA_EXPORT UA_StatusCode
+UA_SharedMemory_read(const void *region, size_t regionSize, UA_UInt32 entry,
+                     UA_DataValue *value);
+
 typedef enum {
     UA_VALUEBACKENDTYPE_NONE,
     UA_VALUEBACKENDTYPE_INTERNAL,
     UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK,
-    UA_VALUEBACKENDTYPE_EXTERNAL
+    UA_VALUEBACKENDTYPE_EXTERNAL,
+    UA_VALUEBACKENDTYPE_SHAREDMEMORY
 } UA_ValueBackendType;
 
 typedef struct {
@@ -587,6 +669,11 @@ typedef struct {
             UA_DataValue **value;
             UA_ExternalValueCallback callback;
         } external;
+        struct {
+            const void *region; /* Points to the UA_SharedMemoryHeader */
+            size_t regionSize;  /* Size of the mapping in the server */
+            UA_UInt32 entry;
+        } sharedMemory;
     } backend;
 } UA_ValueBackend;
 
@@ -622,6 +709,13 @@ typedef struct {
                            * background. Only dynamic variables conserve source
                            * and server timestamp for the value attribute.
                            * Static variables have timestamps of "now". */
+    UA_Boolean cacheEncodedValue; /* Encode the value only once for the Read
+                                   * service. See
+                                   * UA_Server_setVariableNode_encodedValueCache */
+    UA_ByteString *encodedValue;  /* Cached encoding, managed by the server */
+#if UA_MULTITHREADING >= 100
+    UA_Boolean async; /* Read and write the DataSource in async operations */
+#endif
 } UA_VariableNode;
 
 /**
@@ -155,6 +155,20 @@ struct UA_ServerConfig {
     UA_EventLoop *eventLoop;
     UA_Boolean externalEventLoop; /* The EventLoop is not deleted with the config */
 
+#if UA_MULTITHREADING >= 100
+    /* Additional EventLoops that serve the TCP connections of the server. Each
+     * of them listens on the server sockets (with SO_REUSEPORT, so that the
+     * kernel distributes the new connections) and is run in its own thread.
+     * A SecureChannel stays with the EventLoop that accepted the connection.
+     * Decoding, encoding and the cryptographic operations for the channel run
+     * in that thread. The services themselves remain serialized by the server
+     * lock. The reactor EventLoops need a TCP ConnectionManager. They are
+     * started and stopped with the server and deleted with the config.
+     * Distributing the connections requires SO_REUSEPORT (Linux, BSD). */
+    UA_EventLoop **reactorEventLoops;
+    size_t reactorEventLoopsSize;
+#endif
+
     /**
      * Networking
      * ^^^^^^^^^^
@@ -266,6 +280,10 @@ struct UA_ServerConfig {
     size_t maxAsyncOperationQueueSize; /* 0 => unlimited */
     /* Notify workers when an async operation was enqueued */
     UA_Server_AsyncOperationNotifyCallback asyncOperationNotifyCallback;
+    /* Number of built-in worker threads that execute async method calls. They
+     * are started and stopped with the server. 0 => no built-in workers, the
+     * application takes the operations. */
+    UA_UInt16 asyncOperationWorkers;
 #endif
 
     /**
@@ -305,6 +323,23 @@ struct UA_ServerConfig {
     UA_UInt32 maxNotificationsPerPublish;
     UA_Boolean enableRetransmissionQueue;
     UA_UInt32 maxRetransmissionQueueSize; /* 0 -> unlimited size */
+    /* Memory limits for the retransmission queues. The oldest messages are
+     * removed when a limit is exceeded. Counted are the encoded messages and
+     * the bookkeeping per message. */
+    size_t maxRetransmissionQueueBytes; /* per Session, 0 -> unlimited */
+    size_t maxServerRetransmissionQueueBytes; /* all Sessions, 0 -> unlimited */
+
+    /* Notifications are allocated in slabs of this many entries. Unused
+     * notifications are kept for reuse until the server is deleted. See the
+     * notification pool statistics from UA_Server_getStatistics for tuning.
+     * 0 -> allocate every notification individually. */
+    UA_UInt32 notificationSlabSize;
+
+    /* Subscriptions with the same publishing interval share one cyclic
+     * callback and are published together. The PublishResponses for the same
+     * SecureChannel are then sent with as few network writes as possible. The
+     * publish cycles of all intervals are aligned to the same base time. */
+    UA_Boolean alignPublishingIntervals;
 # ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     UA_UInt32 maxEventsPerNode; /* 0 -> unlimited size */
 # endif
@@ -804,6 +839,16 @@ UA_Server_readExecutable(UA_Server *server, const UA_NodeId nodeId,
 UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_write(UA_Server *server, const UA_WriteValue *value);
 
+/* Like UA_Server_write. But the written value is moved into the node instead
+ * of making a deep copy. This makes updating large values (e.g. multi-MB
+ * arrays) independent of the value size. If the value was moved, then
+ * value->value is reset to its initial state. The value is copied instead for
+ * writes with an index range, variables with a DataSource or a value backend,
+ * and if the value requires a type conversion. In any case, the caller has to
+ * clean up the WriteValue afterwards. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_writeMove(UA_Server *server, UA_WriteValue *value);
+
 /* Don't use this function. There are typed versions with no additional
  * overhead. */
 UA_StatusCode UA_EXPORT UA_THREADSAFE
@@ -1146,6 +1191,19 @@ UA_Server_setVariableNode_valueBackend(UA_Server *server,
                                        const UA_NodeId nodeId,
                                        const UA_ValueBackend valueBackend);
 
+/* Encode the value of the VariableNode only once for all Read requests. The
+ * binary encoding is cached in the node and copied directly into the
+ * ReadResponse messages. This pays off for values that are read by many
+ * clients more often than they change. The cache is invalidated when the value
+ * is written or the value source changes. It applies only to values stored in
+ * the node itself (not DataSources and value backends) and to reads without an
+ * IndexRange. Returns UA_STATUSCODE_BADNOTSUPPORTED with
+ * UA_ENABLE_IMMUTABLE_NODES. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_setVariableNode_encodedValueCache(UA_Server *server,
+                                            const UA_NodeId nodeId,
+                                            UA_Boolean enable);
+
 /**
  * .. _local-monitoreditems:
  *
@@ -1926,6 +1984,18 @@ UA_Server_getNamespaceByIndex(UA_Server *server, const size_t namespaceIndex,
  * ready. See the examples in ``/examples/tutorial_server_method_async.c`` for
  * the usage.
  *
+ * Likewise, variables with a DataSource can be marked as async. Then the
+ * operations of a ReadRequest or WriteRequest for their value attribute are put
+ * into the queue. The AccessLevel and UserAccessLevel of the session are checked
+ * before the operation is handed to a worker. The worker receives the
+ * ReadValueId (WriteValue) and returns the DataValue (StatusCode).
+ *
+ * Alternatively, the server starts ``asyncOperationWorkers`` built-in worker
+ * threads (see the server config). They execute the method callbacks and the
+ * DataSource read/write callbacks (with the admin session) and return the
+ * results. Returned results wake up the EventLoop so that the
+ * response is sent out right away.
+ *
  * Note that the operation can time out (see the asyncOperationTimeout setting in
  * the server config) also when it has been retrieved by the worker. */
 
@@ -1936,23 +2006,29 @@ UA_StatusCode UA_EXPORT
 UA_Server_setMethodNodeAsync(UA_Server *server, const UA_NodeId id,
                              UA_Boolean isAsync);
 
+/* Set the async flag in a variable node. Only has an effect for the value
+ * attribute of variables with a DataSource. */
+UA_StatusCode UA_EXPORT
+UA_Server_setVariableNodeAsync(UA_Server *server, const UA_NodeId id,
+                               UA_Boolean isAsync);
+
 typedef enum {
     UA_ASYNCOPERATIONTYPE_INVALID, /* 0, the default */
-    UA_ASYNCOPERATIONTYPE_CALL
-    /* UA_ASYNCOPERATIONTYPE_READ, */
-    /* UA_ASYNCOPERATIONTYPE_WRITE, */
+    UA_ASYNCOPERATIONTYPE_CALL,
+    UA_ASYNCOPERATIONTYPE_READ,
+    UA_ASYNCOPERATIONTYPE_WRITE
 } UA_AsyncOperationType;
 
 typedef union {
     UA_CallMethodRequest callMethodRequest;
-    /* UA_ReadValueId readValueId; */
-    /* UA_WriteValue writeValue; */
+    UA_ReadValueId readValueId;
+    UA_WriteValue writeValue;
 } UA_AsyncOperationRequest;
 
 typedef union {
     UA_CallMethodResult callMethodResult;
-    /* UA_DataValue readResult; */
-    /* UA_StatusCode writeResult; */
+    UA_DataValue readResult;
+    UA_StatusCode writeResult;
 } UA_AsyncOperationResponse;
 
 /* Get the next async operation without blocking
@@ -1970,10 +2046,14 @@ UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType
                                        const UA_AsyncOperationRequest **request,
                                        void **context, UA_DateTime *timeout);
 
-/* UA_Boolean UA_EXPORT */
-/* UA_Server_getAsyncOperationBlocking(UA_Server *server, UA_AsyncOperationType *type, */
-/*                                     const UA_AsyncOperationRequest **request, */
-/*                                     void **context, UA_DateTime *timeout); */
+/* Get the next async operation. Blocks until an operation is available. Same
+ * arguments as for _getAsyncOperationNonBlocking.
+ *
+ * @return false if the server was shut down, true else */
+UA_Boolean UA_EXPORT
+UA_Server_getAsyncOperationBlocking(UA_Server *server, UA_AsyncOperationType *type,
+                                    const UA_AsyncOperationRequest **request,
+                                    void **context, UA_DateTime *timeout);
 
 /* Submit an async operation result
  *
@@ -1993,9 +2073,19 @@ UA_Server_setAsyncOperationResult(UA_Server *server,
  * Statistic counters keeping track of the current state of the stack. Counters
  * are structured per OPC UA communication layer. */
 
+typedef struct {
+    size_t slabCount;        /* Slabs allocated for notifications */
+    size_t capacity;         /* Notifications in all slabs */
+    size_t inUse;            /* Notifications currently queued */
+    size_t peakInUse;        /* Maximum of inUse since the server start */
+    size_t inlineValueCount; /* Values that were stored inside the
+                              * notification without an allocation */
+} UA_NotificationPoolStatistics;
+
 typedef struct {
    UA_SecureChannelStatistics scs;
    UA_SessionStatistics ss;
+   UA_NotificationPoolStatistics nps; /* Zero without subscriptions */
 } UA_ServerStatistics;
 
 UA_ServerStatistics UA_EXPORT
@@ -1060,6 +1060,29 @@ typedef enum {
     UA_DATATYPEKIND_BITFIELDCLUSTER = 30 /* bitfields + padding */
 } UA_DataTypeKind;
 
+#ifdef UA_ENABLE_BINARY_CODEC
+/* Specialized binary en/decoding of a structure. The routines are generated by
+ * ``tools/generate_datatypes.py --binary-codec`` with straight-line code for
+ * the members. Then they are used instead of interpreting the member
+ * descriptions at runtime. The ctx is handed to the member routines (see
+ * ``UA_encodeBinaryMember``). The en/decoding ctx starts with the buffer
+ * position. The ctx for the size computation starts with the size so far. */
+typedef struct {
+    UA_Byte *pos;
+    const UA_Byte *end;
+} UA_BinaryCodecBuffer;
+
+typedef struct {
+    size_t size;
+} UA_BinaryCodecSize;
+
+typedef struct {
+    UA_StatusCode (*encodeBinary)(const void *src, void *ctx);
+    UA_StatusCode (*decodeBinary)(void *dst, void *ctx);
+    UA_StatusCode (*calcSizeBinary)(const void *src, void *ctx);
+} UA_DataTypeBinaryCodec;
+#endif
+
 struct UA_DataType {
 #ifdef UA_ENABLE_TYPEDESCRIPTION
     const char *typeName;
@@ -1075,6 +1098,9 @@ struct UA_DataType {
                                  * in memory and on the binary stream. */
     UA_UInt32 membersSize : 8;  /* How many members does the type have? */
     UA_DataTypeMember *members;
+#ifdef UA_ENABLE_BINARY_CODEC
+    const UA_DataTypeBinaryCodec *binaryCodec; /* Can be NULL */
+#endif
 };
 
 /* Datatype arrays with custom type definitions can be added in a linked list to
@@ -1241,6 +1267,13 @@ UA_encodeBinary(const void *p, const UA_DataType *type,
 typedef struct {
     const UA_DataTypeArray *customTypes; /* Begin of a linked list with custom
                                           * datatype definitions */
+
+    /* Strings, ByteStrings, XmlElements and arrays of overlayable types (e.g.
+     * integers) point into the input buffer instead of being copied. Arrays
+     * that are not aligned in the buffer are still copied. The decoded value
+     * must not outlive the input buffer. It is cleaned up with
+     * UA_clearBorrowed (not with UA_clear). */
+    UA_Boolean borrowBuffer;
 } UA_DecodeBinaryOptions;
 
 /* Decodes a data structure from the input buffer in the binary format. It is
@@ -1251,6 +1284,36 @@ UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
                 const UA_DecodeBinaryOptions *options);
 
+/* Clears a value that was decoded with the ``borrowBuffer`` option. Members
+ * that point into the input buffer are not freed. */
+UA_EXPORT void
+UA_clearBorrowed(void *p, const UA_DataType *type, const UA_ByteString *inBuf);
+
+#ifdef UA_ENABLE_BINARY_CODEC
+/* En/decode and size a structure member (scalar or array) from within a
+ * UA_DataTypeBinaryCodec. The ctx is the argument of the codec routine. */
+UA_EXPORT UA_StatusCode
+UA_encodeBinaryMember(const void *src, const UA_DataType *type, void *ctx);
+
+UA_EXPORT UA_StatusCode
+UA_encodeBinaryMemberArray(const void *src, size_t size,
+                           const UA_DataType *type, void *ctx);
+
+UA_EXPORT UA_StatusCode
+UA_decodeBinaryMember(void *dst, const UA_DataType *type, void *ctx);
+
+UA_EXPORT UA_StatusCode
+UA_decodeBinaryMemberArray(void **dst, size_t *size,
+                           const UA_DataType *type, void *ctx);
+
+UA_EXPORT UA_StatusCode
+UA_calcSizeBinaryMember(const void *src, const UA_DataType *type, void *ctx);
+
+UA_EXPORT UA_StatusCode
+UA_calcSizeBinaryMemberArray(const void *src, size_t size,
+                             const UA_DataType *type, void *ctx);
+#endif
+
 /**
  * JSON En/Decoding
  * ----------------
@@ -0,0 +1,827 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* The in-memory ConnectionManager connects applications in the same process
+ * without sockets. A connection is a pair of single-producer single-consumer
+ * byte rings, one for each direction. The rings are lock-free. The receiver
+ * gets the data handed out directly from the ring memory.
+ *
+ * Listen-connections register their name in a process-wide registry. Active
+ * connections look up the name when they open. The receiving side is notified
+ * with a delayed callback in its EventLoop. The notifications are coalesced.
+ * So a polling EventLoop in another thread is woken up at most once per burst
+ * of messages. The ConnectionManager only uses the public EventLoop API and is
+ * architecture agnostic. */
+
+#include <open62541/plugin/eventloop.h>
+
+#if defined(UA_ARCHITECTURE_POSIX) || defined(UA_ARCHITECTURE_WIN32)
+
+#include "eventloop_common.h"
+#include "../../deps/open62541_queue.h"
+
+#include <string.h>
+
+/* Ordering of the ring indices and flags between the threads */
+#if UA_MULTITHREADING >= 100 && defined(__GNUC__)
+# define MEM_LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+# define MEM_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+# define MEM_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif UA_MULTITHREADING >= 100 && defined(_WIN32)
+/* Volatile accesses have acquire/release semantics with MSVC */
+# define MEM_LOAD(p) (*(p))
+# define MEM_STORE(p, v) (*(p) = (v))
+# define MEM_FENCE() MemoryBarrier()
+#else
+# define MEM_LOAD(p) (*(p))
+# define MEM_STORE(p, v) (*(p) = (v))
+# define MEM_FENCE()
+#endif
+
+/* Scheduling state of a connection */
+#define MEM_IDLE ((void*)0x0)
+#define MEM_SCHEDULED ((void*)0x1) /* The delayed callback is queued */
+#define MEM_DONE ((void*)0x2)      /* Finally closed, never scheduled again */
+
+#define MEM_DEFAULT_RINGSIZE (1u << 18) /* 256kB */
+
+/* Configuration parameters */
+
+#define MEM_MANAGERPARAMS 1
+
+static UA_KeyValueRestriction memManagerParams[MEM_MANAGERPARAMS] = {
+    {{0, UA_STRING_STATIC("ring-size")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+};
+
+#define MEM_PARAMETERSSIZE 4
+#define MEM_PARAMINDEX_ADDR 0
+#define MEM_PARAMINDEX_PORT 1
+#define MEM_PARAMINDEX_LISTEN 2
+#define MEM_PARAMINDEX_VALIDATE 3
+
+static UA_KeyValueRestriction memConnectionParams[MEM_PARAMETERSSIZE] = {
+    {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], true, true, true},
+    {{0, UA_STRING_STATIC("port")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
+    {{0, UA_STRING_STATIC("listen")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
+};
+
+typedef struct {
+    UA_Byte *data;
+    size_t mask; /* The capacity is a power of two */
+
+    /* The producer only writes the head, the consumer only writes the tail.
+     * Both increase monotonically. Keep them on different cache lines. */
+    volatile size_t head;
+    UA_Byte pad[64];
+    volatile size_t tail;
+} MEM_Ring;
+
+struct MEM_ConnectionManager;
+typedef struct MEM_ConnectionManager MEM_ConnectionManager;
+
+struct MEM_Pair;
+typedef struct MEM_Pair MEM_Pair;
+
+/* Sent data that did not fit into the ring */
+typedef struct MEM_PendingBuffer {
+    struct MEM_PendingBuffer *next;
+    UA_ByteString buf;
+    size_t pos;
+} MEM_PendingBuffer;
+
+typedef struct MEM_Connection {
+    LIST_ENTRY(MEM_Connection) pointers; /* In the ConnectionManager */
+    uintptr_t connectionId;
+    MEM_ConnectionManager *mcm;
+
+    UA_ConnectionManager_connectionCallback applicationCB;
+    void *application;
+    void *context;
+
+    /* The delayed callback processes the connection in its EventLoop */
+    UA_DelayedCallback dc;
+    void * volatile scheduled; /* MEM_IDLE, MEM_SCHEDULED or MEM_DONE */
+    volatile UA_Boolean closing;
+
+    /* Listen-connections */
+    UA_Boolean listen;
+    UA_Boolean ready; /* Announced to the application, accepts connections */
+    UA_String name;
+    LIST_ENTRY(MEM_Connection) registryPointers;
+
+    /* Active and accepted connections */
+    MEM_Pair *pair;
+    struct MEM_Connection *peer;
+    MEM_Ring *rx; /* Written by the peer */
+    MEM_Ring *tx; /* Read by the peer */
+    UA_Boolean known;       /* The application knows the connectionId */
+    UA_Boolean established; /* ESTABLISHED was signaled */
+    volatile UA_Boolean txBlocked; /* Pending buffers wait for space */
+    volatile UA_Boolean shutdown;  /* Finally closed, seen by the peer */
+    MEM_PendingBuffer *txPending;
+    MEM_PendingBuffer **txPendingLast;
+} MEM_Connection;
+
+struct MEM_Pair {
+    MEM_Connection ends[2]; /* Active side and accepted side */
+    MEM_Ring rings[2];      /* Active -> accepted and accepted -> active */
+    void * volatile firstClosed;
+};
+
+struct MEM_ConnectionManager {
+    UA_ConnectionManager cm;
+    size_t ringSize;
+    uintptr_t lastConnectionId;
+    size_t connectionsSize;
+    LIST_HEAD(, MEM_Connection) connections;
+#if UA_MULTITHREADING >= 100
+    UA_Lock lock;
+#endif
+};
+
+/* Process-wide registry of the listen-connections. The lock is only taken to
+ * open and close connections. The lock order is registry -> cm->lock. A
+ * CRITICAL_SECTION cannot be initialized statically. So on Windows the lock is
+ * initialized once before the first use. */
+static LIST_HEAD(, MEM_Connection) memListeners;
+#if UA_MULTITHREADING >= 100
+# ifdef UA_ARCHITECTURE_WIN32
+static UA_Lock memListenersLock;
+static INIT_ONCE memListenersLockOnce = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK
+initRegistryLock(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void)once, (void)param, (void)context;
+    UA_LOCK_INIT(&memListenersLock);
+    return TRUE;
+}
+# else
+static UA_Lock memListenersLock = UA_LOCK_STATIC_INIT;
+# endif
+#endif
+
+static void
+lockRegistry(void) {
+#if UA_MULTITHREADING >= 100 && defined(UA_ARCHITECTURE_WIN32)
+    InitOnceExecuteOnce(&memListenersLockOnce, initRegistryLock, NULL, NULL);
+#endif
+    UA_LOCK(&memListenersLock);
+}
+
+static void
+unlockRegistry(void) {
+    UA_UNLOCK(&memListenersLock);
+}
+
+/********/
+/* Ring */
+/********/
+
+static UA_StatusCode
+MEM_Ring_init(MEM_Ring *r, size_t size) {
+    memset(r, 0, sizeof(MEM_Ring));
+    r->data = (UA_Byte*)UA_malloc(size);
+    if(!r->data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    r->mask = size - 1;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Returns the number of written bytes. Only called by the producer. */
+static size_t
+MEM_Ring_write(MEM_Ring *r, const UA_Byte *data, size_t length) {
+    size_t head = r->head;
+    size_t space = (r->mask + 1) - (head - MEM_LOAD(&r->tail));
+    if(length > space)
+        length = space;
+    size_t pos = head & r->mask;
+    size_t first = r->mask + 1 - pos;
+    if(first > length)
+        first = length;
+    memcpy(&r->data[pos], data, first);
+    memcpy(r->data, &data[first], length - first);
+    MEM_STORE(&r->head, head + length);
+    return length;
+}
+
+/* The number of received bytes. Only called by the consumer. */
+static size_t
+MEM_Ring_available(MEM_Ring *r) {
+    return MEM_LOAD(&r->head) - r->tail;
+}
+
+/* Returns the contiguous readable memory at the tail (up to max bytes) */
+static UA_ByteString
+MEM_Ring_peek(MEM_Ring *r, size_t max) {
+    size_t pos = r->tail & r->mask;
+    UA_ByteString bs;
+    bs.data = &r->data[pos];
+    bs.length = r->mask + 1 - pos;
+    if(bs.length > max)
+        bs.length = max;
+    return bs;
+}
+
+static void
+MEM_Ring_consume(MEM_Ring *r, size_t length) {
+    MEM_STORE(&r->tail, r->tail + length);
+}
+
+/**************/
+/* Connection */
+/**************/
+
+static void
+MEM_process(void *application, void *context);
+
+static void
+MEM_schedule(MEM_Connection *conn) {
+    /* Already scheduled or finally closed */
+    if(UA_atomic_cmpxchg(&conn->scheduled, MEM_IDLE, MEM_SCHEDULED) != MEM_IDLE)
+        return;
+    UA_EventLoop *el = conn->mcm->cm.eventSource.eventLoop;
+    el->addDelayedCallback(el, &conn->dc);
+}
+
+static void
+MEM_initConnection(MEM_ConnectionManager *mcm, MEM_Connection *conn,
+                   void *application, void *context,
+                   UA_ConnectionManager_connectionCallback connectionCallback) {
+    UA_LOCK_ASSERT(&mcm->lock, 1);
+    conn->connectionId = ++mcm->lastConnectionId;
+    conn->mcm = mcm;
+    conn->applicationCB = connectionCallback;
+    conn->application = application;
+    conn->context = context;
+    conn->dc.callback = MEM_process;
+    conn->dc.application = mcm;
+    conn->dc.context = conn;
+    conn->txPendingLast = &conn->txPending;
+    LIST_INSERT_HEAD(&mcm->connections, conn, pointers);
+    mcm->connectionsSize++;
+}
+
+static MEM_Connection *
+MEM_findConnection(MEM_ConnectionManager *mcm, uintptr_t connectionId) {
+    UA_LOCK_ASSERT(&mcm->lock, 1);
+    MEM_Connection *conn;
+    LIST_FOREACH(conn, &mcm->connections, pointers) {
+        if(conn->connectionId == connectionId)
+            return conn;
+    }
+    return NULL;
+}
+
+/* Test if the ConnectionManager can be stopped */
+static void
+MEM_checkStopped(MEM_ConnectionManager *mcm) {
+    UA_LOCK_ASSERT(&mcm->lock, 1);
+    if(mcm->connectionsSize == 0 &&
+       mcm->cm.eventSource.state == UA_EVENTSOURCESTATE_STOPPING) {
+        UA_LOG_DEBUG(mcm->cm.eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+                     "MEM\t| All connections closed, the ConnectionManager "
+                     "has stopped");
+        mcm->cm.eventSource.state = UA_EVENTSOURCESTATE_STOPPED;
+    }
+}
+
+/* Move pending buffers into the ring */
+static void
+MEM_flushPending(MEM_Connection *conn) {
+    UA_LOCK_ASSERT(&conn->mcm->lock, 1);
+    while(conn->txPending) {
+        MEM_PendingBuffer *p = conn->txPending;
+        p->pos += MEM_Ring_write(conn->tx, &p->buf.data[p->pos],
+                                 p->buf.length - p->pos);
+        if(p->pos < p->buf.length)
+            return;
+        conn->txPending = p->next;
+        if(!conn->txPending)
+            conn->txPendingLast = &conn->txPending;
+        UA_ByteString_clear(&p->buf);
+        UA_free(p);
+    }
+}
+
+static void
+MEM_deletePair(MEM_Pair *pair) {
+    UA_free(pair->rings[0].data);
+    UA_free(pair->rings[1].data);
+    UA_free(pair);
+}
+
+/* Final removal of a connection. Called from the delayed callback. */
+static void
+MEM_finalize(MEM_ConnectionManager *mcm, MEM_Connection *conn) {
+    /* Scheduled again in the meantime. Finalize in the next run. */
+    if(UA_atomic_cmpxchg(&conn->scheduled, MEM_IDLE, MEM_DONE) != MEM_IDLE)
+        return;
+
+    /* Remove from the ConnectionManager. No more sending afterwards. */
+    UA_LOCK(&mcm->lock);
+    LIST_REMOVE(conn, pointers);
+    while(conn->txPending) {
+        MEM_PendingBuffer *p = conn->txPending;
+        conn->txPending = p->next;
+        UA_ByteString_clear(&p->buf);
+        UA_free(p);
+    }
+    UA_UNLOCK(&mcm->lock);
+
+    UA_LOG_INFO(mcm->cm.eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+                "MEM %u\t| Connection closed", (unsigned)conn->connectionId);
+
+    if(conn->listen) {
+        /* Remove from the registry */
+        lockRegistry();
+        LIST_REMOVE(conn, registryPointers);
+        unlockRegistry();
+    } else {
+        /* Notify the peer */
+        MEM_STORE(&conn->shutdown, true);
+        MEM_schedule(conn->peer);
+    }
+
+    /* Signal closing to the application */
+    if(conn->known)
+        conn->applicationCB(&mcm->cm, conn->connectionId, conn->application,
+                            &conn->context, UA_CONNECTIONSTATE_CLOSING,
+                            &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
+
+    /* Free the memory. The pair is freed by the second connection. */
+    if(conn->listen) {
+        UA_String_clear(&conn->name);
+        UA_free(conn);
+    } else {
+        MEM_Pair *pair = conn->pair;
+        if(UA_atomic_cmpxchg(&pair->firstClosed, NULL, conn) != NULL)
+            MEM_deletePair(pair);
+    }
+
+    /* Check if this was the last connection for a closing ConnectionManager */
+    UA_LOCK(&mcm->lock);
+    mcm->connectionsSize--;
+    MEM_checkStopped(mcm);
+    UA_UNLOCK(&mcm->lock);
+}
+
+/* Delayed callback in the EventLoop of the connection */
+static void
+MEM_process(void *application, void *context) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)application;
+    MEM_Connection *conn = (MEM_Connection*)context;
+
+    /* New notifications schedule the callback again from here on */
+    UA_atomic_xchg(&conn->scheduled, MEM_IDLE);
+    MEM_FENCE();
+
+    if(conn->listen) {
+        if(conn->closing)
+            MEM_finalize(mcm, conn);
+        return;
+    }
+
+    /* The connection has fully opened */
+    if(!conn->established && !conn->closing) {
+        conn->established = true;
+        conn->known = true;
+        conn->applicationCB(&mcm->cm, conn->connectionId, conn->application,
+                            &conn->context, UA_CONNECTIONSTATE_ESTABLISHED,
+                            &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
+    }
+
+    /* Send the pending buffers if the peer has consumed in the meantime */
+    UA_LOCK(&mcm->lock);
+    if(conn->txPending) {
+        MEM_flushPending(conn);
+        if(!conn->txPending)
+            MEM_STORE(&conn->txBlocked, false);
+        MEM_schedule(conn->peer);
+    }
+    UA_UNLOCK(&mcm->lock);
+
+    /* Hand out the received data directly from the ring. Limit to what is
+     * available now. Data arriving in the meantime schedules the next run. */
+    size_t available = MEM_Ring_available(conn->rx);
+    size_t consumed = 0;
+    while(!conn->closing && consumed < available) {
+        UA_ByteString msg = MEM_Ring_peek(conn->rx, available - consumed);
+        conn->applicationCB(&mcm->cm, conn->connectionId, conn->application,
+                            &conn->context, UA_CONNECTIONSTATE_ESTABLISHED,
+                            &UA_KEYVALUEMAP_NULL, msg);
+        MEM_Ring_consume(conn->rx, msg.length);
+        consumed += msg.length;
+    }
+
+    /* Space became available for a blocked peer */
+    if(consumed > 0) {
+        MEM_FENCE();
+        if(MEM_LOAD(&conn->peer->txBlocked))
+            MEM_schedule(conn->peer);
+    }
+
+    /* Close if requested locally. Or if the peer has closed and everything
+     * was received. */
+    if(conn->closing ||
+       (MEM_LOAD(&conn->peer->shutdown) && MEM_Ring_available(conn->rx) == 0))
+        MEM_finalize(mcm, conn);
+}
+
+static UA_StatusCode
+MEM_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       const UA_KeyValueMap *params, UA_ByteString *buf) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+    UA_LOCK(&mcm->lock);
+
+    MEM_Connection *conn = MEM_findConnection(mcm, connectionId);
+    if(!conn || conn->listen || conn->closing || MEM_LOAD(&conn->peer->shutdown)) {
+        UA_UNLOCK(&mcm->lock);
+        UA_ByteString_clear(buf);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    /* Keep the order behind already pending buffers */
+    size_t written = 0;
+    if(!conn->txPending)
+        written = MEM_Ring_write(conn->tx, buf->data, buf->length);
+
+    if(written < buf->length) {
+        /* The ring is full. Keep the remainder until the peer has consumed. */
+        MEM_PendingBuffer *p = (MEM_PendingBuffer*)UA_malloc(sizeof(MEM_PendingBuffer));
+        if(!p) {
+            /* The stream is broken after a partial write */
+            conn->closing = true;
+            MEM_schedule(conn);
+            UA_UNLOCK(&mcm->lock);
+            UA_ByteString_clear(buf);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        p->next = NULL;
+        p->buf = *buf;
+        p->pos = written;
+        *conn->txPendingLast = p;
+        conn->txPendingLast = &p->next;
+        UA_ByteString_init(buf);
+
+        /* Retry after announcing the blocked state. Otherwise the peer might
+         * have consumed everything before it could see the flag. */
+        MEM_STORE(&conn->txBlocked, true);
+        MEM_FENCE();
+        MEM_flushPending(conn);
+        if(!conn->txPending)
+            MEM_STORE(&conn->txBlocked, false);
+    } else {
+        UA_ByteString_clear(buf);
+    }
+
+    MEM_schedule(conn->peer);
+    UA_UNLOCK(&mcm->lock);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+MEM_closeConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+    UA_LOCK(&mcm->lock);
+    MEM_Connection *conn = MEM_findConnection(mcm, connectionId);
+    if(!conn) {
+        UA_LOG_WARNING(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+                       "MEM\t| Cannot close connection %u - not found",
+                       (unsigned)connectionId);
+        UA_UNLOCK(&mcm->lock);
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+    conn->closing = true;
+    MEM_schedule(conn);
+    UA_UNLOCK(&mcm->lock);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+MEM_openListenConnection(MEM_ConnectionManager *mcm, const UA_String *name,
+                         void *application, void *context,
+                         UA_ConnectionManager_connectionCallback connectionCallback,
+                         UA_Boolean validate) {
+    UA_EventLoop *el = mcm->cm.eventSource.eventLoop;
+    if(name->length == 0) {
+        UA_LOG_ERROR(el->logger, UA_LOGCATEGORY_NETWORK,
+                     "MEM\t| Cannot listen without a name");
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Allocate the connection */
+    MEM_Connection *conn = (MEM_Connection*)UA_calloc(1, sizeof(MEM_Connection));
+    if(!conn)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_StatusCode res = UA_String_copy(name, &conn->name);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_free(conn);
+        return res;
+    }
+    conn->listen = true;
+
+    /* The name must be unique in the process */
+    lockRegistry();
+    MEM_Connection *other;
+    LIST_FOREACH(other, &memListeners, registryPointers) {
+        if(UA_String_equal(&other->name, name))
+            break;
+    }
+    if(other || validate) {
+        unlockRegistry();
+        UA_String_clear(&conn->name);
+        UA_free(conn);
+        if(validate && !other)
+            return UA_STATUSCODE_GOOD;
+        UA_LOG_WARNING(el->logger, UA_LOGCATEGORY_NETWORK,
+                       "MEM\t| The name \"%.*s\" is already in use",
+                       (int)name->length, (const char*)name->data);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    UA_LOCK(&mcm->lock);
+    MEM_initConnection(mcm, conn, application, context, connectionCallback);
+    UA_UNLOCK(&mcm->lock);
+    LIST_INSERT_HEAD(&memListeners, conn, registryPointers);
+    unlockRegistry();
+
+    UA_LOG_INFO(el->logger, UA_LOGCATEGORY_NETWORK,
+                "MEM %u\t| Listening on \"%.*s\"", (unsigned)conn->connectionId,
+                (int)name->length, (const char*)name->data);
+
+    /* Announce the listen-connection in the application. Connections are
+     * accepted afterwards. They inherit the context that is set here. */
+    conn->known = true;
+    connectionCallback(&mcm->cm, conn->connectionId, application, &conn->context,
+                       UA_CONNECTIONSTATE_ESTABLISHED, &UA_KEYVALUEMAP_NULL,
+                       UA_BYTESTRING_NULL);
+    lockRegistry();
+    conn->ready = true;
+    unlockRegistry();
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+MEM_openActiveConnection(MEM_ConnectionManager *mcm, const UA_String *name,
+                         void *application, void *context,
+                         UA_ConnectionManager_connectionCallback connectionCallback,
+                         UA_Boolean validate) {
+    UA_EventLoop *el = mcm->cm.eventSource.eventLoop;
+
+    /* Find the listen-connection */
+    lockRegistry();
+    MEM_Connection *listener;
+    LIST_FOREACH(listener, &memListeners, registryPointers) {
+        if(listener->ready && !listener->closing &&
+           listener->mcm->cm.eventSource.state == UA_EVENTSOURCESTATE_STARTED &&
+           UA_String_equal(&listener->name, name))
+            break;
+    }
+    if(!listener) {
+        unlockRegistry();
+        UA_LOG_WARNING(el->logger, UA_LOGCATEGORY_NETWORK,
+                       "MEM\t| Nobody listens on \"%.*s\"",
+                       (int)name->length, (const char*)name->data);
+        return UA_STATUSCODE_BADCONNECTIONREJECTED;
+    }
+
+    if(validate) {
+        unlockRegistry();
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Allocate the pair of connections with the rings. Each ring has the
+     * size configured at the receiving side. */
+    MEM_ConnectionManager *lmcm = listener->mcm;
+    MEM_Pair *pair = (MEM_Pair*)UA_calloc(1, sizeof(MEM_Pair));
+    if(!pair) {
+        unlockRegistry();
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    UA_StatusCode res = MEM_Ring_init(&pair->rings[0], lmcm->ringSize);
+    res |= MEM_Ring_init(&pair->rings[1], mcm->ringSize);
+    if(res != UA_STATUSCODE_GOOD) {
+        unlockRegistry();
+        MEM_deletePair(pair);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    MEM_Connection *active = &pair->ends[0];
+    MEM_Connection *accepted = &pair->ends[1];
+    active->pair = accepted->pair = pair;
+    active->peer = accepted;
+    accepted->peer = active;
+    active->tx = accepted->rx = &pair->rings[0];
+    accepted->tx = active->rx = &pair->rings[1];
+    active->known = true;
+
+    UA_LOCK(&lmcm->lock);
+    if(lmcm->cm.eventSource.state != UA_EVENTSOURCESTATE_STARTED) {
+        /* Stopped in the meantime */
+        UA_UNLOCK(&lmcm->lock);
+        unlockRegistry();
+        MEM_deletePair(pair);
+        return UA_STATUSCODE_BADCONNECTIONREJECTED;
+    }
+    MEM_initConnection(lmcm, accepted, listener->application,
+                       listener->context, listener->applicationCB);
+    UA_UNLOCK(&lmcm->lock);
+    UA_LOCK(&mcm->lock);
+    MEM_initConnection(mcm, active, application, context, connectionCallback);
+    UA_UNLOCK(&mcm->lock);
+    unlockRegistry();
+
+    UA_LOG_INFO(el->logger, UA_LOGCATEGORY_NETWORK,
+                "MEM %u\t| New connection to \"%.*s\"", (unsigned)active->connectionId,
+                (int)name->length, (const char*)name->data);
+
+    /* Signal the new connection to the application as asynchonously opening.
+     * Both sides signal ESTABLISHED from their EventLoop. */
+    connectionCallback(&mcm->cm, active->connectionId, application,
+                       &active->context, UA_CONNECTIONSTATE_OPENING,
+                       &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
+    MEM_schedule(accepted);
+    MEM_schedule(active);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+MEM_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
+                   void *application, void *context,
+                   UA_ConnectionManager_connectionCallback connectionCallback) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+    UA_EventLoop *el = cm->eventSource.eventLoop;
+
+    if(cm->eventSource.state != UA_EVENTSOURCESTATE_STARTED) {
+        UA_LOG_ERROR(el->logger, UA_LOGCATEGORY_NETWORK,
+                     "MEM\t| Cannot open a connection for a "
+                     "ConnectionManager that is not started");
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Check the parameters */
+    UA_StatusCode res =
+        UA_KeyValueRestriction_validate(el->logger, "MEM", memConnectionParams,
+                                        MEM_PARAMETERSSIZE, params);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* The server passes the address as an array like for TCP */
+    const UA_Variant *addr =
+        UA_KeyValueMap_get(params, memConnectionParams[MEM_PARAMINDEX_ADDR].name);
+    UA_assert(addr); /* existence is checked before */
+    if(!UA_Variant_isScalar(addr) && addr->arrayLength != 1) {
+        UA_LOG_ERROR(el->logger, UA_LOGCATEGORY_NETWORK,
+                     "MEM\t| Exactly one address must be given");
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    const UA_String *name = (const UA_String*)addr->data;
+
+    /* Only validate the parameters? */
+    UA_Boolean validate = false;
+    const UA_Boolean *validateParam = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params,
+                                 memConnectionParams[MEM_PARAMINDEX_VALIDATE].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(validateParam)
+        validate = *validateParam;
+
+    /* Listen or active connection? */
+    UA_Boolean listen = false;
+    const UA_Boolean *listenParam = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params,
+                                 memConnectionParams[MEM_PARAMINDEX_LISTEN].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(listenParam)
+        listen = *listenParam;
+
+    if(listen)
+        return MEM_openListenConnection(mcm, name, application, context,
+                                        connectionCallback, validate);
+    return MEM_openActiveConnection(mcm, name, application, context,
+                                    connectionCallback, validate);
+}
+
+static UA_StatusCode
+MEM_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       UA_ByteString *buf, size_t bufSize) {
+    return UA_ByteString_allocBuffer(buf, bufSize);
+}
+
+static void
+MEM_freeNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
+                      UA_ByteString *buf) {
+    UA_ByteString_clear(buf);
+}
+
+/*********************/
+/* ConnectionManager */
+/*********************/
+
+static UA_StatusCode
+MEM_eventSourceStart(UA_ConnectionManager *cm) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+    UA_EventLoop *el = cm->eventSource.eventLoop;
+    if(!el)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Check the state */
+    if(cm->eventSource.state != UA_EVENTSOURCESTATE_STOPPED) {
+        UA_LOG_ERROR(el->logger, UA_LOGCATEGORY_NETWORK,
+                     "MEM\t| To start the ConnectionManager, it has to be "
+                     "registered in an EventLoop and not started yet");
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Check the parameters */
+    UA_StatusCode res =
+        UA_KeyValueRestriction_validate(el->logger, "MEM", memManagerParams,
+                                        MEM_MANAGERPARAMS, &cm->eventSource.params);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Round the ring size up to a power of two */
+    size_t ringSize = MEM_DEFAULT_RINGSIZE;
+    const UA_UInt32 *configRingSize = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 memManagerParams[0].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(configRingSize && *configRingSize > 0)
+        ringSize = *configRingSize;
+    mcm->ringSize = 1;
+    while(mcm->ringSize < ringSize)
+        mcm->ringSize <<= 1;
+
+    cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+MEM_eventSourceStop(UA_ConnectionManager *cm) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+
+    UA_LOG_INFO(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+                "MEM\t| Shutting down the ConnectionManager");
+
+    UA_LOCK(&mcm->lock);
+
+    /* Prevent new connections to open */
+    cm->eventSource.state = UA_EVENTSOURCESTATE_STOPPING;
+
+    /* Close all connections */
+    MEM_Connection *conn;
+    LIST_FOREACH(conn, &mcm->connections, pointers) {
+        conn->closing = true;
+        MEM_schedule(conn);
+    }
+
+    /* All connections closed? Otherwise iterate some more. */
+    MEM_checkStopped(mcm);
+
+    UA_UNLOCK(&mcm->lock);
+}
+
+static UA_StatusCode
+MEM_eventSourceDelete(UA_ConnectionManager *cm) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)cm;
+    if(cm->eventSource.state >= UA_EVENTSOURCESTATE_STARTING) {
+        UA_LOG_ERROR(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_EVENTLOOP,
+                     "MEM\t| The EventSource must be stopped before it can be deleted");
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    UA_KeyValueMap_clear(&cm->eventSource.params);
+    UA_String_clear(&cm->eventSource.name);
+    UA_LOCK_DESTROY(&mcm->lock);
+    UA_free(mcm);
+    return UA_STATUSCODE_GOOD;
+}
+
+static const char *memName = "mem";
+
+UA_ConnectionManager *
+UA_ConnectionManager_new_Memory(const UA_String eventSourceName) {
+    MEM_ConnectionManager *mcm = (MEM_ConnectionManager*)
+        UA_calloc(1, sizeof(MEM_ConnectionManager));
+    if(!mcm)
+        return NULL;
+
+    UA_LOCK_INIT(&mcm->lock);
+    mcm->cm.eventSource.eventSourceType = UA_EVENTSOURCETYPE_CONNECTIONMANAGER;
+    UA_String_copy(&eventSourceName, &mcm->cm.eventSource.name);
+    mcm->cm.eventSource.start = (UA_StatusCode (*)(UA_EventSource *))MEM_eventSourceStart;
+    mcm->cm.eventSource.stop = (void (*)(UA_EventSource *))MEM_eventSourceStop;
+    mcm->cm.eventSource.free = (UA_StatusCode (*)(UA_EventSource *))MEM_eventSourceDelete;
+    mcm->cm.protocol = UA_STRING((char*)(uintptr_t)memName);
+    mcm->cm.openConnection = MEM_openConnection;
+    mcm->cm.allocNetworkBuffer = MEM_allocNetworkBuffer;
+    mcm->cm.freeNetworkBuffer = MEM_freeNetworkBuffer;
+    mcm->cm.sendWithConnection = MEM_sendWithConnection;
+    mcm->cm.closeConnection = MEM_closeConnection;
+    return &mcm->cm;
+}
+
+#endif /* defined(UA_ARCHITECTURE_POSIX) || defined(UA_ARCHITECTURE_WIN32) */
@@ -25,9 +25,9 @@ cmpId(const UA_UInt64 *a, const UA_UInt64 *b) {
 ZIP_FUNCTIONS(UA_TimerTree, UA_TimerEntry, treeEntry, UA_DateTime, nextTime, cmpDateTime)
 ZIP_FUNCTIONS(UA_TimerIdTree, UA_TimerEntry, idTreeEntry, UA_UInt64, id, cmpId)
 
-static UA_DateTime
-calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
-                  UA_DateTime interval) {
+UA_DateTime
+UA_Timer_calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
+                           UA_DateTime interval) {
     /* Take the difference between current and base time */
     UA_DateTime diffCurrentTimeBaseTime = currentTime - baseTime;
 
@@ -112,7 +112,7 @@ UA_Timer_addRepeatedCallback(UA_Timer *t, UA_ApplicationCallback callback,
     if(baseTime == NULL) {
         nextTime = now + (UA_DateTime)interval;
     } else {
-        nextTime = calculateNextTime(now, *baseTime, (UA_DateTime)interval);
+        nextTime = UA_Timer_calculateNextTime(now, *baseTime, (UA_DateTime)interval);
     }
 
     UA_LOCK(&t->timerMutex);
@@ -152,7 +152,7 @@ UA_Timer_changeRepeatedCallback(UA_Timer *t, UA_UInt64 callbackId,
     if(baseTime == NULL) {
         te->nextTime = now + (UA_DateTime)interval;
     } else {
-        te->nextTime = calculateNextTime(now, *baseTime, (UA_DateTime)interval);
+        te->nextTime = UA_Timer_calculateNextTime(now, *baseTime, (UA_DateTime)interval);
     }
 
     /* Update the remaining parameters and re-insert */
@@ -226,8 +226,8 @@ processEntryCallback(void *context, UA_TimerEntry *te) {
      * changes. (Part 4, 5.12.1.2) */
     if(te->nextTime < tpc->now) {
         if(te->timerPolicy == UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME)
-            te->nextTime = calculateNextTime(tpc->now, te->nextTime,
-                                              (UA_DateTime)te->interval);
+            te->nextTime = UA_Timer_calculateNextTime(tpc->now, te->nextTime,
+                                                       (UA_DateTime)te->interval);
         else
             te->nextTime = tpc->now + (UA_DateTime)te->interval;
     }
@@ -92,6 +92,12 @@ UA_Timer_process(UA_Timer *t, UA_DateTime now);
 void
 UA_Timer_clear(UA_Timer *t);
 
+/* Next execution time of a repeated callback after currentTime that is aligned
+ * to the baseTime */
+UA_DateTime
+UA_Timer_calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
+                           UA_DateTime interval);
+
 _UA_END_DECLS
 
 #endif /* UA_TIMER_H_ */
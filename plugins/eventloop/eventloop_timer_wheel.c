@@ -0,0 +1,445 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "eventloop_timer_wheel.h"
+
+/* Markers for entries that are not in a slot of the wheel */
+#define UA_TIMERWHEEL_EXPIRED UA_TIMERWHEEL_LEVELS
+#define UA_TIMERWHEEL_DUE (UA_TIMERWHEEL_LEVELS + 1)
+
+#define UA_TIMERWHEEL_SLOTMASK ((UA_UInt64)UA_TIMERWHEEL_SLOTS - 1)
+
+/* x must not be zero */
+static unsigned
+highestBit(UA_UInt64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (unsigned)__builtin_clzll(x);
+#else
+    unsigned b = 0;
+    while(x >>= 1)
+        b++;
+    return b;
+#endif
+}
+
+/* x must not be zero */
+static unsigned
+lowestBit(UA_UInt64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    unsigned b = 0;
+    while(!(x & 1)) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+static UA_UInt64
+rotateLeft(UA_UInt64 x, unsigned n) {
+    n &= 63;
+    if(n == 0)
+        return x;
+    return (x << n) | (x >> (64 - n));
+}
+
+/* Move the entries of a list to an (empty) list on the stack */
+static void
+takeList(UA_TimerWheelSlot *from, UA_TimerWheelSlot *to) {
+    LIST_FIRST(to) = LIST_FIRST(from);
+    if(LIST_FIRST(to))
+        LIST_FIRST(to)->slotEntry.le_prev = &LIST_FIRST(to);
+    LIST_INIT(from);
+}
+
+static void
+insertEntry(UA_TimerWheel *t, UA_TimerWheelEntry *te) {
+    if(te->nextTime <= t->currentTime) {
+        te->level = UA_TIMERWHEEL_EXPIRED;
+        LIST_INSERT_HEAD(&t->expired, te, slotEntry);
+        return;
+    }
+
+    /* The level of the highest bit that differs from the current time */
+    UA_UInt64 diff = (UA_UInt64)te->nextTime ^ (UA_UInt64)t->currentTime;
+    unsigned level = highestBit(diff) / UA_TIMERWHEEL_BITS;
+    unsigned slot = (unsigned)(((UA_UInt64)te->nextTime >> (level * UA_TIMERWHEEL_BITS)) &
+                               UA_TIMERWHEEL_SLOTMASK);
+    te->level = (UA_Byte)level;
+    te->slot = (UA_Byte)slot;
+    LIST_INSERT_HEAD(&t->slots[level][slot], te, slotEntry);
+    t->occupied[level] |= (UA_UInt64)1 << slot;
+}
+
+static void
+unlinkEntry(UA_TimerWheel *t, UA_TimerWheelEntry *te) {
+    LIST_REMOVE(te, slotEntry);
+    if(te->level < UA_TIMERWHEEL_LEVELS &&
+       LIST_EMPTY(&t->slots[te->level][te->slot]))
+        t->occupied[te->level] &= ~((UA_UInt64)1 << te->slot);
+}
+
+/* Callback identifiers */
+
+static UA_StatusCode
+addHandle(UA_TimerWheel *t, UA_TimerWheelEntry *te) {
+    /* Grow the handle table */
+    if(t->freeHandle == 0) {
+        UA_UInt32 newSize = (t->handlesSize == 0) ? 64 : t->handlesSize * 2;
+        if(newSize <= t->handlesSize)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_TimerWheelHandle *handles = (UA_TimerWheelHandle*)
+            UA_realloc(t->handles, newSize * sizeof(UA_TimerWheelHandle));
+        if(!handles)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        for(UA_UInt32 i = t->handlesSize; i < newSize; i++) {
+            handles[i].entry = NULL;
+            handles[i].generation = 0;
+            handles[i].nextFree = (i + 1 < newSize) ? i + 2 : 0;
+        }
+        t->freeHandle = t->handlesSize + 1;
+        t->handles = handles;
+        t->handlesSize = newSize;
+    }
+
+    UA_UInt32 index = t->freeHandle - 1;
+    UA_TimerWheelHandle *h = &t->handles[index];
+    t->freeHandle = h->nextFree;
+    h->entry = te;
+    te->id = ((UA_UInt64)h->generation << 32) | (UA_UInt64)(index + 1);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_TimerWheelEntry *
+findEntry(UA_TimerWheel *t, UA_UInt64 callbackId) {
+    UA_UInt32 index = (UA_UInt32)(callbackId & 0xFFFFFFFF);
+    if(index == 0 || index > t->handlesSize)
+        return NULL;
+    UA_TimerWheelHandle *h = &t->handles[index - 1];
+    if(h->generation != (UA_UInt32)(callbackId >> 32))
+        return NULL;
+    return h->entry;
+}
+
+/* The entry must not be in a list */
+static void
+freeEntry(UA_TimerWheel *t, UA_TimerWheelEntry *te) {
+    UA_UInt32 index = (UA_UInt32)(te->id & 0xFFFFFFFF);
+    UA_TimerWheelHandle *h = &t->handles[index - 1];
+    h->entry = NULL;
+    h->generation++; /* Invalidate the identifier */
+    h->nextFree = t->freeHandle;
+    t->freeHandle = index;
+    UA_free(te);
+}
+
+void
+UA_TimerWheel_init(UA_TimerWheel *t) {
+    memset(t, 0, sizeof(UA_TimerWheel));
+    UA_LOCK_INIT(&t->timerMutex);
+}
+
+static UA_StatusCode
+addCallback(UA_TimerWheel *t, UA_ApplicationCallback callback, void *application,
+            void *data, UA_DateTime nextTime, UA_UInt64 interval,
+            UA_TimerPolicy timerPolicy, UA_UInt64 *callbackId) {
+    /* A callback method needs to be present */
+    if(!callback)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_TimerWheelEntry *te = (UA_TimerWheelEntry*)UA_malloc(sizeof(UA_TimerWheelEntry));
+    if(!te)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_StatusCode res = addHandle(t, te);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_free(te);
+        return res;
+    }
+
+    te->interval = interval;
+    te->callback = callback;
+    te->application = application;
+    te->data = data;
+    te->nextTime = nextTime;
+    te->timerPolicy = timerPolicy;
+    insertEntry(t, te);
+
+    if(callbackId)
+        *callbackId = te->id;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_TimerWheel_addTimedCallback(UA_TimerWheel *t, UA_ApplicationCallback callback,
+                               void *application, void *data, UA_DateTime date,
+                               UA_UInt64 *callbackId) {
+    UA_LOCK(&t->timerMutex);
+    UA_StatusCode res = addCallback(t, callback, application, data, date,
+                                    0, UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                    callbackId);
+    UA_UNLOCK(&t->timerMutex);
+    return res;
+}
+
+UA_StatusCode
+UA_TimerWheel_addRepeatedCallback(UA_TimerWheel *t, UA_ApplicationCallback callback,
+                                  void *application, void *data, UA_Double interval_ms,
+                                  UA_DateTime now, UA_DateTime *baseTime,
+                                  UA_TimerPolicy timerPolicy, UA_UInt64 *callbackId) {
+    /* The interval needs to be positive */
+    if(interval_ms <= 0.0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_UInt64 interval = (UA_UInt64)(interval_ms * UA_DATETIME_MSEC);
+    if(interval == 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Compute the first time for execution */
+    UA_DateTime nextTime;
+    if(baseTime == NULL) {
+        nextTime = now + (UA_DateTime)interval;
+    } else {
+        nextTime = UA_Timer_calculateNextTime(now, *baseTime, (UA_DateTime)interval);
+    }
+
+    UA_LOCK(&t->timerMutex);
+    UA_StatusCode res = addCallback(t, callback, application, data, nextTime,
+                                    interval, timerPolicy, callbackId);
+    UA_UNLOCK(&t->timerMutex);
+    return res;
+}
+
+UA_StatusCode
+UA_TimerWheel_changeRepeatedCallback(UA_TimerWheel *t, UA_UInt64 callbackId,
+                                     UA_Double interval_ms, UA_DateTime now,
+                                     UA_DateTime *baseTime, UA_TimerPolicy timerPolicy) {
+    /* The interval needs to be positive */
+    if(interval_ms <= 0.0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_UInt64 interval = (UA_UInt64)(interval_ms * UA_DATETIME_MSEC);
+    if(interval == 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_LOCK(&t->timerMutex);
+
+    UA_TimerWheelEntry *te = findEntry(t, callbackId);
+    if(!te) {
+        UA_UNLOCK(&t->timerMutex);
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+
+    /* Entries that are currently processed are re-inserted afterwards. Same
+     * as for the UA_Timer, only the interval and nextTime are adjusted. */
+    UA_Boolean due = (te->level == UA_TIMERWHEEL_DUE);
+    if(!due)
+        unlinkEntry(t, te);
+
+    if(baseTime == NULL) {
+        te->nextTime = now + (UA_DateTime)interval;
+    } else {
+        te->nextTime = UA_Timer_calculateNextTime(now, *baseTime, (UA_DateTime)interval);
+    }
+    te->interval = interval;
+    te->timerPolicy = timerPolicy;
+
+    if(!due)
+        insertEntry(t, te);
+
+    UA_UNLOCK(&t->timerMutex);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_TimerWheel_removeCallback(UA_TimerWheel *t, UA_UInt64 callbackId) {
+    UA_LOCK(&t->timerMutex);
+    UA_TimerWheelEntry *te = findEntry(t, callbackId);
+    if(UA_LIKELY(te != NULL)) {
+        if(te->level == UA_TIMERWHEEL_DUE) {
+            /* Currently processed. Only mark the entry to be deleted. */
+            te->callback = NULL;
+        } else {
+            unlinkEntry(t, te);
+            freeEntry(t, te);
+        }
+    }
+    UA_UNLOCK(&t->timerMutex);
+}
+
+/* Take the entries out of a list. Move them to the list of due entries or
+ * re-insert them into the wheel (at a lower level). */
+static void
+sortOutList(UA_TimerWheel *t, UA_TimerWheelSlot *list, UA_TimerWheelSlot *due,
+            UA_DateTime now) {
+    UA_TimerWheelSlot tmp;
+    takeList(list, &tmp);
+    UA_TimerWheelEntry *te;
+    while((te = LIST_FIRST(&tmp))) {
+        LIST_REMOVE(te, slotEntry);
+        if(te->nextTime <= now) {
+            te->level = UA_TIMERWHEEL_DUE;
+            LIST_INSERT_HEAD(due, te, slotEntry);
+        } else {
+            insertEntry(t, te);
+        }
+    }
+}
+
+/* Advance the current time of the wheel and collect the due entries */
+static void
+advance(UA_TimerWheel *t, UA_DateTime now, UA_TimerWheelSlot *due) {
+    /* Compute the slots reached by the new time for every level. If the digit
+     * of a level does not change, then neither do the digits of the higher
+     * levels. */
+    UA_UInt64 reached[UA_TIMERWHEEL_LEVELS];
+    unsigned levels = 0;
+    if(now > t->currentTime) {
+        for(; levels < UA_TIMERWHEEL_LEVELS; levels++) {
+            unsigned shift = levels * UA_TIMERWHEEL_BITS;
+            UA_UInt64 from = (UA_UInt64)t->currentTime >> shift;
+            UA_UInt64 to = (UA_UInt64)now >> shift;
+            if(from == to)
+                break;
+            UA_UInt64 elapsed = to - from;
+            UA_UInt64 mask = UA_UINT64_MAX;
+            if(elapsed < UA_TIMERWHEEL_SLOTS)
+                mask = rotateLeft(((UA_UInt64)1 << elapsed) - 1,
+                                  (unsigned)((from + 1) & UA_TIMERWHEEL_SLOTMASK));
+            reached[levels] = mask & t->occupied[levels];
+            t->occupied[levels] &= ~reached[levels];
+        }
+        t->currentTime = now;
+    }
+
+    /* Entries that were added with a nextTime in the past */
+    sortOutList(t, &t->expired, due, now);
+
+    /* Re-inserted entries only go to lower levels. So starting from the lowest
+     * level, every entry is moved only once. */
+    for(unsigned level = 0; level < levels; level++) {
+        UA_UInt64 mask = reached[level];
+        while(mask) {
+            unsigned slot = lowestBit(mask);
+            mask &= mask - 1;
+            sortOutList(t, &t->slots[level][slot], due, now);
+        }
+    }
+}
+
+static UA_DateTime
+nextTime(UA_TimerWheel *t) {
+    UA_DateTime next = UA_INT64_MAX;
+    UA_TimerWheelEntry *te;
+    LIST_FOREACH(te, &t->expired, slotEntry) {
+        if(te->nextTime < next)
+            next = te->nextTime;
+    }
+    if(next != UA_INT64_MAX)
+        return next;
+
+    /* All entries in a level are earlier than those in the higher levels. The
+     * first occupied slot after the current time has the earliest entries. */
+    for(unsigned level = 0; level < UA_TIMERWHEEL_LEVELS; level++) {
+        if(!t->occupied[level])
+            continue;
+        unsigned shift = level * UA_TIMERWHEEL_BITS;
+        unsigned start = (unsigned)((((UA_UInt64)t->currentTime >> shift) + 1) &
+                                    UA_TIMERWHEEL_SLOTMASK);
+        UA_UInt64 rotated = rotateLeft(t->occupied[level], UA_TIMERWHEEL_SLOTS - start);
+        unsigned slot = (start + lowestBit(rotated)) & (unsigned)UA_TIMERWHEEL_SLOTMASK;
+        LIST_FOREACH(te, &t->slots[level][slot], slotEntry) {
+            if(te->nextTime < next)
+                next = te->nextTime;
+        }
+        break;
+    }
+    return next;
+}
+
+UA_DateTime
+UA_TimerWheel_process(UA_TimerWheel *t, UA_DateTime now) {
+    UA_LOCK(&t->timerMutex);
+
+    /* Not reentrant. Don't call _process from within _process. */
+    if(!t->processing) {
+        t->processing = true;
+
+        UA_TimerWheelSlot due;
+        LIST_INIT(&due);
+        advance(t, now, &due);
+
+        UA_TimerWheelEntry *te;
+        while((te = LIST_FIRST(&due))) {
+            /* Execute the callback. Entries in the due list are only marked
+             * for deletion during the callback. */
+            if(te->callback) {
+                UA_UNLOCK(&t->timerMutex);
+                te->callback(te->application, te->data);
+                UA_LOCK(&t->timerMutex);
+            }
+            LIST_REMOVE(te, slotEntry);
+
+            /* Remove and free the entry if marked for deletion or a one-time
+             * timed callback */
+            if(!te->callback || te->interval == 0) {
+                freeEntry(t, te);
+                continue;
+            }
+
+            /* Set the time for the next regular execution */
+            te->nextTime += (UA_DateTime)te->interval;
+
+            /* Handle the case where the "window" was missed. Identical to the
+             * UA_Timer. */
+            if(te->nextTime < now) {
+                if(te->timerPolicy == UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME)
+                    te->nextTime = UA_Timer_calculateNextTime(now, te->nextTime,
+                                                              (UA_DateTime)te->interval);
+                else
+                    te->nextTime = now + (UA_DateTime)te->interval;
+            }
+
+            insertEntry(t, te);
+        }
+
+        t->processing = false;
+    }
+
+    UA_DateTime next = nextTime(t);
+    UA_UNLOCK(&t->timerMutex);
+    return next;
+}
+
+UA_DateTime
+UA_TimerWheel_nextRepeatedTime(UA_TimerWheel *t) {
+    UA_LOCK(&t->timerMutex);
+    UA_DateTime next = nextTime(t);
+    UA_UNLOCK(&t->timerMutex);
+    return next;
+}
+
+void
+UA_TimerWheel_clear(UA_TimerWheel *t) {
+    UA_LOCK(&t->timerMutex);
+
+    for(UA_UInt32 i = 0; i < t->handlesSize; i++) {
+        if(t->handles[i].entry)
+            UA_free(t->handles[i].entry);
+    }
+    UA_free(t->handles);
+    t->handles = NULL;
+    t->handlesSize = 0;
+    t->freeHandle = 0;
+    for(unsigned level = 0; level < UA_TIMERWHEEL_LEVELS; level++) {
+        for(unsigned slot = 0; slot < UA_TIMERWHEEL_SLOTS; slot++)
+            LIST_INIT(&t->slots[level][slot]);
+        t->occupied[level] = 0;
+    }
+    LIST_INIT(&t->expired);
+    t->currentTime = 0;
+
+    UA_UNLOCK(&t->timerMutex);
+    UA_LOCK_DESTROY(&t->timerMutex);
+}
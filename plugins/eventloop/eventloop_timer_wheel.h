@@ -0,0 +1,108 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UA_TIMER_WHEEL_H_
+#define UA_TIMER_WHEEL_H_
+
+#include <open62541/types.h>
+#include <open62541/plugin/eventloop.h>
+#include "eventloop_timer.h"
+#include "../../deps/open62541_queue.h"
+
+_UA_BEGIN_DECLS
+
+/* Hierarchical timing wheel with the same interface as UA_Timer. Adding,
+ * removing and executing a callback is O(1). Whereas the UA_Timer uses a
+ * time-sorted tree with O(log n) for every execution of a repeated callback.
+ *
+ * The wheel has levels of 64 slots. A slot in level n covers 64^n ticks of the
+ * UA_DateTime (100ns). An entry is placed in the level of the highest digit in
+ * which its nextTime differs from the current time of the wheel. When the
+ * current time reaches the slot, the entries are either executed or moved to a
+ * lower level. So an entry moves at most once per level until execution.
+ *
+ * The same locking rules as for the UA_Timer apply. Callbacks that are due in
+ * the same call to _process are not necessarily executed in the order of
+ * their nextTime. */
+
+#define UA_TIMERWHEEL_BITS 6
+#define UA_TIMERWHEEL_SLOTS (1 << UA_TIMERWHEEL_BITS)
+#define UA_TIMERWHEEL_LEVELS 11 /* 11 * 6 bits cover the positive UA_DateTime */
+
+typedef struct UA_TimerWheelEntry {
+    LIST_ENTRY(UA_TimerWheelEntry) slotEntry;
+    UA_TimerPolicy timerPolicy;
+    UA_DateTime nextTime;
+    UA_UInt64 interval;              /* Zero for a timed callback */
+    UA_ApplicationCallback callback; /* NULL if marked for deletion */
+    void *application;
+    void *data;
+    UA_UInt64 id;
+    UA_Byte level;                   /* Values beyond the levels mark the
+                                      * expired list and the due list */
+    UA_Byte slot;
+} UA_TimerWheelEntry;
+
+typedef LIST_HEAD(UA_TimerWheelSlot, UA_TimerWheelEntry) UA_TimerWheelSlot;
+
+/* Lookup from the callback identifier to the entry. The identifier is made up
+ * from the index in the handle table and a generation counter for the
+ * index. */
+typedef struct {
+    UA_TimerWheelEntry *entry; /* NULL if the handle is unused */
+    UA_UInt32 generation;
+    UA_UInt32 nextFree;        /* Index + 1 of the next unused handle */
+} UA_TimerWheelHandle;
+
+typedef struct {
+    UA_TimerWheelSlot slots[UA_TIMERWHEEL_LEVELS][UA_TIMERWHEEL_SLOTS];
+    UA_UInt64 occupied[UA_TIMERWHEEL_LEVELS]; /* Bitmap of non-empty slots */
+    UA_TimerWheelSlot expired; /* Entries that were already due when added */
+    UA_DateTime currentTime;   /* All entries in the slots are later */
+
+    UA_TimerWheelHandle *handles;
+    UA_UInt32 handlesSize;
+    UA_UInt32 freeHandle;      /* Index + 1 of the first unused handle */
+
+    UA_Boolean processing;
+#if UA_MULTITHREADING >= 100
+    UA_Lock timerMutex;
+#endif
+} UA_TimerWheel;
+
+void
+UA_TimerWheel_init(UA_TimerWheel *t);
+
+UA_DateTime
+UA_TimerWheel_nextRepeatedTime(UA_TimerWheel *t);
+
+UA_StatusCode
+UA_TimerWheel_addTimedCallback(UA_TimerWheel *t, UA_ApplicationCallback callback,
+                               void *application, void *data, UA_DateTime date,
+                               UA_UInt64 *callbackId);
+
+UA_StatusCode
+UA_TimerWheel_addRepeatedCallback(UA_TimerWheel *t, UA_ApplicationCallback callback,
+                                  void *application, void *data, UA_Double interval_ms,
+                                  UA_DateTime now, UA_DateTime *baseTime,
+                                  UA_TimerPolicy timerPolicy, UA_UInt64 *callbackId);
+
+UA_StatusCode
+UA_TimerWheel_changeRepeatedCallback(UA_TimerWheel *t, UA_UInt64 callbackId,
+                                     UA_Double interval_ms, UA_DateTime now,
+                                     UA_DateTime *baseTime, UA_TimerPolicy timerPolicy);
+
+void
+UA_TimerWheel_removeCallback(UA_TimerWheel *t, UA_UInt64 callbackId);
+
+UA_DateTime
+UA_TimerWheel_process(UA_TimerWheel *t, UA_DateTime now);
+
+void
+UA_TimerWheel_clear(UA_TimerWheel *t);
+
+_UA_END_DECLS
+
+#endif /* UA_TIMER_WHEEL_H_ */
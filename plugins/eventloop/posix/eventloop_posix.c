@@ -20,7 +20,7 @@
 static UA_DateTime
 UA_EventLoopPOSIX_nextCyclicTime(UA_EventLoop *public_el) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
-    return UA_Timer_nextRepeatedTime(&el->timer);
+    return UA_EventLoopTimer_nextRepeatedTime(&el->timer);
 }
 
 static UA_StatusCode
@@ -30,8 +30,8 @@ UA_EventLoopPOSIX_addTimedCallback(UA_EventLoop *public_el,
                                    UA_DateTime date,
                                    UA_UInt64 *callbackId) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
-    return UA_Timer_addTimedCallback(&el->timer, callback, application,
-                                     data, date, callbackId);
+    return UA_EventLoopTimer_addTimedCallback(&el->timer, callback, application,
+                                              data, date, callbackId);
 }
 
 static UA_StatusCode
@@ -43,10 +43,10 @@ UA_EventLoopPOSIX_addCyclicCallback(UA_EventLoop *public_el,
                                     UA_TimerPolicy timerPolicy,
                                     UA_UInt64 *callbackId) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
-    return UA_Timer_addRepeatedCallback(&el->timer, cb, application,
-                                        data, interval_ms,
-                                        public_el->dateTime_nowMonotonic(public_el),
-                                        baseTime, timerPolicy, callbackId);
+    return UA_EventLoopTimer_addRepeatedCallback(&el->timer, cb, application,
+                                                 data, interval_ms,
+                                                 public_el->dateTime_nowMonotonic(public_el),
+                                                 baseTime, timerPolicy, callbackId);
 }
 
 static UA_StatusCode
@@ -56,18 +56,105 @@ UA_EventLoopPOSIX_modifyCyclicCallback(UA_EventLoop *public_el,
                                        UA_DateTime *baseTime,
                                        UA_TimerPolicy timerPolicy) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
-    return UA_Timer_changeRepeatedCallback(&el->timer, callbackId, interval_ms,
-                                           public_el->dateTime_nowMonotonic(public_el),
-                                           baseTime, timerPolicy);
+    return UA_EventLoopTimer_changeRepeatedCallback(&el->timer, callbackId, interval_ms,
+                                                    public_el->dateTime_nowMonotonic(public_el),
+                                                    baseTime, timerPolicy);
 }
 
 static void
 UA_EventLoopPOSIX_removeCyclicCallback(UA_EventLoop *public_el,
                                        UA_UInt64 callbackId) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
-    UA_Timer_removeCallback(&el->timer, callbackId);
+    UA_EventLoopTimer_removeCallback(&el->timer, callbackId);
+}
+
+/**********/
+/* Wakeup */
+/**********/
+
+#ifdef UA_HAVE_WAKEUP
+
+static void
+signalWakeup(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+    if(!el->polling || el->wakeupPending)
+        return;
+    el->wakeupPending = true;
+    UA_UInt64 one = 1;
+    ssize_t res = write(el->wakeupWriteFD, &one, sizeof(one));
+    (void)res; /* Fails only if the wakeup is already pending */
 }
 
+static void
+processWakeup(UA_EventSource *es, UA_RegisteredFD *rfd, short event) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)
+        ((uintptr_t)rfd - offsetof(UA_EventLoopPOSIX, wakeupFD));
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    /* Drain the FD. The delayed callbacks are processed in the next
+     * iteration. */
+    UA_UInt64 buf[8];
+    while(read(rfd->fd, buf, sizeof(buf)) > 0) {}
+    el->wakeupPending = false;
+}
+
+static UA_StatusCode
+openWakeup(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+#ifdef UA_HAVE_EVENTFD
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(fd == -1) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not create the wakeup eventfd (%s)",
+                          errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    el->wakeupFD.fd = fd;
+    el->wakeupWriteFD = fd;
+#else
+    UA_FD pipefd[2];
+    if(pipe(pipefd) != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not open the wakeup pipe (%s)",
+                          errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    UA_EventLoopPOSIX_setNonBlocking(pipefd[0]);
+    UA_EventLoopPOSIX_setNonBlocking(pipefd[1]);
+    el->wakeupFD.fd = pipefd[0];
+    el->wakeupWriteFD = pipefd[1];
+#endif
+
+    el->wakeupFD.es = NULL;
+    el->wakeupFD.listenEvents = UA_FDEVENT_IN;
+    el->wakeupFD.eventSourceCB = processWakeup;
+    el->wakeupPending = false;
+    UA_StatusCode res = UA_EventLoopPOSIX_registerFD(el, &el->wakeupFD);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_close(el->wakeupFD.fd);
+        if(el->wakeupWriteFD != el->wakeupFD.fd)
+            UA_close(el->wakeupWriteFD);
+        el->wakeupFD.fd = UA_INVALID_FD;
+    }
+    return res;
+}
+
+static void
+closeWakeup(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+    if(el->wakeupFD.fd == UA_INVALID_FD)
+        return;
+    UA_EventLoopPOSIX_deregisterFD(el, &el->wakeupFD);
+    UA_close(el->wakeupFD.fd);
+    if(el->wakeupWriteFD != el->wakeupFD.fd)
+        UA_close(el->wakeupWriteFD);
+    el->wakeupFD.fd = UA_INVALID_FD;
+}
+
+#endif /* UA_HAVE_WAKEUP */
+
 static void
 UA_EventLoopPOSIX_addDelayedCallback(UA_EventLoop *public_el,
                                      UA_DelayedCallback *dc) {
@@ -75,6 +162,10 @@ UA_EventLoopPOSIX_addDelayedCallback(UA_EventLoop *public_el,
     UA_LOCK(&el->elMutex);
     dc->next = el->delayedCallbacks;
     el->delayedCallbacks = dc;
+#ifdef UA_HAVE_WAKEUP
+    /* Added from a different thread while the EventLoop is polling */
+    signalWakeup(el);
+#endif
     UA_UNLOCK(&el->elMutex);
 }
 
@@ -178,7 +269,19 @@ UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
     }
 #endif
 
+#ifdef UA_HAVE_WAKEUP
+    UA_StatusCode res = openWakeup(el);
+    if(res != UA_STATUSCODE_GOOD) {
+#ifdef UA_HAVE_EPOLL
+        close(el->epollfd);
+#endif
+        UA_UNLOCK(&el->elMutex);
+        return res;
+    }
+#else
     UA_StatusCode res = UA_STATUSCODE_GOOD;
+#endif
+
     UA_EventSource *es = el->eventLoop.eventSources;
     while(es) {
         UA_UNLOCK(&el->elMutex);
@@ -214,6 +317,10 @@ checkClosed(UA_EventLoopPOSIX *el) {
     *(UA_EventLoopState*)(uintptr_t)&el->eventLoop.state =
         UA_EVENTLOOPSTATE_STOPPED;
 
+#ifdef UA_HAVE_WAKEUP
+    closeWakeup(el);
+#endif
+
     /* Close the epoll/IOCP socket once all EventSources have shut down */
 #ifdef UA_HAVE_EPOLL
     close(el->epollfd);
@@ -289,7 +396,7 @@ UA_EventLoopPOSIX_run(UA_EventLoopPOSIX *el, UA_UInt32 timeout) {
         el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
 
     UA_UNLOCK(&el->elMutex);
-    UA_DateTime dateNext = UA_Timer_process(&el->timer, dateBefore);
+    UA_DateTime dateNext = UA_EventLoopTimer_process(&el->timer, dateBefore);
     UA_LOCK(&el->elMutex);
 
     /* Process delayed callbacks here:
@@ -461,7 +568,7 @@ UA_EventLoopPOSIX_free(UA_EventLoopPOSIX *el) {
     }
 
     /* Remove the repeated timed callbacks */
-    UA_Timer_clear(&el->timer);
+    UA_EventLoopTimer_clear(&el->timer);
 
     /* Process remaining delayed callbacks */
     processDelayed(el);
@@ -488,7 +595,11 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger) {
         return NULL;
 
     UA_LOCK_INIT(&el->elMutex);
-    UA_Timer_init(&el->timer);
+    UA_EventLoopTimer_init(&el->timer);
+#ifdef UA_HAVE_WAKEUP
+    el->wakeupFD.fd = UA_INVALID_FD;
+    el->wakeupWriteFD = UA_INVALID_FD;
+#endif
 
 #ifdef _WIN32
     /* Start the WSA networking subsystem on Windows */
@@ -540,6 +651,8 @@ UA_EventLoopPOSIX_allocNetworkBuffer(UA_ConnectionManager *cm,
         return UA_ByteString_allocBuffer(buf, bufSize);
     if(pcm->txBuffer.length < bufSize)
         return UA_STATUSCODE_BADOUTOFMEMORY;
+    if(UA_atomic_cmpxchg(&pcm->txBufferTaken, NULL, (void*)0x1) != NULL)
+        return UA_ByteString_allocBuffer(buf, bufSize); /* In use */
     *buf = pcm->txBuffer;
     buf->length = bufSize;
     return UA_STATUSCODE_GOOD;
@@ -550,10 +663,12 @@ UA_EventLoopPOSIX_freeNetworkBuffer(UA_ConnectionManager *cm,
                                     uintptr_t connectionId,
                                     UA_ByteString *buf) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
-    if(pcm->txBuffer.data == buf->data)
+    if(pcm->txBuffer.data && pcm->txBuffer.data == buf->data) {
         UA_ByteString_init(buf);
-    else
+        UA_atomic_cmpxchg(&pcm->txBufferTaken, (void*)0x1, NULL);
+    } else {
         UA_ByteString_clear(buf);
+    }
 }
 
 UA_StatusCode
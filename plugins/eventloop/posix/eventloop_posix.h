@@ -15,6 +15,7 @@
 #include <open62541/plugin/eventloop.h>
 
 #include "../eventloop_timer.h"
+#include "../eventloop_timer_wheel.h"
 #include "../eventloop_common.h"
 #include "../../deps/mp_printf.h"
 #include "../../deps/open62541_queue.h"
@@ -163,6 +164,16 @@ typedef SSIZE_T ssize_t;
 # include <sys/epoll.h>
 #endif
 
+/* Other threads can wake up the EventLoop from polling. On Linux with an
+ * eventfd, otherwise with the self-pipe trick. */
+#if UA_MULTITHREADING >= 100
+# define UA_HAVE_WAKEUP
+# if defined(__linux__)
+#  define UA_HAVE_EVENTFD
+#  include <sys/eventfd.h>
+# endif
+#endif
+
 #endif
 
 /***********************/
@@ -223,20 +234,49 @@ ZIP_FUNCTIONS(UA_FDTree, UA_RegisteredFD, zipPointers, UA_FD, fd, cmpFD)
 typedef struct {
     UA_ConnectionManager cm;
 
-    /* Statically allocated buffers */
+    /* Statically allocated buffers. The txBuffer is taken with an atomic
+     * operation. Buffers can be allocated from a thread that does not run the
+     * EventLoop (e.g. the server sends on the connections of its reactor
+     * EventLoops). While the txBuffer is taken, buffers are allocated on the
+     * heap. */
     UA_ByteString rxBuffer;
     UA_ByteString txBuffer;
+    void * volatile txBufferTaken;
 
     /* Sorted tree of the FDs */
     size_t fdsSize;
     UA_FDTree fds;
 } UA_POSIXConnectionManager;
 
+/* The timer implementation is selected at build time. Both have the same
+ * interface. */
+#ifdef UA_ENABLE_TIMER_WHEEL
+typedef UA_TimerWheel UA_EventLoopTimer;
+#define UA_EventLoopTimer_init UA_TimerWheel_init
+#define UA_EventLoopTimer_nextRepeatedTime UA_TimerWheel_nextRepeatedTime
+#define UA_EventLoopTimer_addTimedCallback UA_TimerWheel_addTimedCallback
+#define UA_EventLoopTimer_addRepeatedCallback UA_TimerWheel_addRepeatedCallback
+#define UA_EventLoopTimer_changeRepeatedCallback UA_TimerWheel_changeRepeatedCallback
+#define UA_EventLoopTimer_removeCallback UA_TimerWheel_removeCallback
+#define UA_EventLoopTimer_process UA_TimerWheel_process
+#define UA_EventLoopTimer_clear UA_TimerWheel_clear
+#else
+typedef UA_Timer UA_EventLoopTimer;
+#define UA_EventLoopTimer_init UA_Timer_init
+#define UA_EventLoopTimer_nextRepeatedTime UA_Timer_nextRepeatedTime
+#define UA_EventLoopTimer_addTimedCallback UA_Timer_addTimedCallback
+#define UA_EventLoopTimer_addRepeatedCallback UA_Timer_addRepeatedCallback
+#define UA_EventLoopTimer_changeRepeatedCallback UA_Timer_changeRepeatedCallback
+#define UA_EventLoopTimer_removeCallback UA_Timer_removeCallback
+#define UA_EventLoopTimer_process UA_Timer_process
+#define UA_EventLoopTimer_clear UA_Timer_clear
+#endif
+
 typedef struct {
     UA_EventLoop eventLoop;
 
     /* Timer */
-    UA_Timer timer;
+    UA_EventLoopTimer timer;
 
     /* Linked List of Delayed Callbacks */
     UA_DelayedCallback *delayedCallbacks;
@@ -258,6 +298,15 @@ typedef struct {
     size_t fdsSize;
 #endif
 
+#ifdef UA_HAVE_WAKEUP
+    /* Delayed callbacks added from another thread wake up the EventLoop while
+     * it is polling. Then they are processed right away. */
+    UA_RegisteredFD wakeupFD; /* Read end */
+    UA_FD wakeupWriteFD;      /* Same as the read end for an eventfd */
+    UA_Boolean polling;       /* Waiting in pollFDs */
+    UA_Boolean wakeupPending; /* Written to the wakeupFD, not yet read */
+#endif
+
 #if UA_MULTITHREADING >= 100
     UA_Lock elMutex;
 #endif
@@ -71,6 +71,9 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
     /* Poll the registered sockets */
     struct epoll_event epoll_events[64];
     int epollfd = el->epollfd;
+#ifdef UA_HAVE_WAKEUP
+    el->polling = true;
+#endif
     UA_UNLOCK(&el->elMutex);
     int events = epoll_wait(epollfd, epoll_events, 64,
                             (int)(listenTimeout / UA_DATETIME_MSEC));
@@ -84,6 +87,9 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
      * int events = epoll_pwait2(epollfd, epoll_events, 64,
      *                        precisionTimeout, NULL); */
     UA_LOCK(&el->elMutex);
+#ifdef UA_HAVE_WAKEUP
+    el->polling = false;
+#endif
 
     /* Handle error conditions */
     if(events == -1) {
@@ -16,6 +16,30 @@
 #include <net/ethernet.h> /* ETH_P_*/
 #include <linux/if_packet.h>
 #include <linux/net_tstamp.h> /* txtime */
+#include <sys/mman.h> /* PACKET_MMAP rings */
+
+/* AF_XDP sockets. The XDP program is loaded with the bpf system call. Attaching
+ * it with a BPF link requires Linux 5.9 or later. */
+#if defined(__has_include)
+# if __has_include(<linux/if_xdp.h>)
+#  include <linux/bpf.h>
+#  include <linux/if_link.h>
+#  include <linux/if_xdp.h>
+#  include <sys/syscall.h>
+#  if defined(XDP_FLAGS_REPLACE) && defined(__NR_bpf)
+#   define UA_ETH_XDP
+#  endif
+# endif
+#endif
+
+#ifdef UA_ETH_XDP
+# ifndef AF_XDP
+#  define AF_XDP 44
+# endif
+# ifndef SOL_XDP
+#  define SOL_XDP 283
+# endif
+#endif
 
 /* Configuration parameters */
 
@@ -26,7 +50,7 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
-#define ETH_PARAMETERSSIZE 15
+#define ETH_PARAMETERSSIZE 22
 #define ETH_PARAMINDEX_ADDR 0
 #define ETH_PARAMINDEX_LISTEN 1
 #define ETH_PARAMINDEX_IFACE 2
@@ -42,6 +66,13 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
 #define ETH_PARAMINDEX_TXTIME_PICO 12
 #define ETH_PARAMINDEX_TXTIME_DROP 13
 #define ETH_PARAMINDEX_VALIDATE 14
+#define ETH_PARAMINDEX_MMAP 15
+#define ETH_PARAMINDEX_RINGSIZE 16
+#define ETH_PARAMINDEX_RINGTIMEOUT 17
+#define ETH_PARAMINDEX_XDP 18
+#define ETH_PARAMINDEX_XDP_QUEUE 19
+#define ETH_PARAMINDEX_XDP_FLAGS 20
+#define ETH_PARAMINDEX_XDP_BINDFLAGS 21
 
 static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, false},
@@ -59,12 +90,45 @@ static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("txtime-pico")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
     {{0, UA_STRING_STATIC("txtime-drop-late")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
     {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("packet-mmap")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("ring-size")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("ring-timeout")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("xdp")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("xdp-queue")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("xdp-flags")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("xdp-bind-flags")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     /* Duplicated address parameter with a scalar value required. For the send-socket case. */
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], true, true, false},
 };
 
 #define UA_ETH_MAXHEADERLENGTH (2*ETHER_ADDR_LEN)+4+2+2
 
+/* Geometry of the PACKET_MMAP rings. The block size is a multiple of all
+ * common page sizes. TX frames hold a standard Ethernet frame (with VLAN tag)
+ * behind the TPACKET_V2 frame header. */
+#define ETH_RING_BLOCKSIZE (1 << 16)
+#define ETH_RING_FRAMESIZE (1 << 11)
+#define ETH_RING_DEFAULTSIZE (1 << 20)
+#define ETH_RING_DEFAULTTIMEOUT 1 /* ms */
+#define ETH_TXRING_DATAOFFSET (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+
+/* The UMEM of an AF_XDP socket is divided into frames of this size. Every
+ * frame is always either in the fill ring, with the kernel or in the rx ring.
+ * So both rings are as large as the number of frames. */
+#define ETH_XDP_FRAMESIZE (1 << 11)
+#define ETH_XDP_MINFRAMES 64
+
+#ifdef UA_ETH_XDP
+typedef struct {
+    UA_UInt32 *producer;
+    UA_UInt32 *consumer;
+    void *descs;
+    UA_UInt32 size; /* Power of two */
+    void *map;
+    size_t mapSize;
+} ETH_XDPRing;
+#endif
+
 typedef struct {
     UA_RegisteredFD rfd;
 
@@ -84,6 +148,32 @@ typedef struct {
     unsigned char lengthOffset; /* No length field if zero */
 
     UA_Boolean txtimeEnabled;
+
+    /* Optional PACKET_MMAP ring shared with the kernel. Listen connections
+     * use a TPACKET_V3 RX ring of blocks, send connections a TPACKET_V2 TX
+     * ring of frames. */
+    UA_Byte *ring;
+    size_t ringSize;
+    unsigned int ringSlotSize; /* Size of a block (RX) or a frame (TX) */
+    unsigned int ringSlots;
+    unsigned int ringPos;      /* Next block (RX) or frame (TX) */
+    unsigned int ringTimeout;  /* Block retire timeout (RX) or the maximum
+                                * wait for a free frame (TX) in ms */
+
+#ifdef UA_ETH_XDP
+    /* Listen connections with an AF_XDP socket. The XDP program attached to
+     * the interface redirects the matching frames into the UMEM. */
+    UA_Boolean xdp;
+    int xdpMapFd;
+    int xdpProgFd;
+    int xdpLinkFd;
+    int xdpMemberFd; /* AF_PACKET socket holding the multicast membership */
+    UA_Byte *umem;
+    size_t umemSize;
+    ETH_XDPRing fill;
+    ETH_XDPRing comp;
+    ETH_XDPRing rx;
+#endif
 } ETH_FD;
 
 /* The format of a Ethernet address is six groups of hexadecimal digits,
@@ -206,6 +296,30 @@ setETHHeader(unsigned char *buf,
     return (unsigned char)pos;
 }
 
+/* Status words and ring indices are shared with the kernel */
+static UA_UInt32
+ETH_ringLoad(volatile UA_UInt32 *status) {
+    UA_UInt32 s = *status;
+    __sync_synchronize();
+    return s;
+}
+
+static void
+ETH_ringStore(volatile UA_UInt32 *status, UA_UInt32 s) {
+    __sync_synchronize();
+    *status = s;
+}
+
+/* Returns the TX frame at the current ring position if it can be written */
+static struct tpacket2_hdr *
+ETH_txFrame(ETH_FD *erfd) {
+    struct tpacket2_hdr *hdr = (struct tpacket2_hdr*)
+        &erfd->ring[(size_t)erfd->ringPos * erfd->ringSlotSize];
+    if(ETH_ringLoad(&hdr->tp_status) != TP_STATUS_AVAILABLE)
+        return NULL;
+    return hdr;
+}
+
 static UA_StatusCode
 ETH_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
                        UA_ByteString *buf, size_t bufSize) {
@@ -243,6 +357,44 @@ ETH_freeNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
 }
 
+#ifdef UA_ETH_XDP
+static void
+ETH_unmapXDPRing(ETH_XDPRing *ring) {
+    if(ring->map)
+        munmap(ring->map, ring->mapSize);
+    memset(ring, 0, sizeof(ETH_XDPRing));
+}
+#endif
+
+/* Unmap the memory shared with the kernel and detach the XDP program. Called
+ * after the socket is closed. */
+static void
+ETH_releaseRings(ETH_FD *conn) {
+    if(conn->ring) {
+        munmap(conn->ring, conn->ringSize);
+        conn->ring = NULL;
+    }
+#ifdef UA_ETH_XDP
+    if(!conn->xdp)
+        return;
+    if(conn->xdpLinkFd >= 0)
+        UA_close(conn->xdpLinkFd);
+    if(conn->xdpProgFd >= 0)
+        UA_close(conn->xdpProgFd);
+    if(conn->xdpMapFd >= 0)
+        UA_close(conn->xdpMapFd);
+    if(conn->xdpMemberFd >= 0)
+        UA_close(conn->xdpMemberFd);
+    ETH_unmapXDPRing(&conn->fill);
+    ETH_unmapXDPRing(&conn->comp);
+    ETH_unmapXDPRing(&conn->rx);
+    if(conn->umem)
+        munmap(conn->umem, conn->umemSize);
+    conn->umem = NULL;
+    conn->xdp = false;
+#endif
+}
+
 /* Test if the ConnectionManager can be stopped */
 static void
 ETH_checkStopped(UA_POSIXConnectionManager *pcm) {
@@ -296,6 +448,9 @@ ETH_close(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
                           (unsigned)conn->rfd.fd, errno_str));
     }
 
+    /* Unmap the ring */
+    ETH_releaseRings(conn);
+
     /* Don't call free here. This might be done automatically via the delayed
      * callback that calls ETH_close. */
     /* UA_free(rfd); */
@@ -318,6 +473,134 @@ ETH_delayedClose(void *application, void *context) {
     UA_free(conn);
 }
 
+/* Forward a received frame to the application. The VLAN tag is taken from the
+ * ring metadata if the kernel has removed it from the frame. */
+static void
+ETH_deliver(UA_POSIXConnectionManager *pcm, ETH_FD *conn,
+            UA_ByteString frame, const UA_UInt16 *vlanTci) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+    (void)el;
+
+    /* Parse the Ethernet header */
+    unsigned char destAddr[ETHER_ADDR_LEN];
+    unsigned char sourceAddr[ETHER_ADDR_LEN];
+    UA_UInt16 etherType = 0;
+    UA_UInt16 vid = 0;
+    UA_Byte pcp = 0;
+    UA_Boolean dei = 0;
+    size_t headerSize = parseETHHeader(&frame, destAddr, sourceAddr,
+                                       &etherType, &vid, &pcp, &dei);
+    if(headerSize == 0)
+        return;
+    if(vid == 0 && vlanTci) {
+        vid = *vlanTci & 0x0fff;
+        pcp = (UA_Byte)(*vlanTci >> 13);
+        dei = ((*vlanTci >> 12) & 0x01) != 0;
+    }
+
+    /* Set up the parameter arguments passed to the application */
+    unsigned char destAddrBytes[18];
+    unsigned char sourceAddrBytes[18];
+    setAddrString(destAddrBytes, destAddr);
+    setAddrString(sourceAddrBytes, sourceAddr);
+    UA_String destAddrStr = {17, destAddrBytes};
+    UA_String sourceAddrStr = {17, sourceAddrBytes};
+
+    size_t paramsSize = 2;
+    UA_KeyValuePair params[6];
+    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
+    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
+    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+
+    if(etherType > 0) {
+        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+        UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+        paramsSize++;
+    }
+
+    if(vid > 0) {
+        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
+        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
+        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
+        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
+        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
+        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        paramsSize += 3;
+    }
+
+    /* Callback to the application layer with the Ethernet header hidden */
+    UA_KeyValueMap map = {paramsSize, params};
+    frame.data += headerSize;
+    frame.length -= headerSize;
+    UA_UNLOCK(&el->elMutex);
+    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd, conn->application,
+                        &conn->context, UA_CONNECTIONSTATE_ESTABLISHED, &map, frame);
+    UA_LOCK(&el->elMutex);
+}
+
+/* Deliver the frames of all blocks the kernel has retired to userspace. The
+ * frames are passed to the application directly from the ring memory. The
+ * number of blocks per call is bounded so that one busy socket does not starve
+ * the other EventSources. */
+static void
+ETH_receiveRing(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
+    for(unsigned int i = 0; i < conn->ringSlots; i++) {
+        struct tpacket_block_desc *bd = (struct tpacket_block_desc*)
+            &conn->ring[(size_t)conn->ringPos * conn->ringSlotSize];
+        if(!(ETH_ringLoad(&bd->hdr.bh1.block_status) & TP_STATUS_USER))
+            return;
+
+        struct tpacket3_hdr *ph = (struct tpacket3_hdr*)
+            ((UA_Byte*)bd + bd->hdr.bh1.offset_to_first_pkt);
+        for(UA_UInt32 j = 0; j < bd->hdr.bh1.num_pkts; j++) {
+            UA_ByteString frame = {ph->tp_snaplen, (UA_Byte*)ph + ph->tp_mac};
+            UA_UInt16 vlanTci = (UA_UInt16)ph->hv1.tp_vlan_tci;
+            ETH_deliver(pcm, conn, frame,
+                        (ph->tp_status & TP_STATUS_VLAN_VALID) ? &vlanTci : NULL);
+            /* Closing (the ring stays mapped until the delayed close) */
+            if(conn->rfd.dc.callback)
+                break;
+            ph = (struct tpacket3_hdr*)((UA_Byte*)ph + ph->tp_next_offset);
+        }
+
+        /* Return the block to the kernel */
+        ETH_ringStore(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL);
+        conn->ringPos = (conn->ringPos + 1) % conn->ringSlots;
+        if(conn->rfd.dc.callback)
+            return;
+    }
+}
+
+#ifdef UA_ETH_XDP
+/* Deliver the frames from the rx ring directly from the UMEM. Afterwards the
+ * frames are returned to the kernel through the fill ring. */
+static void
+ETH_receiveXDP(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
+    UA_UInt32 cons = *conn->rx.consumer;
+    UA_UInt32 prod = ETH_ringLoad(conn->rx.producer);
+    UA_UInt32 fillProd = *conn->fill.producer;
+    struct xdp_desc *descs = (struct xdp_desc*)conn->rx.descs;
+    UA_UInt64 *fillDescs = (UA_UInt64*)conn->fill.descs;
+    for(; cons != prod; cons++) {
+        const struct xdp_desc *desc = &descs[cons & (conn->rx.size - 1)];
+        UA_ByteString frame = {desc->len, &conn->umem[desc->addr]};
+        ETH_deliver(pcm, conn, frame, NULL);
+        fillDescs[fillProd & (conn->fill.size - 1)] =
+            desc->addr & ~(UA_UInt64)(ETH_XDP_FRAMESIZE - 1);
+        fillProd++;
+        /* Closing (the UMEM stays mapped until the delayed close) */
+        if(conn->rfd.dc.callback) {
+            cons++;
+            break;
+        }
+    }
+    ETH_ringStore(conn->rx.consumer, cons);
+    ETH_ringStore(conn->fill.producer, fillProd);
+}
+#endif
+
 /* Gets called when a socket receives data or closes */
 static void
 ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
@@ -337,6 +620,18 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
         return;
     }
 
+    /* Frames are received into the ring without a system call */
+    if(conn->ring) {
+        ETH_receiveRing(pcm, conn);
+        return;
+    }
+#ifdef UA_ETH_XDP
+    if(conn->xdp) {
+        ETH_receiveXDP(pcm, conn);
+        return;
+    }
+#endif
+
     /* Use the already allocated receive-buffer */
     UA_ByteString response = pcm->rxBuffer;;
 
@@ -371,82 +666,14 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
                  (unsigned)rfd->fd, (unsigned)ret);
 
     response.length = (size_t)ret;
-
-    /* Parse the Ethernet header */
-    unsigned char destAddr[ETHER_ADDR_LEN];
-    unsigned char sourceAddr[ETHER_ADDR_LEN];
-    UA_UInt16 etherType = 0;
-    UA_UInt16 vid = 0;
-    UA_Byte pcp = 0;
-    UA_Boolean dei = 0;
-    size_t headerSize = parseETHHeader(&response, destAddr, sourceAddr,
-                                       &etherType, &vid, &pcp, &dei);
-    if(headerSize == 0)
-        return;
-
-    /* Set up the parameter arguments passed to the application */
-    unsigned char destAddrBytes[18];
-    unsigned char sourceAddrBytes[18];
-    setAddrString(destAddrBytes, destAddr);
-    setAddrString(sourceAddrBytes, sourceAddr);
-    UA_String destAddrStr = {17, destAddrBytes};
-    UA_String sourceAddrStr = {17, sourceAddrBytes};
-
-    size_t paramsSize = 2;
-    UA_KeyValuePair params[6];
-    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
-    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
-    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-
-    if(etherType > 0) {
-        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
-        UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
-        paramsSize++;
-    }
-
-    if(vid > 0) {
-        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
-        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
-        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
-        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
-        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
-        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
-        paramsSize += 3;
-    }
-
-    /* Callback to the application layer with the Ethernet header hidden */
-    UA_KeyValueMap map = {paramsSize, params};
-    response.data += headerSize;
-    response.length -= headerSize;
-    UA_UNLOCK(&el->elMutex);
-    conn->applicationCB(cm, (uintptr_t)rfd->fd, conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED, &map, response);
-    UA_LOCK(&el->elMutex);
-    response.data -= headerSize;
-    response.length += headerSize;
+    ETH_deliver(pcm, conn, response, NULL);
 }
 
+/* Set the interface to promiscuous mode and register for the multicast
+ * address. The memberships are bound to the lifetime of the socket. */
 static UA_StatusCode
-ETH_openListenConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
-                         const UA_KeyValueMap *params,
-                         int ifindex, UA_UInt16 etherType,
-                         UA_Boolean validate) {
-    UA_LOCK_ASSERT(&el->elMutex, 1);
-
-    /* Bind the socket to interface and EtherType. Don't receive anything else. */
-    struct sockaddr_ll sll;
-    memset(&sll, 0, sizeof(struct sockaddr_ll));
-    sll.sll_family = AF_PACKET;
-    sll.sll_protocol = htons(etherType);
-    sll.sll_ifindex = ifindex;
-    if(!validate && bind(conn->rfd.fd, (struct sockaddr*)&sll, sizeof(sll)) < 0)
-        return UA_STATUSCODE_BADINTERNALERROR;
-
-    /* Immediately register for listen events. Don't have to wait for a
-     * connection to open. */
-    conn->rfd.listenEvents = UA_FDEVENT_IN;
-
+ETH_addMemberships(UA_EventLoopPOSIX *el, UA_FD fd, const UA_KeyValueMap *params,
+                   int ifindex, UA_Boolean validate) {
     /* Set receiving to promiscuous (all target host addresses) */
     const UA_Boolean *promiscuous = (const UA_Boolean*)
         UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_PROMISCUOUS].name,
@@ -456,18 +683,18 @@ ETH_openListenConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
         memset(&mreq, 0, sizeof(struct packet_mreq));
         mreq.mr_ifindex = ifindex;
         mreq.mr_type = PACKET_MR_PROMISC;
-        int ret = setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
+        int ret = setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
                              &mreq, sizeof(mreq));
         if(ret < 0) {
             UA_LOG_SOCKET_ERRNO_WRAP(
                UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                             "ETH %u\t| Could not set raw socket to promiscuous mode %s",
-                            (unsigned)conn->rfd.fd, errno_str));
+                            (unsigned)fd, errno_str));
             return UA_STATUSCODE_BADINTERNALERROR;
         } else {
             UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                         "ETH %u\t| The socket was set to promiscuous mode",
-                        (unsigned)conn->rfd.fd);
+                        (unsigned)fd);
         }
     }
 
@@ -496,7 +723,7 @@ ETH_openListenConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
         mreq.mr_type = PACKET_MR_MULTICAST;
         mreq.mr_alen = ETH_ALEN;
         memcpy(mreq.mr_address, addr, ETHER_ADDR_LEN);
-        if(!validate && UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
+        if(!validate && UA_setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
                                       (char *)&mreq, sizeof(mreq)) < 0) {
             UA_LOG_SOCKET_ERRNO_WRAP(
                UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
@@ -506,6 +733,34 @@ ETH_openListenConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
         }
     }
 
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+ETH_openListenConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
+                         const UA_KeyValueMap *params,
+                         int ifindex, UA_UInt16 etherType,
+                         UA_Boolean validate) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    /* Bind the socket to interface and EtherType. Don't receive anything else. */
+    struct sockaddr_ll sll;
+    memset(&sll, 0, sizeof(struct sockaddr_ll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(etherType);
+    sll.sll_ifindex = ifindex;
+    if(!validate && bind(conn->rfd.fd, (struct sockaddr*)&sll, sizeof(sll)) < 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Immediately register for listen events. Don't have to wait for a
+     * connection to open. */
+    conn->rfd.listenEvents = UA_FDEVENT_IN;
+
+    /* Register for promiscuous mode and multicast */
+    UA_StatusCode res = ETH_addMemberships(el, conn->rfd.fd, params, ifindex, validate);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
     UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                 "ETH %u\t| Opened an Ethernet listen socket",
                 (unsigned)conn->rfd.fd);
@@ -619,6 +874,381 @@ ETH_openSendConnection(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap
     return UA_STATUSCODE_GOOD;
 }
 
+#ifdef UA_ETH_XDP
+static int
+ETH_bpf(int cmd, union bpf_attr *attr) {
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(union bpf_attr));
+}
+
+/* Load the XDP program that redirects frames of the EtherType to the AF_XDP
+ * socket registered in the map for the receive queue. All other frames are
+ * passed on to the network stack. */
+static int
+ETH_loadXDPProgram(int mapFd, UA_UInt16 etherType) {
+    struct bpf_insn prog[16];
+    memset(prog, 0, sizeof(prog));
+    /* r6 = ctx; r2 = ctx->data; r3 = ctx->data_end */
+    prog[0].code = BPF_ALU64 | BPF_MOV | BPF_X;
+    prog[0].dst_reg = BPF_REG_6;
+    prog[0].src_reg = BPF_REG_1;
+    prog[1].code = BPF_LDX | BPF_W | BPF_MEM;
+    prog[1].dst_reg = BPF_REG_2;
+    prog[1].src_reg = BPF_REG_1;
+    prog[1].off = offsetof(struct xdp_md, data);
+    prog[2].code = BPF_LDX | BPF_W | BPF_MEM;
+    prog[2].dst_reg = BPF_REG_3;
+    prog[2].src_reg = BPF_REG_1;
+    prog[2].off = offsetof(struct xdp_md, data_end);
+    /* if(data + 14 > data_end) goto pass */
+    prog[3].code = BPF_ALU64 | BPF_MOV | BPF_X;
+    prog[3].dst_reg = BPF_REG_4;
+    prog[3].src_reg = BPF_REG_2;
+    prog[4].code = BPF_ALU64 | BPF_ADD | BPF_K;
+    prog[4].dst_reg = BPF_REG_4;
+    prog[4].imm = 2 * ETHER_ADDR_LEN + 2;
+    prog[5].code = BPF_JMP | BPF_JGT | BPF_X;
+    prog[5].dst_reg = BPF_REG_4;
+    prog[5].src_reg = BPF_REG_3;
+    prog[5].off = 8;
+    /* if(EtherType != etherType) goto pass. Both in network byte order. */
+    prog[6].code = BPF_LDX | BPF_H | BPF_MEM;
+    prog[6].dst_reg = BPF_REG_4;
+    prog[6].src_reg = BPF_REG_2;
+    prog[6].off = 2 * ETHER_ADDR_LEN;
+    if(etherType != ETH_P_ALL) {
+        prog[7].code = BPF_JMP | BPF_JNE | BPF_K;
+        prog[7].dst_reg = BPF_REG_4;
+        prog[7].imm = htons(etherType);
+        prog[7].off = 6;
+    } else {
+        prog[7].code = BPF_JMP | BPF_JA; /* No-op */
+    }
+    /* return bpf_redirect_map(map, ctx->rx_queue_index, XDP_PASS) */
+    prog[8].code = BPF_LDX | BPF_W | BPF_MEM;
+    prog[8].dst_reg = BPF_REG_2;
+    prog[8].src_reg = BPF_REG_6;
+    prog[8].off = offsetof(struct xdp_md, rx_queue_index);
+    prog[9].code = BPF_LD | BPF_DW | BPF_IMM; /* Spans two instructions */
+    prog[9].dst_reg = BPF_REG_1;
+    prog[9].src_reg = BPF_PSEUDO_MAP_FD;
+    prog[9].imm = mapFd;
+    prog[11].code = BPF_ALU64 | BPF_MOV | BPF_K;
+    prog[11].dst_reg = BPF_REG_3;
+    prog[11].imm = XDP_PASS;
+    prog[12].code = BPF_JMP | BPF_CALL;
+    prog[12].imm = BPF_FUNC_redirect_map;
+    prog[13].code = BPF_JMP | BPF_EXIT;
+    /* pass: return XDP_PASS */
+    prog[14].code = BPF_ALU64 | BPF_MOV | BPF_K;
+    prog[14].dst_reg = BPF_REG_0;
+    prog[14].imm = XDP_PASS;
+    prog[15].code = BPF_JMP | BPF_EXIT;
+
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(union bpf_attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (UA_UInt64)(uintptr_t)prog;
+    attr.insn_cnt = 16;
+    attr.license = (UA_UInt64)(uintptr_t)"Dual MPL/GPL";
+    return ETH_bpf(BPF_PROG_LOAD, &attr);
+}
+
+static UA_StatusCode
+ETH_mapXDPRing(UA_FD fd, ETH_XDPRing *ring, const struct xdp_ring_offset *off,
+               UA_UInt32 size, size_t descSize, off_t pgoff) {
+    ring->mapSize = off->desc + size * descSize;
+    void *map = mmap(NULL, ring->mapSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if(map == MAP_FAILED)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    ring->map = map;
+    ring->producer = (UA_UInt32*)((UA_Byte*)map + off->producer);
+    ring->consumer = (UA_UInt32*)((UA_Byte*)map + off->consumer);
+    ring->descs = (UA_Byte*)map + off->desc;
+    ring->size = size;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Set up the AF_XDP socket for a listen connection. The frames are received
+ * into a UMEM area that is shared with the kernel. In the zero-copy mode the
+ * NIC driver writes there directly. The XDP program is attached in the native
+ * mode of the driver if supported and in the generic mode otherwise (e.g. for
+ * veth interfaces). The same holds for zero-copy and copy mode of the socket.
+ * This can be overridden with the xdp-flags and xdp-bind-flags parameters. */
+static UA_StatusCode
+ETH_openXDPConnection(UA_EventLoopPOSIX *el, ETH_FD *conn,
+                      const UA_KeyValueMap *params,
+                      int ifindex, UA_UInt16 etherType) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    conn->xdp = true;
+    conn->xdpMapFd = -1;
+    conn->xdpProgFd = -1;
+    conn->xdpLinkFd = -1;
+    conn->xdpMemberFd = -1;
+
+    UA_UInt32 queue = 0;
+    const UA_UInt32 *queueParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_XDP_QUEUE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(queueParam)
+        queue = *queueParam;
+    UA_UInt32 xdpFlags = 0;
+    const UA_UInt32 *xdpFlagsParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_XDP_FLAGS].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(xdpFlagsParam)
+        xdpFlags = *xdpFlagsParam;
+    UA_UInt16 bindFlags = 0;
+    const UA_UInt32 *bindFlagsParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_XDP_BINDFLAGS].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(bindFlagsParam)
+        bindFlags = (UA_UInt16)*bindFlagsParam;
+
+    /* The number of frames is a power of two */
+    UA_UInt32 ringSize = ETH_RING_DEFAULTSIZE;
+    const UA_UInt32 *ringSizeParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_RINGSIZE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(ringSizeParam && *ringSizeParam > 0)
+        ringSize = *ringSizeParam;
+    UA_UInt32 frames = ETH_XDP_MINFRAMES;
+    while(frames * 2 <= ringSize / ETH_XDP_FRAMESIZE)
+        frames *= 2;
+
+    /* Allocate and register the UMEM */
+    conn->umemSize = (size_t)frames * ETH_XDP_FRAMESIZE;
+    void *umem = mmap(NULL, conn->umemSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(umem == MAP_FAILED) {
+        conn->umemSize = 0;
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    conn->umem = (UA_Byte*)umem;
+
+    struct xdp_umem_reg umemReg;
+    memset(&umemReg, 0, sizeof(struct xdp_umem_reg));
+    umemReg.addr = (UA_UInt64)(uintptr_t)umem;
+    umemReg.len = conn->umemSize;
+    umemReg.chunk_size = ETH_XDP_FRAMESIZE;
+    int ret = setsockopt(conn->rfd.fd, SOL_XDP, XDP_UMEM_REG, &umemReg, sizeof(umemReg));
+    if(ret == 0)
+        ret = setsockopt(conn->rfd.fd, SOL_XDP, XDP_UMEM_FILL_RING, &frames, sizeof(frames));
+    if(ret == 0)
+        ret = setsockopt(conn->rfd.fd, SOL_XDP, XDP_UMEM_COMPLETION_RING,
+                         &frames, sizeof(frames));
+    if(ret == 0)
+        ret = setsockopt(conn->rfd.fd, SOL_XDP, XDP_RX_RING, &frames, sizeof(frames));
+    struct xdp_mmap_offsets off;
+    socklen_t offLen = sizeof(off);
+    if(ret == 0)
+        ret = getsockopt(conn->rfd.fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &offLen);
+    if(ret != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not set up the XDP rings (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Map the rings */
+    UA_StatusCode res =
+        ETH_mapXDPRing(conn->rfd.fd, &conn->fill, &off.fr, frames,
+                       sizeof(UA_UInt64), XDP_UMEM_PGOFF_FILL_RING);
+    res |= ETH_mapXDPRing(conn->rfd.fd, &conn->comp, &off.cr, frames,
+                          sizeof(UA_UInt64), XDP_UMEM_PGOFF_COMPLETION_RING);
+    res |= ETH_mapXDPRing(conn->rfd.fd, &conn->rx, &off.rx, frames,
+                          sizeof(struct xdp_desc), XDP_PGOFF_RX_RING);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not map the XDP rings (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return res;
+    }
+
+    /* Hand all frames to the kernel */
+    UA_UInt64 *fillDescs = (UA_UInt64*)conn->fill.descs;
+    for(UA_UInt32 i = 0; i < frames; i++)
+        fillDescs[i] = (UA_UInt64)i * ETH_XDP_FRAMESIZE;
+    ETH_ringStore(conn->fill.producer, frames);
+
+    /* Bind to the interface queue */
+    struct sockaddr_xdp sxdp;
+    memset(&sxdp, 0, sizeof(struct sockaddr_xdp));
+    sxdp.sxdp_family = AF_XDP;
+    sxdp.sxdp_flags = bindFlags;
+    sxdp.sxdp_ifindex = (UA_UInt32)ifindex;
+    sxdp.sxdp_queue_id = queue;
+    if(bind(conn->rfd.fd, (struct sockaddr*)&sxdp, sizeof(sxdp)) != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not bind the XDP socket to queue %u (%s)",
+                        (unsigned)conn->rfd.fd, (unsigned)queue, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Register the socket for the queue in the map */
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(union bpf_attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(UA_UInt32);
+    attr.value_size = sizeof(int);
+    attr.max_entries = queue + 1;
+    conn->xdpMapFd = ETH_bpf(BPF_MAP_CREATE, &attr);
+    int sockfd = conn->rfd.fd;
+    if(conn->xdpMapFd >= 0) {
+        memset(&attr, 0, sizeof(union bpf_attr));
+        attr.map_fd = (UA_UInt32)conn->xdpMapFd;
+        attr.key = (UA_UInt64)(uintptr_t)&queue;
+        attr.value = (UA_UInt64)(uintptr_t)&sockfd;
+        ret = ETH_bpf(BPF_MAP_UPDATE_ELEM, &attr);
+    }
+
+    /* Load and attach the program. Closing the link detaches it again. */
+    if(conn->xdpMapFd >= 0 && ret == 0)
+        conn->xdpProgFd = ETH_loadXDPProgram(conn->xdpMapFd, etherType);
+    if(conn->xdpProgFd >= 0) {
+        memset(&attr, 0, sizeof(union bpf_attr));
+        attr.link_create.prog_fd = (UA_UInt32)conn->xdpProgFd;
+        attr.link_create.target_ifindex = (UA_UInt32)ifindex;
+        attr.link_create.attach_type = BPF_XDP;
+        attr.link_create.flags = xdpFlags;
+        conn->xdpLinkFd = ETH_bpf(BPF_LINK_CREATE, &attr);
+    }
+    if(conn->xdpLinkFd < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not attach the XDP program (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* AF_XDP sockets cannot register for multicast. A helper AF_PACKET socket
+     * that receives nothing holds the memberships instead. */
+    conn->xdpMemberFd = socket(PF_PACKET, SOCK_RAW, 0);
+    if(conn->xdpMemberFd < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not create the socket for the multicast "
+                        "membership (%s)", (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    res = ETH_addMemberships(el, conn->xdpMemberFd, params, ifindex, false);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    conn->rfd.listenEvents = UA_FDEVENT_IN;
+
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                "ETH %u\t| Opened an AF_XDP listen socket for queue %u "
+                "with %u frames", (unsigned)conn->rfd.fd, (unsigned)queue,
+                (unsigned)frames);
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
+/* Set up the PACKET_MMAP ring if configured. Listen connections get a
+ * TPACKET_V3 RX ring where the kernel fills variable-sized frames into blocks.
+ * A block is handed to userspace when it is full or when the ring-timeout has
+ * passed. Send connections get a TPACKET_V2 TX ring of fixed-size frames. */
+static UA_StatusCode
+ETH_setupRing(UA_EventLoopPOSIX *el, ETH_FD *conn,
+              const UA_KeyValueMap *params, UA_Boolean listen) {
+    const UA_Boolean *mmapParam = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_MMAP].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(!mmapParam || !*mmapParam)
+        return UA_STATUSCODE_GOOD;
+
+    /* The frames of the TX ring carry no transmission time */
+    if(conn->txtimeEnabled) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "ETH %u\t| The ring is not used together with txtime",
+                       (unsigned)conn->rfd.fd);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Round the ring up to full blocks */
+    UA_UInt32 ringSize = ETH_RING_DEFAULTSIZE;
+    const UA_UInt32 *ringSizeParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_RINGSIZE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(ringSizeParam && *ringSizeParam > 0)
+        ringSize = *ringSizeParam;
+    unsigned int blocks = (ringSize + ETH_RING_BLOCKSIZE - 1) / ETH_RING_BLOCKSIZE;
+
+    UA_UInt32 timeout = ETH_RING_DEFAULTTIMEOUT;
+    const UA_UInt32 *timeoutParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RINGTIMEOUT].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(timeoutParam)
+        timeout = *timeoutParam;
+    conn->ringTimeout = timeout;
+
+    int version = (listen) ? TPACKET_V3 : TPACKET_V2;
+    int ret = setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_VERSION,
+                         &version, sizeof(version));
+    if(ret == 0 && listen) {
+        struct tpacket_req3 req;
+        memset(&req, 0, sizeof(struct tpacket_req3));
+        req.tp_block_size = ETH_RING_BLOCKSIZE;
+        req.tp_block_nr = blocks;
+        req.tp_frame_size = ETH_RING_FRAMESIZE;
+        req.tp_frame_nr = blocks * (ETH_RING_BLOCKSIZE / ETH_RING_FRAMESIZE);
+        req.tp_retire_blk_tov = timeout;
+        ret = setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+        conn->ringSlotSize = ETH_RING_BLOCKSIZE;
+        conn->ringSlots = blocks;
+    } else if(ret == 0) {
+        /* Discard malformed frames instead of blocking the ring */
+        int loss = 1;
+        ret = setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_LOSS, &loss, sizeof(loss));
+        struct tpacket_req req;
+        memset(&req, 0, sizeof(struct tpacket_req));
+        req.tp_block_size = ETH_RING_BLOCKSIZE;
+        req.tp_block_nr = blocks;
+        req.tp_frame_size = ETH_RING_FRAMESIZE;
+        req.tp_frame_nr = blocks * (ETH_RING_BLOCKSIZE / ETH_RING_FRAMESIZE);
+        if(ret == 0)
+            ret = setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req));
+        conn->ringSlotSize = ETH_RING_FRAMESIZE;
+        conn->ringSlots = req.tp_frame_nr;
+    }
+    if(ret != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not set up the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Map the ring into the address space */
+    size_t size = (size_t)blocks * ETH_RING_BLOCKSIZE;
+    void *ring = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_LOCKED, conn->rfd.fd, 0);
+    if(ring == MAP_FAILED) /* Retry without locking the pages in memory */
+        ring = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, conn->rfd.fd, 0);
+    if(ring == MAP_FAILED) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not map the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    conn->ring = (UA_Byte*)ring;
+    conn->ringSize = size;
+
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                "ETH %u\t| Mapped a %s ring of %u bytes",
+                (unsigned)conn->rfd.fd, (listen) ? "receive" : "send",
+                (unsigned)size);
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
                    void *application, void *context,
@@ -684,13 +1314,35 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* Receive with an AF_XDP socket? */
+    UA_Boolean xdp = false;
+    const UA_Boolean *xdpParam = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_XDP].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(listen && *listen && xdpParam)
+        xdp = *xdpParam;
+#ifndef UA_ETH_XDP
+    if(xdp) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "ETH\t| AF_XDP sockets are not supported");
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+#endif
+
     /* Create the socket and add the basic configuration */
     ETH_FD *conn = NULL;
     UA_FD sockfd;
-    if(listen && *listen)
+    if(listen && *listen) {
+#ifdef UA_ETH_XDP
+        if(xdp)
+            sockfd = socket(AF_XDP, SOCK_RAW, 0);
+        else
+#endif
         sockfd = socket(PF_PACKET, SOCK_RAW, htons(etherType));
-    else
+    } else {
         sockfd = socket(PF_PACKET, SOCK_RAW, 0); /* Don't receive */
+    }
     if(sockfd == -1) {
         UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                      "ETH\t| Could not create a raw Ethernet socket (are you root?)");
@@ -736,9 +1388,19 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
                                      (unsigned char*)ifr.ifr_hwaddr.sa_data,
                                      ifindex, etherType);
     } else {
+#ifdef UA_ETH_XDP
+        if(xdp) {
+            if(!validate)
+                res = ETH_openXDPConnection(el, conn, params, ifindex, etherType);
+        } else
+#endif
         res = ETH_openListenConnection(el, conn, params, ifindex, etherType, validate);
     }
 
+    /* Set up the ring */
+    if(!validate && !xdp && res == UA_STATUSCODE_GOOD)
+        res = ETH_setupRing(el, conn, params, (listen && *listen));
+
     /* Don't actually open or shut down */
     if(validate || res != UA_STATUSCODE_GOOD)
         goto cleanup;
@@ -761,6 +1423,8 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
 
  cleanup:
     UA_close(sockfd);
+    if(conn)
+        ETH_releaseRings(conn);
     UA_free(conn);
     UA_UNLOCK(&el->elMutex);
     return res;
@@ -884,6 +1548,80 @@ send_txtime(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap *params,
 }
 #endif
 
+/* Trigger the transmission without waiting for it to complete. Frames that
+ * cannot be queued right now remain in the ring and go out with the next
+ * trigger. */
+static UA_StatusCode
+ETH_triggerRing(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    ssize_t n;
+    do {
+        n = UA_sendto(conn->rfd.fd, NULL, 0, MSG_DONTWAIT | MSG_NOSIGNAL,
+                      (struct sockaddr*)&conn->sll, sizeof(conn->sll));
+    } while(n < 0 && UA_ERRNO == UA_INTERRUPTED);
+    if(n < 0 && UA_ERRNO != UA_WOULDBLOCK && UA_ERRNO != UA_AGAIN && UA_ERRNO != ENOBUFS) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Send failed with error %s",
+                        (unsigned)conn->rfd.fd, errno_str));
+        ETH_shutdown(pcm, conn);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Copy the frame into the next slot of the TX ring and let the kernel send all
+ * pending frames. Returns UA_STATUSCODE_BADRESOURCEUNAVAILABLE if no slot is
+ * released within the ring-timeout. */
+static UA_StatusCode
+ETH_sendRing(UA_POSIXConnectionManager *pcm, ETH_FD *conn, const UA_ByteString *buf) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    if(buf->length > ETH_RING_FRAMESIZE - ETH_TXRING_DATAOFFSET) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "ETH %u\t| The frame of %u bytes does not fit into the ring",
+                     (unsigned)conn->rfd.fd, (unsigned)buf->length);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* The ring is full. Trigger the transmission of the queued frames and wait
+     * for a free slot at most for the ring-timeout. The elMutex is held during
+     * the wait. So rather drop the frame than block the EventLoop. */
+    struct tpacket2_hdr *hdr = ETH_txFrame(conn);
+    if(!hdr) {
+        UA_StatusCode res = ETH_triggerRing(pcm, conn);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        struct pollfd tmp_poll_fd;
+        tmp_poll_fd.fd = conn->rfd.fd;
+        tmp_poll_fd.events = UA_POLLOUT;
+        int poll_ret = UA_poll(&tmp_poll_fd, 1, (int)conn->ringTimeout);
+        if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "ETH %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            ETH_shutdown(pcm, conn);
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+        hdr = ETH_txFrame(conn);
+        if(!hdr) {
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                           "ETH %u\t| The send ring is full. Dropping the frame.",
+                           (unsigned)conn->rfd.fd);
+            return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+        }
+    }
+
+    /* Hand the frame to the kernel */
+    memcpy((UA_Byte*)hdr + ETH_TXRING_DATAOFFSET, buf->data, buf->length);
+    hdr->tp_len = (UA_UInt32)buf->length;
+    ETH_ringStore(&hdr->tp_status, TP_STATUS_SEND_REQUEST);
+    conn->ringPos = (conn->ringPos + 1) % conn->ringSlots;
+    return ETH_triggerRing(pcm, conn);
+}
+
 static UA_StatusCode
 ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
@@ -923,6 +1661,14 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* Send through the TX ring */
+    if(conn->ring) {
+        UA_StatusCode res = ETH_sendRing(pcm, conn, buf);
+        UA_UNLOCK(&el->elMutex);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        return res;
+    }
+
     /* Prevent OS signals when sending to a closed socket */
     int flags = MSG_NOSIGNAL;
 
@@ -123,9 +123,15 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
 #endif
     };
 
+#ifdef UA_HAVE_WAKEUP
+    el->polling = true;
+#endif
     UA_UNLOCK(&el->elMutex);
     int selectStatus = UA_select(highestfd+1, &readset, &writeset, &errset, &tmptv);
     UA_LOCK(&el->elMutex);
+#ifdef UA_HAVE_WAKEUP
+    el->polling = false;
+#endif
     if(selectStatus < 0) {
         /* We will retry, only log the error */
         UA_LOG_SOCKET_ERRNO_WRAP(
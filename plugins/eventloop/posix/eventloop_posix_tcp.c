@@ -626,15 +626,32 @@ TCP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
 static UA_StatusCode
 TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
-    /* Don't have a lock and don't take a lock. As the connectionId is the fd,
-     * no need to to a lookup and access internal data strucures. */
-    UA_LOCK_ASSERT(&((UA_EventLoopPOSIX*)cm->eventSource.eventLoop)->elMutex, 0);
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+
+    /* The send can come from a thread that does not run the EventLoop. Take
+     * the EventLoop lock and look up the connection. The socket is closed in
+     * TCP_delayedClose under the same lock and only after the connection was
+     * removed from the tree. So the fd cannot be closed (and the number reused
+     * for a new connection) while the send is ongoing. */
+    UA_LOCK(&el->elMutex);
+
+    UA_FD fd = (UA_FD)connectionId;
+    TCP_FD *conn = (TCP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Cannot send, the connection is closed",
+                       (unsigned)connectionId);
+        UA_UNLOCK(&el->elMutex);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
 
     /* Prevent OS signals when sending to a closed socket */
     int flags = MSG_NOSIGNAL;
 
     struct pollfd tmp_poll_fd;
-    tmp_poll_fd.fd = (UA_FD)connectionId;
+    tmp_poll_fd.fd = fd;
     tmp_poll_fd.events = UA_POLLOUT;
 
     /* Send the full buffer. This may require several calls to send */
@@ -642,11 +659,10 @@ TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
     do {
         ssize_t n = 0;
         do {
-            UA_LOG_DEBUG(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+            UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                          "TCP %u\t| Attempting to send", (unsigned)connectionId);
             size_t bytes_to_send = buf->length - nWritten;
-            n = UA_send((UA_FD)connectionId,
-                        (const char*)buf->data + nWritten,
+            n = UA_send(fd, (const char*)buf->data + nWritten,
                         bytes_to_send, flags);
             if(n < 0) {
                 /* An error we cannot recover from? */
@@ -668,16 +684,18 @@ TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
     } while(nWritten < buf->length);
 
     /* Clean up and return */
+    UA_UNLOCK(&el->elMutex);
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
     return UA_STATUSCODE_GOOD;
 
  shutdown:
     /* Error -> shutdown the connection  */
     UA_LOG_SOCKET_ERRNO_WRAP(
-       UA_LOG_ERROR(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+       UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                     "TCP %u\t| Send failed with error %s",
                     (unsigned)connectionId, errno_str));
-    TCP_shutdownConnection(cm, connectionId);
+    TCP_shutdown(cm, conn);
+    UA_UNLOCK(&el->elMutex);
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
     return UA_STATUSCODE_BADCONNECTIONCLOSED;
 }
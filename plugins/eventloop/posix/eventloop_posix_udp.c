@@ -8,6 +8,18 @@
 
 #include "eventloop_posix.h"
 
+/* Receive and send several datagrams per syscall. Use UDP GRO/GSO where the
+ * kernel supports it. */
+#if defined(UA_ARCHITECTURE_POSIX) && defined(__linux__)
+# define UDP_HAVE_MMSG 1
+# include <netinet/udp.h>
+#endif
+
+#define UDP_DEFAULT_RECVBATCH 8
+#define UDP_MAXSENDBATCH 64 /* Datagrams per sendmmsg */
+#define UDP_MAXGSOSEGMENTS 64
+#define UDP_MAXGSOSIZE 65000 /* Below the IP length limit with headers */
+
 #define IPV4_PREFIX_MASK 0xF0
 #define IPV4_MULTICAST_PREFIX 0xE0
 #if UA_IPV6
@@ -17,13 +29,17 @@
 
 /* Configuration parameters */
 
-#define UDP_MANAGERPARAMS 2
+#define UDP_MANAGERPARAMS 3
+#define UDP_MANAGERPARAMINDEX_RECVBATCH 2
 
 static UA_KeyValueRestriction udpManagerParams[UDP_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
-    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("recv-batch")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false}
 };
 
+static const UA_QualifiedName udpSegmentSizeParam = {0, UA_STRING_STATIC("segment-size")};
+
 #define UDP_PARAMETERSSIZE 9
 #define UDP_PARAMINDEX_LISTEN 0
 #define UDP_PARAMINDEX_ADDR 1
@@ -61,8 +77,39 @@ typedef struct {
 #else
     socklen_t sendAddrLength;
 #endif
+    UA_Boolean noGSO; /* Segmentation offload failed, use sendmmsg instead */
 } UDP_FD;
 
+#ifdef UDP_HAVE_MMSG
+/* Ancillary data with the GRO segment size */
+typedef union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} UDP_Control;
+#endif
+
+typedef struct {
+    UA_POSIXConnectionManager pcm;
+
+    /* The source of the last received datagram and its formatting. Most
+     * datagrams come from the same few senders. The address string is only
+     * formatted again when the source changes. */
+    struct sockaddr_storage lastSource;
+    char lastSourceAddr[64];
+    UA_UInt16 lastSourcePort;
+
+#ifdef UDP_HAVE_MMSG
+    /* The rxBuffer is split into recvBatch slots of slotSize each. The
+     * message headers for recvmmsg point into the slots. */
+    size_t recvBatch;
+    size_t slotSize;
+    struct mmsghdr *msgs;
+    struct iovec *iovs;
+    struct sockaddr_storage *sources;
+    UDP_Control *controls;
+#endif
+} UDP_ConnectionManager;
+
 typedef enum {
     MULTICASTTYPE_NONE = 0,
     MULTICASTTYPE_IPV4,
@@ -502,6 +549,153 @@ UDP_delayedClose(void *application, void *context) {
     UA_UNLOCK(&el->elMutex);
 }
 
+static UA_Boolean
+sameSource(const struct sockaddr_storage *a, const struct sockaddr_storage *b) {
+    if(a->ss_family != b->ss_family)
+        return false;
+    if(a->ss_family == AF_INET) {
+        const struct sockaddr_in *a4 = (const struct sockaddr_in*)a;
+        const struct sockaddr_in *b4 = (const struct sockaddr_in*)b;
+        return (a4->sin_port == b4->sin_port &&
+                a4->sin_addr.s_addr == b4->sin_addr.s_addr);
+    }
+    if(a->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *a6 = (const struct sockaddr_in6*)a;
+        const struct sockaddr_in6 *b6 = (const struct sockaddr_in6*)b;
+        return (a6->sin6_port == b6->sin6_port &&
+                memcmp(&a6->sin6_addr, &b6->sin6_addr, sizeof(struct in6_addr)) == 0);
+    }
+    return false;
+}
+
+/* Hand a received datagram to the application */
+static void
+UDP_deliver(UDP_ConnectionManager *ucm, UDP_FD *conn,
+            const struct sockaddr_storage *source, UA_ByteString msg) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ucm->pcm.cm.eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    /* Extract message source and port. Reuse the formatting of the last
+     * datagram if the source has not changed. */
+    if(!sameSource(source, &ucm->lastSource)) {
+        switch(source->ss_family) {
+        case AF_INET:
+            inet_ntop(AF_INET, &((const struct sockaddr_in *)source)->sin_addr,
+                      ucm->lastSourceAddr, 64);
+            ucm->lastSourcePort =
+                htons(((const struct sockaddr_in *)source)->sin_port);
+            break;
+        case AF_INET6:
+            inet_ntop(AF_INET6, &(((const struct sockaddr_in6 *)source)->sin6_addr),
+                      ucm->lastSourceAddr, 64);
+            ucm->lastSourcePort =
+                htons(((const struct sockaddr_in6 *)source)->sin6_port);
+            break;
+        default:
+            ucm->lastSourceAddr[0] = 0;
+            ucm->lastSourcePort = 0;
+        }
+        ucm->lastSource = *source;
+    }
+
+    UA_String sourceAddrStr = UA_STRING(ucm->lastSourceAddr);
+    UA_UInt16 sourcePort = ucm->lastSourcePort;
+    UA_KeyValuePair kvp[2];
+    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
+    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
+    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap kvm = {2, kvp};
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received message of size %u from %s on port %u",
+                 (unsigned)conn->rfd.fd, (unsigned)msg.length,
+                 ucm->lastSourceAddr, sourcePort);
+
+    /* Callback to the application layer */
+    UA_UNLOCK(&el->elMutex);
+    conn->applicationCB(&ucm->pcm.cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &kvm, msg);
+    UA_LOCK(&el->elMutex);
+}
+
+#ifdef UDP_HAVE_MMSG
+/* Receive up to recvBatch datagrams with a single syscall */
+static void
+UDP_receiveBatch(UDP_ConnectionManager *ucm, UDP_FD *conn) {
+    UA_POSIXConnectionManager *pcm = &ucm->pcm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    /* Reset the message headers. recvmmsg overwrites the lengths. */
+    for(size_t i = 0; i < ucm->recvBatch; i++) {
+        ucm->iovs[i].iov_base = &pcm->rxBuffer.data[i * ucm->slotSize];
+        ucm->iovs[i].iov_len = ucm->slotSize;
+        struct msghdr *mh = &ucm->msgs[i].msg_hdr;
+        memset(mh, 0, sizeof(struct msghdr));
+        mh->msg_name = &ucm->sources[i];
+        mh->msg_namelen = (socklen_t)sizeof(struct sockaddr_storage);
+        mh->msg_iov = &ucm->iovs[i];
+        mh->msg_iovlen = 1;
+        mh->msg_control = ucm->controls[i].buf;
+        mh->msg_controllen = sizeof(ucm->controls[i].buf);
+    }
+
+    int received = recvmmsg(conn->rfd.fd, ucm->msgs, (unsigned)ucm->recvBatch,
+                            MSG_DONTWAIT, NULL);
+    if(received < 0 && (UA_ERRNO == UA_INTERRUPTED || UA_ERRNO == UA_AGAIN))
+        return;
+
+    for(int i = 0; i < received; i++) {
+        struct msghdr *mh = &ucm->msgs[i].msg_hdr;
+        size_t length = ucm->msgs[i].msg_len;
+        if(length == 0) {
+            received = 0; /* Treat as a shutdown of the socket */
+            break;
+        }
+
+        /* With GRO several datagrams of the same size (except the last) from
+         * the same source are coalesced into one buffer */
+        size_t segSize = length;
+#ifdef UDP_GRO
+        for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(mh); cmsg != NULL;
+            cmsg = CMSG_NXTHDR(mh, cmsg)) {
+            if(cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                int gsoSize;
+                memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof(int));
+                if(gsoSize > 0)
+                    segSize = (size_t)gsoSize;
+            }
+        }
+#endif
+
+        UA_Byte *data = (UA_Byte*)mh->msg_iov->iov_base;
+        for(size_t pos = 0; pos < length; pos += segSize) {
+            UA_ByteString msg = {segSize, &data[pos]};
+            if(msg.length > length - pos)
+                msg.length = length - pos;
+            UDP_deliver(ucm, conn, &ucm->sources[i], msg);
+
+            /* The application has closed the connection */
+            if(conn->rfd.dc.callback)
+                return;
+        }
+    }
+
+    /* Receive has failed. Orderly shutdown of the socket. We can immediately
+     * close as no method "below" in the call stack will use the socket in
+     * this iteration of the EventLoop. */
+    if(received <= 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "UDP %u\t| recv signaled the socket was shutdown (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        UDP_close(pcm, conn);
+    }
+}
+#endif
+
 /* Gets called when a socket receives data or closes */
 static void
 UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
@@ -522,6 +716,14 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
         return;
     }
 
+#ifdef UDP_HAVE_MMSG
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)pcm;
+    if(ucm->recvBatch > 1) {
+        UDP_receiveBatch(ucm, conn);
+        return;
+    }
+#endif
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                  "UDP %u\t| Allocate receive buffer", (unsigned)conn->rfd.fd);
 
@@ -557,46 +759,7 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
     }
 
     response.length = (size_t)ret; /* Set the length of the received buffer */
-
-    /* Extract message source and port */
-    char sourceAddr[64];
-    UA_UInt16 sourcePort;
-    switch(source.ss_family) {
-        case AF_INET:
-            inet_ntop(AF_INET, &((struct sockaddr_in *)&source)->sin_addr,
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in *)&source)->sin_port);
-            break;
-        case AF_INET6:
-            inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)&source)->sin6_addr),
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in6 *)&source)->sin6_port);
-            break;
-        default:
-            sourceAddr[0] = 0;
-            sourcePort = 0;
-    }
-
-    UA_String sourceAddrStr = UA_STRING(sourceAddr);
-    UA_KeyValuePair kvp[2];
-    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
-    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
-    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
-    UA_KeyValueMap kvm = {2, kvp};
-
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "UDP %u\t| Received message of size %u from %s on port %u",
-                 (unsigned)conn->rfd.fd, (unsigned)ret,
-                 sourceAddr, sourcePort);
-
-    /* Callback to the application layer */
-    UA_UNLOCK(&el->elMutex);
-    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
-                        conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED,
-                        &kvm, response);
-    UA_LOCK(&el->elMutex);
+    UDP_deliver((UDP_ConnectionManager*)pcm, conn, &source, response);
 }
 
 static UA_StatusCode
@@ -699,6 +862,19 @@ UDP_registerListenSocket(UA_POSIXConnectionManager *pcm, UA_UInt16 port,
         }
     }
 
+#if defined(UDP_HAVE_MMSG) && defined(UDP_GRO)
+    /* Receive coalesced datagrams if the slots can hold the largest GRO
+     * buffer. Older kernels don't support GRO. Then continue without. */
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)pcm;
+    if(ucm->recvBatch > 1 && ucm->slotSize >= 65535) {
+        int gro = 1;
+        if(UA_setsockopt(listenSocket, SOL_UDP, UDP_GRO, &gro, sizeof(gro)) < 0)
+            UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                         "UDP %u\t| GRO is not supported",
+                         (unsigned)listenSocket);
+    }
+#endif
+
     /* Validation is complete - close and return */
     if(validate) {
         UA_close(listenSocket);
@@ -845,6 +1021,80 @@ UDP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Send the data as datagrams of segSize bytes (the last one can be shorter).
+ * Returns the number of bytes sent. Can be less than length. */
+static ssize_t
+UDP_sendSegments(UDP_FD *conn, const UA_Byte *data, size_t length, size_t segSize) {
+#ifdef UDP_HAVE_MMSG
+    size_t segments = (length + segSize - 1) / segSize;
+    int flags = MSG_NOSIGNAL;
+
+# ifdef UDP_SEGMENT
+    /* Let the kernel (or the network card) split the datagrams */
+    if(!conn->noGSO && segments > 1 && segments <= UDP_MAXGSOSEGMENTS &&
+       length <= UDP_MAXGSOSIZE) {
+        struct iovec iov = {(void*)(uintptr_t)data, length};
+        union {
+            char buf[CMSG_SPACE(sizeof(uint16_t))];
+            struct cmsghdr align;
+        } control;
+        memset(&control, 0, sizeof(control));
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(struct msghdr));
+        mh.msg_name = &conn->sendAddr;
+        mh.msg_namelen = conn->sendAddrLength;
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t gsoSize = (uint16_t)segSize;
+        memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(uint16_t));
+        ssize_t n = sendmsg(conn->rfd.fd, &mh, flags);
+        if(n >= 0 || (UA_ERRNO != EIO && UA_ERRNO != EINVAL &&
+                      UA_ERRNO != ENOPROTOOPT && UA_ERRNO != EOPNOTSUPP))
+            return n;
+        conn->noGSO = true; /* Not supported for the route. Don't try again. */
+    }
+# endif
+
+    /* One datagram per message */
+    if(segments == 1)
+        return sendto(conn->rfd.fd, (const char*)data, length, flags,
+                      (struct sockaddr*)&conn->sendAddr, conn->sendAddrLength);
+    struct mmsghdr msgs[UDP_MAXSENDBATCH];
+    struct iovec iovs[UDP_MAXSENDBATCH];
+    if(segments > UDP_MAXSENDBATCH)
+        segments = UDP_MAXSENDBATCH;
+    memset(msgs, 0, sizeof(struct mmsghdr) * segments);
+    for(size_t i = 0; i < segments; i++) {
+        size_t pos = i * segSize;
+        iovs[i].iov_base = (void*)(uintptr_t)&data[pos];
+        iovs[i].iov_len = (length - pos < segSize) ? length - pos : segSize;
+        msgs[i].msg_hdr.msg_name = &conn->sendAddr;
+        msgs[i].msg_hdr.msg_namelen = conn->sendAddrLength;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int sent = sendmmsg(conn->rfd.fd, msgs, (unsigned)segments, flags);
+    if(sent < 0)
+        return -1;
+    ssize_t n = 0;
+    for(int i = 0; i < sent; i++)
+        n += (ssize_t)iovs[i].iov_len;
+    return n;
+#else
+    /* Send one datagram per call */
+    if(segSize > length)
+        segSize = length;
+    return UA_sendto(conn->rfd.fd, (const char*)data, segSize, MSG_NOSIGNAL,
+                     (struct sockaddr*)&conn->sendAddr, conn->sendAddrLength);
+#endif
+}
+
 static UA_StatusCode
 UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params,
@@ -863,6 +1113,14 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* Send several datagrams of the segment size at once? */
+    size_t segSize = buf->length;
+    const UA_UInt16 *segmentSize = (const UA_UInt16*)
+        UA_KeyValueMap_getScalar(params, udpSegmentSizeParam,
+                                 &UA_TYPES[UA_TYPES_UINT16]);
+    if(segmentSize && *segmentSize > 0 && *segmentSize < segSize)
+        segSize = *segmentSize;
+
     /* Send the full buffer. This may require several calls to send */
     size_t nWritten = 0;
     do {
@@ -872,11 +1130,8 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                          "UDP %u\t| Attempting to send", (unsigned)connectionId);
 
             /* Prevent OS signals when sending to a closed socket */
-            int flags = MSG_NOSIGNAL;
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_sendto((UA_FD)connectionId, (const char*)buf->data + nWritten,
-                          bytes_to_send, flags, (struct sockaddr*)&conn->sendAddr,
-                          conn->sendAddrLength);
+            n = UDP_sendSegments(conn, buf->data + nWritten,
+                                 buf->length - nWritten, segSize);
             if(n < 0) {
                 /* An error we cannot recover from? */
                 if(UA_ERRNO != UA_INTERRUPTED &&
@@ -1152,6 +1407,57 @@ UDP_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     return res;
 }
 
+#ifdef UDP_HAVE_MMSG
+static void
+UDP_freeBatch(UDP_ConnectionManager *ucm) {
+    UA_free(ucm->msgs);
+    UA_free(ucm->iovs);
+    UA_free(ucm->sources);
+    UA_free(ucm->controls);
+    ucm->msgs = NULL;
+    ucm->iovs = NULL;
+    ucm->sources = NULL;
+    ucm->controls = NULL;
+    ucm->recvBatch = 0;
+}
+
+static UA_StatusCode
+UDP_allocateBatch(UDP_ConnectionManager *ucm) {
+    UA_POSIXConnectionManager *pcm = &ucm->pcm;
+    UDP_freeBatch(ucm);
+
+    size_t batch = UDP_DEFAULT_RECVBATCH;
+    const UA_UInt16 *configBatch = (const UA_UInt16*)
+        UA_KeyValueMap_getScalar(&pcm->cm.eventSource.params,
+                                 udpManagerParams[UDP_MANAGERPARAMINDEX_RECVBATCH].name,
+                                 &UA_TYPES[UA_TYPES_UINT16]);
+    if(configBatch && *configBatch > 0)
+        batch = *configBatch;
+    if(batch <= 1)
+        return UA_STATUSCODE_GOOD; /* Use the plain recvfrom */
+
+    /* Every slot has the configured receive buffer size */
+    ucm->slotSize = pcm->rxBuffer.length;
+    UA_ByteString_clear(&pcm->rxBuffer);
+    UA_StatusCode res = UA_ByteString_allocBuffer(&pcm->rxBuffer,
+                                                  ucm->slotSize * batch);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    ucm->msgs = (struct mmsghdr*)UA_calloc(batch, sizeof(struct mmsghdr));
+    ucm->iovs = (struct iovec*)UA_calloc(batch, sizeof(struct iovec));
+    ucm->sources = (struct sockaddr_storage*)
+        UA_calloc(batch, sizeof(struct sockaddr_storage));
+    ucm->controls = (UDP_Control*)UA_calloc(batch, sizeof(UDP_Control));
+    if(!ucm->msgs || !ucm->iovs || !ucm->sources || !ucm->controls) {
+        UDP_freeBatch(ucm);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    ucm->recvBatch = batch;
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
 static UA_StatusCode
 UDP_eventSourceStart(UA_ConnectionManager *cm) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
@@ -1183,6 +1489,14 @@ UDP_eventSourceStart(UA_ConnectionManager *cm) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+#ifdef UDP_HAVE_MMSG
+    /* Allocate one rx buffer slot and message header per datagram in the
+     * receive batch */
+    res = UDP_allocateBatch((UDP_ConnectionManager*)pcm);
+    if(res != UA_STATUSCODE_GOOD)
+        goto finish;
+#endif
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1230,6 +1544,9 @@ UDP_eventSourceDelete(UA_ConnectionManager *cm) {
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+#ifdef UDP_HAVE_MMSG
+    UDP_freeBatch((UDP_ConnectionManager*)pcm);
+#endif
     UA_ByteString_clear(&pcm->rxBuffer);
     UA_ByteString_clear(&pcm->txBuffer);
     UA_KeyValueMap_clear(&cm->eventSource.params);
@@ -1243,11 +1560,12 @@ static const char *udpName = "udp";
 
 UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName) {
-    UA_POSIXConnectionManager *cm = (UA_POSIXConnectionManager*)
-        UA_calloc(1, sizeof(UA_POSIXConnectionManager));
-    if(!cm)
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)
+        UA_calloc(1, sizeof(UDP_ConnectionManager));
+    if(!ucm)
         return NULL;
 
+    UA_POSIXConnectionManager *cm = &ucm->pcm;
     cm->cm.eventSource.eventSourceType = UA_EVENTSOURCETYPE_CONNECTIONMANAGER;
     UA_String_copy(&eventSourceName, &cm->cm.eventSource.name);
     cm->cm.eventSource.start = (UA_StatusCode (*)(UA_EventSource *))UDP_eventSourceStart;
@@ -0,0 +1,79 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#ifndef UA_LOG_ASYNC_H_
+#define UA_LOG_ASYNC_H_
+
+#include <open62541/types.h>
+#include <open62541/plugin/log.h>
+
+#include <stdio.h>
+
+_UA_BEGIN_DECLS
+
+/* The async logger does not write from the thread that logs the message.
+ * Every logging thread gets its own ring buffer of records. The timestamp and
+ * the message are printed into the record by the logging thread. The record is
+ * handed to a background thread without taking a lock. The background thread
+ * formats the records and writes them to the output.
+ *
+ * The number of ring buffers is limited by the maxThreads option. Threads that
+ * log after all ring buffers are taken share one additional ring buffer. The
+ * producers take a lock for that shared ring buffer. A thread can hand its ring
+ * buffer back with UA_Log_Async_releaseThread before it ends.
+ *
+ * If the ring buffer of a thread is full, the message is dropped and counted.
+ * The background thread reports the number of dropped messages with a warning
+ * record. Messages longer than UA_LOGASYNC_MESSAGESIZE are truncated.
+ *
+ * In the binary format every record is written as
+ *
+ * - Int64 timestamp (UA_DateTime in UTC)
+ * - UInt16 log level
+ * - UInt16 log category
+ * - UInt32 message length
+ * - the message (without a terminating zero)
+ *
+ * with all integers in little-endian byte order.
+ *
+ * The async logger requires UA_MULTITHREADING >= 100. */
+
+#if UA_MULTITHREADING >= 100
+
+#define UA_LOGASYNC_MESSAGESIZE 496
+
+typedef struct {
+    UA_LogLevel minLevel;
+    size_t recordsPerThread; /* Capacity of the ring buffer of each thread.
+                              * Rounded up to a power of two. Default: 256. */
+    size_t maxThreads;       /* Threads with their own ring buffer. Default: 16 */
+    UA_Boolean binary;       /* Write the binary format instead of text */
+    FILE *output;            /* Default: stdout */
+} UA_LogAsyncConfig;
+
+/* Allocates the logger and starts the background thread. Automatically
+ * cleared up via _clear. Remaining records are written before the background
+ * thread stops. */
+UA_EXPORT UA_Logger *
+UA_Log_Async_new(const UA_LogAsyncConfig *config);
+
+/* Wait until all records logged so far are written and flush the output */
+UA_EXPORT void
+UA_Log_Async_flush(UA_Logger *logger);
+
+/* Hand the ring buffer of the calling thread back to the logger. It is then
+ * reused for the next thread. Call this before a thread that has logged ends.
+ * If the thread logs again, it gets a new ring buffer. */
+UA_EXPORT void
+UA_Log_Async_releaseThread(UA_Logger *logger);
+
+/* Number of messages that were dropped because a ring buffer was full */
+UA_EXPORT UA_UInt64
+UA_Log_Async_getDropped(UA_Logger *logger);
+
+#endif
+
+_UA_END_DECLS
+
+#endif /* UA_LOG_ASYNC_H_ */
@@ -7,18 +7,58 @@
 #ifndef UA_NODESET_LOADER_DEFAULT_H_
 #define UA_NODESET_LOADER_DEFAULT_H_
 
-#include <open62541/util.h>
+#include <open62541/server.h>
 
 _UA_BEGIN_DECLS
 
+#ifdef UA_ENABLE_NODESETLOADER
+
 typedef void UA_NodeSetLoaderOptions;
 
 /* Load the typemodel at runtime, without the need to statically compile the model.
- * This is an alternative to the Python nodeset compiler approach. */
+ * This is an alternative to the Python nodeset compiler approach.
+ *
+ * UA_Server_loadNodesetStream below is an alternative that streams the file
+ * and inserts the nodes directly into the nodestore instead of going through
+ * the AddNodes service. If the model does not change
+ * between restarts, load the XML only once and persist the resulting
+ * information model with UA_Nodestore_saveSnapshot. Later startups use UA_Nodestore_loadSnapshot
+ * instead, which maps the binary image and materializes the nodes on demand
+ * (see open62541/plugin/nodestore_default.h). */
 UA_EXPORT UA_StatusCode
 UA_Server_loadNodeset(UA_Server *server, const char *nodeset2XmlFilePath,
                       UA_NodeSetLoaderOptions *options);
 
+#endif
+
+#ifdef UA_ENABLE_NODESETLOADER_STREAM
+
+typedef struct {
+    size_t batchSize;       /* Nodes per batch (default 1024) */
+    UA_Boolean parseInline; /* Do not use a separate thread for parsing */
+} UA_NodesetStreamOptions;
+
+/* Load a NodeSet2.xml file as a stream. The file is parsed in chunks with the
+ * libxml2 SAX interface, so the memory usage does not depend on the file size.
+ * With multithreading, the XML parser runs in a separate thread while the
+ * calling thread inserts the parsed nodes batch-wise directly into the
+ * nodestore. References to nodes defined later in the file are resolved after
+ * the last node was added.
+ *
+ * The nodes are taken as they are defined in the file. No node constructors
+ * are called and the children from the type definitions are not instantiated
+ * (the nodeset already contains them). The DataType definitions are not
+ * loaded. Values of a DataType other than the builtin types are skipped with a
+ * warning.
+ *
+ * This can only be called before the server is started. Returns
+ * UA_STATUSCODE_BADINVALIDSTATE otherwise. The options can be NULL. */
+UA_EXPORT UA_StatusCode
+UA_Server_loadNodesetStream(UA_Server *server, const char *nodeset2XmlFilePath,
+                            const UA_NodesetStreamOptions *options);
+
+#endif
+
 _UA_END_DECLS
 
 #endif /* UA_NODESET_LOADER_DEFAULT_H_ */
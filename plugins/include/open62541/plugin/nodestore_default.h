@@ -27,6 +27,29 @@ UA_Nodestore_HashMap(UA_Nodestore *ns);
 UA_EXPORT UA_StatusCode
 UA_Nodestore_ZipTree(UA_Nodestore *ns);
 
+/* Write a binary snapshot of the information model to a file. Namespace zero
+ * is not contained in the snapshot as it gets recreated by the server on
+ * startup. Only the references from namespace zero into other namespaces are
+ * retained.
+ *
+ * Node contexts, DataSources, value callbacks, method callbacks and lifecycle
+ * callbacks are not persisted. The namespaces have to be registered in the
+ * server in the same order before the snapshot is loaded. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_saveSnapshot(const UA_Nodestore *ns, const char *path);
+
+/* Wrap an initialized nodestore (e.g. from UA_Nodestore_HashMap) so that the
+ * nodes from the snapshot become visible. The snapshot file is memory-mapped
+ * where supported. The nodes are materialized into the wrapped nodestore when
+ * they are first accessed. So the startup time does not depend on the size of
+ * the information model in the snapshot.
+ *
+ * The custom types are required for decoding values of custom DataTypes. The
+ * DataTypeArray must outlive the nodestore. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_loadSnapshot(UA_Nodestore *ns, const char *path,
+                          const UA_DataTypeArray *customTypes);
+
 _UA_END_DECLS
 
 #endif /* UA_NODESTORE_DEFAULT_H_ */
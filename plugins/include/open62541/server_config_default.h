@@ -121,6 +121,19 @@ UA_EXPORT UA_StatusCode
 UA_ServerConfig_setBasics_withPort(UA_ServerConfig *conf,
                                    UA_UInt16 portNumber);
 
+#if UA_MULTITHREADING >= 100
+/* Adds reactor EventLoops with a TCP ConnectionManager each. Every reactor
+ * EventLoop serves a part of the incoming TCP connections in its own thread
+ * (see ``reactorEventLoops`` in the server config). A good choice for the
+ * count is the number of cores.
+ *
+ * @param config The configuration to manipulate
+ * @param count The number of EventLoops to add
+ */
+UA_EXPORT UA_StatusCode
+UA_ServerConfig_addReactorEventLoops(UA_ServerConfig *config, size_t count);
+#endif
+
 /* Adds the security policy ``SecurityPolicy#None`` to the server. A
  * server certificate may be supplied but is optional.
  *
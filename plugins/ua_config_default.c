@@ -301,6 +301,12 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
         if(udpCM)
             conf->eventLoop->registerEventSource(conf->eventLoop, (UA_EventSource *)udpCM);
 
+        /* Add the in-memory connection manager */
+        UA_ConnectionManager *memCM =
+            UA_ConnectionManager_new_Memory(UA_STRING("mem connection manager"));
+        if(memCM)
+            conf->eventLoop->registerEventSource(conf->eventLoop, (UA_EventSource *)memCM);
+
         /* Add the Ethernet connection manager */
 #ifdef __linux__
         UA_ConnectionManager *ethCM =
@@ -470,6 +476,10 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
     conf->maxNotificationsPerPublish = 1000;
     conf->enableRetransmissionQueue = true;
     conf->maxRetransmissionQueueSize = 0; /* unlimited */
+    conf->maxRetransmissionQueueBytes = 0; /* unlimited */
+    conf->maxServerRetransmissionQueueBytes = 0; /* unlimited */
+    conf->notificationSlabSize = 64;
+    conf->alignPublishingIntervals = false;
 # ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     conf->maxEventsPerNode = 0; /* unlimited */
 # endif
@@ -508,6 +518,7 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
 #if UA_MULTITHREADING >= 100
     conf->maxAsyncOperationQueueSize = 0;
     conf->asyncOperationTimeout = 120000; /* Async Operation Timeout in ms (2 minutes) */
+    conf->asyncOperationWorkers = 0;
 #endif
 
 #ifdef UA_ENABLE_PUBSUB
@@ -532,6 +543,33 @@ UA_ServerConfig_setBasics_withPort(UA_ServerConfig* conf, UA_UInt16 portNumber)
     return setDefaultConfig(conf, portNumber);
 }
 
+#if UA_MULTITHREADING >= 100
+UA_EXPORT UA_StatusCode
+UA_ServerConfig_addReactorEventLoops(UA_ServerConfig *config, size_t count) {
+    UA_EventLoop **reactors = (UA_EventLoop**)
+        UA_realloc(config->reactorEventLoops,
+                   sizeof(UA_EventLoop*) * (config->reactorEventLoopsSize + count));
+    if(!reactors)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    config->reactorEventLoops = reactors;
+
+    for(size_t i = 0; i < count; i++) {
+        UA_EventLoop *el = UA_EventLoop_new_POSIX(config->logging);
+        if(!el)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_ConnectionManager *tcpCM =
+            UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcp connection manager"));
+        if(!tcpCM) {
+            el->free(el);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        el->registerEventSource(el, (UA_EventSource *)tcpCM);
+        reactors[config->reactorEventLoopsSize++] = el;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
 UA_EXPORT UA_StatusCode
 UA_ServerConfig_addSecurityPolicyNone(UA_ServerConfig *config,
                                       const UA_ByteString *certificate) {
@@ -1126,6 +1164,11 @@ UA_ClientConfig_setDefault(UA_ClientConfig *config) {
         UA_ConnectionManager *udpCM =
             UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udp connection manager"));
         config->eventLoop->registerEventSource(config->eventLoop, (UA_EventSource *)udpCM);
+
+        /* Add the in-memory connection manager */
+        UA_ConnectionManager *memCM =
+            UA_ConnectionManager_new_Memory(UA_STRING("mem connection manager"));
+        config->eventLoop->registerEventSource(config->eventLoop, (UA_EventSource *)memCM);
     }
 
     if(config->localConnectionConfig.recvBufferSize == 0)
@@ -970,6 +970,8 @@ parseJSONConfig(UA_ServerConfig *config, UA_ByteString json_config) {
                     retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](&ctx, &config->asyncOperationTimeout, NULL);
                 else if(strcmp(field, "maxAsyncOperationQueueSize") == 0)
                     retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT64](&ctx, &config->maxAsyncOperationQueueSize, NULL);
+                else if(strcmp(field, "asyncOperationWorkers") == 0)
+                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT16](&ctx, &config->asyncOperationWorkers, NULL);
 #endif
 
 #ifdef UA_ENABLE_DISCOVERY
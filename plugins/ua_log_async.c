@@ -0,0 +1,439 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include <open62541/plugin/log_async.h>
+#include <open62541/types.h>
+
+#if UA_MULTITHREADING >= 100
+
+#ifdef UA_ARCHITECTURE_POSIX
+#include <unistd.h>
+#endif
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_YELLOW  "\x1b[33m"
+#define ANSI_COLOR_MAGENTA "\x1b[35m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+static const char *logLevelNames[6] = {"trace", "debug", "info",
+                                       "warn", "error", "fatal"};
+static const char *logLevelColors[6] = {"", "", ANSI_COLOR_GREEN,
+                                        ANSI_COLOR_YELLOW, ANSI_COLOR_RED,
+                                        ANSI_COLOR_MAGENTA};
+static const char *
+logCategoryNames[UA_LOGCATEGORIES] =
+    {"network", "channel", "session", "server", "client",
+     "userland", "securitypolicy", "eventloop", "pubsub", "discovery"};
+
+#define UA_LOGASYNC_DEFAULTRECORDS 256
+#define UA_LOGASYNC_DEFAULTTHREADS 16
+
+/* Atomic load with the UA_atomic_* primitives */
+#define LOAD(addr) UA_atomic_cmpxchg((void * volatile *)(addr), NULL, NULL)
+
+typedef struct {
+    void * volatile full; /* Set by the producer when the record is written.
+                           * Reset by the background thread after writing. */
+    UA_DateTime time;
+    UA_UInt16 level;
+    UA_UInt16 category;
+    UA_UInt32 length;
+    char message[UA_LOGASYNC_MESSAGESIZE];
+} LogRecord;
+
+/* Single-producer single-consumer ring. The producer is the owning thread, the
+ * consumer is the background thread. Every record has a flag that hands it
+ * between both sides. So the positions are private to the respective side. */
+typedef struct {
+    void * volatile owner;   /* Thread-local marker of the owning thread. NULL
+                              * if the ring is free. */
+    void * volatile records; /* LogRecord array. Allocated on the first use
+                              * and kept until the logger is cleared. */
+    void * volatile dropped; /* Counter, written by the owner */
+    size_t head;             /* Next record to write. Used by the owner. */
+    size_t tail;             /* Next record to read. Used by the writer. */
+    size_t reported;         /* Dropped messages that were reported */
+} LogRing;
+
+typedef struct {
+    UA_Logger logger; /* The public part. Must be the first member. */
+    uintptr_t id;     /* Unique for every logger instance */
+    UA_LogLevel minLevel;
+    UA_Boolean binary;
+    UA_Boolean colors;
+    FILE *output;
+    size_t ringSize;  /* Power of two */
+
+    /* One ring for each of the first threads. Further threads share the
+     * overflow ring. There, the producers are serialized with a lock. */
+    LogRing *rings;
+    size_t ringsSize;
+    LogRing shared;
+    UA_Lock sharedLock;
+
+    /* The background thread waits on the wakeup condition when all rings are
+     * empty. Producers only take the lock to signal the condition if the
+     * sleeping flag is set. */
+    UA_Thread writer;
+    UA_Lock lock;
+    UA_Condition wakeup;
+    UA_Condition drained; /* Signalled when all rings were found empty */
+    void * volatile sleeping;
+    UA_UInt64 drainedCount;
+    UA_Boolean stopped;
+} AsyncLog;
+
+/* Distinguish logger instances in the thread-local cache. The address of a
+ * cleared logger can be reused by the next one. */
+static void * volatile nextLoggerId = (void*)1;
+
+/* The address identifies the thread */
+static UA_THREAD_LOCAL char localMarker;
+static UA_THREAD_LOCAL uintptr_t localLoggerId = 0;
+static UA_THREAD_LOCAL LogRing *localRing = NULL;
+
+static LogRecord *
+getRecords(LogRing *ring) {
+    return (LogRecord*)LOAD(&ring->records);
+}
+
+/* Find or claim the ring of this thread. Returns the shared ring if all rings
+ * are taken. */
+static LogRing *
+getRing(AsyncLog *al) {
+    if(localLoggerId == al->id)
+        return localRing;
+
+    /* Only the thread itself claims a ring with its marker. So there is no
+     * race between the lookup and claiming a free ring. */
+    LogRing *ring = NULL;
+    for(size_t i = 0; i < al->ringsSize; i++) {
+        if(LOAD(&al->rings[i].owner) == &localMarker) {
+            ring = &al->rings[i];
+            break;
+        }
+    }
+    for(size_t i = 0; !ring && i < al->ringsSize; i++) {
+        if(UA_atomic_cmpxchg(&al->rings[i].owner, NULL, &localMarker) == NULL)
+            ring = &al->rings[i];
+    }
+
+    /* Allocate the records of a newly claimed ring */
+    if(ring && !getRecords(ring)) {
+        LogRecord *records = (LogRecord*)
+            UA_calloc(al->ringSize, sizeof(LogRecord));
+        if(records) {
+            UA_atomic_xchg(&ring->records, records);
+        } else {
+            UA_atomic_xchg(&ring->owner, NULL);
+            ring = NULL;
+        }
+    }
+    if(!ring)
+        ring = &al->shared;
+
+    localLoggerId = al->id;
+    localRing = ring;
+    return ring;
+}
+
+#ifdef __clang__
+__attribute__((__format__(__printf__, 4 , 0)))
+#endif
+static void
+UA_Log_Async_log(void *context, UA_LogLevel level, UA_LogCategory category,
+                 const char *msg, va_list args) {
+    AsyncLog *al = (AsyncLog*)context;
+    if(al->minLevel > level)
+        return;
+
+    LogRing *ring = getRing(al);
+    if(ring == &al->shared)
+        UA_LOCK(&al->sharedLock);
+
+    /* The ring is full if the next record was not written out yet. The
+     * records of the ring were allocated by this thread or before the shared
+     * ring was used. So no atomic load is required. */
+    LogRecord *r = &((LogRecord*)ring->records)[ring->head & (al->ringSize - 1)];
+    if(r->full) {
+        UA_atomic_xchg(&ring->dropped, (void*)((uintptr_t)ring->dropped + 1));
+        if(ring == &al->shared)
+            UA_UNLOCK(&al->sharedLock);
+        return;
+    }
+
+    /* Print the message into the record. The arguments of the message cannot
+     * outlive this call. */
+    r->time = UA_DateTime_now();
+    r->level = (UA_UInt16)level;
+    r->category = (UA_UInt16)category;
+    int len = vsnprintf(r->message, UA_LOGASYNC_MESSAGESIZE, msg, args);
+    if(len < 0)
+        len = 0;
+    else if(len >= UA_LOGASYNC_MESSAGESIZE)
+        len = UA_LOGASYNC_MESSAGESIZE - 1;
+    r->length = (UA_UInt32)len;
+
+    /* Publish the record (full memory barrier) */
+    UA_atomic_xchg(&r->full, r);
+    ring->head++;
+    if(ring == &al->shared)
+        UA_UNLOCK(&al->sharedLock);
+
+    /* Wake up the background thread. Only the first producer that sees the
+     * flag takes the lock. */
+    if(al->sleeping && UA_atomic_xchg(&al->sleeping, NULL)) {
+        UA_LOCK(&al->lock);
+        UA_CONDITION_SIGNAL(&al->wakeup);
+        UA_UNLOCK(&al->lock);
+    }
+}
+
+static void
+writeLE(FILE *out, UA_UInt64 v, size_t bytes) {
+    UA_Byte buf[8];
+    for(size_t i = 0; i < bytes; i++)
+        buf[i] = (UA_Byte)(v >> (8 * i));
+    fwrite(buf, 1, bytes, out);
+}
+
+static void
+writeRecord(AsyncLog *al, UA_Int64 tOffset, UA_DateTime time, UA_UInt16 level,
+            UA_UInt16 category, const char *message, UA_UInt32 length) {
+    if(al->binary) {
+        writeLE(al->output, (UA_UInt64)time, 8);
+        writeLE(al->output, level, 2);
+        writeLE(al->output, category, 2);
+        writeLE(al->output, length, 4);
+        fwrite(message, 1, length, al->output);
+        return;
+    }
+
+    int logLevelSlot = ((int)level / 100) - 1;
+    if(logLevelSlot < 0 || logLevelSlot > 5)
+        logLevelSlot = 5; /* Set to fatal if the level is outside the range */
+    const char *categoryName = (category < UA_LOGCATEGORIES) ?
+        logCategoryNames[category] : "unknown";
+    UA_DateTimeStruct dts = UA_DateTime_toStruct(time + tOffset);
+    fprintf(al->output, "[%04u-%02u-%02u %02u:%02u:%02u.%03u (UTC%+05d)] %s%s/%s%s\t%.*s\n",
+            dts.year, dts.month, dts.day, dts.hour, dts.min, dts.sec, dts.milliSec,
+            (int)(tOffset / UA_DATETIME_SEC / 36),
+            al->colors ? logLevelColors[logLevelSlot] : "",
+            logLevelNames[logLevelSlot], categoryName,
+            al->colors ? ANSI_COLOR_RESET : "", (int)length, message);
+}
+
+/* Write out all available records of a ring. Returns the number of written
+ * records. */
+static size_t
+drainRing(AsyncLog *al, LogRing *ring, UA_Int64 tOffset) {
+    LogRecord *records = getRecords(ring);
+    if(!records)
+        return 0;
+
+    size_t count = 0;
+    while(true) {
+        LogRecord *r = &records[ring->tail & (al->ringSize - 1)];
+        if(!LOAD(&r->full))
+            break;
+        writeRecord(al, tOffset, r->time, r->level, r->category,
+                    r->message, r->length);
+        UA_atomic_xchg(&r->full, NULL); /* Release the record to the producer */
+        ring->tail++;
+        count++;
+    }
+
+    /* Report dropped messages */
+    size_t dropped = (size_t)(uintptr_t)LOAD(&ring->dropped);
+    if(dropped != ring->reported) {
+        char message[64];
+        int len = snprintf(message, sizeof(message),
+                           "Async logger dropped %lu messages",
+                           (unsigned long)(dropped - ring->reported));
+        writeRecord(al, tOffset, UA_DateTime_now(), UA_LOGLEVEL_WARNING,
+                    UA_LOGCATEGORY_USERLAND, message, (UA_UInt32)len);
+        ring->reported = dropped;
+        count++;
+    }
+    return count;
+}
+
+static size_t
+drainRings(AsyncLog *al) {
+    UA_Int64 tOffset = UA_DateTime_localTimeUtcOffset();
+    size_t count = drainRing(al, &al->shared, tOffset);
+    for(size_t i = 0; i < al->ringsSize; i++)
+        count += drainRing(al, &al->rings[i], tOffset);
+    return count;
+}
+
+static UA_Boolean
+ringPending(AsyncLog *al, LogRing *ring) {
+    LogRecord *records = getRecords(ring);
+    if(!records)
+        return false;
+    return (LOAD(&records[ring->tail & (al->ringSize - 1)].full) != NULL ||
+            (size_t)(uintptr_t)LOAD(&ring->dropped) != ring->reported);
+}
+
+static UA_Boolean
+pendingRecords(AsyncLog *al) {
+    if(ringPending(al, &al->shared))
+        return true;
+    for(size_t i = 0; i < al->ringsSize; i++) {
+        if(ringPending(al, &al->rings[i]))
+            return true;
+    }
+    return false;
+}
+
+static UA_THREAD_FUNCTION(logWriter, context) {
+    AsyncLog *al = (AsyncLog*)context;
+    UA_LOCK(&al->lock);
+    while(true) {
+        UA_UNLOCK(&al->lock);
+        size_t written = drainRings(al);
+        if(written > 0)
+            fflush(al->output);
+        UA_LOCK(&al->lock);
+        if(written > 0)
+            continue;
+
+        /* Announce the sleep before the last check. A producer publishes the
+         * record before it looks at the flag. So either the record is seen
+         * here or the producer signals the condition. */
+        UA_atomic_xchg(&al->sleeping, al);
+        if(pendingRecords(al)) {
+            UA_atomic_xchg(&al->sleeping, NULL);
+            continue;
+        }
+
+        /* All rings are empty. Release the waiting flushes. */
+        al->drainedCount++;
+        UA_CONDITION_BROADCAST(&al->drained);
+        if(al->stopped)
+            break;
+
+        UA_CONDITION_WAIT(&al->wakeup, &al->lock);
+        UA_atomic_xchg(&al->sleeping, NULL);
+    }
+    UA_UNLOCK(&al->lock);
+    UA_THREAD_RETURN;
+}
+
+static void
+UA_Log_Async_delete(AsyncLog *al) {
+    for(size_t i = 0; i < al->ringsSize; i++)
+        UA_free(al->rings[i].records);
+    UA_free(al->rings);
+    UA_free(al->shared.records);
+    UA_CONDITION_DESTROY(&al->drained);
+    UA_CONDITION_DESTROY(&al->wakeup);
+    UA_LOCK_DESTROY(&al->lock);
+    UA_LOCK_DESTROY(&al->sharedLock);
+    UA_free(al);
+}
+
+static void
+UA_Log_Async_clear(UA_Logger *logger) {
+    AsyncLog *al = (AsyncLog*)logger;
+
+    /* Stop the background thread. It writes the remaining records first. */
+    UA_LOCK(&al->lock);
+    al->stopped = true;
+    UA_CONDITION_SIGNAL(&al->wakeup);
+    UA_UNLOCK(&al->lock);
+    UA_THREAD_JOIN(&al->writer);
+    UA_Log_Async_delete(al);
+}
+
+UA_Logger *
+UA_Log_Async_new(const UA_LogAsyncConfig *config) {
+    AsyncLog *al = (AsyncLog*)UA_calloc(1, sizeof(AsyncLog));
+    if(!al)
+        return NULL;
+
+    al->logger.log = UA_Log_Async_log;
+    al->logger.context = al;
+    al->logger.clear = UA_Log_Async_clear;
+    al->minLevel = config->minLevel;
+    al->binary = config->binary;
+    al->output = (config->output) ? config->output : stdout;
+#ifdef UA_ARCHITECTURE_POSIX
+    al->colors = !al->binary && isatty(fileno(al->output));
+#endif
+    UA_LOCK_INIT(&al->lock);
+    UA_LOCK_INIT(&al->sharedLock);
+    UA_CONDITION_INIT(&al->wakeup);
+    UA_CONDITION_INIT(&al->drained);
+
+    /* Get a unique id */
+    void *id;
+    do {
+        id = nextLoggerId;
+    } while(UA_atomic_cmpxchg(&nextLoggerId, id,
+                              (void*)((uintptr_t)id + 1)) != id);
+    al->id = (uintptr_t)id;
+
+    size_t records = (config->recordsPerThread > 0) ?
+        config->recordsPerThread : UA_LOGASYNC_DEFAULTRECORDS;
+    al->ringSize = 1;
+    while(al->ringSize < records)
+        al->ringSize <<= 1;
+
+    al->ringsSize = (config->maxThreads > 0) ?
+        config->maxThreads : UA_LOGASYNC_DEFAULTTHREADS;
+    al->rings = (LogRing*)UA_calloc(al->ringsSize, sizeof(LogRing));
+    al->shared.records = UA_calloc(al->ringSize, sizeof(LogRecord));
+    if(!al->rings || !al->shared.records) {
+        UA_Log_Async_delete(al);
+        return NULL;
+    }
+
+    if(UA_THREAD_CREATE(&al->writer, logWriter, al) != 0) {
+        UA_Log_Async_delete(al);
+        return NULL;
+    }
+    return &al->logger;
+}
+
+void
+UA_Log_Async_flush(UA_Logger *logger) {
+    AsyncLog *al = (AsyncLog*)logger;
+    UA_LOCK(&al->lock);
+    UA_UInt64 drainedCount = al->drainedCount;
+    UA_CONDITION_SIGNAL(&al->wakeup);
+    while(drainedCount == al->drainedCount)
+        UA_CONDITION_WAIT(&al->drained, &al->lock);
+    UA_UNLOCK(&al->lock);
+}
+
+void
+UA_Log_Async_releaseThread(UA_Logger *logger) {
+    AsyncLog *al = (AsyncLog*)logger;
+    for(size_t i = 0; i < al->ringsSize; i++) {
+        if(LOAD(&al->rings[i].owner) != &localMarker)
+            continue;
+        /* The remaining records are written by the background thread. The
+         * next owner continues after them. */
+        UA_atomic_xchg(&al->rings[i].owner, NULL);
+        break;
+    }
+    if(localLoggerId == al->id) {
+        localLoggerId = 0;
+        localRing = NULL;
+    }
+}
+
+UA_UInt64
+UA_Log_Async_getDropped(UA_Logger *logger) {
+    AsyncLog *al = (AsyncLog*)logger;
+    UA_UInt64 dropped = (uintptr_t)LOAD(&al->shared.dropped);
+    for(size_t i = 0; i < al->ringsSize; i++)
+        dropped += (uintptr_t)LOAD(&al->rings[i].dropped);
+    return dropped;
+}
+
+#endif /* UA_MULTITHREADING >= 100 */
@@ -0,0 +1,1788 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include <open62541/plugin/nodesetloader.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/log.h>
+#include <open62541/server.h>
+
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The NodeSet2.xml file is parsed as a stream of SAX events. The parser fills
+ * batches of nodes that are handed over to the insertion stage. With
+ * multithreading, the parser runs in a worker thread and the calling thread
+ * inserts the nodes directly into the nodestore. Only a few batches are in
+ * flight at any time. So the memory usage does not depend on the file size.
+ *
+ * The references are added to the new node right away if the target node is
+ * already known. All other references, and the inverse direction of every
+ * reference, are collected and resolved after the last node was inserted. The
+ * collected references are sorted by node, so that every node is edited only
+ * once in the final pass. */
+
+#define NODESET_DEFAULT_BATCHSIZE 1024
+#define NODESET_BATCHES 4 /* Batches in flight between parser and insertion */
+#define NODESET_CHUNKSIZE 65536
+
+/*****************/
+/* Parsed Nodes  */
+/*****************/
+
+typedef struct {
+    UA_NodeId refTypeId;
+    UA_NodeId targetId;
+    UA_Boolean isForward;
+} NodesetReference;
+
+typedef struct {
+    UA_NodeClass nodeClass;
+    UA_NodeId nodeId;
+    UA_QualifiedName browseName;
+    const UA_DataType *attrType;
+    union {
+        UA_NodeAttributes base;
+        UA_ObjectAttributes object;
+        UA_VariableAttributes variable;
+        UA_MethodAttributes method;
+        UA_ObjectTypeAttributes objectType;
+        UA_VariableTypeAttributes variableType;
+        UA_ReferenceTypeAttributes referenceType;
+        UA_DataTypeAttributes dataType;
+        UA_ViewAttributes view;
+    } attr;
+    size_t refsSize;
+    size_t refsCapacity;
+    NodesetReference *refs;
+} NodesetNode;
+
+typedef struct NodesetBatch {
+    struct NodesetBatch *next;
+    size_t nodesSize;
+    NodesetNode *nodes;
+} NodesetBatch;
+
+static void
+NodesetNode_clear(NodesetNode *n) {
+    UA_NodeId_clear(&n->nodeId);
+    UA_QualifiedName_clear(&n->browseName);
+    if(n->attrType)
+        UA_clear(&n->attr, n->attrType);
+    for(size_t i = 0; i < n->refsSize; i++) {
+        UA_NodeId_clear(&n->refs[i].refTypeId);
+        UA_NodeId_clear(&n->refs[i].targetId);
+    }
+    UA_free(n->refs);
+    memset(n, 0, sizeof(NodesetNode));
+}
+
+static NodesetBatch *
+NodesetBatch_new(size_t batchSize) {
+    NodesetBatch *b = (NodesetBatch*)UA_calloc(1, sizeof(NodesetBatch));
+    if(!b)
+        return NULL;
+    b->nodes = (NodesetNode*)UA_calloc(batchSize, sizeof(NodesetNode));
+    if(!b->nodes) {
+        UA_free(b);
+        return NULL;
+    }
+    return b;
+}
+
+static void
+NodesetBatch_delete(NodesetBatch *b) {
+    for(size_t i = 0; i < b->nodesSize; i++)
+        NodesetNode_clear(&b->nodes[i]);
+    UA_free(b->nodes);
+    UA_free(b);
+}
+
+static void
+logNodeId(const UA_Logger *logger, const char *msg, const UA_NodeId *id) {
+    UA_String idStr = UA_STRING_NULL;
+    UA_NodeId_print(id, &idStr);
+    UA_LOG_WARNING(logger, UA_LOGCATEGORY_SERVER, "Nodeset: %s %.*s",
+                   msg, (int)idStr.length, (char*)idStr.data);
+    UA_String_clear(&idStr);
+}
+
+/*******************/
+/* Insertion Stage */
+/*******************/
+
+/* One direction of a reference that is added in the final pass. The
+ * BrowseName hash of the target is already known for the inverse direction. */
+typedef struct {
+    UA_NodeId nodeId;
+    UA_NodeId refTypeId;
+    UA_NodeId targetId;
+    UA_Boolean isForward;
+    UA_Boolean hasTargetHash;
+    UA_UInt32 targetHash;
+} NodesetHalfReference;
+
+typedef struct {
+    UA_Nodestore *ns;
+    const UA_Logger *logger;
+    UA_StatusCode res;  /* First error */
+    UA_Boolean fatal;   /* Stop inserting */
+
+    /* Lookup from the ReferenceType NodeId to the ReferenceTypeIndex */
+    size_t refTypesSize;
+    UA_NodeId refTypeIds[UA_REFERENCETYPESET_MAX];
+    UA_Byte refTypeIndices[UA_REFERENCETYPESET_MAX];
+
+    /* Collected for the final pass */
+    size_t deferredSize;
+    size_t deferredCapacity;
+    NodesetHalfReference *deferred;
+    size_t newRefTypesSize;
+    UA_NodeId *newRefTypes;
+} NodesetInserter;
+
+static void
+setInsertError(NodesetInserter *in, UA_StatusCode res) {
+    if(in->res == UA_STATUSCODE_GOOD)
+        in->res = res;
+}
+
+static UA_Boolean
+resolveRefType(NodesetInserter *in, const UA_NodeId *refTypeId, UA_Byte *index) {
+    for(size_t i = 0; i < in->refTypesSize; i++) {
+        if(UA_NodeId_equal(&in->refTypeIds[i], refTypeId)) {
+            *index = in->refTypeIndices[i];
+            return true;
+        }
+    }
+
+    const UA_Node *node =
+        in->ns->getNode(in->ns->context, refTypeId, 0,
+                        UA_REFERENCETYPESET_NONE, UA_BROWSEDIRECTION_INVERSE);
+    if(!node)
+        return false;
+    UA_Boolean found = (node->head.nodeClass == UA_NODECLASS_REFERENCETYPE);
+    if(found) {
+        *index = node->referenceTypeNode.referenceTypeIndex;
+        if(in->refTypesSize < UA_REFERENCETYPESET_MAX &&
+           UA_NodeId_copy(refTypeId, &in->refTypeIds[in->refTypesSize]) ==
+           UA_STATUSCODE_GOOD) {
+            in->refTypeIndices[in->refTypesSize] = *index;
+            in->refTypesSize++;
+        }
+    }
+    in->ns->releaseNode(in->ns->context, node);
+    return found;
+}
+
+/* The BrowseName hash of the target is stored with the reference */
+static UA_Boolean
+getTargetHash(NodesetInserter *in, const UA_NodeId *targetId, UA_UInt32 *hash) {
+    const UA_Node *node =
+        in->ns->getNode(in->ns->context, targetId, 0,
+                        UA_REFERENCETYPESET_NONE, UA_BROWSEDIRECTION_INVERSE);
+    if(!node)
+        return false;
+    *hash = UA_QualifiedName_hash(&node->head.browseName);
+    in->ns->releaseNode(in->ns->context, node);
+    return true;
+}
+
+static UA_StatusCode
+deferReference(NodesetInserter *in, const UA_NodeId *nodeId,
+               const UA_NodeId *refTypeId, const UA_NodeId *targetId,
+               UA_Boolean isForward, const UA_UInt32 *targetHash) {
+    if(in->deferredSize == in->deferredCapacity) {
+        size_t cap = (in->deferredCapacity == 0) ? 1024 : in->deferredCapacity * 2;
+        NodesetHalfReference *d = (NodesetHalfReference*)
+            UA_realloc(in->deferred, cap * sizeof(NodesetHalfReference));
+        if(!d)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        in->deferred = d;
+        in->deferredCapacity = cap;
+    }
+    NodesetHalfReference *h = &in->deferred[in->deferredSize];
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &h->nodeId);
+    res |= UA_NodeId_copy(refTypeId, &h->refTypeId);
+    res |= UA_NodeId_copy(targetId, &h->targetId);
+    h->isForward = isForward;
+    h->hasTargetHash = (targetHash != NULL);
+    h->targetHash = (targetHash) ? *targetHash : 0;
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_NodeId_clear(&h->nodeId);
+        UA_NodeId_clear(&h->refTypeId);
+        UA_NodeId_clear(&h->targetId);
+        return res;
+    }
+    in->deferredSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+truncateDeferred(NodesetInserter *in, size_t size) {
+    for(size_t i = size; i < in->deferredSize; i++) {
+        UA_NodeId_clear(&in->deferred[i].nodeId);
+        UA_NodeId_clear(&in->deferred[i].refTypeId);
+        UA_NodeId_clear(&in->deferred[i].targetId);
+    }
+    in->deferredSize = size;
+}
+
+static UA_StatusCode
+addReferences(NodesetInserter *in, UA_Node *node, NodesetNode *n) {
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    UA_UInt32 nodeHash = UA_QualifiedName_hash(&node->head.browseName);
+    for(size_t i = 0; i < n->refsSize && res == UA_STATUSCODE_GOOD; i++) {
+        NodesetReference *r = &n->refs[i];
+
+        /* The inverse direction is always added in the final pass */
+        res = deferReference(in, &r->targetId, &r->refTypeId,
+                             &node->head.nodeId, !r->isForward, &nodeHash);
+        if(res != UA_STATUSCODE_GOOD)
+            break;
+
+        UA_Byte refTypeIndex;
+        UA_UInt32 targetHash;
+        if(!resolveRefType(in, &r->refTypeId, &refTypeIndex) ||
+           !getTargetHash(in, &r->targetId, &targetHash)) {
+            res = deferReference(in, &node->head.nodeId, &r->refTypeId,
+                                 &r->targetId, r->isForward, NULL);
+            continue;
+        }
+
+        UA_ExpandedNodeId target;
+        UA_ExpandedNodeId_init(&target);
+        target.nodeId = r->targetId;
+        res = UA_Node_addReference(node, refTypeIndex, r->isForward,
+                                   &target, targetHash);
+        if(res == UA_STATUSCODE_BADDUPLICATEREFERENCENOTALLOWED)
+            res = UA_STATUSCODE_GOOD;
+    }
+    return res;
+}
+
+static void
+insertNode(NodesetInserter *in, NodesetNode *n) {
+    UA_Nodestore *ns = in->ns;
+    UA_Node *node = ns->newNode(ns->context, n->nodeClass);
+    if(!node) {
+        in->fatal = true;
+        setInsertError(in, UA_STATUSCODE_BADOUTOFMEMORY);
+        return;
+    }
+
+    /* Move NodeId and BrowseName into the node. The BrowseName is used if the
+     * DisplayName is not defined. The nodes from a nodeset are complete
+     * (including the children from the type definition). They are not
+     * instantiated and no constructors are called. */
+    node->head.nodeId = n->nodeId;
+    UA_NodeId_init(&n->nodeId);
+    node->head.browseName = n->browseName;
+    UA_QualifiedName_init(&n->browseName);
+    node->head.constructed = true;
+
+    /* Move the value instead of copying it into the node */
+    UA_Variant value;
+    UA_Variant_init(&value);
+    if(n->nodeClass == UA_NODECLASS_VARIABLE) {
+        value = n->attr.variable.value;
+        UA_Variant_init(&n->attr.variable.value);
+    } else if(n->nodeClass == UA_NODECLASS_VARIABLETYPE) {
+        value = n->attr.variableType.value;
+        UA_Variant_init(&n->attr.variableType.value);
+    }
+
+    size_t deferredBefore = in->deferredSize;
+    UA_StatusCode res = UA_Node_setAttributes(node, &n->attr, n->attrType);
+    if(res == UA_STATUSCODE_GOOD && value.type) {
+        /* Same layout for VariableNode and VariableTypeNode */
+        node->variableNode.value.data.value.value = value;
+        node->variableNode.value.data.value.hasValue = true;
+        UA_Variant_init(&value);
+    }
+    UA_Variant_clear(&value);
+    if(res == UA_STATUSCODE_GOOD)
+        res = addReferences(in, node, n);
+    if(res != UA_STATUSCODE_GOOD) {
+        logNodeId(in->logger, "Could not create node", &node->head.nodeId);
+        truncateDeferred(in, deferredBefore);
+        ns->deleteNode(ns->context, node);
+        setInsertError(in, res);
+        return;
+    }
+
+    /* Insert into the nodestore. The node is deleted if this fails. Keep the
+     * NodeId for the log and to update the subtypes of new ReferenceTypes. */
+    UA_NodeId nodeId;
+    res = UA_NodeId_copy(&node->head.nodeId, &nodeId);
+    if(res != UA_STATUSCODE_GOOD) {
+        truncateDeferred(in, deferredBefore);
+        ns->deleteNode(ns->context, node);
+        setInsertError(in, res);
+        return;
+    }
+    res = ns->insertNode(ns->context, node, NULL);
+    if(res != UA_STATUSCODE_GOOD) {
+        logNodeId(in->logger, "Could not add node", &nodeId);
+        UA_NodeId_clear(&nodeId);
+        truncateDeferred(in, deferredBefore);
+        setInsertError(in, res);
+        return;
+    }
+
+    if(n->nodeClass != UA_NODECLASS_REFERENCETYPE) {
+        UA_NodeId_clear(&nodeId);
+        return;
+    }
+    UA_NodeId *rt = (UA_NodeId*)
+        UA_realloc(in->newRefTypes, (in->newRefTypesSize + 1) * sizeof(UA_NodeId));
+    if(!rt) {
+        UA_NodeId_clear(&nodeId);
+        setInsertError(in, UA_STATUSCODE_BADOUTOFMEMORY);
+        return;
+    }
+    in->newRefTypes = rt;
+    in->newRefTypes[in->newRefTypesSize++] = nodeId;
+}
+
+static void
+insertBatch(NodesetInserter *in, NodesetBatch *b) {
+    for(size_t i = 0; i < b->nodesSize; i++) {
+        if(!in->fatal)
+            insertNode(in, &b->nodes[i]);
+        NodesetNode_clear(&b->nodes[i]);
+    }
+    b->nodesSize = 0;
+}
+
+static int
+cmpHalfReference(const void *a, const void *b) {
+    const NodesetHalfReference *ha = (const NodesetHalfReference*)a;
+    const NodesetHalfReference *hb = (const NodesetHalfReference*)b;
+    return (int)UA_NodeId_order(&ha->nodeId, &hb->nodeId);
+}
+
+/* Add the collected references. Every node is edited only once. */
+static void
+resolveDeferred(NodesetInserter *in) {
+    UA_Nodestore *ns = in->ns;
+    if(in->deferredSize > 1)
+        qsort(in->deferred, in->deferredSize, sizeof(NodesetHalfReference),
+              cmpHalfReference);
+
+    size_t i = 0;
+    while(i < in->deferredSize) {
+        size_t end = i + 1;
+        while(end < in->deferredSize &&
+              UA_NodeId_equal(&in->deferred[end].nodeId, &in->deferred[i].nodeId))
+            end++;
+
+        UA_Node *node = NULL;
+        UA_StatusCode res = ns->getNodeCopy(ns->context, &in->deferred[i].nodeId, &node);
+        if(res != UA_STATUSCODE_GOOD) {
+            logNodeId(in->logger, "Skip the references of the unknown node",
+                      &in->deferred[i].nodeId);
+            i = end;
+            continue;
+        }
+
+        UA_Boolean changed = false;
+        for(; i < end; i++) {
+            NodesetHalfReference *h = &in->deferred[i];
+            UA_Byte refTypeIndex;
+            if(!resolveRefType(in, &h->refTypeId, &refTypeIndex)) {
+                logNodeId(in->logger, "Skip reference with the unknown "
+                          "ReferenceType", &h->refTypeId);
+                continue;
+            }
+            UA_UInt32 targetHash = h->targetHash;
+            if(!h->hasTargetHash && !getTargetHash(in, &h->targetId, &targetHash)) {
+                logNodeId(in->logger, "Skip reference to the unknown node",
+                          &h->targetId);
+                continue;
+            }
+            UA_ExpandedNodeId target;
+            UA_ExpandedNodeId_init(&target);
+            target.nodeId = h->targetId;
+            res = UA_Node_addReference(node, refTypeIndex, h->isForward,
+                                       &target, targetHash);
+            if(res == UA_STATUSCODE_GOOD)
+                changed = true;
+            else if(res != UA_STATUSCODE_BADDUPLICATEREFERENCENOTALLOWED)
+                setInsertError(in, res);
+
+            /* Type nodes receive a reference from every instance. Use the
+             * tree representation early. Otherwise every added reference
+             * searches the array for duplicates. */
+            for(size_t j = 0; j < node->head.referencesSize; j++) {
+                UA_NodeReferenceKind *rk = &node->head.references[j];
+                if(rk->targetsSize > 16 && !rk->hasRefTree)
+                    UA_NodeReferenceKind_switch(rk);
+            }
+        }
+
+        if(changed) {
+            res = ns->replaceNode(ns->context, node);
+            if(res != UA_STATUSCODE_GOOD)
+                setInsertError(in, res);
+        } else {
+            ns->deleteNode(ns->context, node);
+        }
+    }
+}
+
+static void *
+getSupertype(void *context, UA_ReferenceTarget *t) {
+    if(!UA_NodePointer_isLocal(t->targetId))
+        return NULL;
+    *(UA_NodeId*)context = UA_NodePointer_toNodeId(t->targetId);
+    return context;
+}
+
+/* Add the index of new ReferenceTypes to the subtype-sets of their supertypes.
+ * This is otherwise done by the server when a ReferenceType is added. */
+static void
+propagateSubtypes(NodesetInserter *in, const UA_NodeId *refTypeId) {
+    UA_Nodestore *ns = in->ns;
+    UA_Byte index;
+    if(!resolveRefType(in, refTypeId, &index))
+        return;
+    UA_ReferenceTypeSet subType = UA_REFTYPESET(index);
+
+    UA_NodeId current;
+    if(UA_NodeId_copy(refTypeId, &current) != UA_STATUSCODE_GOOD)
+        return;
+    for(size_t depth = 0; depth < UA_REFERENCETYPESET_MAX; depth++) {
+        const UA_Node *node =
+            ns->getNode(ns->context, &current, 0,
+                        UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE),
+                        UA_BROWSEDIRECTION_INVERSE);
+        if(!node)
+            break;
+        UA_NodeId parent = UA_NODEID_NULL;
+        void *found = NULL;
+        for(size_t i = 0; i < node->head.referencesSize && !found; i++) {
+            UA_NodeReferenceKind *rk = &node->head.references[i];
+            if(rk->isInverse &&
+               rk->referenceTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE)
+                found = UA_NodeReferenceKind_iterate(rk, getSupertype, &parent);
+        }
+        UA_NodeId_clear(&current);
+        UA_StatusCode res = UA_NodeId_copy(&parent, &current);
+        ns->releaseNode(ns->context, node);
+        if(!found || res != UA_STATUSCODE_GOOD)
+            break;
+
+        UA_Node *copy = NULL;
+        res = ns->getNodeCopy(ns->context, &current, &copy);
+        if(res != UA_STATUSCODE_GOOD)
+            break;
+        if(copy->head.nodeClass != UA_NODECLASS_REFERENCETYPE) {
+            ns->deleteNode(ns->context, copy);
+            break;
+        }
+        copy->referenceTypeNode.subTypes =
+            UA_ReferenceTypeSet_union(copy->referenceTypeNode.subTypes, subType);
+        ns->replaceNode(ns->context, copy);
+    }
+    UA_NodeId_clear(&current);
+}
+
+static void
+NodesetInserter_clear(NodesetInserter *in) {
+    for(size_t i = 0; i < in->refTypesSize; i++)
+        UA_NodeId_clear(&in->refTypeIds[i]);
+    truncateDeferred(in, 0);
+    UA_free(in->deferred);
+    UA_Array_delete(in->newRefTypes, in->newRefTypesSize, &UA_TYPES[UA_TYPES_NODEID]);
+}
+
+/****************************/
+/* Hand-over between Stages */
+/****************************/
+
+typedef struct {
+    NodesetInserter *inserter;
+    UA_Boolean threaded;
+#if UA_MULTITHREADING >= 100
+    UA_Lock lock;
+    UA_Condition cond;
+    NodesetBatch *full;     /* FIFO of parsed batches */
+    NodesetBatch *fullLast;
+    NodesetBatch *free;     /* Batches ready to be filled */
+    UA_Boolean done;        /* The parser has finished */
+    UA_Boolean aborted;     /* The insertion has failed */
+#endif
+} NodesetPipe;
+
+/**********/
+/* Parser */
+/**********/
+
+typedef enum {
+    NODESET_SECTION_NONE = 0,
+    NODESET_SECTION_NAMESPACES,
+    NODESET_SECTION_ALIASES,
+    NODESET_SECTION_NODE
+} NodesetSection;
+
+typedef enum {
+    NODESET_FIELD_NONE = 0,
+    NODESET_FIELD_DISPLAYNAME,
+    NODESET_FIELD_DESCRIPTION,
+    NODESET_FIELD_INVERSENAME,
+    NODESET_FIELD_REFERENCES,
+    NODESET_FIELD_VALUE
+} NodesetField;
+
+typedef struct {
+    UA_String alias;
+    UA_NodeId nodeId;
+} NodesetAlias;
+
+typedef struct {
+    UA_Server *server;
+    const UA_Logger *logger;
+    xmlParserCtxtPtr ctxt;
+    UA_StatusCode res;
+    size_t batchSize;
+    NodesetPipe *pipe;
+    NodesetBatch *batch;
+
+    /* Position in the document */
+    size_t depth;
+    NodesetSection section;
+    NodesetField field;
+
+    /* Character data of the current element (zero-terminated) */
+    UA_Boolean collect;
+    char *text;
+    size_t textSize;
+    size_t textCapacity;
+
+    /* Map the namespace indices of the file to the server */
+    size_t nsMappingSize;
+    UA_UInt16 *nsMapping;
+
+    /* Sorted after the Aliases section for the lookup */
+    size_t aliasesSize;
+    NodesetAlias *aliases;
+    UA_String currentAlias;
+
+    /* Current node */
+    NodesetNode *node;
+    UA_String locale;
+    NodesetReference ref;
+
+    /* Current value */
+    const UA_DataType *valueType;
+    UA_Boolean valueArray;
+    UA_Boolean valueSkip;
+    size_t valueDepth; /* Depth of the elements with the encoded values */
+    size_t valueSize;
+    size_t valueCapacity;
+    void *valueData;
+    char valueMember[32];
+} NodesetParser;
+
+static void
+stopParser(NodesetParser *p, UA_StatusCode res) {
+    if(p->res == UA_STATUSCODE_GOOD)
+        p->res = res;
+    xmlStopParser(p->ctxt);
+}
+
+static UA_String
+trimmed(const char *s, size_t len) {
+    while(len > 0 && (*s == ' ' || *s == '\n' || *s == '\r' || *s == '\t')) {
+        s++;
+        len--;
+    }
+    while(len > 0 && (s[len-1] == ' ' || s[len-1] == '\n' ||
+                      s[len-1] == '\r' || s[len-1] == '\t'))
+        len--;
+    UA_String str = {len, (UA_Byte*)(uintptr_t)s};
+    return str;
+}
+
+static UA_StatusCode
+mapNamespace(const NodesetParser *p, UA_UInt16 *nsIndex) {
+    if(*nsIndex >= p->nsMappingSize)
+        return UA_STATUSCODE_BADNODEIDINVALID;
+    *nsIndex = p->nsMapping[*nsIndex];
+    return UA_STATUSCODE_GOOD;
+}
+
+static int
+cmpAlias(const void *a, const void *b) {
+    const UA_String *sa = &((const NodesetAlias*)a)->alias;
+    const UA_String *sb = &((const NodesetAlias*)b)->alias;
+    size_t len = (sa->length < sb->length) ? sa->length : sb->length;
+    int c = (len > 0) ? memcmp(sa->data, sb->data, len) : 0;
+    if(c != 0)
+        return c;
+    if(sa->length == sb->length)
+        return 0;
+    return (sa->length < sb->length) ? -1 : 1;
+}
+
+/* Resolve an alias or parse the NodeId and map the namespace index */
+static UA_StatusCode
+parseNodeId(const NodesetParser *p, const char *s, size_t len, UA_NodeId *id) {
+    NodesetAlias key;
+    key.alias = trimmed(s, len);
+    if(p->aliasesSize > 0) {
+        const NodesetAlias *a = (const NodesetAlias*)
+            bsearch(&key, p->aliases, p->aliasesSize, sizeof(NodesetAlias), cmpAlias);
+        if(a)
+            return UA_NodeId_copy(&a->nodeId, id);
+    }
+    UA_StatusCode res = UA_NodeId_parse(id, key.alias);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = mapNamespace(p, &id->namespaceIndex);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_NodeId_clear(id);
+    return res;
+}
+
+/* BrowseNames have the form "1:Name" */
+static UA_StatusCode
+parseQualifiedName(const NodesetParser *p, const char *s, size_t len,
+                   UA_QualifiedName *qn) {
+    UA_QualifiedName_init(qn);
+    size_t pos = 0;
+    UA_UInt32 nsIndex = 0;
+    while(pos < len && s[pos] >= '0' && s[pos] <= '9' && nsIndex <= UA_UINT16_MAX) {
+        nsIndex = nsIndex * 10 + (UA_UInt32)(s[pos] - '0');
+        pos++;
+    }
+    if(pos > 0 && pos < len && s[pos] == ':' && nsIndex <= UA_UINT16_MAX) {
+        qn->namespaceIndex = (UA_UInt16)nsIndex;
+        s += pos + 1;
+        len -= pos + 1;
+    }
+    UA_StatusCode res = mapNamespace(p, &qn->namespaceIndex);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_String name = {len, (UA_Byte*)(uintptr_t)s};
+    return UA_String_copy(&name, &qn->name);
+}
+
+static UA_Boolean
+parseBoolean(const UA_String s) {
+    return (s.length == 4 && strncmp((const char*)s.data, "true", 4) == 0) ||
+        (s.length == 1 && s.data[0] == '1');
+}
+
+static UA_StatusCode
+parseInteger(const UA_String s, UA_Int64 min, UA_Int64 max, UA_Int64 *out) {
+    char buf[32];
+    if(s.length == 0 || s.length >= sizeof(buf))
+        return UA_STATUSCODE_BADDECODINGERROR;
+    memcpy(buf, s.data, s.length);
+    buf[s.length] = 0;
+    char *end = NULL;
+    long long v = strtoll(buf, &end, 10);
+    if(*end != 0 || v < min || v > max)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    *out = (UA_Int64)v;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+parseUnsigned(const UA_String s, UA_UInt64 max, UA_UInt64 *out) {
+    char buf[32];
+    if(s.length == 0 || s.length >= sizeof(buf) || s.data[0] == '-')
+        return UA_STATUSCODE_BADDECODINGERROR;
+    memcpy(buf, s.data, s.length);
+    buf[s.length] = 0;
+    char *end = NULL;
+    unsigned long long v = strtoull(buf, &end, 10);
+    if(*end != 0 || v > max)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    *out = (UA_UInt64)v;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+parseDouble(const UA_String s, UA_Double *out) {
+    char buf[64];
+    if(s.length == 0 || s.length >= sizeof(buf))
+        return UA_STATUSCODE_BADDECODINGERROR;
+    memcpy(buf, s.data, s.length);
+    buf[s.length] = 0;
+    char *end = NULL;
+    *out = strtod(buf, &end);
+    return (*end == 0) ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADDECODINGERROR;
+}
+
+/* xs:dateTime in UTC, e.g. 2024-01-31T12:00:00.123Z */
+static UA_StatusCode
+parseDateTime(const UA_String s, UA_DateTime *out) {
+    char buf[40];
+    if(s.length < 19 || s.length >= sizeof(buf))
+        return UA_STATUSCODE_BADDECODINGERROR;
+    memcpy(buf, s.data, s.length);
+    buf[s.length] = 0;
+    int year, month, day, hour, min, sec, len = 0;
+    if(sscanf(buf, "%4d-%2d-%2dT%2d:%2d:%2d%n", &year, &month, &day,
+              &hour, &min, &sec, &len) != 6 || len != 19)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    UA_DateTimeStruct dts;
+    memset(&dts, 0, sizeof(UA_DateTimeStruct));
+    dts.year = (UA_Int16)year;
+    dts.month = (UA_UInt16)month;
+    dts.day = (UA_UInt16)day;
+    dts.hour = (UA_UInt16)hour;
+    dts.min = (UA_UInt16)min;
+    dts.sec = (UA_UInt16)sec;
+    UA_DateTime frac = 0;
+    const char *pos = &buf[19];
+    if(*pos == '.') {
+        UA_DateTime scale = UA_DATETIME_SEC;
+        for(pos++; *pos >= '0' && *pos <= '9'; pos++) {
+            scale /= 10;
+            frac += (*pos - '0') * scale;
+        }
+    }
+    if(*pos != 0 && strcmp(pos, "Z") != 0)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    *out = UA_DateTime_fromStruct(dts) + frac;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* The builtin types that can be decoded from the Value element */
+static const struct {
+    const char *name;
+    UA_UInt16 typeIndex;
+} valueTypes[] = {
+    {"Boolean", UA_TYPES_BOOLEAN}, {"SByte", UA_TYPES_SBYTE},
+    {"Byte", UA_TYPES_BYTE}, {"Int16", UA_TYPES_INT16},
+    {"UInt16", UA_TYPES_UINT16}, {"Int32", UA_TYPES_INT32},
+    {"UInt32", UA_TYPES_UINT32}, {"Int64", UA_TYPES_INT64},
+    {"UInt64", UA_TYPES_UINT64}, {"Float", UA_TYPES_FLOAT},
+    {"Double", UA_TYPES_DOUBLE}, {"String", UA_TYPES_STRING},
+    {"DateTime", UA_TYPES_DATETIME}, {"Guid", UA_TYPES_GUID},
+    {"ByteString", UA_TYPES_BYTESTRING}, {"NodeId", UA_TYPES_NODEID},
+    {"ExpandedNodeId", UA_TYPES_EXPANDEDNODEID},
+    {"StatusCode", UA_TYPES_STATUSCODE},
+    {"QualifiedName", UA_TYPES_QUALIFIEDNAME},
+    {"LocalizedText", UA_TYPES_LOCALIZEDTEXT}
+};
+
+/* Types that are encoded as the text content of the element (and not in
+ * member elements) */
+static UA_Boolean
+isTextValue(const UA_DataType *type) {
+    return type->typeKind <= UA_DATATYPEKIND_DOUBLE ||
+        type->typeKind == UA_DATATYPEKIND_STRING ||
+        type->typeKind == UA_DATATYPEKIND_DATETIME ||
+        type->typeKind == UA_DATATYPEKIND_BYTESTRING;
+}
+
+static UA_StatusCode
+decodeValue(const NodesetParser *p, void *dst, const char *member) {
+    const UA_DataType *type = p->valueType;
+    UA_String raw = {p->textSize, (UA_Byte*)p->text};
+    UA_String s = trimmed(p->text, p->textSize);
+    UA_Int64 i = 0;
+    UA_UInt64 u = 0;
+    UA_Double d = 0.0;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    switch(type->typeKind) {
+    case UA_DATATYPEKIND_BOOLEAN:
+        *(UA_Boolean*)dst = parseBoolean(s);
+        break;
+    case UA_DATATYPEKIND_SBYTE:
+        res = parseInteger(s, UA_SBYTE_MIN, UA_SBYTE_MAX, &i);
+        *(UA_SByte*)dst = (UA_SByte)i;
+        break;
+    case UA_DATATYPEKIND_INT16:
+        res = parseInteger(s, UA_INT16_MIN, UA_INT16_MAX, &i);
+        *(UA_Int16*)dst = (UA_Int16)i;
+        break;
+    case UA_DATATYPEKIND_INT32:
+        res = parseInteger(s, UA_INT32_MIN, UA_INT32_MAX, &i);
+        *(UA_Int32*)dst = (UA_Int32)i;
+        break;
+    case UA_DATATYPEKIND_INT64:
+        res = parseInteger(s, UA_INT64_MIN, UA_INT64_MAX, &i);
+        *(UA_Int64*)dst = i;
+        break;
+    case UA_DATATYPEKIND_BYTE:
+        res = parseUnsigned(s, UA_BYTE_MAX, &u);
+        *(UA_Byte*)dst = (UA_Byte)u;
+        break;
+    case UA_DATATYPEKIND_UINT16:
+        res = parseUnsigned(s, UA_UINT16_MAX, &u);
+        *(UA_UInt16*)dst = (UA_UInt16)u;
+        break;
+    case UA_DATATYPEKIND_UINT32:
+        res = parseUnsigned(s, UA_UINT32_MAX, &u);
+        *(UA_UInt32*)dst = (UA_UInt32)u;
+        break;
+    case UA_DATATYPEKIND_UINT64:
+        res = parseUnsigned(s, UA_UINT64_MAX, &u);
+        *(UA_UInt64*)dst = u;
+        break;
+    case UA_DATATYPEKIND_FLOAT:
+        res = parseDouble(s, &d);
+        *(UA_Float*)dst = (UA_Float)d;
+        break;
+    case UA_DATATYPEKIND_DOUBLE:
+        res = parseDouble(s, &d);
+        *(UA_Double*)dst = d;
+        break;
+    case UA_DATATYPEKIND_STRING:
+        res = UA_String_copy(&raw, (UA_String*)dst);
+        break;
+    case UA_DATATYPEKIND_DATETIME:
+        res = parseDateTime(s, (UA_DateTime*)dst);
+        break;
+    case UA_DATATYPEKIND_BYTESTRING:
+        res = UA_ByteString_fromBase64((UA_ByteString*)dst, &s);
+        break;
+    case UA_DATATYPEKIND_GUID:
+        if(strcmp(member, "String") == 0)
+            res = UA_Guid_parse((UA_Guid*)dst, s);
+        break;
+    case UA_DATATYPEKIND_NODEID:
+        if(strcmp(member, "Identifier") == 0)
+            res = parseNodeId(p, (const char*)s.data, s.length, (UA_NodeId*)dst);
+        break;
+    case UA_DATATYPEKIND_EXPANDEDNODEID:
+        if(strcmp(member, "Identifier") == 0)
+            res = parseNodeId(p, (const char*)s.data, s.length,
+                              &((UA_ExpandedNodeId*)dst)->nodeId);
+        break;
+    case UA_DATATYPEKIND_STATUSCODE:
+        if(strcmp(member, "Code") == 0) {
+            res = parseUnsigned(s, UA_UINT32_MAX, &u);
+            *(UA_StatusCode*)dst = (UA_StatusCode)u;
+        }
+        break;
+    case UA_DATATYPEKIND_QUALIFIEDNAME: {
+        UA_QualifiedName *qn = (UA_QualifiedName*)dst;
+        if(strcmp(member, "NamespaceIndex") == 0) {
+            res = parseUnsigned(s, UA_UINT16_MAX, &u);
+            qn->namespaceIndex = (UA_UInt16)u;
+            if(res == UA_STATUSCODE_GOOD)
+                res = mapNamespace(p, &qn->namespaceIndex);
+        } else if(strcmp(member, "Name") == 0) {
+            UA_String_clear(&qn->name);
+            res = UA_String_copy(&raw, &qn->name);
+        }
+        break;
+    }
+    case UA_DATATYPEKIND_LOCALIZEDTEXT: {
+        UA_LocalizedText *lt = (UA_LocalizedText*)dst;
+        if(strcmp(member, "Locale") == 0) {
+            UA_String_clear(&lt->locale);
+            res = UA_String_copy(&s, &lt->locale);
+        } else if(strcmp(member, "Text") == 0) {
+            UA_String_clear(&lt->text);
+            res = UA_String_copy(&raw, &lt->text);
+        }
+        break;
+    }
+    default:
+        res = UA_STATUSCODE_BADNOTSUPPORTED;
+        break;
+    }
+    return res;
+}
+
+static void
+clearValue(NodesetParser *p) {
+    if(p->valueData)
+        UA_Array_delete(p->valueData, p->valueSize, p->valueType);
+    p->valueData = NULL;
+    p->valueSize = 0;
+    p->valueCapacity = 0;
+    p->valueType = NULL;
+    p->valueArray = false;
+    p->valueSkip = false;
+    p->valueMember[0] = 0;
+}
+
+static void
+skipValue(NodesetParser *p, const char *reason) {
+    if(!p->valueSkip)
+        logNodeId(p->logger, reason, &p->node->nodeId);
+    if(p->valueData)
+        UA_Array_delete(p->valueData, p->valueSize, p->valueType);
+    p->valueData = NULL;
+    p->valueSize = 0;
+    p->valueCapacity = 0;
+    p->valueSkip = true;
+}
+
+static void
+newValueElement(NodesetParser *p) {
+    if(p->valueSize == p->valueCapacity) {
+        size_t cap = (p->valueCapacity == 0) ? (p->valueArray ? 8 : 1) :
+            p->valueCapacity * 2;
+        void *data = UA_realloc(p->valueData, cap * p->valueType->memSize);
+        if(!data) {
+            stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+            return;
+        }
+        p->valueData = data;
+        p->valueCapacity = cap;
+    }
+    memset((UA_Byte*)p->valueData + (p->valueSize * p->valueType->memSize), 0,
+           p->valueType->memSize);
+    p->valueSize++;
+}
+
+static void
+startValueElement(NodesetParser *p, const char *name) {
+    if(p->valueSkip)
+        return;
+
+    /* The element name defines the type */
+    if(p->depth == 4) {
+        p->valueArray = (strncmp(name, "ListOf", 6) == 0);
+        const char *typeName = p->valueArray ? &name[6] : name;
+        for(size_t i = 0; i < sizeof(valueTypes) / sizeof(valueTypes[0]); i++) {
+            if(strcmp(typeName, valueTypes[i].name) == 0) {
+                p->valueType = &UA_TYPES[valueTypes[i].typeIndex];
+                break;
+            }
+        }
+        if(!p->valueType) {
+            skipValue(p, "Skip the value with an unsupported type of node");
+            return;
+        }
+        p->valueDepth = p->valueArray ? 5 : 4;
+    }
+
+    if(p->depth == p->valueDepth) {
+        newValueElement(p);
+        p->collect = true;
+    } else if(p->depth == p->valueDepth + 1) {
+        strncpy(p->valueMember, name, sizeof(p->valueMember) - 1);
+        p->valueMember[sizeof(p->valueMember) - 1] = 0;
+        p->collect = true;
+    }
+}
+
+static void
+endValueElement(NodesetParser *p) {
+    if(p->valueSkip || !p->valueType || p->valueSize == 0)
+        return;
+    void *dst = (UA_Byte*)p->valueData +
+        ((p->valueSize - 1) * p->valueType->memSize);
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(p->depth == p->valueDepth && isTextValue(p->valueType))
+        res = decodeValue(p, dst, "");
+    else if(p->depth == p->valueDepth + 1 && !isTextValue(p->valueType))
+        res = decodeValue(p, dst, p->valueMember);
+    if(res != UA_STATUSCODE_GOOD)
+        skipValue(p, "Skip the value that cannot be decoded of node");
+}
+
+static void
+endValue(NodesetParser *p) {
+    UA_Variant *v = NULL;
+    if(p->node->nodeClass == UA_NODECLASS_VARIABLE)
+        v = &p->node->attr.variable.value;
+    else if(p->node->nodeClass == UA_NODECLASS_VARIABLETYPE)
+        v = &p->node->attr.variableType.value;
+    if(!v || p->valueSkip || !p->valueType ||
+       (!p->valueArray && p->valueSize != 1)) {
+        clearValue(p);
+        return;
+    }
+
+    if(p->valueArray) {
+        if(p->valueSize == 0) {
+            UA_free(p->valueData);
+            p->valueData = UA_EMPTY_ARRAY_SENTINEL;
+        }
+        UA_Variant_setArray(v, p->valueData, p->valueSize, p->valueType);
+    } else {
+        UA_Variant_setScalar(v, p->valueData, p->valueType);
+    }
+    p->valueData = NULL;
+    p->valueSize = 0;
+    clearValue(p);
+}
+
+/* Attributes are given as (localname, prefix, URI, value, end) */
+static UA_StatusCode
+parseNodeAttribute(NodesetParser *p, const char *name, const char *s, size_t len) {
+    NodesetNode *n = p->node;
+    UA_String str = trimmed(s, len);
+    UA_Int64 i = 0;
+    UA_UInt64 u = 0;
+    UA_Double d = 0.0;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+
+    if(strcmp(name, "NodeId") == 0)
+        return parseNodeId(p, s, len, &n->nodeId);
+    if(strcmp(name, "BrowseName") == 0)
+        return parseQualifiedName(p, s, len, &n->browseName);
+    if(strcmp(name, "WriteMask") == 0) {
+        res = parseUnsigned(str, UA_UINT32_MAX, &u);
+        n->attr.base.writeMask = (UA_UInt32)u;
+        return res;
+    }
+
+    switch(n->nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        if(strcmp(name, "EventNotifier") == 0) {
+            res = parseUnsigned(str, UA_BYTE_MAX, &u);
+            n->attr.object.eventNotifier = (UA_Byte)u;
+        }
+        break;
+    case UA_NODECLASS_VARIABLE:
+    case UA_NODECLASS_VARIABLETYPE: {
+        /* The common members are at different offsets */
+        UA_NodeId *dataType; UA_Int32 *valueRank;
+        size_t *arrayDimensionsSize; UA_UInt32 **arrayDimensions;
+        if(n->nodeClass == UA_NODECLASS_VARIABLE) {
+            dataType = &n->attr.variable.dataType;
+            valueRank = &n->attr.variable.valueRank;
+            arrayDimensionsSize = &n->attr.variable.arrayDimensionsSize;
+            arrayDimensions = &n->attr.variable.arrayDimensions;
+            if(strcmp(name, "AccessLevel") == 0) {
+                res = parseUnsigned(str, UA_BYTE_MAX, &u);
+                n->attr.variable.accessLevel = (UA_Byte)u;
+                break;
+            }
+            if(strcmp(name, "MinimumSamplingInterval") == 0) {
+                res = parseDouble(str, &d);
+                n->attr.variable.minimumSamplingInterval = d;
+                break;
+            }
+            if(strcmp(name, "Historizing") == 0) {
+                n->attr.variable.historizing = parseBoolean(str);
+                break;
+            }
+        } else {
+            dataType = &n->attr.variableType.dataType;
+            valueRank = &n->attr.variableType.valueRank;
+            arrayDimensionsSize = &n->attr.variableType.arrayDimensionsSize;
+            arrayDimensions = &n->attr.variableType.arrayDimensions;
+            if(strcmp(name, "IsAbstract") == 0) {
+                n->attr.variableType.isAbstract = parseBoolean(str);
+                break;
+            }
+        }
+        if(strcmp(name, "DataType") == 0) {
+            UA_NodeId_clear(dataType);
+            res = parseNodeId(p, s, len, dataType);
+        } else if(strcmp(name, "ValueRank") == 0) {
+            res = parseInteger(str, UA_INT32_MIN, UA_INT32_MAX, &i);
+            *valueRank = (UA_Int32)i;
+        } else if(strcmp(name, "ArrayDimensions") == 0) {
+            /* Comma-separated list */
+            for(size_t pos = 0; pos < str.length && res == UA_STATUSCODE_GOOD;) {
+                size_t end = pos;
+                while(end < str.length && str.data[end] != ',')
+                    end++;
+                UA_String dim = {end - pos, &str.data[pos]};
+                res = parseUnsigned(trimmed((const char*)dim.data, dim.length),
+                                    UA_UINT32_MAX, &u);
+                if(res == UA_STATUSCODE_GOOD) {
+                    UA_UInt32 dimValue = (UA_UInt32)u;
+                    res = UA_Array_appendCopy((void**)arrayDimensions,
+                                              arrayDimensionsSize, &dimValue,
+                                              &UA_TYPES[UA_TYPES_UINT32]);
+                }
+                pos = end + 1;
+            }
+        }
+        break;
+    }
+    case UA_NODECLASS_METHOD:
+        if(strcmp(name, "Executable") == 0)
+            n->attr.method.executable = parseBoolean(str);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        if(strcmp(name, "IsAbstract") == 0)
+            n->attr.objectType.isAbstract = parseBoolean(str);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        if(strcmp(name, "IsAbstract") == 0)
+            n->attr.referenceType.isAbstract = parseBoolean(str);
+        else if(strcmp(name, "Symmetric") == 0)
+            n->attr.referenceType.symmetric = parseBoolean(str);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        if(strcmp(name, "IsAbstract") == 0)
+            n->attr.dataType.isAbstract = parseBoolean(str);
+        break;
+    case UA_NODECLASS_VIEW:
+        if(strcmp(name, "ContainsNoLoops") == 0) {
+            n->attr.view.containsNoLoops = parseBoolean(str);
+        } else if(strcmp(name, "EventNotifier") == 0) {
+            res = parseUnsigned(str, UA_BYTE_MAX, &u);
+            n->attr.view.eventNotifier = (UA_Byte)u;
+        }
+        break;
+    default:
+        break;
+    }
+    return res;
+}
+
+static const struct {
+    const char *name;
+    UA_NodeClass nodeClass;
+    UA_UInt16 attrTypeIndex;
+} nodeElements[] = {
+    {"UAObject", UA_NODECLASS_OBJECT, UA_TYPES_OBJECTATTRIBUTES},
+    {"UAVariable", UA_NODECLASS_VARIABLE, UA_TYPES_VARIABLEATTRIBUTES},
+    {"UAMethod", UA_NODECLASS_METHOD, UA_TYPES_METHODATTRIBUTES},
+    {"UAObjectType", UA_NODECLASS_OBJECTTYPE, UA_TYPES_OBJECTTYPEATTRIBUTES},
+    {"UAVariableType", UA_NODECLASS_VARIABLETYPE, UA_TYPES_VARIABLETYPEATTRIBUTES},
+    {"UAReferenceType", UA_NODECLASS_REFERENCETYPE, UA_TYPES_REFERENCETYPEATTRIBUTES},
+    {"UADataType", UA_NODECLASS_DATATYPE, UA_TYPES_DATATYPEATTRIBUTES},
+    {"UAView", UA_NODECLASS_VIEW, UA_TYPES_VIEWATTRIBUTES}
+};
+
+static UA_Boolean
+beginNode(NodesetParser *p, const char *name, int nb_attributes,
+          const xmlChar **attributes) {
+    size_t i = 0;
+    const size_t nodeElementsSize = sizeof(nodeElements) / sizeof(nodeElements[0]);
+    for(; i < nodeElementsSize; i++) {
+        if(strcmp(name, nodeElements[i].name) == 0)
+            break;
+    }
+    if(i == nodeElementsSize)
+        return false;
+
+    /* Initialize with the default values of the NodeSet schema */
+    NodesetNode *n = &p->batch->nodes[p->batch->nodesSize];
+    memset(n, 0, sizeof(NodesetNode));
+    p->node = n;
+    n->nodeClass = nodeElements[i].nodeClass;
+    n->attrType = &UA_TYPES[nodeElements[i].attrTypeIndex];
+    UA_init(&n->attr, n->attrType);
+    if(n->nodeClass == UA_NODECLASS_VARIABLE) {
+        n->attr.variable.dataType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE);
+        n->attr.variable.valueRank = UA_VALUERANK_SCALAR;
+        n->attr.variable.accessLevel = UA_ACCESSLEVELMASK_READ;
+        n->attr.variable.userAccessLevel = UA_ACCESSLEVELMASK_READ;
+    } else if(n->nodeClass == UA_NODECLASS_VARIABLETYPE) {
+        n->attr.variableType.dataType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE);
+        n->attr.variableType.valueRank = UA_VALUERANK_SCALAR;
+    } else if(n->nodeClass == UA_NODECLASS_METHOD) {
+        n->attr.method.executable = true;
+        n->attr.method.userExecutable = true;
+    }
+
+    for(int a = 0; a < nb_attributes; a++) {
+        const char *aname = (const char*)attributes[a * 5];
+        const char *value = (const char*)attributes[a * 5 + 3];
+        size_t len = (size_t)(attributes[a * 5 + 4] - attributes[a * 5 + 3]);
+        UA_StatusCode res = parseNodeAttribute(p, aname, value, len);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_LOG_ERROR(p->logger, UA_LOGCATEGORY_SERVER,
+                         "Nodeset: Cannot parse the attribute %s=\"%.*s\" in line %i",
+                         aname, (int)len, value, xmlSAX2GetLineNumber(p->ctxt));
+            stopParser(p, res);
+            return true;
+        }
+    }
+    return true;
+}
+
+static void
+addReference(NodesetParser *p) {
+    NodesetNode *n = p->node;
+    if(n->refsSize == n->refsCapacity) {
+        size_t cap = (n->refsCapacity == 0) ? 8 : n->refsCapacity * 2;
+        NodesetReference *refs = (NodesetReference*)
+            UA_realloc(n->refs, cap * sizeof(NodesetReference));
+        if(!refs) {
+            stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+            return;
+        }
+        n->refs = refs;
+        n->refsCapacity = cap;
+    }
+    NodesetReference *r = &n->refs[n->refsSize];
+    UA_StatusCode res = parseNodeId(p, p->text, p->textSize, &r->targetId);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(p->logger, UA_LOGCATEGORY_SERVER,
+                     "Nodeset: Cannot parse the reference target \"%.*s\" "
+                     "in line %i", (int)p->textSize, p->text,
+                     xmlSAX2GetLineNumber(p->ctxt));
+        stopParser(p, res);
+        return;
+    }
+    r->refTypeId = p->ref.refTypeId;
+    r->isForward = p->ref.isForward;
+    UA_NodeId_init(&p->ref.refTypeId);
+    n->refsSize++;
+}
+
+static void
+beginReference(NodesetParser *p, int nb_attributes, const xmlChar **attributes) {
+    UA_NodeId_clear(&p->ref.refTypeId);
+    p->ref.isForward = true;
+    for(int a = 0; a < nb_attributes; a++) {
+        const char *aname = (const char*)attributes[a * 5];
+        const char *value = (const char*)attributes[a * 5 + 3];
+        size_t len = (size_t)(attributes[a * 5 + 4] - attributes[a * 5 + 3]);
+        if(strcmp(aname, "ReferenceType") == 0) {
+            UA_StatusCode res = parseNodeId(p, value, len, &p->ref.refTypeId);
+            if(res != UA_STATUSCODE_GOOD) {
+                UA_LOG_ERROR(p->logger, UA_LOGCATEGORY_SERVER,
+                             "Nodeset: Unknown ReferenceType \"%.*s\" in line %i",
+                             (int)len, value, xmlSAX2GetLineNumber(p->ctxt));
+                stopParser(p, res);
+                return;
+            }
+        } else if(strcmp(aname, "IsForward") == 0) {
+            p->ref.isForward = parseBoolean(trimmed(value, len));
+        }
+    }
+}
+
+static void
+getAttribute(int nb_attributes, const xmlChar **attributes,
+             const char *name, UA_String *out) {
+    for(int a = 0; a < nb_attributes; a++) {
+        if(strcmp((const char*)attributes[a * 5], name) != 0)
+            continue;
+        out->data = (UA_Byte*)(uintptr_t)attributes[a * 5 + 3];
+        out->length = (size_t)(attributes[a * 5 + 4] - attributes[a * 5 + 3]);
+        return;
+    }
+    *out = UA_STRING_NULL;
+}
+
+static void
+setLocalizedText(NodesetParser *p, UA_LocalizedText *lt) {
+    /* Only the first entry is used if several locales are defined */
+    if(lt->text.length > 0) {
+        UA_String_clear(&p->locale);
+        return;
+    }
+    UA_String text = {p->textSize, (UA_Byte*)p->text};
+    UA_LocalizedText_clear(lt);
+    lt->locale = p->locale;
+    UA_String_init(&p->locale);
+    if(UA_String_copy(&text, &lt->text) != UA_STATUSCODE_GOOD)
+        stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+}
+
+/* Hand the full batch over to the insertion stage and get an empty batch */
+static void
+handOver(NodesetParser *p) {
+    NodesetPipe *pipe = p->pipe;
+    if(!pipe->threaded) {
+        insertBatch(pipe->inserter, p->batch);
+        if(pipe->inserter->fatal)
+            stopParser(p, pipe->inserter->res);
+        return;
+    }
+
+#if UA_MULTITHREADING >= 100
+    UA_LOCK(&pipe->lock);
+    if(pipe->fullLast)
+        pipe->fullLast->next = p->batch;
+    else
+        pipe->full = p->batch;
+    pipe->fullLast = p->batch;
+    p->batch = NULL;
+    UA_CONDITION_BROADCAST(&pipe->cond);
+    while(!pipe->free && !pipe->aborted)
+        UA_CONDITION_WAIT(&pipe->cond, &pipe->lock);
+    UA_Boolean aborted = pipe->aborted;
+    if(!aborted) {
+        p->batch = pipe->free;
+        pipe->free = p->batch->next;
+        p->batch->next = NULL;
+    }
+    UA_UNLOCK(&pipe->lock);
+    if(aborted)
+        stopParser(p, UA_STATUSCODE_BADINTERNALERROR);
+#endif
+}
+
+static void
+endNode(NodesetParser *p) {
+    NodesetNode *n = p->node;
+    p->node = NULL;
+    if(UA_NodeId_isNull(&n->nodeId)) {
+        UA_LOG_WARNING(p->logger, UA_LOGCATEGORY_SERVER,
+                       "Nodeset: Skip a node without NodeId in line %i",
+                       xmlSAX2GetLineNumber(p->ctxt));
+        NodesetNode_clear(n);
+        return;
+    }
+    p->batch->nodesSize++;
+    if(p->batch->nodesSize == p->batchSize)
+        handOver(p);
+}
+
+static void
+endNamespaceUri(NodesetParser *p) {
+    UA_UInt16 *m = (UA_UInt16*)
+        UA_realloc(p->nsMapping, (p->nsMappingSize + 1) * sizeof(UA_UInt16));
+    if(!m) {
+        stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+        return;
+    }
+    p->nsMapping = m;
+    UA_String uri = trimmed(p->text ? p->text : "", p->textSize);
+    char *terminated = (char*)UA_malloc(uri.length + 1);
+    if(!terminated) {
+        stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+        return;
+    }
+    memcpy(terminated, uri.data, uri.length);
+    terminated[uri.length] = 0;
+    p->nsMapping[p->nsMappingSize++] = UA_Server_addNamespace(p->server, terminated);
+    UA_free(terminated);
+}
+
+static void
+endAlias(NodesetParser *p) {
+    NodesetAlias *a = (NodesetAlias*)
+        UA_realloc(p->aliases, (p->aliasesSize + 1) * sizeof(NodesetAlias));
+    if(!a) {
+        stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+        return;
+    }
+    p->aliases = a;
+    a = &p->aliases[p->aliasesSize];
+    UA_StatusCode res = UA_NodeId_parse(&a->nodeId, trimmed(p->text, p->textSize));
+    if(res == UA_STATUSCODE_GOOD)
+        res = mapNamespace(p, &a->nodeId.namespaceIndex);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(p->logger, UA_LOGCATEGORY_SERVER,
+                     "Nodeset: Cannot parse the alias %.*s in line %i",
+                     (int)p->currentAlias.length, (char*)p->currentAlias.data,
+                     xmlSAX2GetLineNumber(p->ctxt));
+        UA_NodeId_clear(&a->nodeId);
+        stopParser(p, res);
+        return;
+    }
+    a->alias = p->currentAlias;
+    UA_String_init(&p->currentAlias);
+    p->aliasesSize++;
+}
+
+static void
+onStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix,
+               const xmlChar *URI, int nb_namespaces, const xmlChar **namespaces,
+               int nb_attributes, int nb_defaulted, const xmlChar **attributes) {
+    NodesetParser *p = (NodesetParser*)ctx;
+    const char *name = (const char*)localname;
+    p->depth++;
+    p->textSize = 0;
+    p->collect = false;
+    if(p->res != UA_STATUSCODE_GOOD)
+        return;
+
+    if(p->depth == 2) {
+        if(strcmp(name, "NamespaceUris") == 0)
+            p->section = NODESET_SECTION_NAMESPACES;
+        else if(strcmp(name, "Aliases") == 0)
+            p->section = NODESET_SECTION_ALIASES;
+        else if(p->batch && beginNode(p, name, nb_attributes, attributes))
+            p->section = NODESET_SECTION_NODE;
+        return;
+    }
+
+    if(p->depth == 3) {
+        if(p->section == NODESET_SECTION_NAMESPACES) {
+            p->collect = (strcmp(name, "Uri") == 0);
+        } else if(p->section == NODESET_SECTION_ALIASES) {
+            if(strcmp(name, "Alias") != 0)
+                return;
+            UA_String alias;
+            getAttribute(nb_attributes, attributes, "Alias", &alias);
+            UA_String_clear(&p->currentAlias);
+            if(UA_String_copy(&alias, &p->currentAlias) != UA_STATUSCODE_GOOD)
+                stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+            p->collect = true;
+        } else if(p->section == NODESET_SECTION_NODE) {
+            p->field = NODESET_FIELD_NONE;
+            if(strcmp(name, "DisplayName") == 0)
+                p->field = NODESET_FIELD_DISPLAYNAME;
+            else if(strcmp(name, "Description") == 0)
+                p->field = NODESET_FIELD_DESCRIPTION;
+            else if(strcmp(name, "InverseName") == 0)
+                p->field = NODESET_FIELD_INVERSENAME;
+            else if(strcmp(name, "References") == 0)
+                p->field = NODESET_FIELD_REFERENCES;
+            else if(strcmp(name, "Value") == 0)
+                p->field = NODESET_FIELD_VALUE;
+            if(p->field == NODESET_FIELD_DISPLAYNAME ||
+               p->field == NODESET_FIELD_DESCRIPTION ||
+               p->field == NODESET_FIELD_INVERSENAME) {
+                UA_String locale;
+                getAttribute(nb_attributes, attributes, "Locale", &locale);
+                UA_String_clear(&p->locale);
+                if(UA_String_copy(&locale, &p->locale) != UA_STATUSCODE_GOOD)
+                    stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+                p->collect = true;
+            }
+        }
+        return;
+    }
+
+    if(p->section != NODESET_SECTION_NODE || p->depth < 4)
+        return;
+    if(p->field == NODESET_FIELD_REFERENCES && p->depth == 4 &&
+       strcmp(name, "Reference") == 0) {
+        beginReference(p, nb_attributes, attributes);
+        p->collect = true;
+    } else if(p->field == NODESET_FIELD_VALUE) {
+        startValueElement(p, name);
+    }
+}
+
+static void
+onEndElement(void *ctx, const xmlChar *localname,
+             const xmlChar *prefix, const xmlChar *URI) {
+    NodesetParser *p = (NodesetParser*)ctx;
+    const char *name = (const char*)localname;
+    if(p->res == UA_STATUSCODE_GOOD && p->text)
+        p->text[p->textSize] = 0;
+
+    if(p->res != UA_STATUSCODE_GOOD) {
+        /* Skip */
+    } else if(p->depth == 2) {
+        if(p->section == NODESET_SECTION_NODE)
+            endNode(p);
+        else if(p->section == NODESET_SECTION_ALIASES && p->aliasesSize > 1)
+            qsort(p->aliases, p->aliasesSize, sizeof(NodesetAlias), cmpAlias);
+        p->section = NODESET_SECTION_NONE;
+    } else if(p->depth == 3) {
+        if(p->section == NODESET_SECTION_NAMESPACES && strcmp(name, "Uri") == 0) {
+            endNamespaceUri(p);
+        } else if(p->section == NODESET_SECTION_ALIASES &&
+                  strcmp(name, "Alias") == 0) {
+            endAlias(p);
+        } else if(p->section == NODESET_SECTION_NODE) {
+            if(p->field == NODESET_FIELD_DISPLAYNAME)
+                setLocalizedText(p, &p->node->attr.base.displayName);
+            else if(p->field == NODESET_FIELD_DESCRIPTION)
+                setLocalizedText(p, &p->node->attr.base.description);
+            else if(p->field == NODESET_FIELD_INVERSENAME &&
+                    p->node->nodeClass == UA_NODECLASS_REFERENCETYPE)
+                setLocalizedText(p, &p->node->attr.referenceType.inverseName);
+            else if(p->field == NODESET_FIELD_VALUE)
+                endValue(p);
+            p->field = NODESET_FIELD_NONE;
+        }
+    } else if(p->section == NODESET_SECTION_NODE) {
+        if(p->field == NODESET_FIELD_REFERENCES && p->depth == 4)
+            addReference(p);
+        else if(p->field == NODESET_FIELD_VALUE)
+            endValueElement(p);
+    }
+
+    p->depth--;
+    p->textSize = 0;
+    p->collect = false;
+}
+
+static void
+onCharacters(void *ctx, const xmlChar *ch, int len) {
+    NodesetParser *p = (NodesetParser*)ctx;
+    if(!p->collect || p->res != UA_STATUSCODE_GOOD)
+        return;
+    size_t needed = p->textSize + (size_t)len + 1; /* Zero-termination */
+    if(needed > p->textCapacity) {
+        size_t cap = (p->textCapacity == 0) ? 256 : p->textCapacity;
+        while(cap < needed)
+            cap *= 2;
+        char *text = (char*)UA_realloc(p->text, cap);
+        if(!text) {
+            stopParser(p, UA_STATUSCODE_BADOUTOFMEMORY);
+            return;
+        }
+        p->text = text;
+        p->textCapacity = cap;
+    }
+    memcpy(&p->text[p->textSize], ch, (size_t)len);
+    p->textSize += (size_t)len;
+    p->text[p->textSize] = 0;
+}
+
+static void
+onError(void *ctx, xmlErrorPtr error) {
+    NodesetParser *p = (NodesetParser*)ctx;
+    if(!error || error->level < XML_ERR_ERROR)
+        return;
+    UA_LOG_ERROR(p->logger, UA_LOGCATEGORY_SERVER,
+                 "Nodeset: XML error in line %i: %s", error->line,
+                 error->message ? error->message : "");
+    if(p->res == UA_STATUSCODE_GOOD)
+        p->res = UA_STATUSCODE_BADDECODINGERROR;
+}
+
+static void
+parseFile(NodesetParser *p, FILE *f) {
+    xmlSAXHandler sax;
+    memset(&sax, 0, sizeof(xmlSAXHandler));
+    sax.initialized = XML_SAX2_MAGIC;
+    sax.startElementNs = onStartElement;
+    sax.endElementNs = onEndElement;
+    sax.characters = onCharacters;
+    sax.serror = onError;
+
+    p->ctxt = xmlCreatePushParserCtxt(&sax, p, NULL, 0, NULL);
+    if(!p->ctxt) {
+        p->res = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+    /* Never load external entities */
+    xmlCtxtUseOptions(p->ctxt, XML_PARSE_NONET);
+
+    char *chunk = (char*)UA_malloc(NODESET_CHUNKSIZE);
+    if(!chunk) {
+        p->res = UA_STATUSCODE_BADOUTOFMEMORY;
+    } else {
+        while(p->res == UA_STATUSCODE_GOOD) {
+            size_t read = fread(chunk, 1, NODESET_CHUNKSIZE, f);
+            int terminate = (read < NODESET_CHUNKSIZE);
+            if(xmlParseChunk(p->ctxt, chunk, (int)read, terminate) != 0 &&
+               p->res == UA_STATUSCODE_GOOD)
+                p->res = UA_STATUSCODE_BADDECODINGERROR;
+            if(terminate)
+                break;
+        }
+        UA_free(chunk);
+    }
+    xmlFreeParserCtxt(p->ctxt);
+    p->ctxt = NULL;
+
+    /* The node was not completed if the parser was stopped */
+    if(p->node) {
+        NodesetNode_clear(p->node);
+        p->node = NULL;
+    }
+    clearValue(p);
+
+    /* Hand over the last partially filled batch */
+    if(p->res == UA_STATUSCODE_GOOD && p->batch && p->batch->nodesSize > 0 &&
+       !p->pipe->threaded)
+        insertBatch(p->pipe->inserter, p->batch);
+}
+
+static void
+NodesetParser_clear(NodesetParser *p) {
+    UA_NodeId_clear(&p->ref.refTypeId);
+    UA_String_clear(&p->locale);
+    UA_String_clear(&p->currentAlias);
+    for(size_t i = 0; i < p->aliasesSize; i++) {
+        UA_String_clear(&p->aliases[i].alias);
+        UA_NodeId_clear(&p->aliases[i].nodeId);
+    }
+    UA_free(p->aliases);
+    UA_free(p->nsMapping);
+    UA_free(p->text);
+}
+
+/*****************/
+/* Worker Thread */
+/*****************/
+
+#if UA_MULTITHREADING >= 100
+
+typedef struct {
+    NodesetParser *parser;
+    FILE *file;
+} NodesetWorker;
+
+static UA_THREAD_FUNCTION(parserThread, context) {
+    NodesetWorker *w = (NodesetWorker*)context;
+    NodesetParser *p = w->parser;
+    NodesetPipe *pipe = p->pipe;
+    parseFile(p, w->file);
+
+    /* Hand over the last partially filled batch and finish */
+    UA_LOCK(&pipe->lock);
+    if(p->batch) {
+        if(p->res == UA_STATUSCODE_GOOD && p->batch->nodesSize > 0) {
+            if(pipe->fullLast)
+                pipe->fullLast->next = p->batch;
+            else
+                pipe->full = p->batch;
+            pipe->fullLast = p->batch;
+        } else {
+            p->batch->next = pipe->free;
+            pipe->free = p->batch;
+        }
+        p->batch = NULL;
+    }
+    pipe->done = true;
+    UA_CONDITION_BROADCAST(&pipe->cond);
+    UA_UNLOCK(&pipe->lock);
+    UA_THREAD_RETURN;
+}
+
+/* Insert the batches from the worker until the parser is done */
+static UA_StatusCode
+runPipeline(NodesetParser *p, FILE *f) {
+    NodesetPipe *pipe = p->pipe;
+    UA_LOCK_INIT(&pipe->lock);
+    UA_CONDITION_INIT(&pipe->cond);
+
+    /* Allocate the batches that circulate between the stages */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < NODESET_BATCHES; i++) {
+        NodesetBatch *b = NodesetBatch_new(p->batchSize);
+        if(!b) {
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+            break;
+        }
+        b->next = pipe->free;
+        pipe->free = b;
+    }
+
+    NodesetWorker w = {p, f};
+    UA_Thread thread;
+    if(res == UA_STATUSCODE_GOOD) {
+        p->batch = pipe->free;
+        pipe->free = p->batch->next;
+        p->batch->next = NULL;
+        if(UA_THREAD_CREATE(&thread, parserThread, &w) != 0) {
+            pipe->threaded = false; /* Fall back to parsing in this thread */
+            parseFile(p, f);
+        } else {
+            UA_LOCK(&pipe->lock);
+            while(true) {
+                while(!pipe->full && !pipe->done)
+                    UA_CONDITION_WAIT(&pipe->cond, &pipe->lock);
+                NodesetBatch *b = pipe->full;
+                if(!b)
+                    break;
+                pipe->full = b->next;
+                if(!pipe->full)
+                    pipe->fullLast = NULL;
+                b->next = NULL;
+                UA_UNLOCK(&pipe->lock);
+
+                insertBatch(pipe->inserter, b); /* Also clears the batch */
+
+                UA_LOCK(&pipe->lock);
+                b->next = pipe->free;
+                pipe->free = b;
+                if(pipe->inserter->fatal)
+                    pipe->aborted = true;
+                UA_CONDITION_BROADCAST(&pipe->cond);
+            }
+            UA_UNLOCK(&pipe->lock);
+            UA_THREAD_JOIN(&thread);
+        }
+    }
+
+    if(p->batch) {
+        p->batch->next = pipe->free;
+        pipe->free = p->batch;
+        p->batch = NULL;
+    }
+    while(pipe->free) {
+        NodesetBatch *b = pipe->free;
+        pipe->free = b->next;
+        NodesetBatch_delete(b);
+    }
+    UA_CONDITION_DESTROY(&pipe->cond);
+    UA_LOCK_DESTROY(&pipe->lock);
+    return res;
+}
+
+#endif /* UA_MULTITHREADING >= 100 */
+
+/*************/
+/* Interface */
+/*************/
+
+UA_StatusCode
+UA_Server_loadNodesetStream(UA_Server *server, const char *nodeset2XmlFilePath,
+                            const UA_NodesetStreamOptions *options) {
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    const UA_Logger *logger = config->logging;
+
+    /* The nodes are inserted directly into the nodestore */
+    if(UA_Server_getLifecycleState(server) != UA_LIFECYCLESTATE_STOPPED) {
+        UA_LOG_ERROR(logger, UA_LOGCATEGORY_SERVER,
+                     "Nodeset: The nodeset can only be loaded before the "
+                     "server is started");
+        return UA_STATUSCODE_BADINVALIDSTATE;
+    }
+
+    FILE *f = fopen(nodeset2XmlFilePath, "rb");
+    if(!f) {
+        UA_LOG_ERROR(logger, UA_LOGCATEGORY_SERVER,
+                     "Nodeset: Cannot open the file %s", nodeset2XmlFilePath);
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+
+    NodesetInserter in;
+    memset(&in, 0, sizeof(NodesetInserter));
+    in.ns = &config->nodestore;
+    in.logger = logger;
+
+    NodesetPipe pipe;
+    memset(&pipe, 0, sizeof(NodesetPipe));
+    pipe.inserter = &in;
+
+    NodesetParser p;
+    memset(&p, 0, sizeof(NodesetParser));
+    p.server = server;
+    p.logger = logger;
+    p.pipe = &pipe;
+    p.batchSize = (options && options->batchSize > 0) ?
+        options->batchSize : NODESET_DEFAULT_BATCHSIZE;
+
+    /* Namespace zero is always mapped to itself */
+    p.nsMapping = (UA_UInt16*)UA_calloc(1, sizeof(UA_UInt16));
+    if(!p.nsMapping) {
+        fclose(f);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    p.nsMappingSize = 1;
+
+    xmlInitParser();
+
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+#if UA_MULTITHREADING >= 100
+    pipe.threaded = !(options && options->parseInline);
+    if(pipe.threaded)
+        res = runPipeline(&p, f);
+#endif
+    if(!pipe.threaded) {
+        p.batch = NodesetBatch_new(p.batchSize);
+        if(p.batch) {
+            parseFile(&p, f);
+            NodesetBatch_delete(p.batch);
+            p.batch = NULL;
+        } else {
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+    }
+    fclose(f);
+    if(res == UA_STATUSCODE_GOOD)
+        res = in.fatal ? in.res : p.res;
+
+    /* Add the collected references in the final pass */
+    if(res == UA_STATUSCODE_GOOD && !in.fatal) {
+        resolveDeferred(&in);
+        for(size_t i = 0; i < in.newRefTypesSize; i++)
+            propagateSubtypes(&in, &in.newRefTypes[i]);
+    }
+    if(res == UA_STATUSCODE_GOOD)
+        res = in.res;
+
+    NodesetParser_clear(&p);
+    NodesetInserter_clear(&in);
+    return res;
+}
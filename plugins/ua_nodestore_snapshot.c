@@ -0,0 +1,1322 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include <open62541/util.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef UA_ARCHITECTURE_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* The snapshot is a binary image of the information model without namespace
+ * zero. Namespace zero is created by the server on every startup anyway. But
+ * the references from namespace zero into the other namespaces (e.g. from the
+ * ObjectsFolder) are kept as "patches" that get applied to the ns0 nodes when
+ * they are first accessed.
+ *
+ * Layout of the image (all integers are little-endian):
+ *
+ * - Header (SNAPSHOT_HEADERSIZE bytes)
+ * - Node records
+ * - Patch records
+ * - Node index: (UInt32 NodeId-hash, UInt64 record-offset), sorted by hash
+ * - Patch index: same layout as the node index
+ *
+ * Attributes in the records are encoded in the OPC UA binary encoding with a
+ * UInt32 length prefix. ReferenceTypes are stored by their NodeId and mapped to
+ * the ReferenceTypeIndex of the running server when a node is materialized.
+ * The ReferenceTypes from the image are materialized as soon as the
+ * ReferenceTypes of ns0 are available. Otherwise they would be missing from
+ * the subtype-sets used for browsing.
+ *
+ * Values from DataSources and callbacks, method callbacks, node contexts and
+ * lifecycle callbacks cannot be persisted. They have to be re-attached by the
+ * application after the restart. */
+
+#define SNAPSHOT_MAGIC "UANS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_HEADERSIZE 48
+#define SNAPSHOT_INDEXENTRYSIZE 12
+
+/* Materialization state of the image entries */
+#define SNAPSHOT_ENTRY_IMAGE 0        /* Only in the image */
+#define SNAPSHOT_ENTRY_MATERIALIZING 1
+#define SNAPSHOT_ENTRY_MATERIALIZED 2 /* Lives in the backend nodestore */
+#define SNAPSHOT_ENTRY_REMOVED 3      /* Removed before materialization */
+
+/*********************/
+/* Binary Primitives */
+/*********************/
+
+typedef struct {
+    UA_Byte *data;
+    size_t length;
+    size_t capacity;
+    UA_StatusCode res;
+} SnapshotWriter;
+
+typedef struct {
+    const UA_Byte *pos;
+    const UA_Byte *end;
+    const UA_DecodeBinaryOptions *options;
+    UA_StatusCode res;
+} SnapshotReader;
+
+static UA_Byte *
+writerReserve(SnapshotWriter *w, size_t len) {
+    if(w->res != UA_STATUSCODE_GOOD)
+        return NULL;
+    if(w->length + len > w->capacity) {
+        size_t newCap = (w->capacity > 0) ? w->capacity * 2 : 1024;
+        while(newCap < w->length + len)
+            newCap *= 2;
+        UA_Byte *newData = (UA_Byte*)UA_realloc(w->data, newCap);
+        if(!newData) {
+            w->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return NULL;
+        }
+        w->data = newData;
+        w->capacity = newCap;
+    }
+    UA_Byte *pos = &w->data[w->length];
+    w->length += len;
+    return pos;
+}
+
+static void
+storeU32(UA_Byte *p, UA_UInt32 v) {
+    p[0] = (UA_Byte)v;
+    p[1] = (UA_Byte)(v >> 8);
+    p[2] = (UA_Byte)(v >> 16);
+    p[3] = (UA_Byte)(v >> 24);
+}
+
+static void
+storeU64(UA_Byte *p, UA_UInt64 v) {
+    storeU32(p, (UA_UInt32)v);
+    storeU32(&p[4], (UA_UInt32)(v >> 32));
+}
+
+static UA_UInt32
+loadU32(const UA_Byte *p) {
+    return (UA_UInt32)p[0] | ((UA_UInt32)p[1] << 8) |
+        ((UA_UInt32)p[2] << 16) | ((UA_UInt32)p[3] << 24);
+}
+
+static UA_UInt64
+loadU64(const UA_Byte *p) {
+    return (UA_UInt64)loadU32(p) | ((UA_UInt64)loadU32(&p[4]) << 32);
+}
+
+static void
+putByte(SnapshotWriter *w, UA_Byte v) {
+    UA_Byte *p = writerReserve(w, 1);
+    if(p)
+        *p = v;
+}
+
+static void
+putU32(SnapshotWriter *w, UA_UInt32 v) {
+    UA_Byte *p = writerReserve(w, 4);
+    if(p)
+        storeU32(p, v);
+}
+
+/* Fixed-size builtin types (Int32, Double, ...) and all variable-length types
+ * are written with their binary encoding and a length prefix */
+static void
+putEncoded(SnapshotWriter *w, const void *v, const UA_DataType *type) {
+    size_t len = UA_calcSizeBinary(v, type);
+    if(len == 0 || len > UA_UINT32_MAX) {
+        w->res = UA_STATUSCODE_BADENCODINGERROR;
+        return;
+    }
+    putU32(w, (UA_UInt32)len);
+    UA_Byte *p = writerReserve(w, len);
+    if(!p)
+        return;
+    UA_ByteString buf = {len, p};
+    w->res = UA_encodeBinary(v, type, &buf);
+}
+
+static UA_Byte
+getByte(SnapshotReader *r) {
+    if(r->res != UA_STATUSCODE_GOOD || r->pos + 1 > r->end) {
+        r->res = UA_STATUSCODE_BADDECODINGERROR;
+        return 0;
+    }
+    return *r->pos++;
+}
+
+static UA_UInt32
+getU32(SnapshotReader *r) {
+    if(r->res != UA_STATUSCODE_GOOD || r->pos + 4 > r->end) {
+        r->res = UA_STATUSCODE_BADDECODINGERROR;
+        return 0;
+    }
+    UA_UInt32 v = loadU32(r->pos);
+    r->pos += 4;
+    return v;
+}
+
+/* The target is initialized also when decoding fails */
+static void
+getEncoded(SnapshotReader *r, void *v, const UA_DataType *type) {
+    UA_init(v, type);
+    UA_UInt32 len = getU32(r);
+    if(r->res != UA_STATUSCODE_GOOD)
+        return;
+    if((size_t)(r->end - r->pos) < len) {
+        r->res = UA_STATUSCODE_BADDECODINGERROR;
+        return;
+    }
+    UA_ByteString buf = {len, (UA_Byte*)(uintptr_t)r->pos};
+    r->res = UA_decodeBinary(&buf, v, type, r->options);
+    r->pos += len;
+}
+
+/*******************/
+/* Writing Records */
+/*******************/
+
+typedef struct {
+    UA_UInt32 hash;
+    UA_UInt64 offset;
+} SnapshotIndexEntry;
+
+typedef struct {
+    SnapshotIndexEntry *entries;
+    size_t entriesSize;
+    size_t entriesCapacity;
+} SnapshotIndex;
+
+typedef struct {
+    const UA_Nodestore *ns;
+    FILE *file;
+    UA_UInt64 offset;
+    SnapshotWriter w;
+    SnapshotIndex nodes;
+    SnapshotIndex patches;
+    UA_StatusCode res;
+} SnapshotSaveContext;
+
+static UA_StatusCode
+addIndexEntry(SnapshotIndex *index, UA_UInt32 hash, UA_UInt64 offset) {
+    if(index->entriesSize == index->entriesCapacity) {
+        size_t newCap = (index->entriesCapacity > 0) ?
+            index->entriesCapacity * 2 : 64;
+        SnapshotIndexEntry *newEntries = (SnapshotIndexEntry*)
+            UA_realloc(index->entries, newCap * sizeof(SnapshotIndexEntry));
+        if(!newEntries)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        index->entries = newEntries;
+        index->entriesCapacity = newCap;
+    }
+    index->entries[index->entriesSize].hash = hash;
+    index->entries[index->entriesSize].offset = offset;
+    index->entriesSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static int
+cmpIndexEntry(const void *a, const void *b) {
+    const SnapshotIndexEntry *aa = (const SnapshotIndexEntry*)a;
+    const SnapshotIndexEntry *bb = (const SnapshotIndexEntry*)b;
+    if(aa->hash != bb->hash)
+        return (aa->hash < bb->hash) ? -1 : 1;
+    if(aa->offset != bb->offset)
+        return (aa->offset < bb->offset) ? -1 : 1;
+    return 0;
+}
+
+static UA_Boolean
+isNs0Target(const UA_ReferenceTarget *t) {
+    if(!UA_NodePointer_isLocal(t->targetId))
+        return false;
+    UA_NodeId id = UA_NodePointer_toNodeId(t->targetId);
+    return (id.namespaceIndex == 0);
+}
+
+typedef struct {
+    SnapshotWriter *w;
+    UA_Boolean onlyNonNs0;
+    UA_UInt32 count;
+} TargetWriteContext;
+
+static void *
+countTarget(void *context, UA_ReferenceTarget *t) {
+    TargetWriteContext *tc = (TargetWriteContext*)context;
+    if(!tc->onlyNonNs0 || !isNs0Target(t))
+        tc->count++;
+    return NULL;
+}
+
+static void *
+writeTarget(void *context, UA_ReferenceTarget *t) {
+    TargetWriteContext *tc = (TargetWriteContext*)context;
+    if(tc->onlyNonNs0 && isNs0Target(t))
+        return NULL;
+    UA_ExpandedNodeId en = UA_NodePointer_toExpandedNodeId(t->targetId);
+    putEncoded(tc->w, &en, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    putU32(tc->w, t->targetNameHash);
+    return NULL;
+}
+
+/* Writes the references of the node. Returns the number of targets written. If
+ * onlyNonNs0 is set, then only references to nodes outside of ns0 are
+ * considered. */
+static UA_UInt32
+writeReferences(const UA_Nodestore *ns, SnapshotWriter *w,
+                const UA_NodeHead *head, UA_Boolean onlyNonNs0) {
+    /* Count the ReferenceKinds with matching targets */
+    UA_UInt32 kindsCount = 0;
+    UA_UInt32 totalTargets = 0;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        TargetWriteContext tc = {w, onlyNonNs0, 0};
+        UA_NodeReferenceKind_iterate(&head->references[i], countTarget, &tc);
+        if(tc.count > 0)
+            kindsCount++;
+    }
+    putU32(w, kindsCount);
+
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        TargetWriteContext tc = {w, onlyNonNs0, 0};
+        UA_NodeReferenceKind_iterate(rk, countTarget, &tc);
+        if(tc.count == 0)
+            continue;
+        const UA_NodeId *refTypeId =
+            ns->getReferenceTypeId(ns->context, rk->referenceTypeIndex);
+        if(!refTypeId) {
+            w->res = UA_STATUSCODE_BADREFERENCETYPEIDINVALID;
+            return 0;
+        }
+        putEncoded(w, refTypeId, &UA_TYPES[UA_TYPES_NODEID]);
+        putByte(w, rk->isInverse);
+        putU32(w, tc.count);
+        UA_NodeReferenceKind_iterate(rk, writeTarget, &tc);
+        totalTargets += tc.count;
+    }
+    return totalTargets;
+}
+
+static void
+writeLocalizedTextList(SnapshotWriter *w, const UA_LocalizedTextListEntry *lt) {
+    UA_UInt32 count = 0;
+    for(const UA_LocalizedTextListEntry *e = lt; e; e = e->next)
+        count++;
+    putU32(w, count);
+    for(; lt; lt = lt->next)
+        putEncoded(w, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+}
+
+static void
+writeVariableAttributes(SnapshotWriter *w, const UA_VariableNode *vn) {
+    putEncoded(w, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    putEncoded(w, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    putU32(w, (UA_UInt32)vn->arrayDimensionsSize);
+    for(size_t i = 0; i < vn->arrayDimensionsSize; i++)
+        putU32(w, vn->arrayDimensions[i]);
+
+    /* Values from a DataSource or an external backend are not persisted */
+    UA_Boolean internalValue = (vn->valueSource == UA_VALUESOURCE_DATA &&
+                                (vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_NONE ||
+                                 vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_INTERNAL));
+    putByte(w, internalValue);
+    if(internalValue) {
+        putByte(w, vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_INTERNAL);
+        putEncoded(w, &vn->value.data.value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    }
+}
+
+static void
+writeNodeRecord(const UA_Nodestore *ns, SnapshotWriter *w, const UA_Node *node) {
+    const UA_NodeHead *head = &node->head;
+    putEncoded(w, &head->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    putU32(w, (UA_UInt32)head->nodeClass);
+    putEncoded(w, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    writeLocalizedTextList(w, head->displayName);
+    writeLocalizedTextList(w, head->description);
+    putU32(w, head->writeMask);
+    writeReferences(ns, w, head, false);
+
+    switch(head->nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        writeVariableAttributes(w, &node->variableNode);
+        putByte(w, node->variableNode.accessLevel);
+        putEncoded(w, &node->variableNode.minimumSamplingInterval,
+                   &UA_TYPES[UA_TYPES_DOUBLE]);
+        putByte(w, node->variableNode.historizing);
+        putByte(w, node->variableNode.isDynamic);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        writeVariableAttributes(w, (const UA_VariableNode*)&node->variableTypeNode);
+        putByte(w, node->variableTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_METHOD:
+        putByte(w, node->methodNode.executable);
+        break;
+    case UA_NODECLASS_OBJECT:
+        putByte(w, node->objectNode.eventNotifier);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        putByte(w, node->objectTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        putByte(w, node->referenceTypeNode.isAbstract);
+        putByte(w, node->referenceTypeNode.symmetric);
+        putEncoded(w, &node->referenceTypeNode.inverseName,
+                   &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        putByte(w, node->dataTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_VIEW:
+        putByte(w, node->viewNode.eventNotifier);
+        putByte(w, node->viewNode.containsNoLoops);
+        break;
+    default:
+        w->res = UA_STATUSCODE_BADNODECLASSINVALID;
+        break;
+    }
+}
+
+static UA_StatusCode
+flushRecord(SnapshotSaveContext *ctx, SnapshotIndex *index,
+            const UA_NodeId *nodeId) {
+    if(ctx->w.res != UA_STATUSCODE_GOOD)
+        return ctx->w.res;
+    UA_StatusCode res = addIndexEntry(index, UA_NodeId_hash(nodeId), ctx->offset);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    if(fwrite(ctx->w.data, 1, ctx->w.length, ctx->file) != ctx->w.length)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    ctx->offset += ctx->w.length;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+saveNodeVisitor(void *visitorCtx, const UA_Node *node) {
+    SnapshotSaveContext *ctx = (SnapshotSaveContext*)visitorCtx;
+    if(ctx->res != UA_STATUSCODE_GOOD)
+        return;
+
+    ctx->w.length = 0;
+    if(node->head.nodeId.namespaceIndex != 0) {
+        writeNodeRecord(ctx->ns, &ctx->w, node);
+        ctx->res = flushRecord(ctx, &ctx->nodes, &node->head.nodeId);
+        return;
+    }
+
+    /* Ns0 node. Only keep the references into other namespaces. */
+    putEncoded(&ctx->w, &node->head.nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_UInt32 targets = writeReferences(ctx->ns, &ctx->w, &node->head, true);
+    if(targets > 0)
+        ctx->res = flushRecord(ctx, &ctx->patches, &node->head.nodeId);
+}
+
+static UA_StatusCode
+writeIndex(SnapshotSaveContext *ctx, SnapshotIndex *index) {
+    qsort(index->entries, index->entriesSize,
+          sizeof(SnapshotIndexEntry), cmpIndexEntry);
+    UA_Byte buf[SNAPSHOT_INDEXENTRYSIZE];
+    for(size_t i = 0; i < index->entriesSize; i++) {
+        storeU32(buf, index->entries[i].hash);
+        storeU64(&buf[4], index->entries[i].offset);
+        if(fwrite(buf, 1, SNAPSHOT_INDEXENTRYSIZE, ctx->file) !=
+           SNAPSHOT_INDEXENTRYSIZE)
+            return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    ctx->offset += index->entriesSize * SNAPSHOT_INDEXENTRYSIZE;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_UInt32
+countNs0ReferenceTypes(const UA_Nodestore *ns) {
+    UA_UInt32 count = 0;
+    for(size_t i = 0; i < UA_REFERENCETYPESET_MAX; i++) {
+        const UA_NodeId *id = ns->getReferenceTypeId(ns->context, (UA_Byte)i);
+        if(!id)
+            break;
+        if(id->namespaceIndex == 0)
+            count++;
+    }
+    return count;
+}
+
+UA_StatusCode
+UA_Nodestore_saveSnapshot(const UA_Nodestore *ns, const char *path) {
+    if(!ns || !ns->iterate || !path)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    SnapshotSaveContext ctx;
+    memset(&ctx, 0, sizeof(SnapshotSaveContext));
+    ctx.ns = ns;
+    ctx.file = fopen(path, "wb");
+    if(!ctx.file)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Reserve space for the header. It is written in the end. */
+    UA_Byte header[SNAPSHOT_HEADERSIZE];
+    memset(header, 0, SNAPSHOT_HEADERSIZE);
+    if(fwrite(header, 1, SNAPSHOT_HEADERSIZE, ctx.file) != SNAPSHOT_HEADERSIZE)
+        ctx.res = UA_STATUSCODE_BADINTERNALERROR;
+    ctx.offset = SNAPSHOT_HEADERSIZE;
+
+    /* Write the records */
+    if(ctx.res == UA_STATUSCODE_GOOD)
+        ns->iterate(ns->context, saveNodeVisitor, &ctx);
+
+    /* Write the indices */
+    UA_UInt64 nodeIndexOffset = ctx.offset;
+    if(ctx.res == UA_STATUSCODE_GOOD)
+        ctx.res = writeIndex(&ctx, &ctx.nodes);
+    UA_UInt64 patchIndexOffset = ctx.offset;
+    if(ctx.res == UA_STATUSCODE_GOOD)
+        ctx.res = writeIndex(&ctx, &ctx.patches);
+
+    /* Write the header */
+    if(ctx.res == UA_STATUSCODE_GOOD) {
+        memcpy(header, SNAPSHOT_MAGIC, 4);
+        storeU32(&header[4], SNAPSHOT_VERSION);
+        storeU32(&header[8], (UA_UInt32)ctx.nodes.entriesSize);
+        storeU32(&header[12], (UA_UInt32)ctx.patches.entriesSize);
+        storeU32(&header[16], countNs0ReferenceTypes(ns));
+        storeU64(&header[24], nodeIndexOffset);
+        storeU64(&header[32], patchIndexOffset);
+        storeU64(&header[40], ctx.offset);
+        if(fseek(ctx.file, 0, SEEK_SET) != 0 ||
+           fwrite(header, 1, SNAPSHOT_HEADERSIZE, ctx.file) != SNAPSHOT_HEADERSIZE)
+            ctx.res = UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    if(fclose(ctx.file) != 0 && ctx.res == UA_STATUSCODE_GOOD)
+        ctx.res = UA_STATUSCODE_BADINTERNALERROR;
+    UA_free(ctx.w.data);
+    UA_free(ctx.nodes.entries);
+    UA_free(ctx.patches.entries);
+    if(ctx.res != UA_STATUSCODE_GOOD)
+        remove(path);
+    return ctx.res;
+}
+
+/*****************/
+/* Loading Image */
+/*****************/
+
+typedef struct {
+    UA_Nodestore backend; /* The wrapped nodestore that holds the materialized
+                           * nodes */
+
+    const UA_Byte *image;
+    size_t imageSize;
+#ifdef UA_ARCHITECTURE_POSIX
+    UA_Boolean mapped; /* Otherwise the image is on the heap */
+#endif
+    UA_DecodeBinaryOptions options;
+
+    UA_UInt32 nodesCount;
+    const UA_Byte *nodeIndex;
+    UA_Byte *nodeState;
+
+    UA_UInt32 patchesCount;
+    UA_UInt32 patchesPending;
+    const UA_Byte *patchIndex;
+    UA_Byte *patchState;
+
+    UA_UInt32 ns0RefTypes; /* Number of ReferenceTypes in ns0 when the
+                            * snapshot was taken */
+    UA_Boolean refTypesReady;  /* All ReferenceTypes of ns0 are available */
+    UA_Boolean refTypesLoaded; /* Materialized the ReferenceTypes of the image */
+} UA_SnapshotStore;
+
+/* Returns the position in the index or -1 if not found */
+static long
+findIndexEntry(const UA_SnapshotStore *s, const UA_Byte *index,
+               UA_UInt32 count, const UA_NodeId *nodeId) {
+    UA_UInt32 hash = UA_NodeId_hash(nodeId);
+    UA_UInt32 low = 0, high = count;
+    while(low < high) {
+        UA_UInt32 mid = low + ((high - low) / 2);
+        if(loadU32(&index[mid * SNAPSHOT_INDEXENTRYSIZE]) < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    /* Compare the NodeId of all records with the same hash */
+    for(; low < count; low++) {
+        const UA_Byte *entry = &index[low * SNAPSHOT_INDEXENTRYSIZE];
+        if(loadU32(entry) != hash)
+            break;
+        SnapshotReader r = {&s->image[loadU64(&entry[4])],
+                            &s->image[s->imageSize], NULL, UA_STATUSCODE_GOOD};
+        UA_NodeId id;
+        getEncoded(&r, &id, &UA_TYPES[UA_TYPES_NODEID]);
+        UA_Boolean found = (r.res == UA_STATUSCODE_GOOD && UA_NodeId_equal(&id, nodeId));
+        UA_NodeId_clear(&id);
+        if(found)
+            return (long)low;
+    }
+    return -1;
+}
+
+static SnapshotReader
+entryReader(const UA_SnapshotStore *s, const UA_Byte *index, long pos) {
+    UA_UInt64 offset = loadU64(&index[pos * SNAPSHOT_INDEXENTRYSIZE + 4]);
+    SnapshotReader r = {&s->image[offset], &s->image[s->imageSize],
+                        &s->options, UA_STATUSCODE_GOOD};
+    return r;
+}
+
+static UA_StatusCode
+materializeNode(UA_SnapshotStore *s, long pos);
+
+/* The ReferenceTypes from ns0 have fixed indices and are created in-order
+ * during the bootstrapping of ns0. Only materialize ReferenceTypes from the
+ * image afterwards. */
+static UA_Boolean
+referenceTypesReady(UA_SnapshotStore *s) {
+    if(s->refTypesReady)
+        return true;
+    if(s->ns0RefTypes > 0 &&
+       !s->backend.getReferenceTypeId(s->backend.context,
+                                      (UA_Byte)(s->ns0RefTypes - 1)))
+        return false;
+    UA_UInt32 count = 0;
+    for(size_t i = 0; i < UA_REFERENCETYPESET_MAX; i++) {
+        const UA_NodeId *id = s->backend.getReferenceTypeId(s->backend.context,
+                                                            (UA_Byte)i);
+        if(!id)
+            break;
+        if(id->namespaceIndex == 0)
+            count++;
+    }
+    s->refTypesReady = (count >= s->ns0RefTypes);
+    return s->refTypesReady;
+}
+
+static UA_StatusCode
+resolveReferenceType(UA_SnapshotStore *s, const UA_NodeId *refTypeId,
+                     UA_Byte *outIndex) {
+    for(size_t attempt = 0; attempt < 2; attempt++) {
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX; i++) {
+            const UA_NodeId *id = s->backend.getReferenceTypeId(s->backend.context,
+                                                                (UA_Byte)i);
+            if(!id)
+                break;
+            if(UA_NodeId_equal(id, refTypeId)) {
+                *outIndex = (UA_Byte)i;
+                return UA_STATUSCODE_GOOD;
+            }
+        }
+
+        if(attempt > 0 || refTypeId->namespaceIndex == 0 ||
+           !referenceTypesReady(s))
+            break;
+
+        long pos = findIndexEntry(s, s->nodeIndex, s->nodesCount, refTypeId);
+        if(pos < 0 || materializeNode(s, pos) != UA_STATUSCODE_GOOD)
+            break;
+    }
+    return UA_STATUSCODE_BADREFERENCETYPEIDINVALID;
+}
+
+static void
+readReferences(UA_SnapshotStore *s, SnapshotReader *r, UA_Node *node) {
+    UA_UInt32 kindsCount = getU32(r);
+    for(UA_UInt32 i = 0; i < kindsCount && r->res == UA_STATUSCODE_GOOD; i++) {
+        UA_NodeId refTypeId;
+        getEncoded(r, &refTypeId, &UA_TYPES[UA_TYPES_NODEID]);
+        UA_Boolean isInverse = (getByte(r) != 0);
+        UA_UInt32 targetsCount = getU32(r);
+        UA_Byte refTypeIndex = 0;
+        if(r->res == UA_STATUSCODE_GOOD)
+            r->res = resolveReferenceType(s, &refTypeId, &refTypeIndex);
+        UA_NodeId_clear(&refTypeId);
+        for(UA_UInt32 j = 0; j < targetsCount && r->res == UA_STATUSCODE_GOOD; j++) {
+            UA_ExpandedNodeId target;
+            getEncoded(r, &target, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            UA_UInt32 targetNameHash = getU32(r);
+            if(r->res == UA_STATUSCODE_GOOD) {
+                UA_StatusCode res = UA_Node_addReference(node, refTypeIndex, !isInverse,
+                                                         &target, targetNameHash);
+                if(res != UA_STATUSCODE_BADDUPLICATEREFERENCENOTALLOWED)
+                    r->res = res;
+            }
+            UA_ExpandedNodeId_clear(&target);
+        }
+    }
+}
+
+static void
+readLocalizedTextList(SnapshotReader *r, UA_LocalizedTextListEntry **root) {
+    UA_UInt32 count = getU32(r);
+    UA_LocalizedTextListEntry **next = root;
+    for(UA_UInt32 i = 0; i < count && r->res == UA_STATUSCODE_GOOD; i++) {
+        UA_LocalizedTextListEntry *lt = (UA_LocalizedTextListEntry*)
+            UA_calloc(1, sizeof(UA_LocalizedTextListEntry));
+        if(!lt) {
+            r->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        *next = lt; /* Keep the original order */
+        next = &lt->next;
+        getEncoded(r, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    }
+}
+
+static void
+readVariableAttributes(SnapshotReader *r, UA_VariableNode *vn) {
+    getEncoded(r, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    getEncoded(r, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    UA_UInt32 dims = getU32(r);
+    if(r->res != UA_STATUSCODE_GOOD)
+        return;
+    if(dims > 0) {
+        if((size_t)(r->end - r->pos) < (size_t)dims * 4) {
+            r->res = UA_STATUSCODE_BADDECODINGERROR;
+            return;
+        }
+        vn->arrayDimensions = (UA_UInt32*)
+            UA_Array_new(dims, &UA_TYPES[UA_TYPES_UINT32]);
+        if(!vn->arrayDimensions) {
+            r->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        vn->arrayDimensionsSize = dims;
+        for(UA_UInt32 i = 0; i < dims; i++)
+            vn->arrayDimensions[i] = getU32(r);
+    }
+
+    vn->valueSource = UA_VALUESOURCE_DATA;
+    if(getByte(r)) {
+        if(getByte(r))
+            vn->valueBackend.backendType = UA_VALUEBACKENDTYPE_INTERNAL;
+        getEncoded(r, &vn->value.data.value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    }
+}
+
+static UA_StatusCode
+readNodeRecord(UA_SnapshotStore *s, SnapshotReader *r, UA_Node **outNode) {
+    UA_NodeId nodeId;
+    getEncoded(r, &nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_NodeClass nodeClass = (UA_NodeClass)getU32(r);
+    if(r->res != UA_STATUSCODE_GOOD) {
+        UA_NodeId_clear(&nodeId);
+        return r->res;
+    }
+
+    UA_Node *node = s->backend.newNode(s->backend.context, nodeClass);
+    if(!node) {
+        UA_NodeId_clear(&nodeId);
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    }
+
+    UA_NodeHead *head = &node->head;
+    head->nodeId = nodeId;
+    getEncoded(r, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    readLocalizedTextList(r, &head->displayName);
+    readLocalizedTextList(r, &head->description);
+    head->writeMask = getU32(r);
+    readReferences(s, r, node);
+
+    /* The node is fully initialized. Callbacks and contexts can be attached
+     * again by the application. */
+    head->constructed = true;
+
+    switch(nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        readVariableAttributes(r, &node->variableNode);
+        node->variableNode.accessLevel = getByte(r);
+        getEncoded(r, &node->variableNode.minimumSamplingInterval,
+                   &UA_TYPES[UA_TYPES_DOUBLE]);
+        node->variableNode.historizing = (getByte(r) != 0);
+        node->variableNode.isDynamic = (getByte(r) != 0);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        readVariableAttributes(r, (UA_VariableNode*)&node->variableTypeNode);
+        node->variableTypeNode.isAbstract = (getByte(r) != 0);
+        break;
+    case UA_NODECLASS_METHOD:
+        node->methodNode.executable = (getByte(r) != 0);
+        break;
+    case UA_NODECLASS_OBJECT:
+        node->objectNode.eventNotifier = getByte(r);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        node->objectTypeNode.isAbstract = (getByte(r) != 0);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        node->referenceTypeNode.isAbstract = (getByte(r) != 0);
+        node->referenceTypeNode.symmetric = (getByte(r) != 0);
+        getEncoded(r, &node->referenceTypeNode.inverseName,
+                   &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        node->dataTypeNode.isAbstract = (getByte(r) != 0);
+        break;
+    case UA_NODECLASS_VIEW:
+        node->viewNode.eventNotifier = getByte(r);
+        node->viewNode.containsNoLoops = (getByte(r) != 0);
+        break;
+    default:
+        r->res = UA_STATUSCODE_BADNODECLASSINVALID;
+        break;
+    }
+
+    if(r->res != UA_STATUSCODE_GOOD) {
+        s->backend.deleteNode(s->backend.context, node);
+        return r->res;
+    }
+    *outNode = node;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void *
+getSupertype(void *context, UA_ReferenceTarget *t) {
+    if(!UA_NodePointer_isLocal(t->targetId))
+        return NULL;
+    *(UA_NodeId*)context = UA_NodePointer_toNodeId(t->targetId);
+    return context;
+}
+
+static const UA_Node *
+UA_SnapshotStore_getNode(void *context, const UA_NodeId *nodeId,
+                         UA_UInt32 attributeMask,
+                         UA_ReferenceTypeSet references,
+                         UA_BrowseDirection referenceDirections);
+
+/* Add the subtypes of a new ReferenceType to all of its supertypes. This is
+ * otherwise done by the server when a ReferenceType is added. */
+static void
+propagateSubtypes(UA_SnapshotStore *s, const UA_NodeId *refTypeId,
+                  const UA_ReferenceTypeSet *subTypes) {
+    UA_NodeId current;
+    if(UA_NodeId_copy(refTypeId, &current) != UA_STATUSCODE_GOOD)
+        return;
+    for(size_t depth = 0; depth < UA_REFERENCETYPESET_MAX; depth++) {
+        /* Find the supertype (ReferenceTypes have single inheritance) */
+        const UA_Node *node =
+            UA_SnapshotStore_getNode(s, &current, 0, UA_REFERENCETYPESET_ALL,
+                                     UA_BROWSEDIRECTION_INVERSE);
+        if(!node)
+            break;
+        UA_NodeId parent = UA_NODEID_NULL;
+        void *found = NULL;
+        for(size_t i = 0; i < node->head.referencesSize && !found; i++) {
+            UA_NodeReferenceKind *rk = &node->head.references[i];
+            if(rk->isInverse &&
+               rk->referenceTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE)
+                found = UA_NodeReferenceKind_iterate(rk, getSupertype, &parent);
+        }
+        UA_NodeId_clear(&current);
+        UA_StatusCode res = UA_NodeId_copy(&parent, &current);
+        s->backend.releaseNode(s->backend.context, node);
+        if(!found || res != UA_STATUSCODE_GOOD)
+            break;
+
+        /* Materialize (if required) and edit the supertype */
+        node = UA_SnapshotStore_getNode(s, &current, 0, UA_REFERENCETYPESET_NONE,
+                                        UA_BROWSEDIRECTION_INVERSE);
+        if(!node)
+            break;
+        s->backend.releaseNode(s->backend.context, node);
+        UA_Node *copy = NULL;
+        res = s->backend.getNodeCopy(s->backend.context, &current, &copy);
+        if(res != UA_STATUSCODE_GOOD)
+            break;
+        if(copy->head.nodeClass != UA_NODECLASS_REFERENCETYPE) {
+            s->backend.deleteNode(s->backend.context, copy);
+            break;
+        }
+        copy->referenceTypeNode.subTypes =
+            UA_ReferenceTypeSet_union(copy->referenceTypeNode.subTypes, *subTypes);
+        s->backend.replaceNode(s->backend.context, copy);
+    }
+    UA_NodeId_clear(&current);
+}
+
+static UA_StatusCode
+materializeNode(UA_SnapshotStore *s, long pos) {
+    if(s->nodeState[pos] == SNAPSHOT_ENTRY_MATERIALIZED)
+        return UA_STATUSCODE_GOOD;
+    if(s->nodeState[pos] != SNAPSHOT_ENTRY_IMAGE)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    /* Decode the node. This can recursively materialize ReferenceTypes. */
+    s->nodeState[pos] = SNAPSHOT_ENTRY_MATERIALIZING;
+    SnapshotReader r = entryReader(s, s->nodeIndex, pos);
+    UA_Node *node = NULL;
+    UA_StatusCode res = readNodeRecord(s, &r, &node);
+    if(res != UA_STATUSCODE_GOOD) {
+        s->nodeState[pos] = SNAPSHOT_ENTRY_IMAGE; /* Retry later */
+        return res;
+    }
+
+    /* Insert into the backend */
+    UA_NodeId nodeId;
+    res = UA_NodeId_copy(&node->head.nodeId, &nodeId);
+    if(res != UA_STATUSCODE_GOOD) {
+        s->backend.deleteNode(s->backend.context, node);
+        s->nodeState[pos] = SNAPSHOT_ENTRY_IMAGE;
+        return res;
+    }
+    UA_Boolean isRefType = (node->head.nodeClass == UA_NODECLASS_REFERENCETYPE);
+    res = s->backend.insertNode(s->backend.context, node, NULL);
+    if(res != UA_STATUSCODE_GOOD) {
+        s->nodeState[pos] = SNAPSHOT_ENTRY_IMAGE;
+        UA_NodeId_clear(&nodeId);
+        return res;
+    }
+    s->nodeState[pos] = SNAPSHOT_ENTRY_MATERIALIZED;
+
+    /* Set up the subtype bitfields of new ReferenceTypes. Materialize the
+     * subtypes from the image so that browsing for the ReferenceType also
+     * yields references of the subtypes. */
+    if(isRefType) {
+        const UA_Node *rn =
+            s->backend.getNode(s->backend.context, &nodeId, 0,
+                               UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+        if(rn) {
+            UA_ReferenceTypeSet subTypes = rn->referenceTypeNode.subTypes;
+            s->backend.releaseNode(s->backend.context, rn);
+            propagateSubtypes(s, &nodeId, &subTypes);
+        }
+
+        r = entryReader(s, s->nodeIndex, pos);
+        UA_NodeId tmpId;
+        getEncoded(&r, &tmpId, &UA_TYPES[UA_TYPES_NODEID]);
+        UA_NodeId_clear(&tmpId);
+        getU32(&r);
+        UA_QualifiedName tmpName;
+        getEncoded(&r, &tmpName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+        UA_QualifiedName_clear(&tmpName);
+        for(size_t l = 0; l < 2; l++) {
+            UA_UInt32 texts = getU32(&r);
+            for(UA_UInt32 i = 0; i < texts && r.res == UA_STATUSCODE_GOOD; i++) {
+                UA_LocalizedText tmpText;
+                getEncoded(&r, &tmpText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+                UA_LocalizedText_clear(&tmpText);
+            }
+        }
+        getU32(&r); /* writeMask */
+
+        const UA_NodeId hasSubtypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE);
+        UA_UInt32 kindsCount = getU32(&r);
+        for(UA_UInt32 i = 0; i < kindsCount && r.res == UA_STATUSCODE_GOOD; i++) {
+            UA_NodeId refTypeId;
+            getEncoded(&r, &refTypeId, &UA_TYPES[UA_TYPES_NODEID]);
+            UA_Boolean subtypeRefs = (getByte(&r) == 0 &&
+                                      UA_NodeId_equal(&refTypeId, &hasSubtypeId));
+            UA_NodeId_clear(&refTypeId);
+            UA_UInt32 targetsCount = getU32(&r);
+            for(UA_UInt32 j = 0; j < targetsCount && r.res == UA_STATUSCODE_GOOD; j++) {
+                UA_ExpandedNodeId target;
+                getEncoded(&r, &target, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+                getU32(&r);
+                if(subtypeRefs && r.res == UA_STATUSCODE_GOOD) {
+                    long subPos = findIndexEntry(s, s->nodeIndex, s->nodesCount,
+                                                 &target.nodeId);
+                    if(subPos >= 0)
+                        materializeNode(s, subPos);
+                }
+                UA_ExpandedNodeId_clear(&target);
+            }
+        }
+    }
+
+    UA_NodeId_clear(&nodeId);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Materialize all ReferenceTypes of the image once the ns0 ReferenceTypes are
+ * available. The server computes the subtype-sets for browsing from the
+ * ReferenceTypeNodes. So they need to be complete before the first lookup. */
+static void
+loadReferenceTypes(UA_SnapshotStore *s) {
+    if(s->refTypesLoaded || !referenceTypesReady(s))
+        return;
+    s->refTypesLoaded = true;
+    for(UA_UInt32 i = 0; i < s->nodesCount; i++) {
+        if(s->nodeState[i] != SNAPSHOT_ENTRY_IMAGE)
+            continue;
+        SnapshotReader r = entryReader(s, s->nodeIndex, (long)i);
+        UA_NodeId id;
+        getEncoded(&r, &id, &UA_TYPES[UA_TYPES_NODEID]);
+        UA_NodeId_clear(&id);
+        if(getU32(&r) == UA_NODECLASS_REFERENCETYPE && r.res == UA_STATUSCODE_GOOD)
+            materializeNode(s, (long)i);
+    }
+}
+
+/* Apply the references from the image to an ns0 node */
+static void
+applyPatch(UA_SnapshotStore *s, const UA_NodeId *nodeId) {
+    long pos = findIndexEntry(s, s->patchIndex, s->patchesCount, nodeId);
+    if(pos < 0 || s->patchState[pos] != SNAPSHOT_ENTRY_IMAGE)
+        return;
+
+    UA_Node *copy = NULL;
+    UA_StatusCode res = s->backend.getNodeCopy(s->backend.context, nodeId, &copy);
+    if(res != UA_STATUSCODE_GOOD)
+        return;
+
+    s->patchState[pos] = SNAPSHOT_ENTRY_MATERIALIZING;
+    SnapshotReader r = entryReader(s, s->patchIndex, pos);
+    UA_NodeId tmpId;
+    getEncoded(&r, &tmpId, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_NodeId_clear(&tmpId);
+    readReferences(s, &r, copy);
+    if(r.res != UA_STATUSCODE_GOOD) {
+        /* The ReferenceTypes are not yet available. Retry later. */
+        s->backend.deleteNode(s->backend.context, copy);
+        s->patchState[pos] = SNAPSHOT_ENTRY_IMAGE;
+        return;
+    }
+
+    res = s->backend.replaceNode(s->backend.context, copy);
+    if(res != UA_STATUSCODE_GOOD) {
+        s->patchState[pos] = SNAPSHOT_ENTRY_IMAGE;
+        return;
+    }
+    s->patchState[pos] = SNAPSHOT_ENTRY_MATERIALIZED;
+    s->patchesPending--;
+}
+
+static void
+prepareNode(UA_SnapshotStore *s, const UA_NodeId *nodeId) {
+    loadReferenceTypes(s);
+    if(nodeId->namespaceIndex == 0) {
+        if(s->patchesPending > 0)
+            applyPatch(s, nodeId);
+        return;
+    }
+    long pos = findIndexEntry(s, s->nodeIndex, s->nodesCount, nodeId);
+    if(pos >= 0)
+        materializeNode(s, pos);
+}
+
+/***********************/
+/* Interface functions */
+/***********************/
+
+static UA_Node *
+UA_SnapshotStore_newNode(void *context, UA_NodeClass nodeClass) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    return s->backend.newNode(s->backend.context, nodeClass);
+}
+
+static void
+UA_SnapshotStore_deleteNode(void *context, UA_Node *node) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    s->backend.deleteNode(s->backend.context, node);
+}
+
+static const UA_Node *
+UA_SnapshotStore_getNode(void *context, const UA_NodeId *nodeId,
+                         UA_UInt32 attributeMask,
+                         UA_ReferenceTypeSet references,
+                         UA_BrowseDirection referenceDirections) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    loadReferenceTypes(s);
+    if(nodeId->namespaceIndex == 0 && s->patchesPending > 0)
+        applyPatch(s, nodeId);
+    const UA_Node *node =
+        s->backend.getNode(s->backend.context, nodeId, attributeMask,
+                           references, referenceDirections);
+    if(node || nodeId->namespaceIndex == 0)
+        return node;
+    long pos = findIndexEntry(s, s->nodeIndex, s->nodesCount, nodeId);
+    if(pos < 0 || materializeNode(s, pos) != UA_STATUSCODE_GOOD)
+        return NULL;
+    return s->backend.getNode(s->backend.context, nodeId, attributeMask,
+                              references, referenceDirections);
+}
+
+static const UA_Node *
+UA_SnapshotStore_getNodeFromPtr(void *context, UA_NodePointer ptr,
+                                UA_UInt32 attributeMask,
+                                UA_ReferenceTypeSet references,
+                                UA_BrowseDirection referenceDirections) {
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    UA_NodeId id = UA_NodePointer_toNodeId(ptr);
+    return UA_SnapshotStore_getNode(context, &id, attributeMask,
+                                    references, referenceDirections);
+}
+
+static void
+UA_SnapshotStore_releaseNode(void *context, const UA_Node *node) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    s->backend.releaseNode(s->backend.context, node);
+}
+
+static UA_StatusCode
+UA_SnapshotStore_getNodeCopy(void *context, const UA_NodeId *nodeId,
+                             UA_Node **outNode) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    prepareNode(s, nodeId);
+    return s->backend.getNodeCopy(s->backend.context, nodeId, outNode);
+}
+
+static UA_StatusCode
+UA_SnapshotStore_insertNode(void *context, UA_Node *node,
+                            UA_NodeId *addedNodeId) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    UA_NodeId *id = &node->head.nodeId;
+
+    /* Generate a random numeric identifier that is not yet used in the image
+     * or the backend. Use the same range as the default nodestores. */
+    if(id->namespaceIndex != 0 && id->identifierType == UA_NODEIDTYPE_NUMERIC &&
+       id->identifier.numeric == 0) {
+        for(size_t attempt = 0; attempt < 1000; attempt++) {
+            id->identifier.numeric = 50000 + (UA_UInt32_random() % (0x01 << 24));
+            if(findIndexEntry(s, s->nodeIndex, s->nodesCount, id) >= 0)
+                continue;
+            const UA_Node *existing =
+                s->backend.getNode(s->backend.context, id, 0,
+                                   UA_REFERENCETYPESET_NONE,
+                                   UA_BROWSEDIRECTION_INVERSE);
+            if(!existing)
+                break;
+            s->backend.releaseNode(s->backend.context, existing);
+        }
+    }
+
+    /* The node exists in the image */
+    long pos = findIndexEntry(s, s->nodeIndex, s->nodesCount, id);
+    if(pos >= 0 && s->nodeState[pos] != SNAPSHOT_ENTRY_REMOVED) {
+        s->backend.deleteNode(s->backend.context, node);
+        return UA_STATUSCODE_BADNODEIDEXISTS;
+    }
+
+    return s->backend.insertNode(s->backend.context, node, addedNodeId);
+}
+
+static UA_StatusCode
+UA_SnapshotStore_replaceNode(void *context, UA_Node *node) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    return s->backend.replaceNode(s->backend.context, node);
+}
+
+static UA_StatusCode
+UA_SnapshotStore_removeNode(void *context, const UA_NodeId *nodeId) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+
+    /* Not yet materialized. Only mark as removed. */
+    long pos = findIndexEntry(s, s->nodeIndex, s->nodesCount, nodeId);
+    if(pos >= 0 && s->nodeState[pos] == SNAPSHOT_ENTRY_IMAGE) {
+        s->nodeState[pos] = SNAPSHOT_ENTRY_REMOVED;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Look up the patch first. The NodeId can point into the removed node. */
+    long patchPos = findIndexEntry(s, s->patchIndex, s->patchesCount, nodeId);
+    UA_StatusCode res = s->backend.removeNode(s->backend.context, nodeId);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* The image entry must neither be materialized again nor block a new node
+     * with the same NodeId. A pending patch must not be applied to a new ns0
+     * node either. */
+    if(pos >= 0)
+        s->nodeState[pos] = SNAPSHOT_ENTRY_REMOVED;
+    if(patchPos >= 0 && s->patchState[patchPos] != SNAPSHOT_ENTRY_REMOVED) {
+        if(s->patchState[patchPos] == SNAPSHOT_ENTRY_IMAGE)
+            s->patchesPending--;
+        s->patchState[patchPos] = SNAPSHOT_ENTRY_REMOVED;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static const UA_NodeId *
+UA_SnapshotStore_getReferenceTypeId(void *context, UA_Byte refTypeIndex) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    return s->backend.getReferenceTypeId(s->backend.context, refTypeIndex);
+}
+
+static void
+UA_SnapshotStore_iterate(void *context, UA_NodestoreVisitor visitor,
+                         void *visitorContext) {
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+
+    /* Materialize everything (that can be materialized) first */
+    loadReferenceTypes(s);
+    for(UA_UInt32 i = 0; i < s->nodesCount; i++)
+        materializeNode(s, (long)i);
+    for(UA_UInt32 i = 0; i < s->patchesCount && s->patchesPending > 0; i++) {
+        if(s->patchState[i] != SNAPSHOT_ENTRY_IMAGE)
+            continue;
+        SnapshotReader r = entryReader(s, s->patchIndex, (long)i);
+        UA_NodeId id;
+        getEncoded(&r, &id, &UA_TYPES[UA_TYPES_NODEID]);
+        if(r.res == UA_STATUSCODE_GOOD)
+            applyPatch(s, &id);
+        UA_NodeId_clear(&id);
+    }
+
+    s->backend.iterate(s->backend.context, visitor, visitorContext);
+}
+
+static void
+unloadImage(UA_SnapshotStore *s) {
+    if(!s->image)
+        return;
+#ifdef UA_ARCHITECTURE_POSIX
+    if(s->mapped) {
+        munmap((void*)(uintptr_t)s->image, s->imageSize);
+        s->image = NULL;
+        return;
+    }
+#endif
+    UA_free((void*)(uintptr_t)s->image);
+    s->image = NULL;
+}
+
+static void
+UA_SnapshotStore_clear(void *context) {
+    if(!context)
+        return;
+    UA_SnapshotStore *s = (UA_SnapshotStore*)context;
+    s->backend.clear(s->backend.context);
+    unloadImage(s);
+    UA_free(s->nodeState);
+    UA_free(s->patchState);
+    UA_free(s);
+}
+
+/* Map the file into memory. Pages of the mmapped file can be shared between
+ * processes that load the same snapshot. Fall back to reading the entire file
+ * if mmap is not available. */
+static UA_StatusCode
+loadImage(UA_SnapshotStore *s, const char *path) {
+#ifdef UA_ARCHITECTURE_POSIX
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return UA_STATUSCODE_BADNOTFOUND;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+    void *image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(image != MAP_FAILED) {
+        s->image = (const UA_Byte*)image;
+        s->imageSize = (size_t)st.st_size;
+        s->mapped = true;
+        return UA_STATUSCODE_GOOD;
+    }
+#endif
+
+    FILE *f = fopen(path, "rb");
+    if(!f)
+        return UA_STATUSCODE_BADNOTFOUND;
+    UA_StatusCode res = UA_STATUSCODE_BADINTERNALERROR;
+    long size = -1;
+    if(fseek(f, 0, SEEK_END) == 0)
+        size = ftell(f);
+    if(size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        UA_Byte *image = (UA_Byte*)UA_malloc((size_t)size);
+        if(!image) {
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+        } else if(fread(image, 1, (size_t)size, f) != (size_t)size) {
+            UA_free(image);
+        } else {
+            s->image = image;
+            s->imageSize = (size_t)size;
+            res = UA_STATUSCODE_GOOD;
+        }
+    }
+    fclose(f);
+    return res;
+}
+
+static UA_StatusCode
+checkImage(UA_SnapshotStore *s) {
+    const UA_Byte *h = s->image;
+    if(s->imageSize < SNAPSHOT_HEADERSIZE ||
+       memcmp(h, SNAPSHOT_MAGIC, 4) != 0 ||
+       loadU32(&h[4]) != SNAPSHOT_VERSION ||
+       loadU64(&h[40]) != s->imageSize)
+        return UA_STATUSCODE_BADDECODINGERROR;
+
+    s->nodesCount = loadU32(&h[8]);
+    s->patchesCount = loadU32(&h[12]);
+    s->ns0RefTypes = loadU32(&h[16]);
+    UA_UInt64 nodeIndexOffset = loadU64(&h[24]);
+    UA_UInt64 patchIndexOffset = loadU64(&h[32]);
+    if(nodeIndexOffset + (UA_UInt64)s->nodesCount * SNAPSHOT_INDEXENTRYSIZE !=
+       patchIndexOffset ||
+       patchIndexOffset + (UA_UInt64)s->patchesCount * SNAPSHOT_INDEXENTRYSIZE !=
+       s->imageSize)
+        return UA_STATUSCODE_BADDECODINGERROR;
+
+    /* Record offsets must point before the indices */
+    s->nodeIndex = &s->image[nodeIndexOffset];
+    s->patchIndex = &s->image[patchIndexOffset];
+    for(UA_UInt32 i = 0; i < s->nodesCount; i++) {
+        if(loadU64(&s->nodeIndex[i * SNAPSHOT_INDEXENTRYSIZE + 4]) >= nodeIndexOffset)
+            return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    for(UA_UInt32 i = 0; i < s->patchesCount; i++) {
+        if(loadU64(&s->patchIndex[i * SNAPSHOT_INDEXENTRYSIZE + 4]) >= nodeIndexOffset)
+            return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Nodestore_loadSnapshot(UA_Nodestore *ns, const char *path,
+                          const UA_DataTypeArray *customTypes) {
+    if(!ns || !ns->context || !path)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    UA_SnapshotStore *s = (UA_SnapshotStore*)UA_calloc(1, sizeof(UA_SnapshotStore));
+    if(!s)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    s->options.customTypes = customTypes;
+
+    UA_StatusCode res = loadImage(s, path);
+    if(res == UA_STATUSCODE_GOOD)
+        res = checkImage(s);
+    if(res == UA_STATUSCODE_GOOD) {
+        s->nodeState = (UA_Byte*)UA_calloc(s->nodesCount + 1, sizeof(UA_Byte));
+        s->patchState = (UA_Byte*)UA_calloc(s->patchesCount + 1, sizeof(UA_Byte));
+        if(!s->nodeState || !s->patchState)
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    if(res != UA_STATUSCODE_GOOD) {
+        unloadImage(s);
+        UA_free(s->nodeState);
+        UA_free(s->patchState);
+        UA_free(s);
+        return res;
+    }
+    s->patchesPending = s->patchesCount;
+
+    /* Wrap the existing nodestore */
+    s->backend = *ns;
+    ns->context = s;
+    ns->clear = UA_SnapshotStore_clear;
+    ns->newNode = UA_SnapshotStore_newNode;
+    ns->deleteNode = UA_SnapshotStore_deleteNode;
+    ns->getNode = UA_SnapshotStore_getNode;
+    ns->getNodeFromPtr = UA_SnapshotStore_getNodeFromPtr;
+    ns->releaseNode = UA_SnapshotStore_releaseNode;
+    ns->getNodeCopy = UA_SnapshotStore_getNodeCopy;
+    ns->insertNode = UA_SnapshotStore_insertNode;
+    ns->replaceNode = UA_SnapshotStore_replaceNode;
+    ns->removeNode = UA_SnapshotStore_removeNode;
+    ns->getReferenceTypeId = UA_SnapshotStore_getReferenceTypeId;
+    ns->iterate = UA_SnapshotStore_iterate;
+    return UA_STATUSCODE_GOOD;
+}
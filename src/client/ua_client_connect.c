@@ -1687,15 +1687,15 @@ initConnect(UA_Client *client) {
         return;
     }
 
-    /* Initialize the TCP connection */
-    UA_String tcpString = UA_STRING("tcp");
+    /* Initialize the TCP (or in-memory) connection */
+    UA_String protocol = getEndpointUrlProtocol(&client->config.endpointUrl);
     for(UA_EventSource *es = client->config.eventLoop->eventSources;
         es != NULL; es = es->next) {
         /* Is this a usable connection manager? */
         if(es->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
             continue;
         UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
-        if(!UA_String_equal(&tcpString, &cm->protocol))
+        if(!UA_String_equal(&protocol, &cm->protocol))
             continue;
 
         /* Set up the parameters */
@@ -333,6 +333,17 @@ UA_PubSubConnection_connectUDP(UA_Server *server, UA_PubSubConnection *c,
     return UA_STATUSCODE_GOOD;
 }
 
+/* Connection properties of the PubSubConnection that are forwarded to the
+ * Ethernet ConnectionManager under a different name. All but the first are
+ * UInt32 for the ConnectionManager. */
+#define UA_PUBSUB_ETH_PROPERTIES 4
+static const UA_QualifiedName ethProperties[UA_PUBSUB_ETH_PROPERTIES][2] = {
+    {{0, UA_STRING_STATIC("enableXdpSocket")}, {0, UA_STRING_STATIC("xdp")}},
+    {{0, UA_STRING_STATIC("hwreceivequeue")}, {0, UA_STRING_STATIC("xdp-queue")}},
+    {{0, UA_STRING_STATIC("xdpflag")}, {0, UA_STRING_STATIC("xdp-flags")}},
+    {{0, UA_STRING_STATIC("xdpbindflag")}, {0, UA_STRING_STATIC("xdp-bind-flags")}}
+};
+
 static UA_StatusCode
 UA_PubSubConnection_connectETH(UA_Server *server, UA_PubSubConnection *c,
                                UA_Boolean validate) {
@@ -354,7 +365,7 @@ UA_PubSubConnection_connectETH(UA_Server *server, UA_PubSubConnection *c,
     /* Set up the connection parameters.
      * TDOD: Complete the considered parameters. VID, PCP, etc. */
     UA_Boolean listen = true;
-    UA_KeyValuePair kvp[4];
+    UA_KeyValuePair kvp[4 + UA_PUBSUB_ETH_PROPERTIES];
     UA_KeyValueMap kvm = {4, kvp};
     kvp[0].key = UA_QUALIFIEDNAME(0, "address");
     UA_Variant_setScalar(&kvp[0].value, &address, &UA_TYPES[UA_TYPES_STRING]);
@@ -366,6 +377,24 @@ UA_PubSubConnection_connectETH(UA_Server *server, UA_PubSubConnection *c,
     kvp[3].key = UA_QUALIFIEDNAME(0, "validate");
     UA_Variant_setScalar(&kvp[3].value, &validate, &UA_TYPES[UA_TYPES_BOOLEAN]);
 
+    /* Receive with an AF_XDP socket if configured. Numeric properties that
+     * are set as UInt16 are converted to UInt32. */
+    UA_UInt32 ethValues[UA_PUBSUB_ETH_PROPERTIES];
+    for(size_t i = 0; i < UA_PUBSUB_ETH_PROPERTIES; i++) {
+        const UA_Variant *prop =
+            UA_KeyValueMap_get(&c->config.connectionProperties, ethProperties[i][0]);
+        if(!prop)
+            continue;
+        kvp[kvm.mapSize].key = ethProperties[i][1];
+        kvp[kvm.mapSize].value = *prop;
+        if(i > 0 && UA_Variant_hasScalarType(prop, &UA_TYPES[UA_TYPES_UINT16])) {
+            ethValues[i] = *(const UA_UInt16*)prop->data;
+            UA_Variant_setScalar(&kvp[kvm.mapSize].value, &ethValues[i],
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+        }
+        kvm.mapSize++;
+    }
+
     /* Open recv channels */
     if(c->recvChannelsSize == 0) {
         UA_UNLOCK(&server->serviceMutex);
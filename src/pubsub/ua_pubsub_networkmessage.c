@@ -1028,6 +1028,14 @@ UA_NetworkMessage_calcSizeBinary(UA_NetworkMessage *p,
             size += (size_t)(2LU * count); /* uint16 */
     }
     for(size_t i = 0; i < count; i++) {
+        /* Reuse the DataSetMessage sizes computed for the payload header. Not
+         * when the offset buffer is generated, that needs to visit every
+         * field. */
+        if(!offsetBuffer && p->payload.dataSetPayload.sizes &&
+           p->payload.dataSetPayload.sizes[i] != 0) {
+            size += p->payload.dataSetPayload.sizes[i];
+            continue;
+        }
         UA_DataSetMessage *dsm = &p->payload.dataSetPayload.dataSetMessages[i];
         size = UA_DataSetMessage_calcSizeBinary(dsm, offsetBuffer, size);
     }
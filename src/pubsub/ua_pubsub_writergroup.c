@@ -1107,12 +1107,17 @@ generateNetworkMessage(UA_PubSubConnection *connection, UA_WriterGroup *wg,
     if(networkMessage->groupHeader.groupVersionEnabled)
         networkMessage->groupHeader.groupVersion = wgm->groupVersion;
 
-    /* Compute the length of the dsm separately for the header */
+    /* Compute the length of the dsm separately for the header. The lengths
+     * are reused when the size of the NetworkMessage is computed. Leave at
+     * zero if the length does not fit, so it gets computed again. */
     UA_UInt16 *dsmLengths = (UA_UInt16 *) UA_calloc(dsmCount, sizeof(UA_UInt16));
     if(!dsmLengths)
         return UA_STATUSCODE_BADOUTOFMEMORY;
-    for(UA_Byte i = 0; i < dsmCount; i++)
-        dsmLengths[i] = (UA_UInt16) UA_DataSetMessage_calcSizeBinary(&dsm[i], NULL, 0);
+    for(UA_Byte i = 0; i < dsmCount; i++) {
+        size_t dsmLength = UA_DataSetMessage_calcSizeBinary(&dsm[i], NULL, 0);
+        if(dsmLength <= UA_UINT16_MAX)
+            dsmLengths[i] = (UA_UInt16)dsmLength;
+    }
 
     networkMessage->payloadHeader.dataSetPayloadHeader.count = dsmCount;
     networkMessage->payloadHeader.dataSetPayloadHeader.dataSetWriterIds = writerIds;
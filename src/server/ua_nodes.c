@@ -427,6 +427,10 @@ void UA_Node_clear(UA_Node *node) {
         p->arrayDimensionsSize = 0;
         if(p->valueSource == UA_VALUESOURCE_DATA)
             UA_DataValue_clear(&p->value.data.value);
+        if(head->nodeClass == UA_NODECLASS_VARIABLE && p->encodedValue) {
+            UA_ByteString_delete(p->encodedValue);
+            p->encodedValue = NULL;
+        }
         break;
     }
     case UA_NODECLASS_REFERENCETYPE: {
@@ -477,6 +481,11 @@ UA_VariableNode_copy(const UA_VariableNode *src, UA_VariableNode *dst) {
     dst->minimumSamplingInterval = src->minimumSamplingInterval;
     dst->historizing = src->historizing;
     dst->isDynamic = src->isDynamic;
+    dst->cacheEncodedValue = src->cacheEncodedValue;
+    dst->encodedValue = NULL; /* The cached encoding is not shared */
+#if UA_MULTITHREADING >= 100
+    dst->async = src->async;
+#endif
     return UA_CommonVariableNode_copy(src, dst);
 }
 
@@ -981,10 +990,33 @@ addReferenceKind(UA_NodeHead *head, UA_Byte refTypeIndex, UA_Boolean isForward,
     return UA_STATUSCODE_GOOD;
 }
 
+/* Counts the edits of inverse HasSubtype references in all nodes. The server
+ * drops its type tree cache when the counter has moved. This also covers the
+ * plugins that edit the nodes directly (nodeset loader, snapshot nodestore). */
+static void * volatile subtypeChanges = NULL;
+
+static void
+countSubtypeChange(UA_Byte refTypeIndex, UA_Boolean isForward) {
+    if(isForward || refTypeIndex != UA_REFERENCETYPEINDEX_HASSUBTYPE)
+        return;
+    void *count;
+    do {
+        count = subtypeChanges;
+    } while(UA_atomic_cmpxchg(&subtypeChanges, count,
+                              (void*)((uintptr_t)count + 1)) != count);
+}
+
+size_t
+nodeSubtypeChanges(void) {
+    return (size_t)(uintptr_t)UA_atomic_cmpxchg(&subtypeChanges, NULL, NULL);
+}
+
 UA_StatusCode
 UA_Node_addReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForward,
                      const UA_ExpandedNodeId *targetNodeId,
                      UA_UInt32 targetBrowseNameHash) {
+    countSubtypeChange(refTypeIndex, isForward);
+
     /* Find the matching reference kind */
     for(size_t i = 0; i < node->head.referencesSize; ++i) {
         UA_NodeReferenceKind *refs = &node->head.references[i];
@@ -1018,6 +1050,7 @@ UA_Node_addReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForward,
 UA_StatusCode
 UA_Node_deleteReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForward,
                         const UA_ExpandedNodeId *targetNodeId) {
+    countSubtypeChange(refTypeIndex, isForward);
     UA_NodeHead *head = &node->head;
     for(size_t i = 0; i < head->referencesSize; i++) {
         UA_NodeReferenceKind *refs = &head->references[i];
@@ -1203,3 +1236,210 @@ UA_Node_insertOrUpdateDescription(UA_NodeHead *head,
                                   const UA_LocalizedText *value) {
     return UA_Node_insertOrUpdateLocale(&head->description, value);
 }
+
+/*******************************/
+/* Shared Memory Value Backend */
+/*******************************/
+
+#define UA_SHAREDMEMORY_ALIGN(x) (((x) + 7) & ~(UA_UInt64)7)
+#define UA_SHAREDMEMORY_MAXRETRIES 64
+
+/* The region is shared with another process. So memory barriers are required
+ * also without multithreading in the server. */
+static UA_INLINE void
+sharedMemoryFence(void) {
+#if defined(__GNUC__) || defined(__clang__)
+    __sync_synchronize();
+#elif defined(_WIN32)
+    MemoryBarrier();
+#endif
+}
+
+static UA_SharedMemoryEntry *
+getSharedMemoryEntry(const UA_SharedMemoryHeader *header, UA_UInt32 entry) {
+    return &((UA_SharedMemoryEntry*)(uintptr_t)(header + 1))[entry];
+}
+
+/* The region is written by another process. Copy the entry once and validate
+ * the copy against the size of the local mapping. The other process can change
+ * the region at any time. So only the validated copy is used afterwards. Only
+ * the sequence counter is read again from the region. */
+static UA_StatusCode
+copySharedMemoryEntry(const UA_SharedMemoryHeader *header, size_t regionSize,
+                      UA_UInt32 entry, UA_SharedMemoryEntry *e) {
+    if(!header || regionSize < sizeof(UA_SharedMemoryHeader))
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    const volatile UA_SharedMemoryHeader *vh =
+        (const volatile UA_SharedMemoryHeader*)header;
+    if(vh->magic != UA_SHAREDMEMORY_MAGIC || vh->version != UA_SHAREDMEMORY_VERSION)
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    if(entry >= vh->entriesSize)
+        return UA_STATUSCODE_BADNOTFOUND;
+    sharedMemoryFence(); /* Entries are published before entriesSize */
+    if(sizeof(UA_SharedMemoryHeader) +
+       (((UA_UInt64)entry + 1) * sizeof(UA_SharedMemoryEntry)) > regionSize)
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    memcpy(e, getSharedMemoryEntry(header, entry), sizeof(UA_SharedMemoryEntry));
+
+    if(e->typeIndex >= UA_TYPES_COUNT || !UA_TYPES[e->typeIndex].pointerFree ||
+       (!e->isArray && e->arrayLength != 1))
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    UA_UInt64 bufSize = sizeof(UA_SharedMemoryBuffer) +
+        ((UA_UInt64)e->arrayLength * UA_TYPES[e->typeIndex].memSize);
+    for(size_t i = 0; i < 2; i++) {
+        if(e->offset[i] != UA_SHAREDMEMORY_ALIGN(e->offset[i]) ||
+           e->offset[i] > regionSize || bufSize > regionSize - e->offset[i])
+            return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_SharedMemory_init(void *region, size_t regionSize, UA_UInt32 entriesCapacity) {
+    UA_UInt64 used = UA_SHAREDMEMORY_ALIGN(sizeof(UA_SharedMemoryHeader) +
+                                           ((UA_UInt64)entriesCapacity *
+                                            sizeof(UA_SharedMemoryEntry)));
+    if(!region || used > regionSize)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    memset(region, 0, (size_t)used);
+    UA_SharedMemoryHeader *header = (UA_SharedMemoryHeader*)region;
+    header->version = UA_SHAREDMEMORY_VERSION;
+    header->entriesCapacity = entriesCapacity;
+    header->regionSize = regionSize;
+    header->usedSize = used;
+    /* Readers check the magic number last */
+    sharedMemoryFence();
+    header->magic = UA_SHAREDMEMORY_MAGIC;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_SharedMemory_addEntry(void *region, const UA_DataType *type,
+                         UA_Boolean isArray, UA_UInt32 arrayLength,
+                         UA_UInt32 *outEntry) {
+    UA_SharedMemoryHeader *header = (UA_SharedMemoryHeader*)region;
+    if(!header || header->magic != UA_SHAREDMEMORY_MAGIC || !type ||
+       !type->pointerFree || type < UA_TYPES || type >= &UA_TYPES[UA_TYPES_COUNT] ||
+       (!isArray && arrayLength != 1))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    if(header->entriesSize >= header->entriesCapacity)
+        return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+
+    /* Allocate the two buffers */
+    UA_UInt64 bufSize = UA_SHAREDMEMORY_ALIGN(sizeof(UA_SharedMemoryBuffer) +
+                                              ((UA_UInt64)arrayLength * type->memSize));
+    if(header->usedSize + (2 * bufSize) > header->regionSize)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_SharedMemoryEntry *e = getSharedMemoryEntry(header, header->entriesSize);
+    e->sequence = 0;
+    e->typeIndex = (UA_UInt16)(type - UA_TYPES);
+    e->isArray = isArray;
+    e->arrayLength = arrayLength;
+    e->offset[0] = header->usedSize;
+    e->offset[1] = header->usedSize + bufSize;
+    memset((UA_Byte*)region + header->usedSize, 0, (size_t)(2 * bufSize));
+    header->usedSize += 2 * bufSize;
+
+    /* Initialize with the status "no data yet" */
+    for(size_t i = 0; i < 2; i++) {
+        UA_SharedMemoryBuffer *buf = (UA_SharedMemoryBuffer*)
+            ((uintptr_t)region + (uintptr_t)e->offset[i]);
+        buf->status = UA_STATUSCODE_BADWAITINGFORINITIALDATA;
+    }
+
+    /* Publish the entry */
+    sharedMemoryFence();
+    if(outEntry)
+        *outEntry = header->entriesSize;
+    header->entriesSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_SharedMemory_write(void *region, size_t regionSize, UA_UInt32 entry,
+                      const void *data, UA_StatusCode status,
+                      UA_DateTime sourceTimestamp) {
+    const UA_SharedMemoryHeader *header = (const UA_SharedMemoryHeader*)region;
+    UA_SharedMemoryEntry e;
+    UA_StatusCode res = copySharedMemoryEntry(header, regionSize, entry, &e);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Write into the inactive buffer */
+    volatile UA_UInt32 *sequence = &getSharedMemoryEntry(header, entry)->sequence;
+    UA_UInt32 seq = *sequence;
+    UA_SharedMemoryBuffer *buf = (UA_SharedMemoryBuffer*)
+        ((uintptr_t)region + (uintptr_t)e.offset[((seq >> 1) + 1) & 0x01]);
+    buf->sourceTimestamp = sourceTimestamp;
+    buf->status = status;
+    if(data)
+        memcpy(buf + 1, data, (size_t)e.arrayLength *
+               UA_TYPES[e.typeIndex].memSize);
+
+    /* Activate the buffer */
+    sharedMemoryFence();
+    *sequence = seq + 2;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_SharedMemory_read(const void *region, size_t regionSize, UA_UInt32 entry,
+                     UA_DataValue *value) {
+    const UA_SharedMemoryHeader *header = (const UA_SharedMemoryHeader*)region;
+    UA_SharedMemoryEntry e;
+    UA_StatusCode res = copySharedMemoryEntry(header, regionSize, entry, &e);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    const volatile UA_UInt32 *sequence = &getSharedMemoryEntry(header, entry)->sequence;
+    const UA_DataType *type = &UA_TYPES[e.typeIndex];
+    size_t dataSize = (size_t)e.arrayLength * type->memSize;
+
+    /* Allocate the memory for the value. Arrays of length zero use the
+     * sentinel for empty arrays. */
+    void *data = UA_EMPTY_ARRAY_SENTINEL;
+    if(dataSize > 0) {
+        data = UA_malloc(dataSize);
+        if(!data)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* Copy from the active buffer. Retry if the producer has activated another
+     * buffer in the meantime. Then the buffer we copied from might have been
+     * overwritten. */
+    UA_StatusCode status = UA_STATUSCODE_GOOD;
+    UA_DateTime sourceTimestamp = 0;
+    size_t retries = 0;
+    for(; retries < UA_SHAREDMEMORY_MAXRETRIES; retries++) {
+        UA_UInt32 seq = *sequence;
+        sharedMemoryFence();
+        const UA_SharedMemoryBuffer *buf = (const UA_SharedMemoryBuffer*)
+            ((uintptr_t)region + (uintptr_t)e.offset[(seq >> 1) & 0x01]);
+        sourceTimestamp = buf->sourceTimestamp;
+        status = buf->status;
+        if(dataSize > 0)
+            memcpy(data, buf + 1, dataSize);
+        sharedMemoryFence();
+        if(seq == *sequence)
+            break;
+    }
+    if(retries == UA_SHAREDMEMORY_MAXRETRIES) {
+        if(dataSize > 0)
+            UA_free(data);
+        return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+    }
+
+    /* Set the result */
+    UA_DataValue_init(value);
+    if(e.isArray)
+        UA_Variant_setArray(&value->value, data, e.arrayLength, type);
+    else
+        UA_Variant_setScalar(&value->value, data, type);
+    value->hasValue = true;
+    value->status = status;
+    value->hasStatus = (status != UA_STATUSCODE_GOOD);
+    if(sourceTimestamp != 0) {
+        value->sourceTimestamp = sourceTimestamp;
+        value->hasSourceTimestamp = true;
+    }
+    return UA_STATUSCODE_GOOD;
+}
@@ -288,12 +288,15 @@ UA_Server_delete(UA_Server *server) {
     server->adminSubscription = NULL;
     UA_assert(server->monitoredItemsSize == 0);
     UA_assert(server->subscriptionsSize == 0);
+    UA_NotificationPool_clear(&server->notificationPool);
 #endif
 
     /* Remove all remaining server components (must be all stopped) */
     ZIP_ITER(UA_ServerComponentTree, &server->serverComponents,
              removeServerComponent, server);
 
+    typeTreeClear(server);
+
     UA_UNLOCK(&server->serviceMutex); /* The timer has its own mutex */
 
     /* Clean up the config */
@@ -534,6 +537,39 @@ UA_Server_removeCallback(UA_Server *server, UA_UInt64 callbackId) {
     UA_UNLOCK(&server->serviceMutex);
 }
 
+static void
+processDelayedFree(void *application, void *context) {
+    UA_DelayedFree *df = (UA_DelayedFree*)application;
+#if UA_MULTITHREADING >= 100
+    /* Pass on to the next reactor EventLoop that is running */
+    UA_ServerConfig *config = &df->server->config;
+    while(df->nextEventLoop < config->reactorEventLoopsSize) {
+        UA_EventLoop *rel = config->reactorEventLoops[df->nextEventLoop++];
+        if(rel->state == UA_EVENTLOOPSTATE_FRESH ||
+           rel->state == UA_EVENTLOOPSTATE_STOPPED)
+            continue;
+        rel->addDelayedCallback(rel, &df->dc);
+        return;
+    }
+#endif
+    df->free(df);
+}
+
+void
+addDelayedFree(UA_Server *server, UA_DelayedFree *df) {
+    UA_EventLoop *el = server->config.eventLoop;
+    if(!el) {
+        df->free(df);
+        return;
+    }
+    df->dc.callback = processDelayedFree;
+    df->dc.application = df;
+    df->dc.context = NULL;
+    df->server = server;
+    df->nextEventLoop = 0;
+    el->addDelayedCallback(el, &df->dc);
+}
+
 static void
 notifySecureChannelsStopped(UA_Server *server, struct UA_ServerComponent *sc,
                             UA_LifecycleState state) {
@@ -650,6 +686,17 @@ UA_Server_getStatistics(UA_Server *server) {
     stat.ss.rejectedSessionCount = sds->rejectedSessionCount;
     stat.ss.sessionTimeoutCount = sds->sessionTimeoutCount;
     stat.ss.sessionAbortCount = sds->sessionAbortCount;
+    memset(&stat.nps, 0, sizeof(UA_NotificationPoolStatistics));
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    UA_LOCK(&server->serviceMutex);
+    UA_NotificationPool *pool = &server->notificationPool;
+    stat.nps.slabCount = pool->slabCount;
+    stat.nps.capacity = pool->capacity;
+    stat.nps.inUse = pool->inUse;
+    stat.nps.peakInUse = pool->peakInUse;
+    stat.nps.inlineValueCount = pool->inlineValueCount;
+    UA_UNLOCK(&server->serviceMutex);
+#endif
     return stat;
 }
 
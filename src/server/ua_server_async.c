@@ -10,11 +10,61 @@
 
 #if UA_MULTITHREADING >= 100
 
+static const UA_DataType *
+getRequestType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_CALL: return &UA_TYPES[UA_TYPES_CALLMETHODREQUEST];
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_READVALUEID];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_WRITEVALUE];
+    default: return NULL;
+    }
+}
+
+static const UA_DataType *
+getResultType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_CALL: return &UA_TYPES[UA_TYPES_CALLMETHODRESULT];
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_DATAVALUE];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_STATUSCODE];
+    default: return NULL;
+    }
+}
+
+static const UA_DataType *
+getResponseType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_CALL: return &UA_TYPES[UA_TYPES_CALLRESPONSE];
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_READRESPONSE];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_WRITERESPONSE];
+    default: return NULL;
+    }
+}
+
+/* The type is passed separately as the parent might be removed already */
 static void
-UA_AsyncOperation_delete(UA_AsyncOperation *ar) {
-    UA_CallMethodRequest_clear(&ar->request);
-    UA_CallMethodResult_clear(&ar->response);
-    UA_free(ar);
+UA_AsyncOperation_delete(UA_AsyncOperation *ao, UA_AsyncOperationType type) {
+    UA_clear(&ao->request, getRequestType(type));
+    UA_clear(&ao->response, getResultType(type));
+    UA_free(ao);
+}
+
+/* Set a bad status for an operation that did not return from the worker */
+static void
+setOperationStatus(UA_AsyncOperation *ao, UA_StatusCode status) {
+    switch(ao->parent->operationType) {
+    case UA_ASYNCOPERATIONTYPE_CALL:
+        ao->response.callMethodResult.statusCode = status;
+        break;
+    case UA_ASYNCOPERATIONTYPE_READ:
+        ao->response.readResult.hasStatus = true;
+        ao->response.readResult.status = status;
+        break;
+    case UA_ASYNCOPERATIONTYPE_WRITE:
+        ao->response.writeResult = status;
+        break;
+    default:
+        break;
+    }
 }
 
 static void
@@ -53,8 +103,8 @@ UA_AsyncManager_sendAsyncResponse(UA_AsyncManager *am, UA_Server *server,
 
     /* Send the Response */
     UA_StatusCode res =
-        sendResponse(server, channel, ar->requestId,
-                     (UA_Response*)&ar->response, &UA_TYPES[UA_TYPES_CALLRESPONSE]);
+        sendResponse(server, channel, ar->requestId, (UA_Response*)&ar->response,
+                     getResponseType(ar->operationType));
     if(res != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_SESSION(server->config.logging, session,
                                "Async Response for Req# %" PRIu32 " failed "
@@ -82,9 +132,40 @@ integrateOperationResult(UA_AsyncManager *am, UA_Server *server,
                  "Return result in the server thread with %" PRIu32 " remaining",
                  ar->opCountdown);
 
-    /* Move the UA_CallMethodResult to UA_CallResponse */
-    ar->response.callResponse.results[ao->index] = ao->response;
-    UA_CallMethodResult_init(&ao->response);
+    /* Move the operation result to the response */
+    switch(ar->operationType) {
+    case UA_ASYNCOPERATIONTYPE_CALL:
+        ar->response.callResponse.results[ao->index] = ao->response.callMethodResult;
+        UA_CallMethodResult_init(&ao->response.callMethodResult);
+        break;
+    case UA_ASYNCOPERATIONTYPE_READ: {
+        UA_DataValue *dv = &ar->response.readResponse.results[ao->index];
+        *dv = ao->response.readResult;
+        UA_DataValue_init(&ao->response.readResult);
+        /* Only return the requested timestamps */
+        UA_TimestampsToReturn ttr = ar->timestampsToReturn;
+        if(ttr == UA_TIMESTAMPSTORETURN_SERVER || ttr == UA_TIMESTAMPSTORETURN_BOTH) {
+            if(!dv->hasServerTimestamp) {
+                UA_EventLoop *el = server->config.eventLoop;
+                dv->serverTimestamp = el->dateTime_now(el);
+                dv->hasServerTimestamp = true;
+            }
+        } else {
+            dv->hasServerTimestamp = false;
+            dv->hasServerPicoseconds = false;
+        }
+        if(ttr == UA_TIMESTAMPSTORETURN_SERVER || ttr == UA_TIMESTAMPSTORETURN_NEITHER) {
+            dv->hasSourceTimestamp = false;
+            dv->hasSourcePicoseconds = false;
+        }
+        break;
+    }
+    case UA_ASYNCOPERATIONTYPE_WRITE:
+        ar->response.writeResponse.results[ao->index] = ao->response.writeResult;
+        break;
+    default:
+        break;
+    }
 
     /* Done with all operations -> send the response */
     UA_Boolean done = (ar->opCountdown == 0);
@@ -107,9 +188,10 @@ processAsyncResults(UA_Server *server) {
     UA_LOCK(&am->queueLock);
     while((ao = TAILQ_FIRST(&am->resultQueue))) {
         TAILQ_REMOVE(&am->resultQueue, ao, pointers);
+        UA_AsyncOperationType type = ao->parent->operationType;
         if(integrateOperationResult(am, server, ao))
             count++;
-        UA_AsyncOperation_delete(ao);
+        UA_AsyncOperation_delete(ao, type);
         /* Pacify clang-analyzer */
         UA_assert(TAILQ_FIRST(&am->resultQueue) != ao);
         am->opsCount--;
@@ -118,6 +200,18 @@ processAsyncResults(UA_Server *server) {
     return count;
 }
 
+/* Integrate the results returned by the workers */
+static void
+processResultCallback(UA_Server *server, void *_) {
+    UA_AsyncManager *am = &server->asyncManager;
+    UA_LOCK(&server->serviceMutex);
+    UA_LOCK(&am->queueLock);
+    am->resultCallbackPending = false;
+    UA_UNLOCK(&am->queueLock);
+    processAsyncResults(server);
+    UA_UNLOCK(&server->serviceMutex);
+}
+
 /* Check if any operations have timed out */
 static void
 checkTimeouts(UA_Server *server, void *_) {
@@ -139,7 +233,7 @@ checkTimeouts(UA_Server *server, void *_) {
             break;
 
         /* Mark as timed out and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADTIMEOUT;
+        setOperationStatus(op, UA_STATUSCODE_BADTIMEOUT);
         TAILQ_REMOVE(&am->dispatchedQueue, op, pointers);
         TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
@@ -153,7 +247,7 @@ checkTimeouts(UA_Server *server, void *_) {
             break;
 
         /* Mark as timed out and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADTIMEOUT;
+        setOperationStatus(op, UA_STATUSCODE_BADTIMEOUT);
         TAILQ_REMOVE(&am->newQueue, op, pointers);
         TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
@@ -168,6 +262,113 @@ checkTimeouts(UA_Server *server, void *_) {
     UA_UNLOCK(&server->serviceMutex);
 }
 
+static UA_Boolean
+waitAsyncOperation(UA_Server *server, UA_AsyncOperationType *type,
+                   const UA_AsyncOperationRequest **request,
+                   void **context, UA_DateTime *timeout, UA_NodeId *sessionId);
+
+/* Built-in worker thread. Executes operations until the AsyncManager is
+ * stopped. The operations are executed with the session of the originating
+ * request. The timestamps are filtered when the result is integrated. */
+static UA_THREAD_FUNCTION(asyncWorker, context) {
+    UA_Server *server = (UA_Server*)context;
+    UA_AsyncOperationType type;
+    const UA_AsyncOperationRequest *request;
+    void *opContext;
+    UA_NodeId sessionId;
+    while(waitAsyncOperation(server, &type, &request, &opContext,
+                             NULL, &sessionId)) {
+        UA_AsyncOperationResponse response;
+        memset(&response, 0, sizeof(UA_AsyncOperationResponse));
+        UA_LOCK(&server->serviceMutex);
+        UA_Session *session = getSessionById(server, &sessionId);
+        switch(type) {
+#ifdef UA_ENABLE_METHODCALLS
+        case UA_ASYNCOPERATIONTYPE_CALL:
+            if(session)
+                Operation_CallMethod(server, session, NULL, &request->callMethodRequest,
+                                     &response.callMethodResult);
+            else
+                response.callMethodResult.statusCode =
+                    UA_STATUSCODE_BADSESSIONIDINVALID;
+            break;
+#endif
+        case UA_ASYNCOPERATIONTYPE_READ:
+            if(session) {
+                response.readResult =
+                    readWithSession(server, session, &request->readValueId,
+                                    UA_TIMESTAMPSTORETURN_BOTH);
+            } else {
+                response.readResult.hasStatus = true;
+                response.readResult.status = UA_STATUSCODE_BADSESSIONIDINVALID;
+            }
+            break;
+        case UA_ASYNCOPERATIONTYPE_WRITE:
+            if(session)
+                Operation_Write(server, session, NULL, &request->writeValue,
+                                &response.writeResult);
+            else
+                response.writeResult = UA_STATUSCODE_BADSESSIONIDINVALID;
+            break;
+        default:
+            UA_UNLOCK(&server->serviceMutex);
+            UA_NodeId_clear(&sessionId);
+            continue;
+        }
+        UA_UNLOCK(&server->serviceMutex);
+        UA_NodeId_clear(&sessionId);
+        UA_Server_setAsyncOperationResult(server, &response, opContext);
+        UA_clear(&response, getResultType(type));
+    }
+    UA_THREAD_RETURN;
+}
+
+static void
+startWorkers(UA_AsyncManager *am, UA_Server *server) {
+    UA_LOCK(&am->workerLock);
+    am->stopped = false;
+    UA_UNLOCK(&am->workerLock);
+
+    size_t count = server->config.asyncOperationWorkers;
+    if(count == 0)
+        return;
+    am->workers = (UA_Thread*)UA_calloc(count, sizeof(UA_Thread));
+    if(!am->workers) {
+        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                     "Async Service: Could not allocate the worker threads");
+        return;
+    }
+    for(; am->workersSize < count; am->workersSize++) {
+        if(UA_THREAD_CREATE(&am->workers[am->workersSize],
+                            asyncWorker, server) != 0) {
+            UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                         "Async Service: Could only start %u of %u worker threads",
+                         (unsigned)am->workersSize, (unsigned)count);
+            break;
+        }
+    }
+}
+
+/* Wake up all blocked workers and wait for the built-in workers to finish.
+ * Workers may still be in a method call that needs the serviceMutex. */
+static void
+stopWorkers(UA_AsyncManager *am, UA_Server *server) {
+    UA_LOCK(&am->workerLock);
+    am->stopped = true;
+    UA_CONDITION_BROADCAST(&am->workerCondition);
+    UA_UNLOCK(&am->workerLock);
+
+    if(am->workersSize == 0)
+        return;
+    UA_UNLOCK(&server->serviceMutex);
+    for(size_t i = 0; i < am->workersSize; i++)
+        UA_THREAD_JOIN(&am->workers[i]);
+    UA_LOCK(&server->serviceMutex);
+    UA_free(am->workers);
+    am->workers = NULL;
+    am->workersSize = 0;
+}
+
 void
 UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server) {
     memset(am, 0, sizeof(UA_AsyncManager));
@@ -176,6 +377,10 @@ UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server) {
     TAILQ_INIT(&am->dispatchedQueue);
     TAILQ_INIT(&am->resultQueue);
     UA_LOCK_INIT(&am->queueLock);
+    am->resultCallback.callback = (UA_Callback)processResultCallback;
+    am->resultCallback.application = server;
+    UA_LOCK_INIT(&am->workerLock);
+    UA_CONDITION_INIT(&am->workerCondition);
 }
 
 void UA_AsyncManager_start(UA_AsyncManager *am, UA_Server *server) {
@@ -183,31 +388,35 @@ void UA_AsyncManager_start(UA_AsyncManager *am, UA_Server *server) {
      * responses at a 100ms interval. */
     addRepeatedCallback(server, (UA_ServerCallback)checkTimeouts,
                         NULL, 100.0, &am->checkTimeoutCallbackId);
+
+    startWorkers(am, server);
 }
 
 void UA_AsyncManager_stop(UA_AsyncManager *am, UA_Server *server) {
     /* Add a regular callback for checking timeouts and sending finished
      * responses at a 100ms interval. */
     removeCallback(server, am->checkTimeoutCallbackId);
+
+    stopWorkers(am, server);
 }
 
 void
 UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
     UA_AsyncOperation *ar, *ar_tmp;
 
-    /* Clean up queues */
+    /* Clean up queues. The AsyncResponses are removed afterwards. */
     UA_LOCK(&am->queueLock);
     TAILQ_FOREACH_SAFE(ar, &am->newQueue, pointers, ar_tmp) {
         TAILQ_REMOVE(&am->newQueue, ar, pointers);
-        UA_AsyncOperation_delete(ar);
+        UA_AsyncOperation_delete(ar, ar->parent->operationType);
     }
     TAILQ_FOREACH_SAFE(ar, &am->dispatchedQueue, pointers, ar_tmp) {
         TAILQ_REMOVE(&am->dispatchedQueue, ar, pointers);
-        UA_AsyncOperation_delete(ar);
+        UA_AsyncOperation_delete(ar, ar->parent->operationType);
     }
     TAILQ_FOREACH_SAFE(ar, &am->resultQueue, pointers, ar_tmp) {
         TAILQ_REMOVE(&am->resultQueue, ar, pointers);
-        UA_AsyncOperation_delete(ar);
+        UA_AsyncOperation_delete(ar, ar->parent->operationType);
     }
     UA_UNLOCK(&am->queueLock);
 
@@ -217,8 +426,17 @@ UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
         UA_AsyncManager_removeAsyncResponse(am, current);
     }
 
+    /* Remove the pending delayed callback */
+    if(am->resultCallbackPending) {
+        UA_EventLoop *el = server->config.eventLoop;
+        el->removeDelayedCallback(el, &am->resultCallback);
+        am->resultCallbackPending = false;
+    }
+
     /* Delete all locks */
     UA_LOCK_DESTROY(&am->queueLock);
+    UA_CONDITION_DESTROY(&am->workerCondition);
+    UA_LOCK_DESTROY(&am->workerLock);
 }
 
 UA_StatusCode
@@ -242,6 +460,7 @@ UA_AsyncManager_createAsyncResponse(UA_AsyncManager *am, UA_Server *server,
     am->asyncResponsesCount += 1;
     newentry->requestId = requestId;
     newentry->requestHandle = requestHandle;
+    newentry->operationType = operationType;
     newentry->timeout = el->dateTime_nowMonotonic(el);
     if(server->config.asyncOperationTimeout > 0.0)
         newentry->timeout += (UA_DateTime)
@@ -257,20 +476,20 @@ void
 UA_AsyncManager_removeAsyncResponse(UA_AsyncManager *am, UA_AsyncResponse *ar) {
     TAILQ_REMOVE(&am->asyncResponses, ar, pointers);
     am->asyncResponsesCount -= 1;
-    UA_CallResponse_clear(&ar->response.callResponse);
+    UA_clear(&ar->response, getResponseType(ar->operationType));
     UA_NodeId_clear(&ar->sessionId);
     UA_free(ar);
 }
 
-/* Enqueue next MethodRequest */
+/* Enqueue the next operation */
 UA_StatusCode
 UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
                               UA_AsyncResponse *ar, size_t opIndex,
-                              const UA_CallMethodRequest *opRequest) {
+                              const void *opRequest) {
     if(server->config.maxAsyncOperationQueueSize != 0 &&
        am->opsCount >= server->config.maxAsyncOperationQueueSize) {
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                       "UA_Server_SetNextAsyncMethod: Queue exceeds limit (%d).",
+                       "UA_AsyncManager_createAsyncOp: Queue exceeds limit (%d).",
                        (int unsigned)server->config.maxAsyncOperationQueueSize);
         return UA_STATUSCODE_BADUNEXPECTEDERROR;
     }
@@ -278,19 +497,19 @@ UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
     UA_AsyncOperation *ao = (UA_AsyncOperation*)UA_calloc(1, sizeof(UA_AsyncOperation));
     if(!ao) {
         UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
-                     "UA_Server_SetNextAsyncMethod: Mem alloc failed.");
+                     "UA_AsyncManager_createAsyncOp: Mem alloc failed.");
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
 
-    UA_StatusCode result = UA_CallMethodRequest_copy(opRequest, &ao->request);
+    UA_StatusCode result =
+        UA_copy(opRequest, &ao->request, getRequestType(ar->operationType));
     if(result != UA_STATUSCODE_GOOD) {
         UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
-                     "UA_Server_SetAsyncMethodResult: UA_CallMethodRequest_copy failed.");
+                     "UA_AsyncManager_createAsyncOp: Copying the request failed.");
         UA_free(ao);
         return result;
     }
 
-    UA_CallMethodResult_init(&ao->response);
     ao->index = opIndex;
     ao->parent = ar;
 
@@ -300,17 +519,24 @@ UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
     ar->opCountdown++;
     UA_UNLOCK(&am->queueLock);
 
+    /* Wake up a blocked worker */
+    UA_LOCK(&am->workerLock);
+    am->wakeups++;
+    UA_CONDITION_SIGNAL(&am->workerCondition);
+    UA_UNLOCK(&am->workerLock);
+
     if(server->config.asyncOperationNotifyCallback)
         server->config.asyncOperationNotifyCallback(server);
 
     return UA_STATUSCODE_GOOD;
 }
 
-/* Get and remove next Method Call Request */
-UA_Boolean
-UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType *type,
-                                       const UA_AsyncOperationRequest **request,
-                                       void **context, UA_DateTime *timeout) {
+/* Get and remove next Method Call Request. Optionally copy the SessionId of
+ * the originating request while the operation is known to be valid. */
+static UA_Boolean
+takeAsyncOperation(UA_Server *server, UA_AsyncOperationType *type,
+                   const UA_AsyncOperationRequest **request,
+                   void **context, UA_DateTime *timeout, UA_NodeId *sessionId) {
     UA_AsyncManager *am = &server->asyncManager;
 
     UA_Boolean bRV = false;
@@ -320,11 +546,13 @@ UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType
     if(ao) {
         TAILQ_REMOVE(&am->newQueue, ao, pointers);
         TAILQ_INSERT_TAIL(&am->dispatchedQueue, ao, pointers);
-        *type = UA_ASYNCOPERATIONTYPE_CALL;
+        *type = ao->parent->operationType;
         *request = (UA_AsyncOperationRequest*)&ao->request;
         *context = (void*)ao;
         if(timeout)
             *timeout = ao->parent->timeout;
+        if(sessionId)
+            UA_NodeId_copy(&ao->parent->sessionId, sessionId);
         bRV = true;
     }
     UA_UNLOCK(&am->queueLock);
@@ -332,6 +560,45 @@ UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType
     return bRV;
 }
 
+static UA_Boolean
+waitAsyncOperation(UA_Server *server, UA_AsyncOperationType *type,
+                   const UA_AsyncOperationRequest **request,
+                   void **context, UA_DateTime *timeout, UA_NodeId *sessionId) {
+    UA_AsyncManager *am = &server->asyncManager;
+    while(true) {
+        /* Wait for a new operation */
+        UA_LOCK(&am->workerLock);
+        while(am->wakeups == 0 && !am->stopped)
+            UA_CONDITION_WAIT(&am->workerCondition, &am->workerLock);
+        if(am->stopped) {
+            UA_UNLOCK(&am->workerLock);
+            *type = UA_ASYNCOPERATIONTYPE_INVALID;
+            return false;
+        }
+        am->wakeups--;
+        UA_UNLOCK(&am->workerLock);
+
+        /* The operation might have been taken by a non-blocking worker or
+         * removed due to a timeout in the meantime */
+        if(takeAsyncOperation(server, type, request, context, timeout, sessionId))
+            return true;
+    }
+}
+
+UA_Boolean
+UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType *type,
+                                       const UA_AsyncOperationRequest **request,
+                                       void **context, UA_DateTime *timeout) {
+    return takeAsyncOperation(server, type, request, context, timeout, NULL);
+}
+
+UA_Boolean
+UA_Server_getAsyncOperationBlocking(UA_Server *server, UA_AsyncOperationType *type,
+                                    const UA_AsyncOperationRequest **request,
+                                    void **context, UA_DateTime *timeout) {
+    return waitAsyncOperation(server, type, request, context, timeout, NULL);
+}
+
 /* Worker submits Method Call Response */
 void
 UA_Server_setAsyncOperationResult(UA_Server *server,
@@ -368,17 +635,24 @@ UA_Server_setAsyncOperationResult(UA_Server *server,
 
     /* Copy the result into the internal AsyncOperation */
     UA_StatusCode result =
-        UA_CallMethodResult_copy(&response->callMethodResult, &ao->response);
+        UA_copy(response, &ao->response, getResultType(ao->parent->operationType));
     if(result != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                       "UA_Server_SetAsyncMethodResult: UA_CallMethodResult_copy failed.");
-        ao->response.statusCode = UA_STATUSCODE_BADOUTOFMEMORY;
+                       "UA_Server_SetAsyncMethodResult: Copying the result failed.");
+        setOperationStatus(ao, UA_STATUSCODE_BADOUTOFMEMORY);
     }
 
     /* Move to the result queue */
     TAILQ_REMOVE(&am->dispatchedQueue, ao, pointers);
     TAILQ_INSERT_TAIL(&am->resultQueue, ao, pointers);
 
+    /* Integrate the result in the next EventLoop iteration */
+    if(!am->resultCallbackPending) {
+        am->resultCallbackPending = true;
+        UA_EventLoop *el = server->config.eventLoop;
+        el->addDelayedCallback(el, &am->resultCallback);
+    }
+
     UA_UNLOCK(&am->queueLock);
 
     UA_LOG_DEBUG(server->config.logging, UA_LOGCATEGORY_SERVER,
@@ -409,10 +683,31 @@ UA_Server_setMethodNodeAsync(UA_Server *server, const UA_NodeId id,
     return res;
 }
 
+static UA_StatusCode
+setVariableNodeAsync(UA_Server *server, UA_Session *session,
+                     UA_Node *node, UA_Boolean *isAsync) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    node->variableNode.async = *isAsync;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_setVariableNodeAsync(UA_Server *server, const UA_NodeId id,
+                               UA_Boolean isAsync) {
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode res =
+        UA_Server_editNode(server, &server->adminSession, &id,
+                           (UA_EditNodeCallback)setVariableNodeAsync, &isAsync);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
 UA_StatusCode
 UA_Server_processServiceOperationsAsync(UA_Server *server, UA_Session *session,
                                         UA_UInt32 requestId, UA_UInt32 requestHandle,
                                         UA_AsyncServiceOperation operationCallback,
+                                        const void *context,
                                         const size_t *requestOperations,
                                         const UA_DataType *requestOperationsType,
                                         size_t *responseOperations,
@@ -434,7 +729,7 @@ UA_Server_processServiceOperationsAsync(UA_Server *server, UA_Session *session,
     uintptr_t reqOp = *(uintptr_t*)((uintptr_t)requestOperations + sizeof(size_t));
     for(size_t i = 0; i < ops; i++) {
         operationCallback(server, session, requestId, requestHandle,
-                          i, (void*)reqOp, (void*)respOp, ar);
+                          i, context, (void*)reqOp, (void*)respOp, ar);
         reqOp += requestOperationsType->memSize;
         respOp += responseOperationsType->memSize;
     }
@@ -457,7 +752,7 @@ UA_AsyncManager_cancel(UA_Server *server, UA_Session *session, UA_UInt32 request
             continue;
 
         /* Set status and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT;
+        setOperationStatus(op, UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT);
         TAILQ_REMOVE(&am->dispatchedQueue, op, pointers);
         TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
 
@@ -473,7 +768,7 @@ UA_AsyncManager_cancel(UA_Server *server, UA_Session *session, UA_UInt32 request
             continue;
 
         /* Mark as timed out and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT;
+        setOperationStatus(op, UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT);
         TAILQ_REMOVE(&am->newQueue, op, pointers);
         TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
 
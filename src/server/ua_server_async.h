@@ -29,8 +29,8 @@ typedef struct UA_AsyncResponse UA_AsyncResponse;
 /* A single operation (of a larger request) */
 typedef struct UA_AsyncOperation {
     TAILQ_ENTRY(UA_AsyncOperation) pointers;
-    UA_CallMethodRequest request;
-    UA_CallMethodResult	response;
+    UA_AsyncOperationRequest request;   /* Type depends on the parent */
+    UA_AsyncOperationResponse response;
     size_t index;             /* Index of the operation in the array of ops in
                                * request/response */
     UA_AsyncResponse *parent; /* Always non-NULL. The parent is only removed
@@ -44,6 +44,7 @@ struct UA_AsyncResponse {
     UA_UInt32 requestHandle;
     UA_DateTime	timeout;
     UA_AsyncOperationType operationType;
+    UA_TimestampsToReturn timestampsToReturn; /* Only for read operations */
     union {
         UA_CallResponse callResponse;
         UA_ReadResponse readResponse;
@@ -74,6 +75,25 @@ typedef struct {
     size_t opsCount; /* How many operations are transient (in one of the three queues)? */
 
     UA_UInt64 checkTimeoutCallbackId; /* Registered repeated callbacks */
+
+    /* Results returned by the workers are integrated in a delayed callback.
+     * That wakes up the EventLoop and the response is sent out right away. */
+    UA_DelayedCallback resultCallback;
+    UA_Boolean resultCallbackPending; /* Protected by the queueLock */
+
+#if UA_MULTITHREADING >= 100
+    /* Workers blocking in UA_Server_getAsyncOperationBlocking wait for this
+     * condition. The wakeups count the new operations that were not yet
+     * picked up by a blocked worker. */
+    UA_Lock workerLock;
+    UA_Condition workerCondition;
+    size_t wakeups;
+    UA_Boolean stopped;
+
+    /* Built-in worker threads */
+    UA_Thread *workers;
+    size_t workersSize;
+#endif
 } UA_AsyncManager;
 
 void UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server);
@@ -93,10 +113,11 @@ UA_AsyncManager_createAsyncResponse(UA_AsyncManager *am, UA_Server *server,
 void
 UA_AsyncManager_removeAsyncResponse(UA_AsyncManager *am, UA_AsyncResponse *ar);
 
+/* The operation type is taken from the AsyncResponse */
 UA_StatusCode
 UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
                               UA_AsyncResponse *ar, size_t opIndex,
-                              const UA_CallMethodRequest *opRequest);
+                              const void *opRequest);
 
 /* Send out the response with status set. Also removes all outstanding
  * operations from the dispatch queue. The queuelock needs to be taken before
@@ -106,7 +127,8 @@ UA_AsyncManager_cancel(UA_Server *server, UA_Session *session, UA_UInt32 request
 
 typedef void (*UA_AsyncServiceOperation)(UA_Server *server, UA_Session *session,
                                          UA_UInt32 requestId, UA_UInt32 requestHandle,
-                                         size_t opIndex, const void *requestOperation,
+                                         size_t opIndex, const void *context,
+                                         const void *requestOperation,
                                          void *responseOperation, UA_AsyncResponse **ar);
 
 /* Creates an AsyncResponse in-situ when an async operation is encountered. If
@@ -115,6 +137,7 @@ UA_StatusCode
 UA_Server_processServiceOperationsAsync(UA_Server *server, UA_Session *session,
                                         UA_UInt32 requestId, UA_UInt32 requestHandle,
                                         UA_AsyncServiceOperation operationCallback,
+                                        const void *context,
                                         const size_t *requestOperations,
                                         const UA_DataType *requestOperationsType,
                                         size_t *responseOperations,
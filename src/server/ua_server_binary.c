@@ -36,13 +36,24 @@ void UA_debug_dumpCompleteChunk(UA_Server *const server, UA_Connection *const co
 /* Binary Protocol Server Component */
 /************************************/
 
-/* Maximum numbers of sockets to listen on */
-#define UA_MAXSERVERCONNECTIONS 16
+/* Maximum numbers of sockets to listen on. With reactor EventLoops, every
+ * EventLoop has its own sockets. */
+#define UA_MAXSERVERCONNECTIONS 64
+
+/* Borrowed requests are decoded into a thread-local arena. The arena is reset
+ * after the response was sent. Larger requests overflow to the heap. */
+#define UA_REQUESTARENASIZE 16384
+
+static UA_THREAD_LOCAL UA_Byte requestArenaData[UA_REQUESTARENASIZE];
+static UA_THREAD_LOCAL UA_Boolean requestArenaInUse = false;
 
 /* SecureChannel Linked List */
 typedef struct channel_entry {
     UA_SecureChannel channel;
     TAILQ_ENTRY(channel_entry) pointers;
+#if UA_MULTITHREADING >= 100
+    UA_Lock sendLock; /* See lockSecureChannelSend */
+#endif
 } channel_entry;
 
 typedef struct {
@@ -94,6 +105,13 @@ typedef struct {
     LIST_HEAD(, reverse_connect_context) reverseConnects;
     UA_UInt64 reverseConnectsCheckHandle;
     UA_UInt64 lastReverseConnectHandle;
+
+#if UA_MULTITHREADING >= 100
+    /* Threads running the reactor EventLoops from the server config */
+    UA_Thread *reactorThreads;
+    size_t reactorThreadsSize;
+    UA_UInt64 *reactorHouseKeepingIds;
+#endif
 } UA_BinaryProtocolManager;
 
 void setReverseConnectState(UA_Server *server, reverse_connect_context *context,
@@ -121,6 +139,24 @@ generateSecureChannelTokenId(UA_Server *server) {
     return bpm->lastTokenId++;
 }
 
+void
+lockSecureChannelSend(UA_SecureChannel *channel) {
+#if UA_MULTITHREADING >= 100
+    UA_LOCK(&((channel_entry*)channel)->sendLock);
+#else
+    (void)channel;
+#endif
+}
+
+void
+unlockSecureChannelSend(UA_SecureChannel *channel) {
+#if UA_MULTITHREADING >= 100
+    UA_UNLOCK(&((channel_entry*)channel)->sendLock);
+#else
+    (void)channel;
+#endif
+}
+
 static void
 setBinaryProtocolManagerState(UA_Server *server,
                               UA_BinaryProtocolManager *bpm,
@@ -147,6 +183,9 @@ deleteServerSecureChannel(UA_BinaryProtocolManager *bpm,
 
     /* Detach the channel from the server list */
     TAILQ_REMOVE(&bpm->channels, (channel_entry*)channel, pointers);
+#if UA_MULTITHREADING >= 100
+    UA_LOCK_DESTROY(&((channel_entry*)channel)->sendLock);
+#endif
 
     /* Update the statistics */
     UA_SecureChannelStatistics *scs = &bpm->server->secureChannelStatistics;
@@ -199,9 +238,13 @@ sendServiceFault(UA_Server *server, UA_SecureChannel *channel,
 
     /* Send error message. Message type is MSG and not ERR, since we are on a
      * SecureChannel! */
-    return UA_SecureChannel_sendSymmetricMessage(channel, requestId,
-                                                 UA_MESSAGETYPE_MSG, &response,
-                                                 &UA_TYPES[UA_TYPES_SERVICEFAULT]);
+    lockSecureChannelSend(channel);
+    UA_StatusCode res =
+        UA_SecureChannel_sendSymmetricMessage(channel, requestId,
+                                              UA_MESSAGETYPE_MSG, &response,
+                                              &UA_TYPES[UA_TYPES_SERVICEFAULT]);
+    unlockSecureChannelSend(channel);
+    return res;
 }
 
 /* This is not an ERR message, the connection is not closed afterwards */
@@ -333,10 +376,13 @@ processOPN(UA_Server *server, UA_SecureChannel *channel,
     }
     UA_NodeId_clear(&requestType);
 
-    /* Call the service */
+    /* Call the service. Take the server lock, the SecurityToken must not
+     * change while a response is sent from the main EventLoop. */
     UA_OpenSecureChannelResponse openScResponse;
     UA_OpenSecureChannelResponse_init(&openScResponse);
+    UA_LOCK(&server->serviceMutex);
     Service_OpenSecureChannel(server, channel, &openSecureChannelRequest, &openScResponse);
+    UA_UNLOCK(&server->serviceMutex);
     UA_OpenSecureChannelRequest_clear(&openSecureChannelRequest);
     if(openScResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_CHANNEL(server->config.logging, channel,
@@ -347,8 +393,10 @@ processOPN(UA_Server *server, UA_SecureChannel *channel,
     }
 
     /* Send the response */
+    lockSecureChannelSend(channel);
     retval = UA_SecureChannel_sendAsymmetricOPNMessage(channel, requestId, &openScResponse,
                                                        &UA_TYPES[UA_TYPES_OPENSECURECHANNELRESPONSE]);
+    unlockSecureChannelSend(channel);
     UA_OpenSecureChannelResponse_clear(&openScResponse);
     if(retval != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_CHANNEL(server->config.logging, channel,
@@ -378,10 +426,11 @@ sendResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
     response->responseHeader.timestamp = el->dateTime_now(el);
 
     /* Start the message context */
+    lockSecureChannelSend(channel);
     UA_MessageContext mc;
     UA_StatusCode retval = UA_MessageContext_begin(&mc, channel, requestId, UA_MESSAGETYPE_MSG);
     if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+        goto out;
 
     /* Assert's required for clang-analyzer */
     UA_assert(mc.buf_pos == &mc.messageBuffer.data[UA_SECURECHANNEL_SYMMETRIC_HEADER_TOTALLENGTH]);
@@ -391,15 +440,19 @@ sendResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
     retval = UA_MessageContext_encode(&mc, &responseType->binaryEncodingId,
                                       &UA_TYPES[UA_TYPES_NODEID]);
     if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+        goto out;
 
     /* Encode the response */
     retval = UA_MessageContext_encode(&mc, response, responseType);
     if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+        goto out;
 
     /* Finish / send out */
-    return UA_MessageContext_finish(&mc);
+    retval = UA_MessageContext_finish(&mc);
+
+ out:
+    unlockSecureChannelSend(channel);
+    return retval;
 }
 
 /* A Session is "bound" to a SecureChannel if it was created by the
@@ -473,12 +526,28 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
                                             requestId, UA_STATUSCODE_BADSERVICEUNSUPPORTED);
     }
 
-    /* Decode the request */
+    /* Decode the request. Strings of borrowed requests point into the message
+     * buffer. Their other members are allocated from the arena (if it is not
+     * already used further up the stack). */
     UA_Request request;
     size_t requestPos = offset; /* Store the offset (for sendServiceFault) */
-    retval = UA_decodeBinaryInternal(msg, &offset, &request,
-                                     sd->requestType, server->config.customDataTypes);
+    UA_DecodeArena arena = {requestArenaData, UA_REQUESTARENASIZE, 0};
+    UA_DecodeArena *requestArena = NULL;
+    if(sd->borrowRequest) {
+        if(!requestArenaInUse) {
+            requestArenaInUse = true;
+            requestArena = &arena;
+        }
+        retval = UA_decodeBinaryBorrowed(msg, &offset, &request, sd->requestType,
+                                         server->config.customDataTypes,
+                                         requestArena);
+    } else {
+        retval = UA_decodeBinaryInternal(msg, &offset, &request, sd->requestType,
+                                         server->config.customDataTypes);
+    }
     if(retval != UA_STATUSCODE_GOOD) {
+        if(requestArena)
+            requestArenaInUse = false;
         UA_LOG_DEBUG_CHANNEL(server->config.logging, channel,
                              "Could not decode the request with StatusCode %s",
                              UA_StatusCode_name(retval));
@@ -503,7 +572,12 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     }
 
     /* Clean up */
-    UA_clear(&request, sd->requestType);
+    if(sd->borrowRequest)
+        UA_clearBorrowedArena(&request, sd->requestType, msg, requestArena);
+    else
+        UA_clear(&request, sd->requestType);
+    if(requestArena)
+        requestArenaInUse = false;
     UA_clear(&response, sd->responseType);
     return retval;
 }
@@ -552,7 +626,9 @@ processSecureChannelMessage(void *application, UA_SecureChannel *channel,
         UA_TcpErrorMessage errMsg;
         UA_TcpErrorMessage_init(&errMsg);
         errMsg.error = retval;
+        lockSecureChannelSend(channel);
         UA_SecureChannel_sendError(channel, &errMsg);
+        unlockSecureChannelSend(channel);
         UA_ShutdownReason reason;
         switch(retval) {
         case UA_STATUSCODE_BADSECURITYMODEREJECTED:
@@ -661,6 +737,10 @@ createServerSecureChannel(UA_BinaryProtocolManager *bpm, UA_ConnectionManager *c
 
     /* Set up the new SecureChannel */
     UA_SecureChannel_init(&entry->channel);
+#if UA_MULTITHREADING >= 100
+    UA_LOCK_INIT(&entry->sendLock);
+    entry->channel.sendLock = &entry->sendLock;
+#endif
     entry->channel.config = connConfig;
     entry->channel.certificateVerification = &config->secureChannelPKI;
     entry->channel.processOPNHeader = configServerSecureChannel;
@@ -713,6 +793,10 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
            state == UA_CONNECTIONSTATE_CLOSING)
             return;
 
+        /* Server sockets are registered synchronously from
+         * createServerConnection. The server lock is already taken. */
+        UA_LOCK_ASSERT(&bpm->server->serviceMutex, 1);
+
         /* Cannot register */
         if(bpm->serverConnectionsSize >= UA_MAXSERVERCONNECTIONS) {
             UA_LOG_WARNING(bpm->logging, UA_LOGCATEGORY_SERVER,
@@ -738,8 +822,11 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     UA_Boolean serverSocket = (sc >= bpm->serverConnections &&
                                sc < &bpm->serverConnections[UA_MAXSERVERCONNECTIONS]);
 
-    /* The connection is closing. This is the last callback for it. */
+    /* The connection is closing. This is the last callback for it. The
+     * callback can come from a reactor EventLoop. Take the server lock to
+     * modify the lists of the BinaryProtocolManager. */
     if(state == UA_CONNECTIONSTATE_CLOSING) {
+        UA_LOCK(&bpm->server->serviceMutex);
         if(serverSocket) {
             /* Server socket is closed */
             sc->state = UA_CONNECTIONSTATE_CLOSED;
@@ -760,6 +847,7 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
            setBinaryProtocolManagerState(bpm->server, bpm,
                                          UA_LIFECYCLESTATE_STOPPED);
         }
+        UA_UNLOCK(&bpm->server->serviceMutex);
         return;
     }
 
@@ -767,7 +855,9 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     if(serverSocket) {
         /* A new connection is opening. This is the only place where
          * createSecureChannel is used. */
+        UA_LOCK(&bpm->server->serviceMutex);
         retval = createServerSecureChannel(bpm, cm, connectionId, &channel);
+        UA_UNLOCK(&bpm->server->serviceMutex);
         if(retval != UA_STATUSCODE_GOOD) {
             UA_LOG_WARNING(bpm->logging, UA_LOGCATEGORY_SERVER,
                            "TCP %lu\t| Could not accept the connection with status %s",
@@ -790,7 +880,7 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
 
     /* Received a message on a normal connection */
 #ifdef UA_DEBUG_DUMP_PKGS
-    UA_dump_hex_pkg(message->data, message->length);
+    UA_dump_hex_pkg(msg.data, msg.length);
 #endif
 #ifdef UA_DEBUG_DUMP_PKGS_FILE
     UA_debug_dumpCompleteChunk(server, channel->connection, message);
@@ -810,34 +900,23 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_TcpErrorMessage error;
         error.error = retval;
         error.reason = UA_STRING_NULL;
+        lockSecureChannelSend(channel);
         UA_SecureChannel_sendError(channel, &error);
+        unlockSecureChannelSend(channel);
         UA_SecureChannel_shutdown(channel, UA_SHUTDOWNREASON_ABORT);
     }
 }
 
 static UA_StatusCode
-createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl) {
-    UA_Server *server = bpm->server;
-    UA_ServerConfig *config = &server->config;
-
-    UA_LOCK_ASSERT(&server->serviceMutex, 1);
-
-    /* Extract the protocol, hostname and port from the url */
-    UA_String hostname = UA_STRING_NULL;
-    UA_String path = UA_STRING_NULL;
-    UA_UInt16 port = 4840; /* default */
-    UA_StatusCode res = UA_parseEndpointUrl(serverUrl, &hostname, &port, &path);
-    if(res != UA_STATUSCODE_GOOD)
-        return res;
-
-    UA_String tcpString = UA_STRING("tcp");
-    for(UA_EventSource *es = config->eventLoop->eventSources;
-        es != NULL; es = es->next) {
+createServerConnectionInEventLoop(UA_BinaryProtocolManager *bpm, UA_EventLoop *el,
+                                  UA_String protocol, UA_String hostname,
+                                  UA_UInt16 port) {
+    for(UA_EventSource *es = el->eventSources; es != NULL; es = es->next) {
         /* Is this a usable connection manager? */
         if(es->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
             continue;
         UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
-        if(!UA_String_equal(&tcpString, &cm->protocol))
+        if(!UA_String_equal(&protocol, &cm->protocol))
             continue;
 
         /* Set up the parameters */
@@ -863,7 +942,8 @@ createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl
         paramsMap.mapSize = paramsSize;
 
         /* Open the server connection */
-        res = cm->openConnection(cm, &paramsMap, bpm, NULL, serverNetworkCallback);
+        UA_StatusCode res =
+            cm->openConnection(cm, &paramsMap, bpm, NULL, serverNetworkCallback);
         if(res == UA_STATUSCODE_GOOD)
             return res;
     }
@@ -871,26 +951,179 @@ createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl
     return UA_STATUSCODE_BADINTERNALERROR;
 }
 
-/* Remove timed out SecureChannels */
+static UA_StatusCode
+createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl) {
+    UA_Server *server = bpm->server;
+    UA_ServerConfig *config = &server->config;
+
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    /* Extract the protocol, hostname and port from the url */
+    UA_String hostname = UA_STRING_NULL;
+    UA_String path = UA_STRING_NULL;
+    UA_UInt16 port = 4840; /* default */
+    UA_StatusCode res = UA_parseEndpointUrl(serverUrl, &hostname, &port, &path);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_String protocol = getEndpointUrlProtocol(serverUrl);
+
+#if UA_MULTITHREADING >= 100
+    /* Every reactor EventLoop listens on the same port. The sockets are opened
+     * with SO_REUSEPORT and the kernel distributes the connections. In-memory
+     * names are unique and only opened in the main EventLoop. */
+    UA_String tcpString = UA_STRING("tcp");
+    if(config->reactorEventLoopsSize > 0 && UA_String_equal(&protocol, &tcpString)) {
+        res = UA_STATUSCODE_BADINTERNALERROR;
+        for(size_t i = 0; i < config->reactorEventLoopsSize; i++) {
+            if(createServerConnectionInEventLoop(bpm, config->reactorEventLoops[i],
+                                                 protocol, hostname,
+                                                 port) == UA_STATUSCODE_GOOD)
+                res = UA_STATUSCODE_GOOD;
+        }
+        return res;
+    }
+#endif
+
+    return createServerConnectionInEventLoop(bpm, config->eventLoop,
+                                             protocol, hostname, port);
+}
+
+/* Remove timed out SecureChannels. Only the EventLoop that serves the
+ * connection checks the SecureChannel. The SecurityToken rollover must not
+ * interleave with the processing of received messages. */
 static void
-secureChannelHouseKeeping(UA_Server *server, void *context) {
-    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)context;
-    UA_LOCK(&server->serviceMutex);
+checkSecureChannelTimeouts(UA_BinaryProtocolManager *bpm, UA_EventLoop *el) {
+    UA_LOCK_ASSERT(&bpm->server->serviceMutex, 1);
 
-    UA_EventLoop *el = server->config.eventLoop;
-    UA_DateTime nowMonotonic = el->dateTime_nowMonotonic(el);
+    /* The timestamps of the SecureChannels are always from the main EventLoop */
+    UA_EventLoop *mainEl = bpm->server->config.eventLoop;
+    UA_DateTime nowMonotonic = mainEl->dateTime_nowMonotonic(mainEl);
 
     channel_entry *entry;
     TAILQ_FOREACH(entry, &bpm->channels, pointers) {
+        UA_ConnectionManager *cm = entry->channel.connectionManager;
+        UA_EventLoop *channelEl = (cm) ? cm->eventSource.eventLoop : mainEl;
+        if(channelEl != el)
+            continue;
         UA_Boolean timeout = UA_SecureChannel_checkTimeout(&entry->channel, nowMonotonic);
         if(timeout) {
             UA_LOG_INFO_CHANNEL(bpm->logging, &entry->channel, "SecureChannel has timed out");
             UA_SecureChannel_shutdown(&entry->channel, UA_SHUTDOWNREASON_TIMEOUT);
         }
     }
+}
+
+static void
+secureChannelHouseKeeping(UA_Server *server, void *context) {
+    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)context;
+    UA_LOCK(&server->serviceMutex);
+    checkSecureChannelTimeouts(bpm, server->config.eventLoop);
     UA_UNLOCK(&server->serviceMutex);
 }
 
+/**********************/
+/* Reactor EventLoops */
+/**********************/
+
+#if UA_MULTITHREADING >= 100
+
+/* Cyclic callback in the reactor EventLoop */
+static void
+reactorHouseKeeping(void *application, void *data) {
+    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)application;
+    UA_LOCK(&bpm->server->serviceMutex);
+    checkSecureChannelTimeouts(bpm, (UA_EventLoop*)data);
+    UA_UNLOCK(&bpm->server->serviceMutex);
+}
+
+static UA_THREAD_FUNCTION(reactorThread, data) {
+    UA_EventLoop *el = (UA_EventLoop*)data;
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          el->state != UA_EVENTLOOPSTATE_FRESH)
+        el->run(el, 100);
+    UA_THREAD_RETURN;
+}
+
+/* Start the reactor EventLoops before the server sockets are opened */
+static UA_StatusCode
+startReactorEventLoops(UA_BinaryProtocolManager *bpm) {
+    UA_ServerConfig *config = &bpm->server->config;
+    size_t count = config->reactorEventLoopsSize;
+    if(count == 0)
+        return UA_STATUSCODE_GOOD;
+
+    bpm->reactorHouseKeepingIds = (UA_UInt64*)UA_calloc(count, sizeof(UA_UInt64));
+    if(!bpm->reactorHouseKeepingIds)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    for(size_t i = 0; i < count; i++) {
+        UA_EventLoop *el = config->reactorEventLoops[i];
+        if(el->state != UA_EVENTLOOPSTATE_STARTED) {
+            UA_StatusCode res = el->start(el);
+            if(res != UA_STATUSCODE_GOOD)
+                return res;
+        }
+        el->addCyclicCallback(el, reactorHouseKeeping, bpm, el, 1000.0, NULL,
+                              UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                              &bpm->reactorHouseKeepingIds[i]);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Run every reactor EventLoop in its own thread */
+static void
+startReactorThreads(UA_BinaryProtocolManager *bpm) {
+    UA_ServerConfig *config = &bpm->server->config;
+    size_t count = config->reactorEventLoopsSize;
+    if(count == 0)
+        return;
+    bpm->reactorThreads = (UA_Thread*)UA_calloc(count, sizeof(UA_Thread));
+    if(!bpm->reactorThreads) {
+        UA_LOG_ERROR(bpm->logging, UA_LOGCATEGORY_SERVER,
+                     "Could not allocate the reactor threads");
+        return;
+    }
+    for(; bpm->reactorThreadsSize < count; bpm->reactorThreadsSize++) {
+        if(UA_THREAD_CREATE(&bpm->reactorThreads[bpm->reactorThreadsSize],
+                            reactorThread,
+                            config->reactorEventLoops[bpm->reactorThreadsSize]) != 0) {
+            UA_LOG_ERROR(bpm->logging, UA_LOGCATEGORY_SERVER,
+                         "Could only start %u of %u reactor threads",
+                         (unsigned)bpm->reactorThreadsSize, (unsigned)count);
+            break;
+        }
+    }
+}
+
+/* Stopping a reactor EventLoop closes all its connections. The threads process
+ * the closing callbacks (they need the server lock) and return when the
+ * EventLoop has stopped. */
+static void
+stopReactorEventLoops(UA_BinaryProtocolManager *bpm) {
+    UA_ServerConfig *config = &bpm->server->config;
+    for(size_t i = 0; i < config->reactorEventLoopsSize; i++) {
+        UA_EventLoop *el = config->reactorEventLoops[i];
+        if(bpm->reactorHouseKeepingIds && bpm->reactorHouseKeepingIds[i])
+            el->removeCyclicCallback(el, bpm->reactorHouseKeepingIds[i]);
+        if(el->state == UA_EVENTLOOPSTATE_STARTED)
+            el->stop(el);
+    }
+    UA_free(bpm->reactorHouseKeepingIds);
+    bpm->reactorHouseKeepingIds = NULL;
+
+    if(bpm->reactorThreadsSize == 0)
+        return;
+    UA_UNLOCK(&bpm->server->serviceMutex);
+    for(size_t i = 0; i < bpm->reactorThreadsSize; i++)
+        UA_THREAD_JOIN(&bpm->reactorThreads[i]);
+    UA_LOCK(&bpm->server->serviceMutex);
+    UA_free(bpm->reactorThreads);
+    bpm->reactorThreads = NULL;
+    bpm->reactorThreadsSize = 0;
+}
+
+#endif /* UA_MULTITHREADING >= 100 */
+
 /**********************/
 /* Reverse Connection */
 /**********************/
@@ -1173,6 +1406,7 @@ serverReverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
 
     /* The connection is closing. This is the last callback for it. */
     if(state == UA_CONNECTIONSTATE_CLOSING) {
+        UA_LOCK(&bpm->server->serviceMutex);
         if(context->channel) {
             deleteServerSecureChannel(bpm, context->channel);
             context->channel = NULL;
@@ -1193,12 +1427,14 @@ serverReverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
                 setBinaryProtocolManagerState(bpm->server, bpm,
                                               UA_LIFECYCLESTATE_STOPPED);
             }
+            UA_UNLOCK(&bpm->server->serviceMutex);
             return;
         }
 
         /* Reset. Will be picked up in the regular retry callback. */
         context->currentConnection.connectionId = 0;
         setReverseConnectState(bpm->server, context, UA_SECURECHANNELSTATE_CONNECTING);
+        UA_UNLOCK(&bpm->server->serviceMutex);
         return;
     }
 
@@ -1209,7 +1445,9 @@ serverReverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
      * createSecureChannel is used. */
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
     if(!context->channel) {
+        UA_LOCK(&bpm->server->serviceMutex);
         retval = createServerSecureChannel(bpm, cm, connectionId, &context->channel);
+        UA_UNLOCK(&bpm->server->serviceMutex);
         if(retval != UA_STATUSCODE_GOOD) {
             UA_LOG_WARNING(bpm->logging, UA_LOGCATEGORY_SERVER,
                            "TCP %lu\t| Could not accept the reverse "
@@ -1254,7 +1492,9 @@ serverReverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_TcpErrorMessage error;
         error.error = retval;
         error.reason = UA_STRING_NULL;
+        lockSecureChannelSend(context->channel);
         UA_SecureChannel_sendError(context->channel, &error);
+        unlockSecureChannelSend(context->channel);
         UA_SecureChannel_shutdown(context->channel, UA_SHUTDOWNREASON_ABORT);
 
         setReverseConnectState(bpm->server, context, UA_SECURECHANNELSTATE_CLOSING);
@@ -1281,6 +1521,15 @@ UA_BinaryProtocolManager_start(UA_Server *server,
     if(retVal != UA_STATUSCODE_GOOD)
         return retVal;
 
+#if UA_MULTITHREADING >= 100
+    retVal = startReactorEventLoops(bpm);
+    if(retVal != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(config->logging, UA_LOGCATEGORY_SERVER,
+                     "Could not start the reactor EventLoops");
+        return retVal;
+    }
+#endif
+
     /* Open server sockets */
     UA_Boolean haveServerSocket = false;
     if(config->serverUrlsSize == 0) {
@@ -1338,6 +1587,10 @@ UA_BinaryProtocolManager_start(UA_Server *server,
     setBinaryProtocolManagerState(bpm->server, bpm,
                                   UA_LIFECYCLESTATE_STARTED);
 
+#if UA_MULTITHREADING >= 100
+    startReactorThreads(bpm);
+#endif
+
     return UA_STATUSCODE_GOOD;
 }
 
@@ -1382,6 +1635,10 @@ UA_BinaryProtocolManager_stop(UA_Server *server,
             cm->closeConnection(cm, sc->connectionId);
     }
 
+#if UA_MULTITHREADING >= 100
+    stopReactorEventLoops(bpm);
+#endif
+
     /* If open sockets remain, set to STOPPING */
     if(bpm->serverConnectionsSize == 0 &&
        LIST_EMPTY(&bpm->reverseConnects) &&
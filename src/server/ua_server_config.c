@@ -28,6 +28,24 @@ UA_ServerConfig_clean(UA_ServerConfig *config) {
 # endif
 #endif
 
+#if UA_MULTITHREADING >= 100
+    /* Stop and delete the reactor EventLoops */
+    for(size_t i = 0; i < config->reactorEventLoopsSize; i++) {
+        UA_EventLoop *rel = config->reactorEventLoops[i];
+        if(rel->state != UA_EVENTLOOPSTATE_FRESH &&
+           rel->state != UA_EVENTLOOPSTATE_STOPPED) {
+            rel->stop(rel);
+            while(rel->state != UA_EVENTLOOPSTATE_STOPPED) {
+                rel->run(rel, 100);
+            }
+        }
+        rel->free(rel);
+    }
+    UA_free(config->reactorEventLoops);
+    config->reactorEventLoops = NULL;
+    config->reactorEventLoopsSize = 0;
+#endif
+
     /* Stop and delete the EventLoop */
     UA_EventLoop *el = config->eventLoop;
     if(el && !config->externalEventLoop) {
@@ -113,6 +113,38 @@ addServerComponent(UA_Server *server, UA_ServerComponent *sc,
 UA_ServerComponent *
 getServerComponentByName(UA_Server *server, UA_String name);
 
+/*******************/
+/* Type Tree Cache */
+/*******************/
+
+/* Caches the HasSubtype hierarchy for the subtype checks in isNodeInTree. Every
+ * entry points to the entry of its (single) supertype. All supertypes of a
+ * cached entry are cached as well. Entries are added lazily during the lookup.
+ * The entire cache is dropped when the inverse HasSubtype references of any
+ * node change or a cached node is deleted. */
+
+typedef struct {
+    UA_UInt32 nodeIdHash;
+    UA_NodeId nodeId;
+} UA_TypeTreeKey;
+
+typedef struct UA_TypeTreeEntry {
+    ZIP_ENTRY(UA_TypeTreeEntry) treeEntry;
+    UA_TypeTreeKey key;
+    struct UA_TypeTreeEntry *parent; /* NULL for the root */
+    UA_UInt16 depth; /* Distance to the root */
+    UA_Boolean ambiguous; /* The node (or a supertype) has several or remote
+                           * supertypes. Use the full tree walk. */
+} UA_TypeTreeEntry;
+
+enum ZIP_CMP
+cmpTypeTreeKey(const UA_TypeTreeKey *a, const UA_TypeTreeKey *b);
+
+typedef ZIP_HEAD(UA_TypeTree, UA_TypeTreeEntry) UA_TypeTree;
+
+ZIP_FUNCTIONS(UA_TypeTree, UA_TypeTreeEntry, treeEntry,
+              UA_TypeTreeKey, key, cmpTypeTreeKey)
+
 /********************/
 /* Server Structure */
 /********************/
@@ -159,6 +191,10 @@ struct UA_Server {
      * the parent and member instantiation */
     UA_Boolean bootstrapNS0;
 
+    /* Cache for the subtype checks */
+    UA_TypeTree typeTree;
+    size_t typeTreeChanges; /* nodeSubtypeChanges() when the cache was valid */
+
     /* Subscriptions */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* The admin session is initialized with a special subscription. This
@@ -171,7 +207,11 @@ struct UA_Server {
     LIST_HEAD(, UA_Subscription) subscriptions; /* All subscriptions in the
                                                  * server. They may be detached
                                                  * from a session. */
+    size_t retransmissionQueueBytes; /* Memory used by all retransmission
+                                      * queues */
+    UA_NotificationPool notificationPool;
     UA_UInt32 lastSubscriptionId; /* To generate unique SubscriptionIds */
+    LIST_HEAD(, UA_PublishSlot) publishSlots; /* See alignPublishingIntervals */
 
 # ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
     LIST_HEAD(, UA_ConditionSource) conditionSources;
@@ -236,6 +276,16 @@ getSecurityPolicyByUri(const UA_Server *server,
 UA_UInt32
 generateSecureChannelTokenId(UA_Server *server);
 
+/* Sending on a SecureChannel is serialized. Responses are sent from the
+ * EventLoop that serves the connection (possibly a reactor EventLoop) and from
+ * the main EventLoop (e.g. PublishResponses). The server lock can be taken
+ * before the send lock, but not the other way round. */
+void
+lockSecureChannelSend(UA_SecureChannel *channel);
+
+void
+unlockSecureChannelSend(UA_SecureChannel *channel);
+
 /********************/
 /* Session Handling */
 /********************/
@@ -304,6 +354,19 @@ UA_Boolean
 isNodeInTree(UA_Server *server, const UA_NodeId *leafNode,
              const UA_NodeId *nodeToFind, const UA_ReferenceTypeSet *relevantRefs);
 
+/* Drop the type tree cache if the node is contained. Called when the node is
+ * deleted. */
+void
+typeTreeInvalidate(UA_Server *server, const UA_NodeId *nodeId);
+
+/* Number of edits of inverse HasSubtype references in any node so far. See
+ * UA_Node_addReference and UA_Node_deleteReference. */
+size_t
+nodeSubtypeChanges(void);
+
+void
+typeTreeClear(UA_Server *server);
+
 /* Convenience function with just a single ReferenceTypeIndex */
 UA_Boolean
 isNodeInTree_singleRef(UA_Server *server, const UA_NodeId *leafNode,
@@ -426,6 +489,12 @@ void
 Operation_Write(UA_Server *server, UA_Session *session, void *context,
                 const UA_WriteValue *wv, UA_StatusCode *result);
 
+#ifdef UA_ENABLE_METHODCALLS
+void
+Operation_CallMethod(UA_Server *server, UA_Session *session, void *context,
+                     const UA_CallMethodRequest *request, UA_CallMethodResult *result);
+#endif
+
 UA_StatusCode
 writeAttribute(UA_Server *server, UA_Session *session,
                const UA_NodeId *nodeId, const UA_AttributeId attributeId,
@@ -548,6 +617,22 @@ UA_StatusCode
 addRepeatedCallback(UA_Server *server, UA_ServerCallback callback,
                     void *data, UA_Double interval_ms, UA_UInt64 *callbackId);
 
+/* Memory that the threads of the reactor EventLoops can still read without the
+ * server lock (e.g. a value that is encoded into a response after the service
+ * has returned) is released with a delayed callback that passes through the
+ * main EventLoop and all reactor EventLoops. When the free-method is called,
+ * every EventLoop has completed the cycle in which the memory was detached.
+ * The payload is allocated behind the struct. */
+typedef struct UA_DelayedFree {
+    UA_DelayedCallback dc; /* Internal */
+    UA_Server *server;     /* Internal */
+    size_t nextEventLoop;  /* Internal */
+    void (*free)(struct UA_DelayedFree *df); /* Frees the payload and df */
+} UA_DelayedFree;
+
+void
+addDelayedFree(UA_Server *server, UA_DelayedFree *df);
+
 #ifdef UA_ENABLE_DISCOVERY
 UA_ServerComponent *
 UA_DiscoveryManager_new(UA_Server *server);
@@ -620,6 +705,11 @@ UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v);
 
+/* Release the cached binary encoding of the value (if any). Must be called
+ * when the value or the value source of a VariableNode changes. */
+void
+invalidateEncodedValue(UA_Server *server, UA_VariableNode *node);
+
 /* Test whether the value matches a variable definition given by
  * - datatype
  * - valuerank
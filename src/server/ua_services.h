@@ -59,6 +59,9 @@ typedef struct {
     UA_Service serviceCallback;
     const UA_DataType *requestType;
     const UA_DataType *responseType;
+    UA_Boolean borrowRequest; /* The request is decoded without copying strings
+                               * from the message buffer (the service does not
+                               * retain parts of the request) */
 } UA_ServiceDescription;
 
 /* Returns NULL if none found */
@@ -328,6 +331,12 @@ void Service_Read(UA_Server *server, UA_Session *session,
                   const UA_ReadRequest *request,
                   UA_ReadResponse *response);
 
+#if UA_MULTITHREADING >= 100
+void Service_ReadAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                       const UA_ReadRequest *request, UA_ReadResponse *response,
+                       UA_Boolean *finished);
+#endif
+
 /**
  * Write Service
  * ^^^^^^^^^^^^^
@@ -339,6 +348,12 @@ void Service_Write(UA_Server *server, UA_Session *session,
                    const UA_WriteRequest *request,
                    UA_WriteResponse *response);
 
+#if UA_MULTITHREADING >= 100
+void Service_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                        const UA_WriteRequest *request, UA_WriteResponse *response,
+                        UA_Boolean *finished);
+#endif
+
 /**
  * HistoryRead Service
  * ^^^^^^^^^^^^^^^^^^^
@@ -158,10 +158,64 @@ readIsAbstractAttribute(const UA_Node *node, UA_Variant *v) {
     return UA_Variant_setScalarCopy(v, isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
 }
 
+/* Encoded Value Cache */
+
+static void
+freeDelayedEncodedValue(UA_DelayedFree *df) {
+    UA_ByteString_delete(*(UA_ByteString**)(uintptr_t)(df + 1));
+    UA_free(df);
+}
+
+void
+invalidateEncodedValue(UA_Server *server, UA_VariableNode *node) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE || !node->encodedValue)
+        return;
+    UA_ByteString *encoded = node->encodedValue;
+    node->encodedValue = NULL;
+
+    /* Responses that are encoded in the current cycle of an EventLoop (also
+     * in a reactor thread without the server lock) may still point to the
+     * encoding. Release it once all EventLoops have cycled. */
+    UA_DelayedFree *df = (UA_DelayedFree*)
+        UA_malloc(sizeof(UA_DelayedFree) + sizeof(UA_ByteString*));
+    if(!df) {
+        UA_ByteString_delete(encoded);
+        return;
+    }
+    *(UA_ByteString**)(uintptr_t)(df + 1) = encoded;
+    df->free = freeDelayedEncodedValue;
+    addDelayedFree(server, df);
+}
+
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+/* Point the DataValue to the cached encoding of the node value. The encoding is
+ * created on first use. The node is edited in-situ under the service lock. */
+static UA_StatusCode
+readEncodedValue(UA_VariableNode *vn, UA_DataValue *v) {
+    if(!vn->encodedValue) {
+        UA_ByteString *encoded = UA_ByteString_new();
+        if(!encoded)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_StatusCode res = UA_encodeBinary(&vn->value.data.value.value,
+                                            &UA_TYPES[UA_TYPES_VARIANT], encoded);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_ByteString_delete(encoded);
+            return res;
+        }
+        vn->encodedValue = encoded;
+    }
+
+    *v = vn->value.data.value; /* Copy status and timestamps */
+    UA_Variant_setScalar(&v->value, vn->encodedValue, &UA_PREENCODEDVARIANT);
+    v->value.storageType = UA_VARIANT_DATA_NODELETE;
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
 static UA_StatusCode
 readValueAttributeFromNode(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
-                           UA_NumericRange *rangeptr) {
+                           UA_NumericRange *rangeptr, UA_Boolean preEncoded) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
     /* Update the value by the user callback */
     if(vn->value.data.callback.onRead) {
@@ -183,6 +237,13 @@ readValueAttributeFromNode(UA_Server *server, UA_Session *session,
 
     /* Set the result */
     UA_StatusCode retval;
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+    if(preEncoded && !rangeptr && vn->cacheEncodedValue &&
+       vn->head.nodeClass == UA_NODECLASS_VARIABLE &&
+       vn->value.data.value.hasValue) {
+        retval = readEncodedValue((UA_VariableNode*)(uintptr_t)vn, v);
+    } else
+#endif
     if(!rangeptr) {
         retval = UA_DataValue_copy(&vn->value.data.value, v);
     } else {
@@ -229,7 +290,8 @@ readValueAttributeFromDataSource(UA_Server *server, UA_Session *session,
 static UA_StatusCode
 readValueAttributeComplete(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_TimestampsToReturn timestamps,
-                           const UA_String *indexRange, UA_DataValue *v) {
+                           const UA_String *indexRange, UA_Boolean preEncoded,
+                           UA_DataValue *v) {
     UA_EventLoop *el = server->config.eventLoop;
 
     /* Compute the index range */
@@ -245,7 +307,8 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
 
     switch(vn->valueBackend.backendType) {
         case UA_VALUEBACKENDTYPE_INTERNAL:
-            retval = readValueAttributeFromNode(server, session, vn, v, rangeptr);
+            retval = readValueAttributeFromNode(server, session, vn, v,
+                                                rangeptr, preEncoded);
             //TODO change old structure to value backend
             break;
         case UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK:
@@ -273,10 +336,29 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
             else
                 retval = UA_DataValue_copy(*vn->valueBackend.backend.external.value, v);
             break;
+        case UA_VALUEBACKENDTYPE_SHAREDMEMORY: {
+            /* Read from the shared memory region without callbacks */
+            if(!rangeptr) {
+                retval = UA_SharedMemory_read(vn->valueBackend.backend.sharedMemory.region,
+                                              vn->valueBackend.backend.sharedMemory.regionSize,
+                                              vn->valueBackend.backend.sharedMemory.entry, v);
+                break;
+            }
+            UA_DataValue full;
+            retval = UA_SharedMemory_read(vn->valueBackend.backend.sharedMemory.region,
+                                          vn->valueBackend.backend.sharedMemory.regionSize,
+                                          vn->valueBackend.backend.sharedMemory.entry, &full);
+            if(retval != UA_STATUSCODE_GOOD)
+                break;
+            retval = UA_DataValue_copyVariantRange(&full, v, *rangeptr);
+            UA_DataValue_clear(&full);
+            break;
+        }
         case UA_VALUEBACKENDTYPE_NONE:
             /* Read the value */
             if(vn->valueSource == UA_VALUESOURCE_DATA)
-                retval = readValueAttributeFromNode(server, session, vn, v, rangeptr);
+                retval = readValueAttributeFromNode(server, session, vn, v,
+                                                    rangeptr, preEncoded);
             else
                 retval = readValueAttributeFromDataSource(server, session, vn, v,
                                                           timestamps, rangeptr);
@@ -301,7 +383,7 @@ UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v) {
     return readValueAttributeComplete(server, session, vn,
-                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, v);
+                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, false, v);
 }
 
 static const UA_String binEncoding = {sizeof("Default Binary")-1, (UA_Byte*)"Default Binary"};
@@ -382,11 +464,12 @@ getStructureDefinition(const UA_DataType *type, UA_StructureDefinition *def) {
 
 /* Returns a datavalue that may point into the node via the
  * UA_VARIANT_DATA_NODELETE tag. Don't access the returned DataValue once the
- * node has been released! */
-void
-ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
+ * node has been released! With preEncoded, the value attribute may be returned
+ * as a UA_PREENCODEDVARIANT that can only be used for the binary encoding. */
+static void
+readWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
              UA_TimestampsToReturn timestampsToReturn,
-             const UA_ReadValueId *id, UA_DataValue *v) {
+             const UA_ReadValueId *id, UA_Boolean preEncoded, UA_DataValue *v) {
     UA_LOG_NODEID_TRACE(&node->head.nodeId,
                         UA_LOG_TRACE_SESSION(server->config.logging, session,
                                              "Read attribute %"PRIi32 " of Node %.*s",
@@ -500,7 +583,8 @@ ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
             }
         }
         retval = readValueAttributeComplete(server, session, &node->variableNode,
-                                            timestampsToReturn, &id->indexRange, v);
+                                            timestampsToReturn, &id->indexRange,
+                                            preEncoded, v);
         break;
     }
     case UA_ATTRIBUTEID_DATATYPE:
@@ -630,8 +714,15 @@ ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
 }
 
 void
-Operation_Read(UA_Server *server, UA_Session *session, UA_TimestampsToReturn *ttr,
-               const UA_ReadValueId *rvi, UA_DataValue *dv) {
+ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
+             UA_TimestampsToReturn timestampsToReturn,
+             const UA_ReadValueId *id, UA_DataValue *v) {
+    readWithNode(node, server, session, timestampsToReturn, id, false, v);
+}
+
+static void
+readOperation(UA_Server *server, UA_Session *session, UA_TimestampsToReturn ttr,
+              const UA_ReadValueId *rvi, UA_Boolean preEncoded, UA_DataValue *dv) {
     /* Get the node (with only the selected attribute if the NodeStore supports that) */
     const UA_Node *node =
         UA_NODESTORE_GET_SELECTIVE(server, &rvi->nodeId,
@@ -645,40 +736,56 @@ Operation_Read(UA_Server *server, UA_Session *session, UA_TimestampsToReturn *tt
     }
 
     /* Perform the read operation */
-    ReadWithNode(node, server, session, *ttr, rvi, dv);
+    readWithNode(node, server, session, ttr, rvi, preEncoded, dv);
     UA_NODESTORE_RELEASE(server, node);
 }
 
 void
-Service_Read(UA_Server *server, UA_Session *session,
-             const UA_ReadRequest *request, UA_ReadResponse *response) {
-    UA_LOG_DEBUG_SESSION(server->config.logging, session, "Processing ReadRequest");
-    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+Operation_Read(UA_Server *server, UA_Session *session, UA_TimestampsToReturn *ttr,
+               const UA_ReadValueId *rvi, UA_DataValue *dv) {
+    readOperation(server, session, *ttr, rvi, false, dv);
+}
+
+/* The ReadResponse is encoded before the next EventLoop cycle. So values from
+ * the encoded value cache can be used. */
+static void
+Operation_ReadEncoded(UA_Server *server, UA_Session *session,
+                      UA_TimestampsToReturn *ttr, const UA_ReadValueId *rvi,
+                      UA_DataValue *dv) {
+    readOperation(server, session, *ttr, rvi, true, dv);
+}
 
+static UA_StatusCode
+checkReadRequest(UA_Server *server, const UA_ReadRequest *request) {
     /* Check if the timestampstoreturn is valid */
-    if(request->timestampsToReturn > UA_TIMESTAMPSTORETURN_NEITHER) {
-        response->responseHeader.serviceResult = UA_STATUSCODE_BADTIMESTAMPSTORETURNINVALID;
-        return;
-    }
+    if(request->timestampsToReturn > UA_TIMESTAMPSTORETURN_NEITHER)
+        return UA_STATUSCODE_BADTIMESTAMPSTORETURNINVALID;
 
     /* Check if maxAge is valid */
-    if(request->maxAge < 0) {
-        response->responseHeader.serviceResult = UA_STATUSCODE_BADMAXAGEINVALID;
-        return;
-    }
+    if(request->maxAge < 0)
+        return UA_STATUSCODE_BADMAXAGEINVALID;
 
     /* Check if there are too many operations */
     if(server->config.maxNodesPerRead != 0 &&
-       request->nodesToReadSize > server->config.maxNodesPerRead) {
-        response->responseHeader.serviceResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
-        return;
-    }
+       request->nodesToReadSize > server->config.maxNodesPerRead)
+        return UA_STATUSCODE_BADTOOMANYOPERATIONS;
+
+    return UA_STATUSCODE_GOOD;
+}
 
+void
+Service_Read(UA_Server *server, UA_Session *session,
+             const UA_ReadRequest *request, UA_ReadResponse *response) {
+    UA_LOG_DEBUG_SESSION(server->config.logging, session, "Processing ReadRequest");
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
+    response->responseHeader.serviceResult = checkReadRequest(server, request);
+    if(response->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+        return;
+
     response->responseHeader.serviceResult =
         UA_Server_processServiceOperations(server, session,
-                                           (UA_ServiceOperation)Operation_Read,
+                                           (UA_ServiceOperation)Operation_ReadEncoded,
                                            &request->timestampsToReturn,
                                            &request->nodesToReadSize,
                                            &UA_TYPES[UA_TYPES_READVALUEID],
@@ -686,6 +793,149 @@ Service_Read(UA_Server *server, UA_Session *session,
                                            &UA_TYPES[UA_TYPES_DATAVALUE]);
 }
 
+#if UA_MULTITHREADING >= 100
+
+/* Is the value attribute of the variable read/written in async operations? */
+static UA_Boolean
+isAsyncDataSource(const UA_Node *node) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return false;
+    const UA_VariableNode *vn = &node->variableNode;
+    if(!vn->async)
+        return false;
+    if(vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK)
+        return true;
+    return (vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_NONE &&
+            vn->valueSource == UA_VALUESOURCE_DATASOURCE);
+}
+
+/* Check the AccessLevel and UserAccessLevel in the server thread before the
+ * operation is handed to a worker */
+static UA_StatusCode
+checkAsyncValueAccess(UA_Server *server, UA_Session *session,
+                      const UA_VariableNode *vn, UA_Byte mask,
+                      UA_StatusCode notAccessible) {
+    if(!(getAccessLevel(server, session, vn) & mask))
+        return notAccessible;
+    if(!(getUserAccessLevel(server, session, vn) & mask))
+        return UA_STATUSCODE_BADUSERACCESSDENIED;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+Operation_ReadAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                    UA_UInt32 requestHandle, size_t opIndex,
+                    UA_TimestampsToReturn *ttr, const UA_ReadValueId *rvi,
+                    UA_DataValue *dv, UA_AsyncResponse **ar) {
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, &rvi->nodeId,
+                                   attributeId2AttributeMask((UA_AttributeId)rvi->attributeId),
+                                   UA_REFERENCETYPESET_NONE,
+                                   UA_BROWSEDIRECTION_INVALID);
+    if(!node) {
+        dv->hasStatus = true;
+        dv->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        return;
+    }
+
+    /* Synchronous execution */
+    if(rvi->attributeId != UA_ATTRIBUTEID_VALUE || !isAsyncDataSource(node) ||
+       (rvi->dataEncoding.name.length > 0 &&
+        !UA_String_equal(&binEncoding, &rvi->dataEncoding.name))) {
+        readWithNode(node, server, session, *ttr, rvi, true, dv);
+        goto cleanup;
+    }
+
+    /* <-- Async read --> */
+
+    UA_StatusCode res =
+        checkAsyncValueAccess(server, session, &node->variableNode,
+                              UA_ACCESSLEVELMASK_READ, UA_STATUSCODE_BADNOTREADABLE);
+    if(res != UA_STATUSCODE_GOOD)
+        goto error;
+
+    /* No AsyncResponse allocated so far */
+    if(!*ar) {
+        res = UA_AsyncManager_createAsyncResponse(&server->asyncManager, server,
+                                                  &session->sessionId, requestId,
+                                                  requestHandle,
+                                                  UA_ASYNCOPERATIONTYPE_READ, ar);
+        if(res != UA_STATUSCODE_GOOD)
+            goto error;
+        (*ar)->timestampsToReturn = *ttr;
+    }
+
+    /* Create the Async Request to be taken by workers */
+    res = UA_AsyncManager_createAsyncOp(&server->asyncManager, server,
+                                        *ar, opIndex, rvi);
+
+ error:
+    if(res != UA_STATUSCODE_GOOD) {
+        dv->hasStatus = true;
+        dv->status = res;
+    }
+
+ cleanup:
+    UA_NODESTORE_RELEASE(server, node);
+}
+
+void
+Service_ReadAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                  const UA_ReadRequest *request, UA_ReadResponse *response,
+                  UA_Boolean *finished) {
+    UA_LOG_DEBUG_SESSION(server->config.logging, session, "Processing ReadRequestAsync");
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    response->responseHeader.serviceResult = checkReadRequest(server, request);
+    if(response->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+        return;
+
+    UA_AsyncResponse *ar = NULL;
+    response->responseHeader.serviceResult =
+        UA_Server_processServiceOperationsAsync(server, session, requestId,
+                  request->requestHeader.requestHandle,
+                  (UA_AsyncServiceOperation)Operation_ReadAsync,
+                  &request->timestampsToReturn,
+                  &request->nodesToReadSize, &UA_TYPES[UA_TYPES_READVALUEID],
+                  &response->resultsSize, &UA_TYPES[UA_TYPES_DATAVALUE], &ar);
+
+    if(!ar)
+        return;
+
+    /* If there is a new AsyncResponse, ensure it has at least one pending
+     * operation */
+    if(ar->opCountdown == 0) {
+        UA_AsyncManager_removeAsyncResponse(&server->asyncManager, ar);
+        return;
+    }
+
+    /* The synchronous results may point into the encoded value cache. That is
+     * only valid until the next EventLoop cycle. Take a copy before the
+     * response is deferred. */
+    for(size_t i = 0; i < response->resultsSize; i++) {
+        UA_Variant *v = &response->results[i].value;
+        if(v->type != &UA_PREENCODEDVARIANT ||
+           v->storageType != UA_VARIANT_DATA_NODELETE)
+            continue;
+        UA_Variant owned;
+        if(UA_Variant_copy(v, &owned) != UA_STATUSCODE_GOOD) {
+            UA_DataValue_clear(&response->results[i]);
+            response->results[i].hasStatus = true;
+            response->results[i].status = UA_STATUSCODE_BADOUTOFMEMORY;
+            continue;
+        }
+        *v = owned;
+    }
+
+    /* Move all results to the AsyncResponse. The async operation results will
+     * be overwritten when the workers return results. */
+    ar->response.readResponse = *response;
+    UA_ReadResponse_init(response);
+    *finished = false;
+}
+
+#endif /* UA_MULTITHREADING >= 100 */
+
 UA_DataValue
 readWithSession(UA_Server *server, UA_Session *session,
                 const UA_ReadValueId *item,
@@ -1097,8 +1347,8 @@ compatibleValue(UA_Server *server, UA_Session *session, const UA_NodeId *targetD
 /*****************/
 
 static void
-freeWrapperArray(void *app, void *context) {
-    UA_free(context);
+freeWrapperArray(UA_DelayedFree *df) {
+    UA_free(df);
 }
 
 static void
@@ -1123,13 +1373,13 @@ unwrapEOArray(UA_Server *server, UA_Variant *value) {
      * not cleaned up (only the original value), this memory is being cleaned up
      * by a delayed callback in the server after the method call has
      * finished. */
-    UA_DelayedCallback *dc = (UA_DelayedCallback*)
-        UA_malloc(sizeof(UA_DelayedCallback) + (value->arrayLength * innerType->memSize));
-    if(!dc)
+    UA_DelayedFree *df = (UA_DelayedFree*)
+        UA_malloc(sizeof(UA_DelayedFree) + (value->arrayLength * innerType->memSize));
+    if(!df)
         return;
 
     /* Move the content */
-    uintptr_t pos = ((uintptr_t)dc) + sizeof(UA_DelayedCallback);
+    uintptr_t pos = ((uintptr_t)df) + sizeof(UA_DelayedFree);
     void *unwrappedArray = (void*)pos;
     for(size_t i = 0; i < value->arrayLength; i++) {
         memcpy((void*)pos, eo[i].content.decoded.data, innerType->memSize);
@@ -1141,11 +1391,8 @@ unwrapEOArray(UA_Server *server, UA_Variant *value) {
     value->data = unwrappedArray;
 
     /* Add the delayed callback to free the memory of the unwrapped array */
-    dc->callback = freeWrapperArray;
-    dc->application = NULL;
-    dc->context = dc;
-    UA_EventLoop *el = server->config.eventLoop;
-    el->addDelayedCallback(el, dc);
+    df->free = freeWrapperArray;
+    addDelayedFree(server, df);
 }
 
 void
@@ -1354,6 +1601,12 @@ writeDataTypeAttribute(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+static void
+freeDelayedDataValue(UA_DelayedFree *df) {
+    UA_DataValue_clear((UA_DataValue*)(uintptr_t)(df + 1));
+    UA_free(df);
+}
+
 static UA_StatusCode
 writeValueAttributeWithoutRange(UA_VariableNode *node, const UA_DataValue *value) {
     UA_DataValue new_value;
@@ -1365,6 +1618,27 @@ writeValueAttributeWithoutRange(UA_VariableNode *node, const UA_DataValue *value
     return UA_STATUSCODE_GOOD;
 }
 
+/* Move the value into the node without a deep copy. The old value is released
+ * after all EventLoops have cycled. So the value passed to the onWrite callback
+ * (which is called without the server lock) remains valid until the end of the
+ * current EventLoop cycle even if another thread writes the node
+ * concurrently. */
+static void
+moveValueAttributeWithoutRange(UA_Server *server, UA_VariableNode *node,
+                               UA_DataValue *value) {
+    UA_DelayedFree *df = (UA_DelayedFree*)
+        UA_malloc(sizeof(UA_DelayedFree) + sizeof(UA_DataValue));
+    if(df) {
+        *(UA_DataValue*)(uintptr_t)(df + 1) = node->value.data.value;
+        df->free = freeDelayedDataValue;
+        addDelayedFree(server, df);
+    } else {
+        UA_DataValue_clear(&node->value.data.value);
+    }
+    node->value.data.value = *value;
+    UA_DataValue_init(value);
+}
+
 static UA_StatusCode
 writeValueAttributeWithRange(UA_VariableNode *node, const UA_DataValue *value,
                              const UA_NumericRange *rangeptr) {
@@ -1405,12 +1679,16 @@ writeValueAttributeWithRange(UA_VariableNode *node, const UA_DataValue *value,
     return UA_STATUSCODE_GOOD;
 }
 
+/* If movable is set (it then points to the same DataValue as value), the
+ * content of the value can be moved into the node instead of copying. Then
+ * movable is reset to its initial state. */
 static UA_StatusCode
 writeNodeValueAttribute(UA_Server *server, UA_Session *session,
                         UA_VariableNode *node, const UA_DataValue *value,
-                        const UA_String *indexRange) {
+                        const UA_String *indexRange, UA_DataValue *movable) {
     UA_assert(node != NULL);
     UA_assert(session != NULL);
+    UA_assert(!movable || movable == value);
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
     /* Parse the range */
@@ -1466,6 +1744,9 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
         adjustedValue.hasSourcePicoseconds = false;
     }
 
+    /* The cached encoding of the previous value becomes stale */
+    invalidateEncodedValue(server, node);
+
     /* Call into the different value storage backends.
      *
      * TODO: Clean up this mess with duplicated possibilities for external
@@ -1474,11 +1755,22 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
     switch(node->valueBackend.backendType) {
     case UA_VALUEBACKENDTYPE_NONE:
         if(node->valueSource == UA_VALUESOURCE_DATA) {
-            /* Write into the in-situ DataValue */
-            if(!rangeptr)
+            /* Write into the in-situ DataValue. The value can only be moved
+             * if the variant "container" was not adjusted to point to
+             * different memory. */
+            if(!rangeptr && movable && server->config.eventLoop &&
+               adjustedValue.value.data == value->value.data &&
+               adjustedValue.value.arrayLength == value->value.arrayLength &&
+               value->value.storageType == UA_VARIANT_DATA) {
+                moveValueAttributeWithoutRange(server, node, &adjustedValue);
+                UA_DataValue_init(movable);
+                adjustedValue = node->value.data.value;
+                retval = UA_STATUSCODE_GOOD;
+            } else if(!rangeptr) {
                 retval = writeValueAttributeWithoutRange(node, &adjustedValue);
-            else
+            } else {
                 retval = writeValueAttributeWithRange(node, &adjustedValue, rangeptr);
+            }
 
             /* Callback after writing */
             if(retval == UA_STATUSCODE_GOOD &&
@@ -1631,10 +1923,11 @@ triggerImmediateDataChange(UA_Server *server, UA_Session *session,
 #endif
 
 /* This function implements the main part of the write service and operates on a
-   copy of the node (not in single-threaded mode). */
+   copy of the node (not in single-threaded mode). If movableValue is set, it
+   points to wvalue->value and the content can be moved into the node. */
 static UA_StatusCode
-copyAttributeIntoNode(UA_Server *server, UA_Session *session,
-                      UA_Node *node, const UA_WriteValue *wvalue) {
+writeAttributeIntoNode(UA_Server *server, UA_Session *session, UA_Node *node,
+                       const UA_WriteValue *wvalue, UA_DataValue *movableValue) {
     UA_assert(session != NULL);
     const void *value = wvalue->value.value.data;
     UA_UInt32 userWriteMask = getUserWriteMask(server, session, &node->head);
@@ -1728,7 +2021,8 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
             CHECK_USERWRITEMASK(UA_WRITEMASK_VALUEFORVARIABLETYPE);
         }
         retval = writeNodeValueAttribute(server, session, &node->variableNode,
-                                         &wvalue->value, &wvalue->indexRange);
+                                         &wvalue->value, &wvalue->indexRange,
+                                         movableValue);
         break;
     case UA_ATTRIBUTEID_DATATYPE:
         CHECK_NODECLASS_WRITE(UA_NODECLASS_VARIABLE | UA_NODECLASS_VARIABLETYPE);
@@ -1809,6 +2103,12 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_StatusCode
+copyAttributeIntoNode(UA_Server *server, UA_Session *session,
+                      UA_Node *node, const UA_WriteValue *wvalue) {
+    return writeAttributeIntoNode(server, session, node, wvalue, NULL);
+}
+
 void
 Operation_Write(UA_Server *server, UA_Session *session, void *context,
                 const UA_WriteValue *wv, UA_StatusCode *result) {
@@ -1818,6 +2118,29 @@ Operation_Write(UA_Server *server, UA_Session *session, void *context,
                                  (void*)(uintptr_t)wv);
 }
 
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+static UA_StatusCode
+moveAttributeIntoNode(UA_Server *server, UA_Session *session,
+                      UA_Node *node, UA_WriteValue *wvalue) {
+    return writeAttributeIntoNode(server, session, node, wvalue, &wvalue->value);
+}
+#endif
+
+/* Like Operation_Write. But the content of the written value can be moved into
+ * the node. With immutable nodes the edit is done on a copy and might be
+ * retried. So moving is not possible there. */
+static void
+Operation_WriteMove(UA_Server *server, UA_Session *session, void *context,
+                    UA_WriteValue *wv, UA_StatusCode *result) {
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+    UA_assert(session != NULL);
+    *result = UA_Server_editNode(server, session, &wv->nodeId,
+                                 (UA_EditNodeCallback)moveAttributeIntoNode, wv);
+#else
+    Operation_Write(server, session, context, wv, result);
+#endif
+}
+
 void
 Service_Write(UA_Server *server, UA_Session *session,
               const UA_WriteRequest *request,
@@ -1833,15 +2156,107 @@ Service_Write(UA_Server *server, UA_Session *session,
         return;
     }
 
+    /* The decoded request is owned by the server and cleaned up after the
+     * service returns. So the written values can be moved into the nodes. */
     response->responseHeader.serviceResult =
         UA_Server_processServiceOperations(server, session,
-                                           (UA_ServiceOperation)Operation_Write, NULL,
+                                           (UA_ServiceOperation)Operation_WriteMove, NULL,
                                            &request->nodesToWriteSize,
                                            &UA_TYPES[UA_TYPES_WRITEVALUE],
                                            &response->resultsSize,
                                            &UA_TYPES[UA_TYPES_STATUSCODE]);
 }
 
+#if UA_MULTITHREADING >= 100
+
+static void
+Operation_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                     UA_UInt32 requestHandle, size_t opIndex, void *context,
+                     UA_WriteValue *wv, UA_StatusCode *result,
+                     UA_AsyncResponse **ar) {
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, &wv->nodeId,
+                                   UA_NODEATTRIBUTESMASK_NODECLASS |
+                                   UA_NODEATTRIBUTESMASK_ACCESSLEVEL,
+                                   UA_REFERENCETYPESET_NONE,
+                                   UA_BROWSEDIRECTION_INVALID);
+    if(!node) {
+        *result = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        return;
+    }
+
+    /* Synchronous execution. Release the node first, it is edited. */
+    if(wv->attributeId != UA_ATTRIBUTEID_VALUE || !isAsyncDataSource(node)) {
+        UA_NODESTORE_RELEASE(server, node);
+        Operation_WriteMove(server, session, NULL, wv, result);
+        return;
+    }
+
+    /* <-- Async write --> */
+
+    *result = checkAsyncValueAccess(server, session, &node->variableNode,
+                                    UA_ACCESSLEVELMASK_WRITE,
+                                    UA_STATUSCODE_BADNOTWRITABLE);
+    if(*result != UA_STATUSCODE_GOOD)
+        goto cleanup;
+
+    /* No AsyncResponse allocated so far */
+    if(!*ar) {
+        *result = UA_AsyncManager_createAsyncResponse(&server->asyncManager, server,
+                                                      &session->sessionId, requestId,
+                                                      requestHandle,
+                                                      UA_ASYNCOPERATIONTYPE_WRITE, ar);
+        if(*result != UA_STATUSCODE_GOOD)
+            goto cleanup;
+    }
+
+    /* Create the Async Request to be taken by workers */
+    *result = UA_AsyncManager_createAsyncOp(&server->asyncManager, server,
+                                            *ar, opIndex, wv);
+
+ cleanup:
+    UA_NODESTORE_RELEASE(server, node);
+}
+
+void
+Service_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                   const UA_WriteRequest *request, UA_WriteResponse *response,
+                   UA_Boolean *finished) {
+    UA_LOG_DEBUG_SESSION(server->config.logging, session,
+                         "Processing WriteRequestAsync");
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    if(server->config.maxNodesPerWrite != 0 &&
+       request->nodesToWriteSize > server->config.maxNodesPerWrite) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+        return;
+    }
+
+    UA_AsyncResponse *ar = NULL;
+    response->responseHeader.serviceResult =
+        UA_Server_processServiceOperationsAsync(server, session, requestId,
+                  request->requestHeader.requestHandle,
+                  (UA_AsyncServiceOperation)Operation_WriteAsync, NULL,
+                  &request->nodesToWriteSize, &UA_TYPES[UA_TYPES_WRITEVALUE],
+                  &response->resultsSize, &UA_TYPES[UA_TYPES_STATUSCODE], &ar);
+
+    if(ar) {
+        if(ar->opCountdown > 0) {
+            /* Move all results to the AsyncResponse. The async operation
+             * results will be overwritten when the workers return results. */
+            ar->response.writeResponse = *response;
+            UA_WriteResponse_init(response);
+            *finished = false;
+        } else {
+            /* If there is a new AsyncResponse, ensure it has at least one
+             * pending operation */
+            UA_AsyncManager_removeAsyncResponse(&server->asyncManager, ar);
+        }
+    }
+}
+
+#endif /* UA_MULTITHREADING >= 100 */
+
 UA_StatusCode
 UA_Server_write(UA_Server *server, const UA_WriteValue *value) {
     UA_StatusCode res = UA_STATUSCODE_GOOD;
@@ -1851,6 +2266,15 @@ UA_Server_write(UA_Server *server, const UA_WriteValue *value) {
     return res;
 }
 
+UA_StatusCode
+UA_Server_writeMove(UA_Server *server, UA_WriteValue *value) {
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    UA_LOCK(&server->serviceMutex);
+    Operation_WriteMove(server, &server->adminSession, NULL, value, &res);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
 /* Convenience function to be wrapped into inline functions */
 UA_StatusCode
 __UA_Server_write(UA_Server *server, const UA_NodeId *nodeId,
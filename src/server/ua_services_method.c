@@ -363,7 +363,7 @@ callWithMethodAndObject(UA_Server *server, UA_Session *session,
 
 static void
 Operation_CallMethodAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
-                          UA_UInt32 requestHandle, size_t opIndex,
+                          UA_UInt32 requestHandle, size_t opIndex, void *context,
                           UA_CallMethodRequest *opRequest, UA_CallMethodResult *opResult,
                           UA_AsyncResponse **ar) {
     /* Get the method node. We only need the nodeClass and executable attribute.
@@ -440,7 +440,7 @@ Service_CallAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
     response->responseHeader.serviceResult =
         UA_Server_processServiceOperationsAsync(server, session, requestId,
                   request->requestHeader.requestHandle,
-                  (UA_AsyncServiceOperation)Operation_CallMethodAsync,
+                  (UA_AsyncServiceOperation)Operation_CallMethodAsync, NULL,
                   &request->methodsToCallSize, &UA_TYPES[UA_TYPES_CALLMETHODREQUEST],
                   &response->resultsSize, &UA_TYPES[UA_TYPES_CALLMETHODRESULT], &ar);
 
@@ -460,7 +460,7 @@ Service_CallAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
 }
 #endif
 
-static void
+void
 Operation_CallMethod(UA_Server *server, UA_Session *session, void *context,
                      const UA_CallMethodRequest *request, UA_CallMethodResult *result) {
     /* Get the method node. We only need the nodeClass and executable attribute.
@@ -727,6 +727,7 @@ copyChild(UA_Server *server, UA_Session *session,
         retval = addNode_addRefs(server, session, &newNodeId, destinationNodeId,
                                  &rd->referenceTypeId, &rd->typeDefinition.nodeId);
         if(retval != UA_STATUSCODE_GOOD) {
+            typeTreeInvalidate(server, &newNodeId);
             UA_NODESTORE_REMOVE(server, &newNodeId);
             UA_NodeId_clear(&newNodeId);
             return retval;
@@ -736,6 +737,7 @@ copyChild(UA_Server *server, UA_Session *session,
             retval = checkSetIsDynamicVariable(server, session, &newNodeId);
 
             if(retval != UA_STATUSCODE_GOOD) {
+                typeTreeInvalidate(server, &newNodeId);
                 UA_NODESTORE_REMOVE(server, &newNodeId);
                 return retval;
             }
@@ -1951,9 +1953,12 @@ deleteNodeSet(UA_Server *server, UA_Session *session,
         const UA_Node *member = UA_NODESTORE_GET(server, &refTree->targets[i-1].nodeId);
         if(!member)
             continue;
+        if(member->head.nodeClass == UA_NODECLASS_VARIABLE)
+            invalidateEncodedValue(server, (UA_VariableNode*)(uintptr_t)&member->variableNode);
         UA_NODESTORE_RELEASE(server, member);
         if(removeTargetRefs)
             removeIncomingReferences(server, session, &member->head);
+        typeTreeInvalidate(server, &refTree->targets[i-1].nodeId);
         UA_NODESTORE_REMOVE(server, &member->head.nodeId);
     }
 }
@@ -2479,6 +2484,7 @@ setDataSource(UA_Server *server, UA_Session *session,
         return UA_STATUSCODE_BADNODECLASSINVALID;
     if(node->valueSource == UA_VALUESOURCE_DATA)
         UA_DataValue_clear(&node->value.data.value);
+    invalidateEncodedValue(server, node);
     node->value.dataSource = *dataSource;
     node->valueSource = UA_VALUESOURCE_DATASOURCE;
     return UA_STATUSCODE_GOOD;
@@ -2511,6 +2517,7 @@ setExternalValueSource(UA_Server *server, UA_Session *session,
                  UA_VariableNode *node, const UA_ValueBackend *externalValueSource) {
     if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
         return UA_STATUSCODE_BADNODECLASSINVALID;
+    invalidateEncodedValue(server, node);
     node->valueBackend.backendType = UA_VALUEBACKENDTYPE_EXTERNAL;
     node->valueBackend.backend.external.value =
         externalValueSource->backend.external.value;
@@ -2521,6 +2528,38 @@ setExternalValueSource(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+/***********************************/
+/* Set Shared Memory Value Backend */
+/***********************************/
+static UA_StatusCode
+setSharedMemorySource(UA_Server *server, UA_Session *session,
+                      UA_VariableNode *node, const UA_ValueBackend *valueBackend) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+
+    /* Check that the entry exists and that it fits the variable */
+    UA_DataValue value;
+    UA_StatusCode res =
+        UA_SharedMemory_read(valueBackend->backend.sharedMemory.region,
+                             valueBackend->backend.sharedMemory.regionSize,
+                             valueBackend->backend.sharedMemory.entry, &value);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    const char *reason;
+    if(!compatibleValue(server, session, &node->dataType, node->valueRank,
+                        node->arrayDimensionsSize, node->arrayDimensions,
+                        &value.value, NULL, &reason))
+        res = UA_STATUSCODE_BADTYPEMISMATCH;
+    UA_DataValue_clear(&value);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    invalidateEncodedValue(server, node);
+    node->valueBackend.backendType = UA_VALUEBACKENDTYPE_SHAREDMEMORY;
+    node->valueBackend.backend.sharedMemory = valueBackend->backend.sharedMemory;
+    return UA_STATUSCODE_GOOD;
+}
+
 /****************************/
 /* Set Data Source Callback */
 /****************************/
@@ -2529,12 +2568,47 @@ setDataSourceCallback(UA_Server *server, UA_Session *session,
                  UA_VariableNode *node, const UA_DataSource *dataSource) {
     if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
         return UA_STATUSCODE_BADNODECLASSINVALID;
+    invalidateEncodedValue(server, node);
     node->valueBackend.backendType = UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK;
     node->valueBackend.backend.dataSource.read = dataSource->read;
     node->valueBackend.backend.dataSource.write = dataSource->write;
     return UA_STATUSCODE_GOOD;
 }
 
+/****************************/
+/* Set Encoded Value Cache  */
+/****************************/
+
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+static UA_StatusCode
+setEncodedValueCache(UA_Server *server, UA_Session *session,
+                     UA_VariableNode *node, const UA_Boolean *enable) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    node->cacheEncodedValue = *enable;
+    invalidateEncodedValue(server, node);
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
+UA_StatusCode
+UA_Server_setVariableNode_encodedValueCache(UA_Server *server,
+                                            const UA_NodeId nodeId,
+                                            UA_Boolean enable) {
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode retval =
+        UA_Server_editNode(server, &server->adminSession, &nodeId,
+                           (UA_EditNodeCallback)setEncodedValueCache, &enable);
+    UA_UNLOCK(&server->serviceMutex);
+    return retval;
+#else
+    /* Copies of the node do not keep the encoding alive until the response
+     * was sent */
+    return UA_STATUSCODE_BADNOTSUPPORTED;
+#endif
+}
+
 /**********************/
 /* Set Value Backend  */
 /**********************/
@@ -2561,6 +2635,11 @@ UA_Server_setVariableNode_valueBackend(UA_Server *server, const UA_NodeId nodeId
                 /* cast away const because callback uses const anyway */
                                         (UA_ValueCallback *)(uintptr_t) &valueBackend);
             break;
+        case UA_VALUEBACKENDTYPE_SHAREDMEMORY:
+            retval = UA_Server_editNode(server, &server->adminSession, &nodeId,
+                                        (UA_EditNodeCallback) setSharedMemorySource,
+                                        (UA_ValueBackend *)(uintptr_t) &valueBackend);
+            break;
     }
 
 
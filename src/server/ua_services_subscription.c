@@ -155,11 +155,8 @@ Service_ModifySubscription(UA_Server *server, UA_Session *session,
 
     /* The publish interval has changed */
     if(sub->publishingInterval != oldPublishingInterval) {
-        /* Change the repeated callback to the new interval. This cannot fail as
-         * memory is reused. */
-        if(sub->publishCallbackId > 0)
-            changeRepeatedCallbackInterval(server, sub->publishCallbackId,
-                                           sub->publishingInterval);
+        /* Change the repeated callback to the new interval */
+        Subscription_updatePublishingInterval(server, sub);
 
         /* For each MonitoredItem check if it was/shall be attached to the
          * publish interval. This ensures that we have less cyclic callbacks
@@ -287,7 +284,7 @@ Service_Publish(UA_Server *server, UA_Session *session,
         }
         /* Remove the acked transmission from the retransmission queue */
         response->results[i] =
-            UA_Subscription_removeRetransmissionMessage(sub, ack->sequenceNumber);
+            UA_Subscription_removeRetransmissionMessage(server, sub, ack->sequenceNumber);
     }
 
     /* Set the maxTime if a timeout hint is defined */
@@ -404,7 +401,7 @@ Service_Republish(UA_Server *server, UA_Session *session,
     /* Find the notification in the retransmission queue  */
     UA_NotificationMessageEntry *entry;
     TAILQ_FOREACH(entry, &sub->retransmissionQueue, listEntry) {
-        if(entry->message.sequenceNumber == request->retransmitSequenceNumber)
+        if(entry->sequenceNumber == request->retransmitSequenceNumber)
             break;
     }
     if(!entry) {
@@ -413,7 +410,7 @@ Service_Republish(UA_Server *server, UA_Session *session,
     }
 
     response->responseHeader.serviceResult =
-        UA_NotificationMessage_copy(&entry->message, &response->notificationMessage);
+        UA_Subscription_republishMessage(entry, &response->notificationMessage);
 
     /* Update the subscription statistics for the case where we return a message */
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -434,7 +431,7 @@ setTransferredSequenceNumbers(const UA_Subscription *sub, UA_TransferResult *res
     UA_NotificationMessageEntry *entry;
     size_t i = 0;
     TAILQ_FOREACH(entry, &sub->retransmissionQueue, listEntry) {
-        result->availableSequenceNumbers[i] = entry->message.sequenceNumber;
+        result->availableSequenceNumbers[i] = entry->sequenceNumber;
         i++;
     }
 
@@ -519,6 +516,7 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
 
     /* Set to the same state as the original subscription */
     newSub->publishCallbackId = 0;
+    newSub->publishSlot = NULL;
     result->statusCode = Subscription_setState(server, newSub, sub->state);
     if(result->statusCode != UA_STATUSCODE_GOOD) {
         UA_Array_delete(result->availableSequenceNumbers,
@@ -557,12 +555,17 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
     TAILQ_FOREACH_SAFE(nme, &sub->retransmissionQueue, listEntry, nme_tmp) {
         TAILQ_REMOVE(&sub->retransmissionQueue, nme, listEntry);
         TAILQ_INSERT_TAIL(&newSub->retransmissionQueue, nme, listEntry);
-        if(oldSession)
+        if(oldSession) {
             oldSession->totalRetransmissionQueueSize -= 1;
+            oldSession->totalRetransmissionQueueBytes -= nme->memSize;
+        }
         sub->retransmissionQueueSize -= 1;
+        sub->retransmissionQueueBytes -= nme->memSize;
     }
     UA_assert(sub->retransmissionQueueSize == 0);
+    UA_assert(sub->retransmissionQueueBytes == 0);
     sub->retransmissionQueueSize = 0;
+    sub->retransmissionQueueBytes = 0;
 
     /* Add to the server */
     UA_assert(newSub->subscriptionId == sub->subscriptionId);
@@ -162,10 +162,165 @@ isNodeInTreeIterateCallback(void *context, UA_ReferenceTarget *t) {
     return res;
 }
 
+/*******************/
+/* Type Tree Cache */
+/*******************/
+
+enum ZIP_CMP
+cmpTypeTreeKey(const UA_TypeTreeKey *a, const UA_TypeTreeKey *b) {
+    if(a->nodeIdHash < b->nodeIdHash)
+        return ZIP_CMP_LESS;
+    if(a->nodeIdHash > b->nodeIdHash)
+        return ZIP_CMP_MORE;
+    return (enum ZIP_CMP)UA_NodeId_order(&a->nodeId, &b->nodeId);
+}
+
+static void *
+deleteTypeTreeEntry(void *context, UA_TypeTreeEntry *entry) {
+    UA_NodeId_clear(&entry->key.nodeId);
+    UA_free(entry);
+    return NULL;
+}
+
+void
+typeTreeClear(UA_Server *server) {
+    ZIP_ITER(UA_TypeTree, &server->typeTree, deleteTypeTreeEntry, NULL);
+    ZIP_INIT(&server->typeTree);
+}
+
+void
+typeTreeInvalidate(UA_Server *server, const UA_NodeId *nodeId) {
+    if(!ZIP_ROOT(&server->typeTree))
+        return;
+    UA_TypeTreeKey key;
+    key.nodeIdHash = UA_NodeId_hash(nodeId);
+    key.nodeId = *nodeId;
+    if(ZIP_FIND(UA_TypeTree, &server->typeTree, &key))
+        typeTreeClear(server);
+}
+
+struct SupertypeContext {
+    size_t count;
+    UA_Boolean remote;
+    UA_NodePointer supertype;
+};
+
+static void *
+countSupertypes(void *context, UA_ReferenceTarget *t) {
+    struct SupertypeContext *sc = (struct SupertypeContext*)context;
+    if(!UA_NodePointer_isLocal(t->targetId))
+        sc->remote = true;
+    sc->supertype = t->targetId;
+    sc->count++;
+    return (sc->count > 1 || sc->remote) ? (void*)0x01 : NULL;
+}
+
+/* Returns the cached entry for the node. Adds the entries for the node and its
+ * supertypes if required. Returns NULL if the node or a supertype is not found,
+ * or if the hierarchy is deeper than UA_MAX_TREE_RECURSE (e.g. a loop). */
+static UA_TypeTreeEntry *
+getTypeTreeEntry(UA_Server *server, const UA_NodeId *nodeId, UA_UInt16 depth) {
+    UA_TypeTreeKey key;
+    key.nodeIdHash = UA_NodeId_hash(nodeId);
+    key.nodeId = *nodeId;
+    UA_TypeTreeEntry *entry = ZIP_FIND(UA_TypeTree, &server->typeTree, &key);
+    if(entry || depth >= UA_MAX_TREE_RECURSE)
+        return entry;
+
+    /* Get the node with only the inverse HasSubtype references */
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, nodeId, UA_NODEATTRIBUTESMASK_NONE,
+                                   UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE),
+                                   UA_BROWSEDIRECTION_INVERSE);
+    if(!node)
+        return NULL;
+
+    struct SupertypeContext sc;
+    memset(&sc, 0, sizeof(struct SupertypeContext));
+    for(size_t i = 0; i < node->head.referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &node->head.references[i];
+        if(!rk->isInverse ||
+           rk->referenceTypeIndex != UA_REFERENCETYPEINDEX_HASSUBTYPE)
+            continue;
+        if(UA_NodeReferenceKind_iterate(rk, countSupertypes, &sc))
+            break;
+    }
+
+    /* Resolve the supertype first. The node stays locked meanwhile. */
+    UA_TypeTreeEntry *parent = NULL;
+    if(sc.count == 1 && !sc.remote) {
+        UA_NodeId parentId = UA_NodePointer_toNodeId(sc.supertype);
+        parent = getTypeTreeEntry(server, &parentId, depth + 1);
+        if(!parent) {
+            UA_NODESTORE_RELEASE(server, node);
+            return NULL;
+        }
+    }
+
+    entry = (UA_TypeTreeEntry*)UA_calloc(1, sizeof(UA_TypeTreeEntry));
+    if(!entry ||
+       UA_NodeId_copy(nodeId, &entry->key.nodeId) != UA_STATUSCODE_GOOD) {
+        UA_free(entry);
+        UA_NODESTORE_RELEASE(server, node);
+        return NULL;
+    }
+    entry->key.nodeIdHash = key.nodeIdHash;
+    if(parent) {
+        entry->parent = parent;
+        entry->depth = parent->depth + 1;
+        entry->ambiguous = parent->ambiguous;
+    } else {
+        entry->ambiguous = (sc.count > 0);
+    }
+    ZIP_INSERT(UA_TypeTree, &server->typeTree, entry);
+    UA_NODESTORE_RELEASE(server, node);
+    return entry;
+}
+
+/* Returns UA_ORDER_EQ/UA_ORDER_MORE if the node is found or not found in the
+ * supertypes. Returns UA_ORDER_LESS if the cache cannot decide. */
+static UA_Order
+typeTreeLookup(UA_Server *server, const UA_NodeId *leafNode,
+               const UA_NodeId *nodeToFind) {
+    /* Drop the cache if HasSubtype references were edited in the meantime */
+    size_t changes = nodeSubtypeChanges();
+    if(changes != server->typeTreeChanges) {
+        typeTreeClear(server);
+        server->typeTreeChanges = changes;
+    }
+
+    UA_TypeTreeEntry *leaf = getTypeTreeEntry(server, leafNode, 0);
+    if(!leaf || leaf->ambiguous)
+        return UA_ORDER_LESS;
+
+    /* All supertypes of the leaf are cached */
+    UA_TypeTreeKey key;
+    key.nodeIdHash = UA_NodeId_hash(nodeToFind);
+    key.nodeId = *nodeToFind;
+    UA_TypeTreeEntry *target = ZIP_FIND(UA_TypeTree, &server->typeTree, &key);
+    if(!target || target->depth > leaf->depth)
+        return UA_ORDER_MORE;
+
+    while(leaf->depth > target->depth)
+        leaf = leaf->parent;
+    return (leaf == target) ? UA_ORDER_EQ : UA_ORDER_MORE;
+}
+
 UA_Boolean
 isNodeInTree(UA_Server *server, const UA_NodeId *leafNode,
              const UA_NodeId *nodeToFind,
              const UA_ReferenceTypeSet *relevantRefs) {
+    if(UA_NodeId_equal(leafNode, nodeToFind))
+        return true;
+
+    /* Subtype checks use the type tree cache */
+    UA_ReferenceTypeSet hasSubtype = UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE);
+    if(memcmp(relevantRefs, &hasSubtype, sizeof(UA_ReferenceTypeSet)) == 0) {
+        UA_Order found = typeTreeLookup(server, leafNode, nodeToFind);
+        if(found != UA_ORDER_LESS)
+            return (found == UA_ORDER_EQ);
+    }
+
     struct IsNodeInTreeContext ctx;
     memset(&ctx, 0, sizeof(struct IsNodeInTreeContext));
     ctx.server = server;
@@ -154,6 +154,7 @@ UA_Session_attachSubscription(UA_Session *session, UA_Subscription *sub) {
 
     /* Increase the number of outstanding retransmissions */
     session->totalRetransmissionQueueSize += sub->retransmissionQueueSize;
+    session->totalRetransmissionQueueBytes += sub->retransmissionQueueBytes;
 
     /* Insert at the end of the subscriptions of the same priority / just before
      * the subscriptions with the next lower priority. */
@@ -180,6 +181,7 @@ UA_Session_detachSubscription(UA_Server *server, UA_Session *session,
 
     /* Reduce the number of outstanding retransmissions */
     session->totalRetransmissionQueueSize -= sub->retransmissionQueueSize;
+    session->totalRetransmissionQueueBytes -= sub->retransmissionQueueBytes;
 
     /* Send remaining publish responses if the last subscription was removed */
     if(!releasePublishResponses || !TAILQ_EMPTY(&session->subscriptions))
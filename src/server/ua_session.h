@@ -80,6 +80,7 @@ struct UA_Session {
     SIMPLEQ_HEAD(, UA_PublishResponseEntry) responseQueue;
 
     size_t totalRetransmissionQueueSize; /* Retransmissions of all subscriptions */
+    size_t totalRetransmissionQueueBytes; /* Memory used for the retransmissions */
 #endif
 
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -19,12 +19,27 @@
 
 #include "ua_server_internal.h"
 #include "ua_subscription.h"
+#include "ua_types_encoding_binary.h"
 #include "itoa.h"
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS /* conditional compilation */
 
 #define UA_MAX_RETRANSMISSIONQUEUESIZE 256
 
+static void
+removeRetransmissionMessage(UA_Server *server, UA_Subscription *sub,
+                            UA_NotificationMessageEntry *entry) {
+    TAILQ_REMOVE(&sub->retransmissionQueue, entry, listEntry);
+    --sub->retransmissionQueueSize;
+    sub->retransmissionQueueBytes -= entry->memSize;
+    if(sub->session) {
+        --sub->session->totalRetransmissionQueueSize;
+        sub->session->totalRetransmissionQueueBytes -= entry->memSize;
+    }
+    server->retransmissionQueueBytes -= entry->memSize;
+    UA_free(entry);
+}
+
 UA_Subscription *
 UA_Subscription_new(void) {
     /* Allocate the memory */
@@ -96,14 +111,10 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub) {
     /* Delete Retransmission Queue */
     UA_NotificationMessageEntry *nme, *nme_tmp;
     TAILQ_FOREACH_SAFE(nme, &sub->retransmissionQueue, listEntry, nme_tmp) {
-        TAILQ_REMOVE(&sub->retransmissionQueue, nme, listEntry);
-        UA_NotificationMessage_clear(&nme->message);
-        UA_free(nme);
-        if(sub->session)
-            --sub->session->totalRetransmissionQueueSize;
-        --sub->retransmissionQueueSize;
+        removeRetransmissionMessage(server, sub, nme);
     }
     UA_assert(sub->retransmissionQueueSize == 0);
+    UA_assert(sub->retransmissionQueueBytes == 0);
 
     /* Pointers to the subscription may still exist upwards in the call stack.
      * Add a delayed callback to remove the Subscription when the current jobs
@@ -129,225 +140,460 @@ UA_Subscription_getMonitoredItem(UA_Subscription *sub, UA_UInt32 monitoredItemId
     return mon;
 }
 
+/* The oldest message is at the head of the queue */
 static void
-removeOldestRetransmissionMessageFromSub(UA_Subscription *sub) {
-    UA_NotificationMessageEntry *oldestEntry =
-        TAILQ_LAST(&sub->retransmissionQueue, NotificationMessageQueue);
-    TAILQ_REMOVE(&sub->retransmissionQueue, oldestEntry, listEntry);
-    UA_NotificationMessage_clear(&oldestEntry->message);
-    UA_free(oldestEntry);
-    --sub->retransmissionQueueSize;
-    if(sub->session)
-        --sub->session->totalRetransmissionQueueSize;
+removeOldestRetransmissionMessageFromSub(UA_Server *server, UA_Subscription *sub) {
+    UA_NotificationMessageEntry *oldestEntry = TAILQ_FIRST(&sub->retransmissionQueue);
+    UA_assert(oldestEntry);
+    removeRetransmissionMessage(server, sub, oldestEntry);
 
 #ifdef UA_ENABLE_DIAGNOSTICS
     sub->discardedMessageCount++;
 #endif
 }
 
+static UA_Subscription *
+oldestRetransmissionSub(UA_Subscription *sub, UA_Subscription *oldestSub) {
+    UA_NotificationMessageEntry *first = TAILQ_FIRST(&sub->retransmissionQueue);
+    if(!first)
+        return oldestSub;
+    if(!oldestSub ||
+       TAILQ_FIRST(&oldestSub->retransmissionQueue)->publishTime > first->publishTime)
+        return sub;
+    return oldestSub;
+}
+
 static void
-removeOldestRetransmissionMessageFromSession(UA_Session *session) {
-    UA_NotificationMessageEntry *oldestEntry = NULL;
+removeOldestRetransmissionMessageFromSession(UA_Server *server, UA_Session *session) {
     UA_Subscription *oldestSub = NULL;
     UA_Subscription *sub;
     TAILQ_FOREACH(sub, &session->subscriptions, sessionListEntry) {
-        UA_NotificationMessageEntry *first =
-            TAILQ_LAST(&sub->retransmissionQueue, NotificationMessageQueue);
-        if(!first)
-            continue;
-        if(!oldestEntry || oldestEntry->message.publishTime > first->message.publishTime) {
-            oldestEntry = first;
-            oldestSub = sub;
-        }
+        oldestSub = oldestRetransmissionSub(sub, oldestSub);
+    }
+    UA_assert(oldestSub);
+    removeOldestRetransmissionMessageFromSub(server, oldestSub);
+}
+
+static void
+removeOldestRetransmissionMessageFromServer(UA_Server *server) {
+    UA_Subscription *oldestSub = NULL;
+    UA_Subscription *sub;
+    LIST_FOREACH(sub, &server->subscriptions, serverListEntry) {
+        oldestSub = oldestRetransmissionSub(sub, oldestSub);
     }
-    UA_assert(oldestEntry);
     UA_assert(oldestSub);
+    removeOldestRetransmissionMessageFromSub(server, oldestSub);
+}
 
-    removeOldestRetransmissionMessageFromSub(oldestSub);
+/* Notifications selected for a NotificationMessage. They are removed from the
+ * queues but deleted only after the message was sent. So their content is
+ * encoded directly without an intermediate DataChangeNotification or
+ * EventNotificationList. */
+#define UA_NOTIFICATIONKIND_DATACHANGE 0
+#define UA_NOTIFICATIONKIND_EVENT 1
+
+typedef struct {
+    NotificationQueue queue; /* Linked via the globalEntry */
+    size_t count[UA_NOTIFICATIONMESSAGE_MAXDATA];
+    size_t length[UA_NOTIFICATIONMESSAGE_MAXDATA]; /* Encoded body length */
+} UA_NotificationSelection;
+
+static const UA_DataType *
+notificationDataType(size_t kind) {
+    if(kind == UA_NOTIFICATIONKIND_DATACHANGE)
+        return &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION];
+    return &UA_TYPES[UA_TYPES_EVENTNOTIFICATIONLIST];
 }
 
+static size_t
+notificationKind(const UA_Notification *n, const void **data,
+                 const UA_DataType **type) {
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    if(n->mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
+        *data = &n->data.event;
+        *type = &UA_TYPES[UA_TYPES_EVENTFIELDLIST];
+        return UA_NOTIFICATIONKIND_EVENT;
+    }
+#endif
+    *data = &n->data.dataChange;
+    *type = &UA_TYPES[UA_TYPES_MONITOREDITEMNOTIFICATION];
+    return UA_NOTIFICATIONKIND_DATACHANGE;
+}
+
+/* Take up to maxNotifications from the head of the Subscription queue */
 static void
+selectNotifications(UA_Server *server, UA_Subscription *sub,
+                    UA_NotificationSelection *sel, size_t maxNotifications) {
+    memset(sel, 0, sizeof(UA_NotificationSelection));
+    TAILQ_INIT(&sel->queue);
+
+    UA_Notification *n;
+    size_t totalNotifications = 0;
+    while(totalNotifications < maxNotifications &&
+          (n = TAILQ_FIRST(&sub->notificationQueue))) {
+        /* If there are Notifications *before this one* in the MonitoredItem-
+         * local queue, remove all of them. These are earlier Notifications that
+         * are non-reporting. And we don't want them to show up after the
+         * current Notification has been sent out. */
+        UA_Notification *prev;
+        while((prev = TAILQ_PREV(n, NotificationQueue, localEntry))) {
+            UA_Notification_delete(server, prev);
+        }
+
+        const void *data;
+        const UA_DataType *type;
+        size_t kind = notificationKind(n, &data, &type);
+        sel->count[kind]++;
+        sel->length[kind] += UA_calcSizeBinary(data, type);
+
+        UA_Notification_dequeue(n);
+        TAILQ_INSERT_TAIL(&sel->queue, n, globalEntry);
+        totalNotifications++;
+    }
+
+    /* Add the array length of the notifications and the (empty) DiagnosticInfo
+     * array of the DataChangeNotification */
+    for(size_t kind = 0; kind < UA_NOTIFICATIONMESSAGE_MAXDATA; kind++) {
+        if(sel->count[kind] > 0)
+            sel->length[kind] += sizeof(UA_Int32);
+    }
+    if(sel->count[UA_NOTIFICATIONKIND_DATACHANGE] > 0)
+        sel->length[UA_NOTIFICATIONKIND_DATACHANGE] += sizeof(UA_Int32);
+}
+
+/* Delete the selected notifications after the message was sent */
+static void
+deleteSelectedNotifications(UA_Server *server, UA_NotificationSelection *sel) {
+    UA_Notification *n, *n_tmp;
+    TAILQ_FOREACH_SAFE(n, &sel->queue, globalEntry, n_tmp) {
+        TAILQ_REMOVE(&sel->queue, n, globalEntry);
+        TAILQ_NEXT(n, globalEntry) = UA_SUBSCRIPTION_QUEUE_SENTINEL;
+        UA_Notification_delete(server, n);
+    }
+}
+
+/* Encode into the buffer if no MessageContext is given */
+static UA_StatusCode
+encodeNotificationPart(UA_MessageContext *mc, UA_Byte **pos, const UA_Byte **end,
+                       const void *src, const UA_DataType *type) {
+    if(mc)
+        return UA_MessageContext_encode(mc, src, type);
+    return UA_encodeBinaryInternal(src, type, pos, end, NULL, NULL);
+}
+
+/* Encode the body of the DataChangeNotification or EventNotificationList from
+ * the selected notifications */
+static UA_StatusCode
+encodeNotificationBody(const UA_NotificationSelection *sel, size_t kind,
+                       UA_MessageContext *mc, UA_Byte **pos, const UA_Byte **end) {
+    UA_Int32 count = (UA_Int32)sel->count[kind];
+    UA_StatusCode res = encodeNotificationPart(mc, pos, end, &count,
+                                               &UA_TYPES[UA_TYPES_INT32]);
+    UA_Notification *n;
+    TAILQ_FOREACH(n, &sel->queue, globalEntry) {
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        const void *data;
+        const UA_DataType *type;
+        if(notificationKind(n, &data, &type) == kind)
+            res = encodeNotificationPart(mc, pos, end, data, type);
+    }
+    if(res != UA_STATUSCODE_GOOD || kind != UA_NOTIFICATIONKIND_DATACHANGE)
+        return res;
+    UA_Int32 noDiagnosticInfos = -1;
+    return encodeNotificationPart(mc, pos, end, &noDiagnosticInfos,
+                                  &UA_TYPES[UA_TYPES_INT32]);
+}
+
+/* Encode the bodies of the notificationData into a single allocation. Returns
+ * NULL if the memory could not be allocated. */
+static UA_NotificationMessageEntry *
+encodeRetransmissionMessage(const UA_NotificationSelection *sel,
+                            const UA_NotificationMessage *message) {
+    size_t memSize = sizeof(UA_NotificationMessageEntry);
+    for(size_t kind = 0; kind < UA_NOTIFICATIONMESSAGE_MAXDATA; kind++)
+        memSize += sel->length[kind];
+
+    UA_NotificationMessageEntry *entry = (UA_NotificationMessageEntry*)
+        UA_malloc(memSize);
+    if(!entry)
+        return NULL;
+    entry->sequenceNumber = message->sequenceNumber;
+    entry->publishTime = message->publishTime;
+    entry->memSize = memSize;
+    entry->notificationDataSize = 0;
+
+    /* Encode the bodies back-to-back */
+    UA_Byte *pos = (UA_Byte*)(entry + 1);
+    const UA_Byte *end = (const UA_Byte*)entry + memSize;
+    for(size_t kind = 0; kind < UA_NOTIFICATIONMESSAGE_MAXDATA; kind++) {
+        if(sel->count[kind] == 0)
+            continue;
+        UA_StatusCode res = encodeNotificationBody(sel, kind, NULL, &pos, &end);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(entry);
+            return NULL;
+        }
+        entry->notificationDataType[entry->notificationDataSize] =
+            notificationDataType(kind);
+        entry->notificationDataLength[entry->notificationDataSize] = sel->length[kind];
+        entry->notificationDataSize++;
+    }
+    UA_assert(pos == end);
+    return entry;
+}
+
+/* Returns a bad StatusCode if the entry was freed instead */
+static UA_StatusCode
 UA_Subscription_addRetransmissionMessage(UA_Server *server, UA_Subscription *sub,
                                          UA_NotificationMessageEntry *entry) {
-    /* Release the oldest entry if there is not enough space */
     UA_Session *session = sub->session;
+    const UA_ServerConfig *config = &server->config;
+
+    /* Don't retain messages that exceed the memory limits on their own */
+    if((config->maxRetransmissionQueueBytes > 0 &&
+        entry->memSize > config->maxRetransmissionQueueBytes) ||
+       (config->maxServerRetransmissionQueueBytes > 0 &&
+        entry->memSize > config->maxServerRetransmissionQueueBytes)) {
+        UA_LOG_WARNING_SUBSCRIPTION(config->logging, sub,
+                                    "NotificationMessage too large for the "
+                                    "retransmission queue");
+        UA_free(entry);
+        return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+    }
+
+    /* Release the oldest entries until there is enough space */
     if(sub->retransmissionQueueSize >= UA_MAX_RETRANSMISSIONQUEUESIZE) {
-        UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
+        UA_LOG_WARNING_SUBSCRIPTION(config->logging, sub,
                                     "Subscription retransmission queue overflow");
-        removeOldestRetransmissionMessageFromSub(sub);
-    } else if(session && server->config.maxRetransmissionQueueSize > 0 &&
-              session->totalRetransmissionQueueSize >=
-              server->config.maxRetransmissionQueueSize) {
-        UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
+        removeOldestRetransmissionMessageFromSub(server, sub);
+    }
+    if(session &&
+       ((config->maxRetransmissionQueueSize > 0 &&
+         session->totalRetransmissionQueueSize >= config->maxRetransmissionQueueSize) ||
+        (config->maxRetransmissionQueueBytes > 0 &&
+         session->totalRetransmissionQueueBytes + entry->memSize >
+         config->maxRetransmissionQueueBytes))) {
+        UA_LOG_WARNING_SUBSCRIPTION(config->logging, sub,
                                     "Session-wide retransmission queue overflow");
-        removeOldestRetransmissionMessageFromSession(sub->session);
+        do {
+            removeOldestRetransmissionMessageFromSession(server, session);
+        } while((config->maxRetransmissionQueueSize > 0 &&
+                 session->totalRetransmissionQueueSize >=
+                 config->maxRetransmissionQueueSize) ||
+                (config->maxRetransmissionQueueBytes > 0 &&
+                 session->totalRetransmissionQueueBytes + entry->memSize >
+                 config->maxRetransmissionQueueBytes));
+    }
+    if(config->maxServerRetransmissionQueueBytes > 0 &&
+       server->retransmissionQueueBytes + entry->memSize >
+       config->maxServerRetransmissionQueueBytes) {
+        UA_LOG_WARNING_SUBSCRIPTION(config->logging, sub,
+                                    "Server-wide retransmission queue overflow");
+        do {
+            removeOldestRetransmissionMessageFromServer(server);
+        } while(server->retransmissionQueueBytes + entry->memSize >
+                config->maxServerRetransmissionQueueBytes);
     }
 
     /* Add entry */
     TAILQ_INSERT_TAIL(&sub->retransmissionQueue, entry, listEntry);
     ++sub->retransmissionQueueSize;
-    if(session)
+    sub->retransmissionQueueBytes += entry->memSize;
+    if(session) {
         ++session->totalRetransmissionQueueSize;
+        session->totalRetransmissionQueueBytes += entry->memSize;
+    }
+    server->retransmissionQueueBytes += entry->memSize;
+    return UA_STATUSCODE_GOOD;
 }
 
 UA_StatusCode
-UA_Subscription_removeRetransmissionMessage(UA_Subscription *sub, UA_UInt32 sequenceNumber) {
+UA_Subscription_removeRetransmissionMessage(UA_Server *server, UA_Subscription *sub,
+                                            UA_UInt32 sequenceNumber) {
     /* Find the retransmission message */
     UA_NotificationMessageEntry *entry;
     TAILQ_FOREACH(entry, &sub->retransmissionQueue, listEntry) {
-        if(entry->message.sequenceNumber == sequenceNumber)
+        if(entry->sequenceNumber == sequenceNumber)
             break;
     }
     if(!entry)
         return UA_STATUSCODE_BADSEQUENCENUMBERUNKNOWN;
 
     /* Remove the retransmission message */
-    TAILQ_REMOVE(&sub->retransmissionQueue, entry, listEntry);
-    --sub->retransmissionQueueSize;
-    UA_NotificationMessage_clear(&entry->message);
-    UA_free(entry);
-
-    if(sub->session)
-        --sub->session->totalRetransmissionQueueSize;
-
+    removeRetransmissionMessage(server, sub, entry);
     return UA_STATUSCODE_GOOD;
 }
 
-/* The output counters are only set when the preparation is successful */
-static UA_StatusCode
-prepareNotificationMessage(UA_Server *server, UA_Subscription *sub,
-                           UA_NotificationMessage *message,
-                           size_t maxNotifications) {
-    UA_assert(maxNotifications > 0);
-
-    /* Allocate an ExtensionObject for Event- and DataChange-Notifications. Also
-     * there can be StatusChange-Notifications. The standard says in Part 4,
-     * 7.2.1:
-     *
-     * If a Subscription contains MonitoredItems for events and data, this array
-     * should have not more than 2 elements. */
+UA_StatusCode
+UA_Subscription_republishMessage(const UA_NotificationMessageEntry *entry,
+                                 UA_NotificationMessage *message) {
     message->notificationData = (UA_ExtensionObject*)
-        UA_Array_new(2, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]);
+        UA_Array_new(entry->notificationDataSize, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]);
     if(!message->notificationData)
         return UA_STATUSCODE_BADOUTOFMEMORY;
-    message->notificationDataSize = 2;
-
-    /* Pre-allocate DataChangeNotifications */
-    size_t notificationDataIdx = 0;
-    size_t dcnPos = 0; /* How many DataChangeNotifications? */
-    UA_DataChangeNotification *dcn = NULL;
-    if(sub->dataChangeNotifications > 0) {
-        dcn = UA_DataChangeNotification_new();
-        if(!dcn) {
-            UA_NotificationMessage_clear(message);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-        UA_ExtensionObject_setValue(message->notificationData, dcn,
-                                    &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
-        size_t dcnSize = sub->dataChangeNotifications;
-        if(dcnSize > maxNotifications)
-            dcnSize = maxNotifications;
-        dcn->monitoredItems = (UA_MonitoredItemNotification*)
-            UA_Array_new(dcnSize, &UA_TYPES[UA_TYPES_MONITOREDITEMNOTIFICATION]);
-        if(!dcn->monitoredItems) {
-            UA_NotificationMessage_clear(message);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-        dcn->monitoredItemsSize = dcnSize;
-        notificationDataIdx++;
-    }
-
-#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
-    size_t enlPos = 0; /* How many EventNotifications? */
-    UA_EventNotificationList *enl = NULL;
-    if(sub->eventNotifications > 0) {
-        enl = UA_EventNotificationList_new();
-        if(!enl) {
-            UA_NotificationMessage_clear(message);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-        UA_ExtensionObject_setValue(&message->notificationData[notificationDataIdx],
-                                    enl, &UA_TYPES[UA_TYPES_EVENTNOTIFICATIONLIST]);
-        size_t enlSize = sub->eventNotifications;
-        if(enlSize > maxNotifications)
-            enlSize = maxNotifications;
-        enl->events = (UA_EventFieldList*)
-            UA_Array_new(enlSize, &UA_TYPES[UA_TYPES_EVENTFIELDLIST]);
-        if(!enl->events) {
+    message->notificationDataSize = entry->notificationDataSize;
+    message->sequenceNumber = entry->sequenceNumber;
+    message->publishTime = entry->publishTime;
+
+    /* Copy the encoded bodies. The typeId is the binary encoding NodeId of the
+     * decoded type. So the bytes on the wire are the same as for the original
+     * NotificationMessage. */
+    const UA_Byte *pos = (const UA_Byte*)(entry + 1);
+    for(size_t i = 0; i < entry->notificationDataSize; i++) {
+        UA_ExtensionObject *eo = &message->notificationData[i];
+        UA_StatusCode res =
+            UA_ByteString_allocBuffer(&eo->content.encoded.body,
+                                      entry->notificationDataLength[i]);
+        if(res != UA_STATUSCODE_GOOD) {
             UA_NotificationMessage_clear(message);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
+            return res;
         }
-        enl->eventsSize = enlSize;
-        notificationDataIdx++;
+        memcpy(eo->content.encoded.body.data, pos, entry->notificationDataLength[i]);
+        eo->encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
+        eo->content.encoded.typeId = entry->notificationDataType[i]->binaryEncodingId;
+        pos += entry->notificationDataLength[i];
     }
-#endif
-
-    UA_assert(notificationDataIdx > 0);
-    message->notificationDataSize = notificationDataIdx;
-
-    /* <-- The point of no return --> */
+    return UA_STATUSCODE_GOOD;
+}
 
-    /* How many notifications were moved to the response overall? */
-    size_t totalNotifications = 0;
-    UA_Notification *notification, *notification_tmp;
-    TAILQ_FOREACH_SAFE(notification, &sub->notificationQueue,
-                       globalEntry, notification_tmp) {
-        if(totalNotifications >= maxNotifications)
-            break;
+static UA_StatusCode
+encodeArrayMC(UA_MessageContext *mc, const void *array, size_t size,
+              const UA_DataType *type) {
+    UA_Int32 length = -1;
+    if(size > 0)
+        length = (UA_Int32)size;
+    else if(array == UA_EMPTY_ARRAY_SENTINEL)
+        length = 0;
+    UA_StatusCode res = UA_MessageContext_encode(mc, &length, &UA_TYPES[UA_TYPES_INT32]);
+    for(size_t i = 0; i < size && res == UA_STATUSCODE_GOOD; i++)
+        res = UA_MessageContext_encode(mc, (const UA_Byte*)array + (i * type->memSize),
+                                       type);
+    return res;
+}
 
-        /* Move the content to the response */
-        switch(notification->mon->itemToMonitor.attributeId) {
-#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
-        case UA_ATTRIBUTEID_EVENTNOTIFIER:
-            UA_assert(enl != NULL); /* Have at least one event notification */
-            enl->events[enlPos] = notification->data.event;
-            UA_EventFieldList_init(&notification->data.event);
-            enlPos++;
-            break;
-#endif
-        default:
-            UA_assert(dcn != NULL); /* Have at least one change notification */
-            dcn->monitoredItems[dcnPos] = notification->data.dataChange;
-            UA_DataValue_init(&notification->data.dataChange.value);
-            dcnPos++;
-            break;
-        }
+/* Encode the PublishResponse into the chunks of the SecureChannel. The members
+ * are encoded one by one and the notifications are streamed from the
+ * selection. */
+static UA_StatusCode
+streamPublishResponse(UA_SecureChannel *channel, UA_UInt32 requestId,
+                      UA_PublishResponse *response, const UA_NotificationSelection *sel,
+                      size_t dataSize) {
+    UA_NotificationMessage *message = &response->notificationMessage;
+    UA_MessageContext mc;
+    UA_StatusCode res = UA_MessageContext_begin(&mc, channel, requestId,
+                                                UA_MESSAGETYPE_MSG);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Encode the members of the PublishResponse up to the notificationData */
+    const UA_DataType *responseType = &UA_TYPES[UA_TYPES_PUBLISHRESPONSE];
+    res = UA_MessageContext_encode(&mc, &responseType->binaryEncodingId,
+                                   &UA_TYPES[UA_TYPES_NODEID]);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_MessageContext_encode(&mc, &response->responseHeader,
+                                   &UA_TYPES[UA_TYPES_RESPONSEHEADER]);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_MessageContext_encode(&mc, &response->subscriptionId,
+                                   &UA_TYPES[UA_TYPES_UINT32]);
+    UA_CHECK_STATUS(res, return res);
+    res = encodeArrayMC(&mc, response->availableSequenceNumbers,
+                        response->availableSequenceNumbersSize,
+                        &UA_TYPES[UA_TYPES_UINT32]);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_MessageContext_encode(&mc, &response->moreNotifications,
+                                   &UA_TYPES[UA_TYPES_BOOLEAN]);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_MessageContext_encode(&mc, &message->sequenceNumber,
+                                   &UA_TYPES[UA_TYPES_UINT32]);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_MessageContext_encode(&mc, &message->publishTime,
+                                   &UA_TYPES[UA_TYPES_DATETIME]);
+    UA_CHECK_STATUS(res, return res);
+
+    /* Encode the notificationData as ExtensionObjects with a binary body. The
+     * body is streamed from the notifications. */
+    UA_Int32 signedDataSize = (UA_Int32)dataSize;
+    res = UA_MessageContext_encode(&mc, &signedDataSize, &UA_TYPES[UA_TYPES_INT32]);
+    UA_CHECK_STATUS(res, return res);
+    for(size_t kind = 0; kind < UA_NOTIFICATIONMESSAGE_MAXDATA; kind++) {
+        if(sel->count[kind] == 0)
+            continue;
+        UA_Byte encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
+        UA_Int32 length = (UA_Int32)sel->length[kind];
+        res = UA_MessageContext_encode(&mc, &notificationDataType(kind)->binaryEncodingId,
+                                       &UA_TYPES[UA_TYPES_NODEID]);
+        UA_CHECK_STATUS(res, return res);
+        res = UA_MessageContext_encode(&mc, &encoding, &UA_TYPES[UA_TYPES_BYTE]);
+        UA_CHECK_STATUS(res, return res);
+        res = UA_MessageContext_encode(&mc, &length, &UA_TYPES[UA_TYPES_INT32]);
+        UA_CHECK_STATUS(res, return res);
+        res = encodeNotificationBody(sel, kind, &mc, NULL, NULL);
+        UA_CHECK_STATUS(res, return res);
+    }
 
-        /* If there are Notifications *before this one* in the MonitoredItem-
-         * local queue, remove all of them. These are earlier Notifications that
-         * are non-reporting. And we don't want them to show up after the
-         * current Notification has been sent out. */
-        UA_Notification *prev;
-        while((prev = TAILQ_PREV(notification, NotificationQueue, localEntry))) {
-            UA_Notification_delete(prev);
-        }
+    /* Encode the remaining members */
+    res = encodeArrayMC(&mc, response->results, response->resultsSize,
+                        &UA_TYPES[UA_TYPES_STATUSCODE]);
+    UA_CHECK_STATUS(res, return res);
+    res = encodeArrayMC(&mc, response->diagnosticInfos, response->diagnosticInfosSize,
+                        &UA_TYPES[UA_TYPES_DIAGNOSTICINFO]);
+    UA_CHECK_STATUS(res, return res);
 
-        /* Delete the notification, remove from the queues and decrease the counters */
-        UA_Notification_delete(notification);
+    return UA_MessageContext_finish(&mc);
+}
 
-        totalNotifications++;
+/* Send the PublishResponse with the selected notifications. If the message was
+ * put into the retransmission queue, the encoded bodies are taken from there.
+ * Otherwise the notifications are encoded directly into the chunks of the
+ * SecureChannel. The members of the PublishResponse are encoded one by one for
+ * this. The notificationData of the response is ignored. */
+static UA_StatusCode
+sendPublishResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
+                    UA_PublishResponse *response, const UA_NotificationSelection *sel,
+                    const UA_NotificationMessageEntry *entry) {
+    UA_NotificationMessage *message = &response->notificationMessage;
+    UA_assert(message->notificationDataSize == 0);
+    size_t dataSize = 0;
+    for(size_t kind = 0; kind < UA_NOTIFICATIONMESSAGE_MAXDATA; kind++) {
+        if(sel->count[kind] > 0)
+            dataSize++;
     }
 
-    /* Set sizes */
-    if(dcn) {
-        dcn->monitoredItemsSize = dcnPos;
-        if(dcnPos == 0) {
-            UA_free(dcn->monitoredItems);
-            dcn->monitoredItems = NULL;
+    /* KeepAlive or take the encoded bodies from the retransmission queue */
+    if(dataSize == 0 || entry) {
+        UA_ExtensionObject data[UA_NOTIFICATIONMESSAGE_MAXDATA];
+        const UA_Byte *pos = (entry) ? (const UA_Byte*)(entry + 1) : NULL;
+        for(size_t i = 0; entry && i < entry->notificationDataSize; i++) {
+            UA_ExtensionObject_init(&data[i]);
+            data[i].encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
+            data[i].content.encoded.typeId =
+                entry->notificationDataType[i]->binaryEncodingId;
+            data[i].content.encoded.body.length = entry->notificationDataLength[i];
+            data[i].content.encoded.body.data = (UA_Byte*)(uintptr_t)pos;
+            pos += entry->notificationDataLength[i];
         }
+        message->notificationData = (entry) ? data : NULL;
+        message->notificationDataSize = (entry) ? entry->notificationDataSize : 0;
+        UA_StatusCode res = sendResponse(server, channel, requestId, (UA_Response*)response,
+                                         &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+        message->notificationData = NULL;
+        message->notificationDataSize = 0;
+        return res;
     }
 
-#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
-    if(enl) {
-        enl->eventsSize = enlPos;
-        if(enlPos == 0) {
-            UA_free(enl->events);
-            enl->events = NULL;
-        }
-    }
-#endif
+    if(response->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+        return sendResponse(server, channel, requestId, (UA_Response*)response,
+                            &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
 
-    return UA_STATUSCODE_GOOD;
+    UA_EventLoop *el = server->config.eventLoop;
+    response->responseHeader.timestamp = el->dateTime_now(el);
+
+    lockSecureChannelSend(channel);
+    UA_StatusCode res =
+        streamPublishResponse(channel, requestId, response, sel, dataSize);
+    unlockSecureChannelSend(channel);
+    return res;
 }
 
 /* According to OPC Unified Architecture, Part 4 5.13.1.1 i) The value 0 is
@@ -465,11 +711,11 @@ UA_Subscription_localPublish(UA_Server *server, UA_Subscription *sub) {
          * current Notification has been sent out. */
         UA_Notification *prev;
         while((prev = TAILQ_PREV(n, NotificationQueue, localEntry))) {
-            UA_Notification_delete(prev);
+            UA_Notification_delete(server, prev);
         }
 
         /* Delete the notification, remove from the queues and decrease the counters */
-        UA_Notification_delete(n);
+        UA_Notification_delete(server, n);
     }
 
     UA_UNLOCK(&server->serviceMutex);
@@ -574,44 +820,17 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     /* Prepare the response */
     UA_PublishResponse *response = &pre->response;
     UA_NotificationMessage *message = &response->notificationMessage;
-    UA_NotificationMessageEntry *retransmission = NULL;
 #ifdef UA_ENABLE_DIAGNOSTICS
     size_t priorDataChangeNotifications = sub->dataChangeNotifications;
     size_t priorEventNotifications = sub->eventNotifications;
 #endif
-    if(notifications > 0) {
-        if(server->config.enableRetransmissionQueue) {
-            /* Allocate the retransmission entry */
-            retransmission = (UA_NotificationMessageEntry*)
-                UA_malloc(sizeof(UA_NotificationMessageEntry));
-            if(!retransmission) {
-                UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
-                                            "Could not allocate memory for retransmission. "
-                                            "The subscription is late.");
-                sub->late = true;
-                UA_Session_queuePublishReq(sub->session, pre, true); /* Re-enqueue */
-                return;
-            }
-        }
-
-        /* Prepare the response */
-        UA_StatusCode retval =
-            prepareNotificationMessage(server, sub, message, notifications);
-        if(retval != UA_STATUSCODE_GOOD) {
-            UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
-                                        "Could not prepare the notification message. "
-                                        "The subscription is late.");
-            /* If the retransmission queue is enabled a retransmission message is allocated */
-            if(retransmission)
-                UA_free(retransmission);
-            sub->late = true;
-            UA_Session_queuePublishReq(sub->session, pre, true); /* Re-enqueue */
-            return;
-        }
-    }
 
     /* <-- The point of no return --> */
 
+    /* Take the notifications out of the queues */
+    UA_NotificationSelection sel;
+    selectNotifications(server, sub, &sel, notifications);
+
     /* Set up the response */
     response->subscriptionId = sub->subscriptionId;
     response->moreNotifications = (sub->notificationQueueSize > 0);
@@ -622,15 +841,20 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
      * response with or without an monitored item. */
     message->sequenceNumber = sub->nextSequenceNumber;
 
+    UA_NotificationMessageEntry *retransmission = NULL;
     if(notifications > 0) {
-        /* If the retransmission queue is enabled a retransmission message is
-         * allocated */
-        if(retransmission) {
-            /* Put the notification message into the retransmission queue. This
-             * needs to be done here, so that the message itself is included in
-             * the available sequence numbers for acknowledgement. */
-            retransmission->message = response->notificationMessage;
-            UA_Subscription_addRetransmissionMessage(server, sub, retransmission);
+        if(server->config.enableRetransmissionQueue) {
+            /* Put the encoded notification message into the retransmission
+             * queue. This needs to be done here, so that the message itself is
+             * included in the available sequence numbers for acknowledgement. */
+            retransmission = encodeRetransmissionMessage(&sel, message);
+            if(!retransmission)
+                UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
+                                            "Could not allocate memory for "
+                                            "retransmission");
+            else if(UA_Subscription_addRetransmissionMessage(server, sub, retransmission) !=
+                    UA_STATUSCODE_GOOD)
+                retransmission = NULL;
         }
         /* Only if a notification was created, the sequence number must be
          * increased. For a keepalive the sequence number can be reused. */
@@ -646,7 +870,7 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     size_t i = 0;
     UA_NotificationMessageEntry *nme;
     TAILQ_FOREACH(nme, &sub->retransmissionQueue, listEntry) {
-        response->availableSequenceNumbers[i] = nme->message.sequenceNumber;
+        response->availableSequenceNumbers[i] = nme->sequenceNumber;
         ++i;
     }
     UA_assert(i == sub->retransmissionQueueSize);
@@ -655,8 +879,9 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     UA_LOG_DEBUG_SUBSCRIPTION(server->config.logging, sub,
                               "Sending out a publish response with %" PRIu32
                               " notifications", notifications);
-    sendResponse(server, sub->session->channel, pre->requestId,
-                 (UA_Response*)response, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+    sendPublishResponse(server, sub->session->channel, pre->requestId,
+                        response, &sel, retransmission);
+    deleteSelectedNotifications(server, &sel);
 
     /* Reset the Subscription state to NORMAL. But only if all notifications
      * have been sent out. Otherwise keep the Subscription in the LATE state. So
@@ -672,10 +897,6 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     sub->currentKeepAliveCount = 0;
 
     /* Free the response */
-    if(retransmission) {
-        /* NotificationMessage was moved into retransmission queue */
-        UA_NotificationMessage_init(&response->notificationMessage);
-    }
     response->availableSequenceNumbers = NULL;
     response->availableSequenceNumbersSize = 0;
     UA_PublishResponse_clear(&pre->response);
@@ -767,10 +988,7 @@ UA_Session_ensurePublishQueueSpace(UA_Server* server, UA_Session* session) {
 }
 
 static void
-sampleAndPublishCallback(UA_Server *server, UA_Subscription *sub) {
-    UA_LOCK(&server->serviceMutex);
-    UA_assert(sub);
-
+sampleAndPublish(UA_Server *server, UA_Subscription *sub) {
     UA_LOG_DEBUG_SUBSCRIPTION(server->config.logging, sub,
                               "Sample and Publish Callback");
 
@@ -783,25 +1001,162 @@ sampleAndPublishCallback(UA_Server *server, UA_Subscription *sub) {
 
     /* Publish the queued notifications */
     UA_Subscription_publish(server, sub);
+}
 
+static void
+sampleAndPublishCallback(UA_Server *server, UA_Subscription *sub) {
+    UA_LOCK(&server->serviceMutex);
+    UA_assert(sub);
+    sampleAndPublish(server, sub);
     UA_UNLOCK(&server->serviceMutex);
 }
 
+/* The responses of other requests can be sent from a reactor EventLoop while
+ * the batch is open. They are added to the batch as well. */
+static void
+beginBatch(UA_SecureChannel *channel) {
+    lockSecureChannelSend(channel);
+    UA_SecureChannel_beginBatch(channel);
+    unlockSecureChannelSend(channel);
+}
+
+static void
+flushBatch(UA_SecureChannel *channel) {
+    lockSecureChannelSend(channel);
+    UA_SecureChannel_flushBatch(channel);
+    unlockSecureChannelSend(channel);
+}
+
+static void
+publishSlotCallback(UA_Server *server, UA_PublishSlot *slot) {
+    UA_LOCK(&server->serviceMutex);
+
+    /* The Subscriptions are grouped by Session. Batch the sending for each
+     * SecureChannel. A Subscription can be deleted during the publish. If the
+     * last Subscription is deleted, then the slot is removed as well. But then
+     * the iteration has ended already. */
+    UA_SecureChannel *channel = NULL;
+    UA_Subscription *sub, *sub_tmp;
+    LIST_FOREACH_SAFE(sub, &slot->subscriptions, publishSlotEntry, sub_tmp) {
+        UA_SecureChannel *subChannel = (sub->session) ? sub->session->channel : NULL;
+        if(subChannel != channel) {
+            if(channel)
+                flushBatch(channel);
+            channel = subChannel;
+            if(channel)
+                beginBatch(channel);
+        }
+        sampleAndPublish(server, sub);
+    }
+    if(channel)
+        flushBatch(channel);
+
+    UA_UNLOCK(&server->serviceMutex);
+}
+
+static UA_StatusCode
+addToPublishSlot(UA_Server *server, UA_Subscription *sub) {
+    UA_PublishSlot *slot;
+    LIST_FOREACH(slot, &server->publishSlots, listEntry) {
+        if(slot->publishingInterval == sub->publishingInterval)
+            break;
+    }
+
+    /* Create a new slot. All slots use the same base time. So the cycles of
+     * slots with commensurable intervals coincide. */
+    if(!slot) {
+        slot = (UA_PublishSlot*)UA_calloc(1, sizeof(UA_PublishSlot));
+        if(!slot)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        slot->publishingInterval = sub->publishingInterval;
+        UA_DateTime baseTime = 0;
+        UA_EventLoop *el = server->config.eventLoop;
+        UA_StatusCode res =
+            el->addCyclicCallback(el, (UA_Callback)publishSlotCallback, server, slot,
+                                  slot->publishingInterval, &baseTime,
+                                  UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME,
+                                  &slot->callbackId);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(slot);
+            return res;
+        }
+        LIST_INSERT_HEAD(&server->publishSlots, slot, listEntry);
+    }
+
+    /* Insert next to a Subscription of the same Session */
+    UA_Subscription *other;
+    LIST_FOREACH(other, &slot->subscriptions, publishSlotEntry) {
+        if(other->session == sub->session)
+            break;
+    }
+    if(other)
+        LIST_INSERT_AFTER(other, sub, publishSlotEntry);
+    else
+        LIST_INSERT_HEAD(&slot->subscriptions, sub, publishSlotEntry);
+    sub->publishSlot = slot;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+addPublishCallback(UA_Server *server, UA_Subscription *sub) {
+    if(server->config.alignPublishingIntervals)
+        return addToPublishSlot(server, sub);
+    return addRepeatedCallback(server, (UA_ServerCallback)sampleAndPublishCallback,
+                               sub, sub->publishingInterval, &sub->publishCallbackId);
+}
+
+static void
+removePublishCallback(UA_Server *server, UA_Subscription *sub) {
+    if(sub->publishCallbackId != 0) {
+        removeCallback(server, sub->publishCallbackId);
+        sub->publishCallbackId = 0;
+    }
+
+    UA_PublishSlot *slot = sub->publishSlot;
+    if(!slot)
+        return;
+    LIST_REMOVE(sub, publishSlotEntry);
+    sub->publishSlot = NULL;
+    if(!LIST_EMPTY(&slot->subscriptions))
+        return;
+
+    /* Remove the empty slot */
+    removeCallback(server, slot->callbackId);
+    LIST_REMOVE(slot, listEntry);
+    UA_free(slot);
+}
+
+UA_StatusCode
+Subscription_updatePublishingInterval(UA_Server *server, UA_Subscription *sub) {
+    /* Modify the repeated callback. This cannot fail as memory is reused. */
+    if(sub->publishCallbackId != 0)
+        return changeRepeatedCallbackInterval(server, sub->publishCallbackId,
+                                              sub->publishingInterval);
+
+    /* Move to the slot of the new interval */
+    if(!sub->publishSlot ||
+       sub->publishSlot->publishingInterval == sub->publishingInterval)
+        return UA_STATUSCODE_GOOD;
+    removePublishCallback(server, sub);
+    UA_StatusCode res = addPublishCallback(server, sub);
+    if(res != UA_STATUSCODE_GOOD)
+        sub->state = UA_SUBSCRIPTIONSTATE_STOPPED;
+    return res;
+}
+
 UA_StatusCode
 Subscription_setState(UA_Server *server, UA_Subscription *sub,
                       UA_SubscriptionState state) {
+    UA_Boolean registered = (sub->publishCallbackId != 0 || sub->publishSlot);
     if(state <= UA_SUBSCRIPTIONSTATE_REMOVING) {
-        if(sub->publishCallbackId != 0) {
-            removeCallback(server, sub->publishCallbackId);
-            sub->publishCallbackId = 0;
+        if(registered) {
+            removePublishCallback(server, sub);
 #ifdef UA_ENABLE_DIAGNOSTICS
             sub->disableCount++;
 #endif
         }
-    } else if(sub->publishCallbackId == 0) {
-        UA_StatusCode res =
-            addRepeatedCallback(server, (UA_ServerCallback)sampleAndPublishCallback,
-                                sub, sub->publishingInterval, &sub->publishCallbackId);
+    } else if(!registered) {
+        UA_StatusCode res = addPublishCallback(server, sub);
         if(res != UA_STATUSCODE_GOOD) {
             sub->state = UA_SUBSCRIPTIONSTATE_STOPPED;
             return res;
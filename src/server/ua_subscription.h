@@ -63,10 +63,21 @@ typedef struct UA_Notification {
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     UA_Boolean isOverflowEvent; /* Counted manually */
 #endif
+    UA_Boolean pooled; /* Taken from a slab of the NotificationPool */
+
+    /* Storage for small scalar values without pointers (numbers, DateTime,
+     * Guid, ...). Then the value in the DataChange notification points here
+     * with UA_VARIANT_DATA_NODELETE and no separate allocation is needed. */
+    union {
+        UA_Int64 i64;
+        UA_Double d;
+        UA_Byte bytes[16];
+    } inlineValue;
 } UA_Notification;
 
-/* Initializes and sets the sentinel pointers */
-UA_Notification * UA_Notification_new(void);
+/* Initializes and sets the sentinel pointers. The notification is taken from
+ * the NotificationPool of the server. */
+UA_Notification * UA_Notification_new(UA_Server *server);
 
 /* Notifications are always added to the queue of the MonitoredItem. That queue
  * can overflow. If Notifications are reported, they are also added to the
@@ -80,14 +91,53 @@ UA_Notification * UA_Notification_new(void);
 void UA_Notification_enqueueAndTrigger(UA_Server *server,
                                        UA_Notification *n);
 
-/* Dequeue and delete the notification */
-void UA_Notification_delete(UA_Notification *n);
+/* Remove the notification from the MonitoredItem and Subscription queues and
+ * adjust the counters. The content remains until the notification is deleted. */
+void UA_Notification_dequeue(UA_Notification *n);
+
+/* Dequeue and delete the notification. Pooled notifications are put back into
+ * the free-list of the NotificationPool. */
+void UA_Notification_delete(UA_Server *server, UA_Notification *n);
+
+/* Notifications are created and deleted at a high rate. So they are allocated
+ * in slabs of config.notificationSlabSize entries. Unused notifications are
+ * kept in a free-list (linked via the localEntry) for reuse. The slabs are only
+ * returned to the system when the server is deleted. */
+typedef struct UA_NotificationSlab {
+    struct UA_NotificationSlab *next;
+    size_t size;
+    /* The notifications follow in the same allocation */
+} UA_NotificationSlab;
+
+typedef struct {
+    UA_NotificationSlab *slabs;
+    UA_Notification *freeList;
+    size_t slabCount;
+    size_t capacity;
+    size_t inUse;
+    size_t peakInUse;
+    size_t inlineValueCount;
+} UA_NotificationPool;
+
+/* All notifications must have been deleted beforehand */
+void UA_NotificationPool_clear(UA_NotificationPool *pool);
+
+/* A NotificationMessage contains an array of notifications. Sent
+ * NotificationMessages are stored for the republish service. Only the binary
+ * encoded bodies of the notificationData ExtensionObjects are retained. They
+ * are stored back-to-back after the entry in the same allocation. Republish
+ * sends them as ExtensionObjects with an encoded body. This results in the
+ * same bytes on the wire without decoding and encoding the content again. */
+#define UA_NOTIFICATIONMESSAGE_MAXDATA 2
 
-/* A NotificationMessage contains an array of notifications.
- * Sent NotificationMessages are stored for the republish service. */
 typedef struct UA_NotificationMessageEntry {
     TAILQ_ENTRY(UA_NotificationMessageEntry) listEntry;
-    UA_NotificationMessage message;
+    UA_UInt32 sequenceNumber;
+    UA_DateTime publishTime;
+    size_t memSize; /* Size of the allocation including the encoded bodies */
+    size_t notificationDataSize;
+    const UA_DataType *notificationDataType[UA_NOTIFICATIONMESSAGE_MAXDATA];
+    size_t notificationDataLength[UA_NOTIFICATIONMESSAGE_MAXDATA];
 } UA_NotificationMessageEntry;
 
 /* Queue Definitions */
@@ -220,6 +270,18 @@ typedef enum {
     UA_SUBSCRIPTIONSTATE_ENABLED
 } UA_SubscriptionState;
 
+/* With config.alignPublishingIntervals the Subscriptions with the same
+ * publishing interval are added to a shared publish slot. The slot has a single
+ * cyclic callback that publishes all its Subscriptions. The Subscriptions are
+ * grouped by Session, so that the PublishResponses for a SecureChannel can be
+ * sent in a batch. */
+typedef struct UA_PublishSlot {
+    LIST_ENTRY(UA_PublishSlot) listEntry;
+    UA_Double publishingInterval;
+    UA_UInt64 callbackId;
+    LIST_HEAD(, UA_Subscription) subscriptions;
+} UA_PublishSlot;
+
 /* Subscriptions are managed in a server-wide linked list. If they are attached
  * to a Session, then they are additionaly in the per-Session linked-list. A
  * subscription is always generated for a Session. But the CloseSession Service
@@ -254,6 +316,10 @@ struct UA_Subscription {
     /* Publish Callback. Registered if id > 0. */
     UA_UInt64 publishCallbackId;
 
+    /* Alternatively published in a shared slot (alignPublishingIntervals) */
+    struct UA_PublishSlot *publishSlot;
+    LIST_ENTRY(UA_Subscription) publishSlotEntry;
+
     /* Delayed callback to schedule publication of more notifications */
     UA_Boolean delayedCallbackRegistered;
     UA_DelayedCallback delayedMoreNotifications;
@@ -276,6 +342,7 @@ struct UA_Subscription {
     /* Retransmission Queue */
     NotificationMessageQueue retransmissionQueue;
     size_t retransmissionQueueSize;
+    size_t retransmissionQueueBytes;
 
     /* Statistics for the server diagnostics. The fields are defined according
      * to the SubscriptionDiagnosticsDataType (Part 5, §12.15). */
@@ -310,6 +377,10 @@ UA_StatusCode
 Subscription_setState(UA_Server *server, UA_Subscription *sub,
                       UA_SubscriptionState state);
 
+/* Move the publish callback to the current publishing interval */
+UA_StatusCode
+Subscription_updatePublishingInterval(UA_Server *server, UA_Subscription *sub);
+
 void
 Subscription_resetLifetime(UA_Subscription *sub);
 
@@ -327,9 +398,14 @@ void
 UA_Subscription_resendData(UA_Server *server, UA_Subscription *sub);
 
 UA_StatusCode
-UA_Subscription_removeRetransmissionMessage(UA_Subscription *sub,
+UA_Subscription_removeRetransmissionMessage(UA_Server *server, UA_Subscription *sub,
                                             UA_UInt32 sequenceNumber);
 
+/* Copy the retained NotificationMessage for the Republish service */
+UA_StatusCode
+UA_Subscription_republishMessage(const UA_NotificationMessageEntry *entry,
+                                 UA_NotificationMessage *message);
+
 void
 UA_Session_ensurePublishQueueSpace(UA_Server *server, UA_Session *session);
 
@@ -128,16 +128,31 @@ UA_StatusCode
 UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_MonitoredItem *mon,
                                               const UA_DataValue *dv) {
     /* Allocate a new notification */
-    UA_Notification *newNot = UA_Notification_new();
+    UA_Notification *newNot = UA_Notification_new(server);
     if(!newNot)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
     /* Prepare the notification */
     newNot->mon = mon;
     newNot->data.dataChange.clientHandle = mon->parameters.clientHandle;
+
+    /* Small scalars without pointers are stored inside the notification */
+    const UA_Variant *v = &dv->value;
+    if(dv->hasValue && UA_Variant_isScalar(v) && v->arrayDimensionsSize == 0 &&
+       v->type->pointerFree && v->type->memSize <= sizeof(newNot->inlineValue)) {
+        UA_DataValue *nv = &newNot->data.dataChange.value;
+        *nv = *dv;
+        memcpy(&newNot->inlineValue, v->data, v->type->memSize);
+        nv->value.data = &newNot->inlineValue;
+        nv->value.storageType = UA_VARIANT_DATA_NODELETE;
+        server->notificationPool.inlineValueCount++;
+        UA_Notification_enqueueAndTrigger(server, newNot);
+        return UA_STATUSCODE_GOOD;
+    }
+
     UA_StatusCode retval = UA_DataValue_copy(dv, &newNot->data.dataChange.value);
     if(retval != UA_STATUSCODE_GOOD) {
-        UA_free(newNot);
+        UA_Notification_delete(server, newNot);
         return retval;
     }
 
@@ -185,7 +185,7 @@ UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
         mon->parameters.filter.content.decoded.data;
 
     /* Allocate memory for the notification */
-    UA_Notification *notification = UA_Notification_new();
+    UA_Notification *notification = UA_Notification_new(server);
     if(!notification)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
@@ -202,7 +202,7 @@ UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
                                        &notification->data.event, &res);
     UA_EventFilterResult_clear(&res);
     if(retval != UA_STATUSCODE_GOOD) {
-        UA_Notification_delete(notification);
+        UA_Notification_delete(server, notification);
         if(retval == UA_STATUSCODE_BADNOMATCH)
             return UA_STATUSCODE_GOOD;
         return retval;
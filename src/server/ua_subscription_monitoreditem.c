@@ -51,7 +51,7 @@ createEventOverflowNotification(UA_Server *server, UA_Subscription *sub,
      * NodeId of the OverflowEventType. */
 
     /* Allocate the notification */
-    UA_Notification *overflowNotification = UA_Notification_new();
+    UA_Notification *overflowNotification = UA_Notification_new(server);
     if(!overflowNotification)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
@@ -61,7 +61,7 @@ createEventOverflowNotification(UA_Server *server, UA_Subscription *sub,
     overflowNotification->data.event.clientHandle = mon->parameters.clientHandle;
     overflowNotification->data.event.eventFields = UA_Variant_new();
     if(!overflowNotification->data.event.eventFields) {
-        UA_free(overflowNotification);
+        UA_Notification_delete(server, overflowNotification);
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
     overflowNotification->data.event.eventFieldsSize = 1;
@@ -69,7 +69,7 @@ createEventOverflowNotification(UA_Server *server, UA_Subscription *sub,
         UA_Variant_setScalarCopy(overflowNotification->data.event.eventFields,
                                  &eventQueueOverflowEventType, &UA_TYPES[UA_TYPES_NODEID]);
     if(retval != UA_STATUSCODE_GOOD) {
-        UA_Notification_delete(overflowNotification);
+        UA_Notification_delete(server, overflowNotification);
         return retval;
     }
 
@@ -167,14 +167,55 @@ UA_MonitoredItem_removeOverflowInfoBits(UA_MonitoredItem *mon) {
         (UA_STATUSCODE_INFOTYPE_DATAVALUE | UA_STATUSCODE_INFOBITS_OVERFLOW);
 }
 
+static UA_Notification *
+allocateNotificationSlab(UA_Server *server) {
+    UA_NotificationPool *pool = &server->notificationPool;
+    size_t size = server->config.notificationSlabSize;
+    UA_NotificationSlab *slab = (UA_NotificationSlab*)
+        UA_calloc(1, sizeof(UA_NotificationSlab) + (size * sizeof(UA_Notification)));
+    if(!slab)
+        return NULL;
+    slab->size = size;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slabCount++;
+    pool->capacity += size;
+
+    /* Return the first entry. Put the others into the free-list. */
+    UA_Notification *entries = (UA_Notification*)(uintptr_t)(slab + 1);
+    for(size_t i = size - 1; i > 0; i--) {
+        TAILQ_NEXT(&entries[i], localEntry) = pool->freeList;
+        pool->freeList = &entries[i];
+    }
+    return &entries[0];
+}
+
 UA_Notification *
-UA_Notification_new(void) {
-    UA_Notification *n = (UA_Notification*)UA_calloc(1, sizeof(UA_Notification));
+UA_Notification_new(UA_Server *server) {
+    UA_NotificationPool *pool = &server->notificationPool;
+    UA_Notification *n = pool->freeList;
+    UA_Boolean pooled = true;
     if(n) {
-        /* Set the sentinel for a notification that is not enqueued */
-        TAILQ_NEXT(n, globalEntry) = UA_SUBSCRIPTION_QUEUE_SENTINEL;
-        TAILQ_NEXT(n, localEntry) = UA_SUBSCRIPTION_QUEUE_SENTINEL;
+        pool->freeList = TAILQ_NEXT(n, localEntry);
+    } else if(server->config.notificationSlabSize > 0) {
+        n = allocateNotificationSlab(server);
+    } else {
+        n = (UA_Notification*)UA_malloc(sizeof(UA_Notification));
+        pooled = false;
     }
+    if(!n)
+        return NULL;
+
+    memset(n, 0, sizeof(UA_Notification));
+    n->pooled = pooled;
+
+    /* Set the sentinel for a notification that is not enqueued */
+    TAILQ_NEXT(n, globalEntry) = UA_SUBSCRIPTION_QUEUE_SENTINEL;
+    TAILQ_NEXT(n, localEntry) = UA_SUBSCRIPTION_QUEUE_SENTINEL;
+
+    pool->inUse++;
+    if(pool->inUse > pool->peakInUse)
+        pool->peakInUse = pool->inUse;
     return n;
 }
 
@@ -183,11 +224,16 @@ static void UA_Notification_enqueueSub(UA_Notification *n);
 static void UA_Notification_dequeueSub(UA_Notification *n);
 
 void
-UA_Notification_delete(UA_Notification *n) {
+UA_Notification_dequeue(UA_Notification *n) {
+    UA_Notification_dequeueMon(n);
+    UA_Notification_dequeueSub(n);
+}
+
+void
+UA_Notification_delete(UA_Server *server, UA_Notification *n) {
     UA_assert(n != UA_SUBSCRIPTION_QUEUE_SENTINEL);
     if(n->mon) {
-        UA_Notification_dequeueMon(n);
-        UA_Notification_dequeueSub(n);
+        UA_Notification_dequeue(n);
         switch(n->mon->itemToMonitor.attributeId) {
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
         case UA_ATTRIBUTEID_EVENTNOTIFIER:
@@ -199,7 +245,28 @@ UA_Notification_delete(UA_Notification *n) {
             break;
         }
     }
-    UA_free(n);
+
+    UA_NotificationPool *pool = &server->notificationPool;
+    UA_assert(pool->inUse > 0);
+    pool->inUse--;
+    if(!n->pooled) {
+        UA_free(n);
+        return;
+    }
+    TAILQ_NEXT(n, localEntry) = pool->freeList;
+    pool->freeList = n;
+}
+
+void
+UA_NotificationPool_clear(UA_NotificationPool *pool) {
+    UA_assert(pool->inUse == 0);
+    UA_NotificationSlab *slab = pool->slabs;
+    while(slab) {
+        UA_NotificationSlab *next = slab->next;
+        UA_free(slab);
+        slab = next;
+    }
+    memset(pool, 0, sizeof(UA_NotificationPool));
 }
 
 /* Add to the MonitoredItem queue, update all counters and then handle overflow */
@@ -519,7 +586,7 @@ UA_MonitoredItem_setMonitoringMode(UA_Server *server, UA_MonitoredItem *mon,
         UA_Notification *notification_tmp;
         UA_MonitoredItem_unregisterSampling(server, mon);
         TAILQ_FOREACH_SAFE(notification, &mon->queue, localEntry, notification_tmp) {
-            UA_Notification_delete(notification);
+            UA_Notification_delete(server, notification);
         }
         UA_DataValue_clear(&mon->lastValue);
         return UA_STATUSCODE_GOOD;
@@ -589,7 +656,7 @@ UA_MonitoredItem_delete(UA_Server *server, UA_MonitoredItem *mon) {
     /* Remove the queued notifications attached to the subscription */
     UA_Notification *notification, *notification_tmp;
     TAILQ_FOREACH_SAFE(notification, &mon->queue, localEntry, notification_tmp) {
-        UA_Notification_delete(notification);
+        UA_Notification_delete(server, notification);
     }
 
     /* Remove the settings */
@@ -689,7 +756,7 @@ UA_MonitoredItem_ensureQueueSpace(UA_Server *server, UA_MonitoredItem *mon) {
         remove--;
 
         /* Delete the notification and remove it from the queues */
-        UA_Notification_delete(del);
+        UA_Notification_delete(server, del);
 
         /* Update the subscription diagnostics statistics */
 #ifdef UA_ENABLE_DIAGNOSTICS
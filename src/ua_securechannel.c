@@ -187,6 +187,11 @@ UA_SecureChannel_clear(UA_SecureChannel *channel) {
     /* Delete remaining chunks */
     UA_SecureChannel_deleteBuffered(channel);
 
+    /* Unsent batched chunks */
+    UA_ByteString_clear(&channel->sendBatch);
+    channel->sendBatchLength = 0;
+    channel->sendBatching = false;
+
     /* Reset the SecureChannel for reuse (in the client) */
     channel->securityMode = UA_MESSAGESECURITYMODE_INVALID;
     channel->shutdownReason = UA_SHUTDOWNREASON_CLOSE;
@@ -351,6 +356,76 @@ encodeHeadersSym(UA_MessageContext *mc, size_t totalLength) {
     return res;
 }
 
+/* Send the batched chunks in one network buffer */
+static UA_StatusCode
+sendBatch(UA_SecureChannel *channel) {
+    if(channel->sendBatchLength == 0)
+        return UA_STATUSCODE_GOOD;
+    UA_ConnectionManager *cm = channel->connectionManager;
+    UA_ByteString buf;
+    UA_StatusCode res = cm->allocNetworkBuffer(cm, channel->connectionId, &buf,
+                                               channel->sendBatchLength);
+    if(res == UA_STATUSCODE_GOOD) {
+        memcpy(buf.data, channel->sendBatch.data, channel->sendBatchLength);
+        res = cm->sendWithConnection(cm, channel->connectionId,
+                                     &UA_KEYVALUEMAP_NULL, &buf);
+    }
+    channel->sendBatchLength = 0;
+    return res;
+}
+
+/* Send the chunk or append it to the batch */
+static UA_StatusCode
+sendChunk(UA_SecureChannel *channel, UA_ByteString *chunk) {
+    UA_ConnectionManager *cm = channel->connectionManager;
+    if(!channel->sendBatching)
+        return cm->sendWithConnection(cm, channel->connectionId,
+                                      &UA_KEYVALUEMAP_NULL, chunk);
+
+    /* Allocate the batch buffer on first use. It is kept until the channel is
+     * cleared. Send directly if the allocation fails. */
+    if(channel->sendBatch.length != channel->config.sendBufferSize) {
+        UA_ByteString_clear(&channel->sendBatch);
+        if(UA_ByteString_allocBuffer(&channel->sendBatch,
+                                     channel->config.sendBufferSize) != UA_STATUSCODE_GOOD) {
+            channel->sendBatching = false;
+            return cm->sendWithConnection(cm, channel->connectionId,
+                                          &UA_KEYVALUEMAP_NULL, chunk);
+        }
+    }
+
+    /* Send out the batch if the chunk does not fit. A chunk is never larger
+     * than the sendBufferSize. */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(channel->sendBatchLength + chunk->length > channel->sendBatch.length)
+        res = sendBatch(channel);
+    if(res == UA_STATUSCODE_GOOD) {
+        memcpy(&channel->sendBatch.data[channel->sendBatchLength],
+               chunk->data, chunk->length);
+        channel->sendBatchLength += chunk->length;
+    }
+    cm->freeNetworkBuffer(cm, channel->connectionId, chunk);
+    return res;
+}
+
+void
+UA_SecureChannel_beginBatch(UA_SecureChannel *channel) {
+    channel->sendBatching = true;
+}
+
+UA_StatusCode
+UA_SecureChannel_flushBatch(UA_SecureChannel *channel) {
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(UA_SecureChannel_isConnected(channel)) {
+        res = sendBatch(channel);
+        if(res != UA_STATUSCODE_GOOD)
+            channel->state = UA_SECURECHANNELSTATE_CLOSING;
+    }
+    channel->sendBatching = false;
+    channel->sendBatchLength = 0;
+    return res;
+}
+
 static UA_StatusCode
 sendSymmetricChunk(UA_MessageContext *mc) {
     UA_SecureChannel *channel = mc->channel;
@@ -415,8 +490,7 @@ sendSymmetricChunk(UA_MessageContext *mc) {
     /* Send the chunk. The buffer is freed in the network layer. If sending goes
      * wrong, the connection is removed in the next iteration of the
      * SecureChannel. Set the SecureChannel to closing already. */
-    res = cm->sendWithConnection(cm, channel->connectionId,
-                                 &UA_KEYVALUEMAP_NULL, &mc->messageBuffer);
+    res = sendChunk(channel, &mc->messageBuffer);
     if(res != UA_STATUSCODE_GOOD && UA_SecureChannel_isConnected(channel))
         channel->state = UA_SECURECHANNELSTATE_CLOSING;
 
@@ -150,6 +150,21 @@ struct UA_SecureChannel {
     UA_ByteString incompleteChunk; /* A half-received chunk (TCP is a
                                     * streaming protocol) is stored here */
 
+    /* Outgoing chunks are collected in the batch buffer while batching is
+     * enabled. See UA_SecureChannel_beginBatch. */
+    UA_Boolean sendBatching;
+    UA_ByteString sendBatch; /* Has the length of config.sendBufferSize.
+                              * Kept until the channel is cleared. */
+    size_t sendBatchLength;  /* Bytes used in the batch buffer */
+
+#if UA_MULTITHREADING >= 100
+    /* Taken for sending and for the SecurityToken rollover. So the token and
+     * the local keys cannot change while another thread signs and encrypts a
+     * message. Optional, only set in the server where messages are received
+     * in a different thread than they are sent from. */
+    UA_Lock *sendLock;
+#endif
+
     UA_CertificateGroup *certificateVerification;
     UA_StatusCode (*processOPNHeader)(void *application, UA_SecureChannel *channel,
                                       const UA_AsymmetricAlgorithmSecurityHeader *asymHeader);
@@ -222,6 +237,17 @@ UA_SecureChannel_sendSymmetricMessage(UA_SecureChannel *channel, UA_UInt32 reque
                                       UA_MessageType messageType, void *payload,
                                       const UA_DataType *payloadType);
 
+/* Collect the outgoing symmetric chunks instead of sending each chunk on its
+ * own. The chunks are copied into a batch buffer of the sendBufferSize which is
+ * sent when the next chunk does not fit. Use this to send many small messages
+ * (e.g. PublishResponses) with few network writes. */
+void
+UA_SecureChannel_beginBatch(UA_SecureChannel *channel);
+
+/* Send the remaining batched chunks and stop batching */
+UA_StatusCode
+UA_SecureChannel_flushBatch(UA_SecureChannel *channel);
+
 /* The MessageContext is forwarded into the encoding layer so that we can send
  * chunks before continuing to encode. This lets us reuse a fixed chunk-sized
  * messages buffer. */
@@ -493,6 +493,26 @@ checkAsymHeader(UA_SecureChannel *channel,
      * because the client/server context is needed. */
 }
 
+static void
+lockRollover(UA_SecureChannel *channel) {
+#if UA_MULTITHREADING >= 100
+    if(channel->sendLock)
+        UA_LOCK(channel->sendLock);
+#else
+    (void)channel;
+#endif
+}
+
+static void
+unlockRollover(UA_SecureChannel *channel) {
+#if UA_MULTITHREADING >= 100
+    if(channel->sendLock)
+        UA_UNLOCK(channel->sendLock);
+#else
+    (void)channel;
+#endif
+}
+
 UA_StatusCode
 checkSymHeader(UA_SecureChannel *channel, const UA_UInt32 tokenId,
                UA_DateTime nowMonotonic) {
@@ -518,11 +538,13 @@ checkSymHeader(UA_SecureChannel *channel, const UA_UInt32 tokenId,
                  return UA_STATUSCODE_BADSECURECHANNELTOKENUNKNOWN);
 
         /* Roll over to the new token, generate new local and remote keys */
+        lockRollover(channel);
         channel->renewState = UA_SECURECHANNELRENEWSTATE_NORMAL;
         channel->securityToken = channel->altSecurityToken;
         UA_ChannelSecurityToken_init(&channel->altSecurityToken);
         retval |= UA_SecureChannel_generateLocalKeys(channel);
         retval |= generateRemoteKeys(channel);
+        unlockRollover(channel);
         UA_CHECK_STATUS(retval, return retval);
         break;
 
@@ -574,11 +596,13 @@ UA_SecureChannel_checkTimeout(UA_SecureChannel *channel, UA_DateTime nowMonotoni
      * Server receives a Message secured with a new SecurityToken.*/
     if(timeout < nowMonotonic && channel->renewState == UA_SECURECHANNELRENEWSTATE_NEWTOKEN_SERVER) {
         /* Revolve the token manually. This is otherwise done in checkSymHeader. */
+        lockRollover(channel);
         channel->renewState = UA_SECURECHANNELRENEWSTATE_NORMAL;
         channel->securityToken = channel->altSecurityToken;
         UA_ChannelSecurityToken_init(&channel->altSecurityToken);
         UA_SecureChannel_generateLocalKeys(channel);
         generateRemoteKeys(channel);
+        unlockRollover(channel);
 
         /* Use the timeout of the new SecurityToken */
         timeout = channel->securityToken.createdAt +
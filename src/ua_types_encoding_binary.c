@@ -49,6 +49,11 @@ typedef struct {
     const UA_DataTypeArray *customTypes;
     UA_exchangeEncodeBuffer exchangeBufferCallback;
     void *exchangeBufferCallbackHandle;
+
+    /* Set during decoding if the decoded values may point into the input
+     * buffer. Then (optionally) memory is also taken from an arena. */
+    const UA_ByteString *borrowed;
+    UA_DecodeArena *arena;
 } Ctx;
 
 typedef status
@@ -395,6 +400,128 @@ DECODE_BINARY(Double) {
 
 #endif
 
+/**********************/
+/* Byte Order Kernels */
+/**********************/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <tmmintrin.h>
+# define UA_BYTESWAP_SSSE3 1
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+# define UA_BYTESWAP_NEON 1
+#endif
+
+#ifdef UA_BYTESWAP_SSSE3
+/* Swaps the complete 16-byte blocks. Returns the number of bytes done. */
+__attribute__((target("ssse3"))) static size_t
+byteSwapSSSE3(u8 *dst, const u8 *src, size_t bytes, size_t width) {
+    __m128i mask;
+    if(width == 2)
+        mask = _mm_set_epi8(14,15,12,13,10,11,8,9,6,7,4,5,2,3,0,1);
+    else if(width == 4)
+        mask = _mm_set_epi8(12,13,14,15,8,9,10,11,4,5,6,7,0,1,2,3);
+    else
+        mask = _mm_set_epi8(8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7);
+    size_t i = 0;
+    for(; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)&src[i]);
+        _mm_storeu_si128((__m128i*)(void*)&dst[i], _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+#endif
+
+#ifdef UA_BYTESWAP_NEON
+static size_t
+byteSwapNEON(u8 *dst, const u8 *src, size_t bytes, size_t width) {
+    size_t i = 0;
+    for(; i + 16 <= bytes; i += 16) {
+        uint8x16_t v = vld1q_u8(&src[i]);
+        if(width == 2)
+            v = vrev16q_u8(v);
+        else if(width == 4)
+            v = vrev32q_u8(v);
+        else
+            v = vrev64q_u8(v);
+        vst1q_u8(&dst[i], v);
+    }
+    return i;
+}
+#endif
+
+static void
+byteSwapScalar(u8 *dst, const u8 *src, size_t count, size_t width) {
+    u8 tmp[8];
+    for(size_t i = 0; i < count; i++) {
+        for(size_t j = 0; j < width; j++)
+            tmp[j] = src[width - 1 - j];
+        memcpy(dst, tmp, width);
+        dst += width;
+        src += width;
+    }
+}
+
+void
+UA_byteSwapArray(void *dst, const void *src, size_t count, size_t width) {
+    UA_assert(width == 2 || width == 4 || width == 8);
+    size_t bytes = count * width;
+    size_t done = 0;
+#if defined(UA_BYTESWAP_SSSE3)
+    if(__builtin_cpu_supports("ssse3"))
+        done = byteSwapSSSE3((u8*)dst, (const u8*)src, bytes, width);
+#elif defined(UA_BYTESWAP_NEON)
+    done = byteSwapNEON((u8*)dst, (const u8*)src, bytes, width);
+#endif
+    byteSwapScalar((u8*)dst + done, (const u8*)src + done,
+                   (bytes - done) / width, width);
+}
+
+/* Converts numerics between the host and the (little-endian) binary
+ * encoding */
+static void
+convertByteOrder(u8 *dst, const u8 *src, size_t count, size_t width) {
+#if UA_LITTLE_ENDIAN
+    memcpy(dst, src, count * width);
+#else
+    UA_byteSwapArray(dst, src, count, width);
+#endif
+}
+
+/* Returns the width of numeric types whose encoding differs from the memory
+ * layout at most in the byte order. Zero otherwise. Floating point values are
+ * only included if the integer encoding is also used for them. */
+static size_t
+numericWidth(const UA_DataType *type) {
+    size_t width = 0;
+    switch(type->typeKind) {
+    case UA_DATATYPEKIND_INT16:
+    case UA_DATATYPEKIND_UINT16:
+        width = 2;
+        break;
+    case UA_DATATYPEKIND_INT32:
+    case UA_DATATYPEKIND_UINT32:
+    case UA_DATATYPEKIND_STATUSCODE:
+    case UA_DATATYPEKIND_ENUM:
+#if (UA_FLOAT_IEEE754 == 1) && (UA_LITTLE_ENDIAN == UA_FLOAT_LITTLE_ENDIAN)
+    case UA_DATATYPEKIND_FLOAT:
+#endif
+        width = 4;
+        break;
+    case UA_DATATYPEKIND_INT64:
+    case UA_DATATYPEKIND_UINT64:
+    case UA_DATATYPEKIND_DATETIME:
+#if (UA_FLOAT_IEEE754 == 1) && (UA_LITTLE_ENDIAN == UA_FLOAT_LITTLE_ENDIAN)
+    case UA_DATATYPEKIND_DOUBLE:
+#endif
+        width = 8;
+        break;
+    default:
+        return 0;
+    }
+    return (type->memSize == width) ? width : 0;
+}
+
 /******************/
 /* Array Handling */
 /******************/
@@ -425,6 +552,48 @@ Array_encodeBinaryOverlayable(uintptr_t ptr, size_t memSize, Ctx *ctx) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Converts whole elements into the current chunk. An element that straddles
+ * the chunk boundary is converted into a temporary buffer first. */
+static status
+Array_encodeBinaryNumeric(uintptr_t ptr, size_t length, size_t width, Ctx *ctx) {
+    /* CalcSize only */
+    if(ctx->end == NULL) {
+        ctx->pos += length * width;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    while(true) {
+        size_t fit = (size_t)(ctx->end - ctx->pos) / width;
+        if(fit > length)
+            fit = length;
+        convertByteOrder(ctx->pos, (const u8*)ptr, fit, width);
+        ctx->pos += fit * width;
+        ptr += fit * width;
+        length -= fit;
+        if(length == 0)
+            return UA_STATUSCODE_GOOD;
+
+        u8 tmp[8];
+        convertByteOrder(tmp, (const u8*)ptr, 1, width);
+        for(size_t copied = 0; copied < width;) {
+            if(ctx->pos == ctx->end) {
+                status ret = exchangeBuffer(ctx);
+                UA_assert(ret != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
+                UA_CHECK_STATUS(ret, return ret);
+                UA_CHECK(ctx->pos < ctx->end, return UA_STATUSCODE_BADENCODINGERROR);
+            }
+            size_t possible = (size_t)(ctx->end - ctx->pos);
+            if(possible > width - copied)
+                possible = width - copied;
+            memcpy(ctx->pos, &tmp[copied], possible);
+            ctx->pos += possible;
+            copied += possible;
+        }
+        ptr += width;
+        length--;
+    }
+}
+
 static status
 Array_encodeBinaryComplex(uintptr_t ptr, size_t length,
                           const UA_DataType *type, Ctx *ctx) {
@@ -456,8 +625,11 @@ Array_encodeBinary(const void *src, size_t length, const UA_DataType *type, Ctx
 
     /* Encode the content */
     if(length > 0) {
+        size_t width;
         if(type->overlayable)
             ret = Array_encodeBinaryOverlayable((uintptr_t)src, length * type->memSize, ctx);
+        else if((width = numericWidth(type)) > 0)
+            ret = Array_encodeBinaryNumeric((uintptr_t)src, length, width, ctx);
         else
             ret = Array_encodeBinaryComplex((uintptr_t)src, length, type, ctx);
     }
@@ -465,6 +637,232 @@ Array_encodeBinary(const void *src, size_t length, const UA_DataType *type, Ctx
     return ret;
 }
 
+/* Borrowed decoding. The data of Strings and overlayable arrays points into
+ * the input buffer. If an arena is set, the other allocations are taken from
+ * it until it is exhausted. Before clearing, the members in these memory
+ * regions are detached. Everything else is allocated on the heap as usual. */
+
+typedef struct {
+    const UA_ByteString *buf;
+    const UA_DecodeArena *arena; /* Can be NULL */
+} Borrowed;
+
+static UA_Boolean
+isBorrowed(const void *p, const Borrowed *b) {
+    const u8 *ptr = (const u8*)p;
+    if(b->buf && ptr >= b->buf->data && ptr < &b->buf->data[b->buf->length])
+        return true;
+    return (b->arena && ptr >= b->arena->data &&
+            ptr < &b->arena->data[b->arena->size]);
+}
+
+static void
+unborrow(void *p, const UA_DataType *type, const Borrowed *b);
+
+/* A borrowed scalar is cleared in-place (heap members) and then detached */
+static void
+unborrowPtr(void **p, const UA_DataType *type, const Borrowed *b) {
+    if(!*p)
+        return;
+    unborrow(*p, type, b);
+    if(!isBorrowed(*p, b))
+        return;
+    UA_clear(*p, type);
+    *p = NULL;
+}
+
+static void
+unborrowArray(void **data, size_t *length, const UA_DataType *type,
+              const Borrowed *b) {
+    if(*data == NULL || *data == UA_EMPTY_ARRAY_SENTINEL)
+        return;
+    UA_Boolean borrowed = isBorrowed(*data, b);
+    if(!type->pointerFree) {
+        uintptr_t ptr = (uintptr_t)*data;
+        for(size_t i = 0; i < *length; i++) {
+            unborrow((void*)ptr, type, b);
+            if(borrowed)
+                UA_clear((void*)ptr, type);
+            ptr += type->memSize;
+        }
+    }
+    if(borrowed) {
+        *data = NULL;
+        *length = 0;
+    }
+}
+
+static void
+unborrowString(UA_String *s, const Borrowed *b) {
+    unborrowArray((void**)&s->data, &s->length, &UA_TYPES[UA_TYPES_BYTE], b);
+}
+
+static void
+unborrowNodeId(UA_NodeId *id, const Borrowed *b) {
+    if(id->identifierType == UA_NODEIDTYPE_STRING ||
+       id->identifierType == UA_NODEIDTYPE_BYTESTRING)
+        unborrowString(&id->identifier.string, b);
+}
+
+static void
+unborrowStructure(void *p, const UA_DataType *type, const Borrowed *b) {
+    uintptr_t ptr = (uintptr_t)p;
+    for(size_t i = 0; i < type->membersSize; ++i) {
+        const UA_DataTypeMember *m = &type->members[i];
+        const UA_DataType *mt = m->memberType;
+        ptr += m->padding;
+        if(m->isArray) {
+            unborrowArray((void**)(ptr + sizeof(size_t)), (size_t*)ptr, mt, b);
+            ptr += sizeof(size_t) + sizeof(void*);
+        } else if(m->isOptional) {
+            unborrowPtr((void**)ptr, mt, b);
+            ptr += sizeof(void*);
+        } else {
+            unborrow((void*)ptr, mt, b);
+            ptr += mt->memSize;
+        }
+    }
+}
+
+static void
+unborrow(void *p, const UA_DataType *type, const Borrowed *b) {
+    switch(type->typeKind) {
+    case UA_DATATYPEKIND_STRING:
+    case UA_DATATYPEKIND_BYTESTRING:
+    case UA_DATATYPEKIND_XMLELEMENT:
+        unborrowString((UA_String*)p, b);
+        break;
+    case UA_DATATYPEKIND_NODEID:
+        unborrowNodeId((UA_NodeId*)p, b);
+        break;
+    case UA_DATATYPEKIND_EXPANDEDNODEID: {
+        UA_ExpandedNodeId *en = (UA_ExpandedNodeId*)p;
+        unborrowNodeId(&en->nodeId, b);
+        unborrowString(&en->namespaceUri, b);
+        break;
+    }
+    case UA_DATATYPEKIND_QUALIFIEDNAME:
+        unborrowString(&((UA_QualifiedName*)p)->name, b);
+        break;
+    case UA_DATATYPEKIND_LOCALIZEDTEXT:
+        unborrowString(&((UA_LocalizedText*)p)->locale, b);
+        unborrowString(&((UA_LocalizedText*)p)->text, b);
+        break;
+    case UA_DATATYPEKIND_EXTENSIONOBJECT: {
+        UA_ExtensionObject *eo = (UA_ExtensionObject*)p;
+        if(eo->encoding <= UA_EXTENSIONOBJECT_ENCODED_XML) {
+            unborrowNodeId(&eo->content.encoded.typeId, b);
+            unborrowString(&eo->content.encoded.body, b);
+        } else if(eo->encoding == UA_EXTENSIONOBJECT_DECODED) {
+            unborrowPtr(&eo->content.decoded.data, eo->content.decoded.type, b);
+        }
+        break;
+    }
+    case UA_DATATYPEKIND_DATAVALUE:
+        unborrow(&((UA_DataValue*)p)->value, &UA_TYPES[UA_TYPES_VARIANT], b);
+        break;
+    case UA_DATATYPEKIND_VARIANT: {
+        UA_Variant *v = (UA_Variant*)p;
+        if(!v->type)
+            break;
+        if(v->arrayLength == 0 && v->data > UA_EMPTY_ARRAY_SENTINEL)
+            unborrowPtr(&v->data, v->type, b); /* Scalar */
+        else
+            unborrowArray(&v->data, &v->arrayLength, v->type, b);
+        unborrowArray((void**)&v->arrayDimensions, &v->arrayDimensionsSize,
+                      &UA_TYPES[UA_TYPES_UINT32], b);
+        break;
+    }
+    case UA_DATATYPEKIND_DIAGNOSTICINFO: {
+        UA_DiagnosticInfo *di = (UA_DiagnosticInfo*)p;
+        unborrowString(&di->additionalInfo, b);
+        unborrowPtr((void**)&di->innerDiagnosticInfo, type, b);
+        break;
+    }
+    case UA_DATATYPEKIND_STRUCTURE:
+    case UA_DATATYPEKIND_OPTSTRUCT:
+        unborrowStructure(p, type, b);
+        break;
+    case UA_DATATYPEKIND_UNION: {
+        UA_UInt32 selection = *(UA_UInt32*)p;
+        if(selection == 0 || selection > type->membersSize)
+            break;
+        const UA_DataTypeMember *m = &type->members[selection-1];
+        uintptr_t ptr = (uintptr_t)p + m->padding;
+        if(m->isArray)
+            unborrowArray((void**)(ptr + sizeof(size_t)), (size_t*)ptr,
+                          m->memberType, b);
+        else
+            unborrow((void*)ptr, m->memberType, b);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* Clear a (partially) decoded value */
+static void
+clearDecoded(void *p, const UA_DataType *type, Ctx *ctx) {
+    if(ctx->borrowed) {
+        Borrowed b = {ctx->borrowed, ctx->arena};
+        unborrow(p, type, &b);
+    }
+    UA_clear(p, type);
+}
+
+void
+UA_clearBorrowed(void *p, const UA_DataType *type, const UA_ByteString *inBuf) {
+    Borrowed b = {inBuf, NULL};
+    unborrow(p, type, &b);
+    UA_clear(p, type);
+}
+
+void
+UA_clearBorrowedArena(void *p, const UA_DataType *type,
+                      const UA_ByteString *inBuf, const UA_DecodeArena *arena) {
+    Borrowed b = {inBuf, arena};
+    unborrow(p, type, &b);
+    UA_clear(p, type);
+}
+
+/* Allocate zeroed memory from the arena. Falls back to the heap if there is no
+ * arena or it is exhausted. */
+static void *
+decodeCalloc(Ctx *ctx, size_t nelem, size_t elsize) {
+    UA_DecodeArena *arena = ctx->arena;
+    if(arena) {
+        /* Align to 8 byte */
+        uintptr_t addr = (uintptr_t)&arena->data[arena->pos];
+        size_t pos = arena->pos + ((8 - (addr % 8)) % 8);
+        if(pos <= arena->size && nelem <= (arena->size - pos) / elsize) {
+            void *p = &arena->data[pos];
+            memset(p, 0, nelem * elsize);
+            arena->pos = pos + (nelem * elsize);
+            return p;
+        }
+    }
+    return UA_calloc(nelem, elsize);
+}
+
+static void
+decodeFree(Ctx *ctx, void *p) {
+    UA_DecodeArena *arena = ctx->arena;
+    if(arena && (u8*)p >= arena->data && (u8*)p < &arena->data[arena->size])
+        return;
+    UA_free(p);
+}
+
+/* Arrays of overlayable types are only borrowed if the members are aligned in
+ * the buffer */
+static UA_Boolean
+canBorrowArray(const UA_DataType *type, Ctx *ctx) {
+    if(!ctx->borrowed)
+        return false;
+    uintptr_t align = (type->memSize < 8) ? type->memSize : 8;
+    return ((uintptr_t)ctx->pos % align) == 0;
+}
+
 static status
 Array_decodeBinary(void *UA_RESTRICT *UA_RESTRICT dst, size_t *out_length,
                    const UA_DataType *type, Ctx *ctx) {
@@ -494,23 +892,51 @@ Array_decodeBinary(void *UA_RESTRICT *UA_RESTRICT dst, size_t *out_length,
     UA_CHECK(ctx->pos + ((type->memSize * length) / 128) <= ctx->end,
              return UA_STATUSCODE_BADDECODINGERROR);
 
+    /* Point into the input buffer */
+    if(type->overlayable && canBorrowArray(type, ctx)) {
+        UA_CHECK(ctx->pos + (type->memSize * length) <= ctx->end,
+                 return UA_STATUSCODE_BADDECODINGERROR);
+        *dst = ctx->pos;
+        ctx->pos += type->memSize * length;
+        *out_length = length;
+        return UA_STATUSCODE_GOOD;
+    }
+
     /* Allocate memory */
-    *dst = UA_calloc(length, type->memSize);
+    *dst = decodeCalloc(ctx, length, type->memSize);
     UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     if(type->overlayable) {
         /* memcpy overlayable array */
         UA_CHECK(ctx->pos + (type->memSize * length) <= ctx->end,
-                 UA_free(*dst); *dst = NULL; return UA_STATUSCODE_BADDECODINGERROR);
+                 decodeFree(ctx, *dst); *dst = NULL;
+                 return UA_STATUSCODE_BADDECODINGERROR);
         memcpy(*dst, ctx->pos, type->memSize * length);
         ctx->pos += type->memSize * length;
+    } else if(numericWidth(type) > 0) {
+        /* Convert the byte order of numeric arrays in bulk */
+        UA_CHECK(ctx->pos + (type->memSize * length) <= ctx->end,
+                 decodeFree(ctx, *dst); *dst = NULL;
+                 return UA_STATUSCODE_BADDECODINGERROR);
+        convertByteOrder((u8*)*dst, ctx->pos, length, type->memSize);
+        ctx->pos += type->memSize * length;
     } else {
         /* Decode array members */
         uintptr_t ptr = (uintptr_t)*dst;
         for(size_t i = 0; i < length; ++i) {
             ret = decodeBinaryJumpTable[type->typeKind]((void*)ptr, type, ctx);
-            UA_CHECK_STATUS(ret, /* +1 because last element is also already initialized */
-                            UA_Array_delete(*dst, i+1, type); *dst = NULL; return ret);
+            if(ret != UA_STATUSCODE_GOOD) {
+                /* +1 because last element is also already initialized */
+                void *data = *dst;
+                size_t initialized = i + 1;
+                if(ctx->borrowed) {
+                    Borrowed b = {ctx->borrowed, ctx->arena};
+                    unborrowArray(&data, &initialized, type, &b);
+                }
+                UA_Array_delete(data, initialized, type);
+                *dst = NULL;
+                return ret;
+            }
             ptr += type->memSize;
         }
     }
@@ -889,7 +1315,7 @@ ExtensionObject_decodeBinaryContent(UA_ExtensionObject *dst, const UA_NodeId *ty
     }
 
     /* Allocate memory */
-    dst->content.decoded.data = UA_new(type);
+    dst->content.decoded.data = decodeCalloc(ctx, 1, type->memSize);
     UA_CHECK_MEM(dst->content.decoded.data, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     /* Jump over the length field (TODO: check if the decoded length matches) */
@@ -909,12 +1335,13 @@ DECODE_BINARY(ExtensionObject) {
     status ret = UA_STATUSCODE_GOOD;
     ret |= DECODE_DIRECT(&binTypeId, NodeId);
     ret |= DECODE_DIRECT(&encoding, Byte);
-    UA_CHECK_STATUS(ret, UA_NodeId_clear(&binTypeId); return ret);
+    UA_CHECK_STATUS(ret, clearDecoded(&binTypeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
+                    return ret);
 
     switch(encoding) {
     case UA_EXTENSIONOBJECT_ENCODED_BYTESTRING:
         ret = ExtensionObject_decodeBinaryContent(dst, &binTypeId, ctx);
-        UA_NodeId_clear(&binTypeId);
+        clearDecoded(&binTypeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
         break;
     case UA_EXTENSIONOBJECT_ENCODED_NOBODY:
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
@@ -925,10 +1352,11 @@ DECODE_BINARY(ExtensionObject) {
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
         dst->content.encoded.typeId = binTypeId; /* move to dst */
         ret = DECODE_DIRECT(&dst->content.encoded.body, String); /* ByteString */
-        UA_CHECK_STATUS(ret, UA_NodeId_clear(&dst->content.encoded.typeId));
+        UA_CHECK_STATUS(ret, clearDecoded(&dst->content.encoded.typeId,
+                                          &UA_TYPES[UA_TYPES_NODEID], ctx));
         break;
     default:
-        UA_NodeId_clear(&binTypeId);
+        clearDecoded(&binTypeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
         ret = UA_STATUSCODE_BADDECODINGERROR;
         break;
     }
@@ -979,12 +1407,34 @@ enum UA_VARIANT_ENCODINGMASKTYPE {
     UA_VARIANT_ENCODINGMASKTYPE_ARRAY = (u8)(0x01u << 7u)  /* bit 7 */
 };
 
+const UA_DataType UA_PREENCODEDVARIANT = {
+    UA_TYPENAME("PreEncodedVariant") /* .typeName */
+    {0, UA_NODEIDTYPE_NUMERIC, {0}}, /* .typeId */
+    {0, UA_NODEIDTYPE_NUMERIC, {0}}, /* .binaryEncodingId */
+    sizeof(UA_ByteString), /* .memSize */
+    UA_DATATYPEKIND_BYTESTRING, /* .typeKind */
+    false, /* .pointerFree */
+    false, /* .overlayable */
+    0, /* .membersSize */
+    NULL, /* .members */
+#ifdef UA_ENABLE_BINARY_CODEC
+    NULL /* .binaryCodec */
+#endif
+};
+
 ENCODE_BINARY(Variant) {
     /* Quit early for the empty variant */
     u8 encoding = 0;
     if(!src->type)
         return ENCODE_DIRECT(&encoding, Byte);
 
+    /* Copy the pre-encoded Variant. This can exchange the buffer. */
+    if(src->type == &UA_PREENCODEDVARIANT) {
+        const UA_ByteString *encoded = (const UA_ByteString*)src->data;
+        return Array_encodeBinaryOverlayable((uintptr_t)encoded->data,
+                                             encoded->length, ctx);
+    }
+
     /* Set the content type in the encoding mask */
     const UA_Boolean isBuiltin = (src->type->typeKind <= UA_DATATYPEKIND_DIAGNOSTICINFO);
     const UA_Boolean isEnum = (src->type->typeKind == UA_DATATYPEKIND_ENUM);
@@ -1050,7 +1500,8 @@ Variant_decodeBinaryUnwrapExtensionObject(UA_Variant *dst, Ctx *ctx) {
     /* Decode the EncodingByte */
     u8 encoding;
     ret = DECODE_DIRECT(&encoding, Byte);
-    UA_CHECK_STATUS(ret, UA_NodeId_clear(&typeId); return ret);
+    UA_CHECK_STATUS(ret, clearDecoded(&typeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
+                    return ret);
 
     /* Search for the datatype. Default to ExtensionObject. */
     if(encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING &&
@@ -1062,10 +1513,10 @@ Variant_decodeBinaryUnwrapExtensionObject(UA_Variant *dst, Ctx *ctx) {
         dst->type = &UA_TYPES[UA_TYPES_EXTENSIONOBJECT];
         ctx->pos = old_pos;
     }
-    UA_NodeId_clear(&typeId);
+    clearDecoded(&typeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
 
     /* Allocate memory */
-    dst->data = UA_new(dst->type);
+    dst->data = decodeCalloc(ctx, 1, dst->type->memSize);
     UA_CHECK_MEM(dst->data, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     /* Decode the content */
@@ -1112,7 +1563,7 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(void *UA_RESTRICT *UA_RESTRICT ds
 
     /* Lookup the data type */
     const UA_DataType *contentType = UA_findDataTypeByBinaryInternal(&binTypeId, ctx);
-    UA_NodeId_clear(&binTypeId);
+    clearDecoded(&binTypeId, &UA_TYPES[UA_TYPES_NODEID], ctx);
     if(!contentType) {
         /* DataType unknown, decode as ExtensionObject array */
         ctx->pos = orig_pos;
@@ -1154,7 +1605,7 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(void *UA_RESTRICT *UA_RESTRICT ds
     }
 
     /* Allocate memory for the unwrapped members */
-    *dst = UA_calloc(length, contentType->memSize);
+    *dst = decodeCalloc(ctx, length, contentType->memSize);
     UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
     *out_length = length;
     *type = contentType;
@@ -1206,7 +1657,7 @@ DECODE_BINARY(Variant) {
     if(!isArray) {
         /* Decode scalar */
         if(typeKind != UA_DATATYPEKIND_EXTENSIONOBJECT) {
-            dst->data = UA_new(dst->type);
+            dst->data = decodeCalloc(ctx, 1, dst->type->memSize);
             UA_CHECK_MEM(dst->data, ctx->depth--; return UA_STATUSCODE_BADOUTOFMEMORY);
             ret = decodeBinaryJumpTable[typeKind](dst->data, dst->type, ctx);
         } else {
@@ -1394,7 +1845,7 @@ DECODE_BINARY(DiagnosticInfo) {
     if(encodingMask & 0x40u) {
         /* innerDiagnosticInfo is allocated on the heap */
         dst->innerDiagnosticInfo = (UA_DiagnosticInfo*)
-            UA_calloc(1, sizeof(UA_DiagnosticInfo));
+            decodeCalloc(ctx, 1, sizeof(UA_DiagnosticInfo));
         UA_CHECK_MEM(dst->innerDiagnosticInfo, return UA_STATUSCODE_BADOUTOFMEMORY);
         dst->hasInnerDiagnosticInfo = true;
 
@@ -1420,6 +1871,16 @@ encodeBinaryStruct(const void *src, const UA_DataType *type, Ctx *ctx) {
              return UA_STATUSCODE_BADENCODINGERROR);
     ctx->depth++;
 
+#ifdef UA_ENABLE_BINARY_CODEC
+    /* Use the generated routine */
+    if(type->binaryCodec) {
+        status res = type->binaryCodec->encodeBinary(src, ctx);
+        UA_assert(res != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
+        ctx->depth--;
+        return res;
+    }
+#endif
+
     /* Loop over members */
     uintptr_t ptr = (uintptr_t)src;
     status ret = UA_STATUSCODE_GOOD;
@@ -1669,6 +2130,15 @@ decodeBinaryStructure(void *dst, const UA_DataType *type, Ctx *ctx) {
              return UA_STATUSCODE_BADENCODINGERROR);
     ctx->depth++;
 
+#ifdef UA_ENABLE_BINARY_CODEC
+    /* Use the generated routine */
+    if(type->binaryCodec) {
+        status res = type->binaryCodec->decodeBinary(dst, ctx);
+        ctx->depth--;
+        return res;
+    }
+#endif
+
     uintptr_t ptr = (uintptr_t)dst;
     status ret = UA_STATUSCODE_GOOD;
     u8 membersSize = type->membersSize;
@@ -1725,7 +2195,7 @@ decodeBinaryStructureWithOptFields(void *dst, const UA_DataType *type, Ctx *ctx)
                 ret = Array_decodeBinary((void *UA_RESTRICT *UA_RESTRICT)ptr, length, mt , ctx);
             } else {
                 /* Optional Scalar */
-                *(void *UA_RESTRICT *UA_RESTRICT) ptr = UA_calloc(1, mt->memSize);
+                *(void *UA_RESTRICT *UA_RESTRICT) ptr = decodeCalloc(ctx, 1, mt->memSize);
                 UA_CHECK_MEM(*(void *UA_RESTRICT *UA_RESTRICT) ptr, return UA_STATUSCODE_BADOUTOFMEMORY);
                 ret = decodeBinaryJumpTable[mt->typeKind](*(void *UA_RESTRICT *UA_RESTRICT) ptr, mt, ctx);
             }
@@ -1821,16 +2291,55 @@ const decodeBinarySignature decodeBinaryJumpTable[UA_DATATYPEKINDS] = {
     (decodeBinarySignature)decodeBinaryNotImplemented /* BitfieldCluster */
 };
 
-status
-UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
-                        void *dst, const UA_DataType *type,
-                        const UA_DataTypeArray *customTypes) {
+#ifdef UA_ENABLE_BINARY_CODEC
+
+/* Member routines for the generated UA_DataTypeBinaryCodec. The generated code
+ * accesses the buffer position directly. */
+
+UA_STATIC_ASSERT(offsetof(Ctx, pos) == offsetof(UA_BinaryCodecBuffer, pos) &&
+                 offsetof(Ctx, end) == offsetof(UA_BinaryCodecBuffer, end),
+                 codec_buffer_position_must_match_the_context);
+
+UA_StatusCode
+UA_encodeBinaryMember(const void *src, const UA_DataType *type, void *ctx) {
+    status ret = encodeWithExchangeBuffer(src, type, (Ctx*)ctx);
+    UA_assert(ret != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
+    return ret;
+}
+
+UA_StatusCode
+UA_encodeBinaryMemberArray(const void *src, size_t size,
+                           const UA_DataType *type, void *ctx) {
+    status ret = Array_encodeBinary(src, size, type, (Ctx*)ctx);
+    UA_assert(ret != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
+    return ret;
+}
+
+UA_StatusCode
+UA_decodeBinaryMember(void *dst, const UA_DataType *type, void *ctx) {
+    return decodeBinaryJumpTable[type->typeKind](dst, type, (Ctx*)ctx);
+}
+
+UA_StatusCode
+UA_decodeBinaryMemberArray(void **dst, size_t *size,
+                           const UA_DataType *type, void *ctx) {
+    return Array_decodeBinary(dst, size, type, (Ctx*)ctx);
+}
+
+#endif /* UA_ENABLE_BINARY_CODEC */
+
+static status
+decodeBinary(const UA_ByteString *src, size_t *offset, void *dst,
+             const UA_DataType *type, const UA_DataTypeArray *customTypes,
+             UA_Boolean borrow, UA_DecodeArena *arena) {
     /* Set up the context */
     Ctx ctx;
     ctx.pos = &src->data[*offset];
     ctx.end = &src->data[src->length];
     ctx.depth = 0;
     ctx.customTypes = customTypes;
+    ctx.borrowed = (borrow) ? src : NULL;
+    ctx.arena = (borrow) ? arena : NULL;
 
     /* Decode */
     memset(dst, 0, type->memSize); /* Initialize the value */
@@ -1841,34 +2350,498 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
         *offset = (size_t)(ctx.pos - src->data) / sizeof(u8);
     } else {
         /* Clean up */
-        UA_clear(dst, type);
+        clearDecoded(dst, type, &ctx);
         memset(dst, 0, type->memSize);
     }
     return ret;
 }
 
+status
+UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
+                        void *dst, const UA_DataType *type,
+                        const UA_DataTypeArray *customTypes) {
+    return decodeBinary(src, offset, dst, type, customTypes, false, NULL);
+}
+
+status
+UA_decodeBinaryBorrowed(const UA_ByteString *src, size_t *offset,
+                        void *dst, const UA_DataType *type,
+                        const UA_DataTypeArray *customTypes,
+                        UA_DecodeArena *arena) {
+    return decodeBinary(src, offset, dst, type, customTypes, true, arena);
+}
+
 UA_StatusCode
 UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
                 const UA_DecodeBinaryOptions *options) {
     size_t offset = 0;
     const UA_DataTypeArray *customTypes = options ? options->customTypes : NULL;
-    return UA_decodeBinaryInternal(inBuf, &offset, p, type, customTypes);
+    UA_Boolean borrow = options ? options->borrowBuffer : false;
+    return decodeBinary(inBuf, &offset, p, type, customTypes, borrow, NULL);
 }
 
 /**
  * Compute the Message Size
  * ------------------------
- * The following methods are used to compute the length of a datum in binary
- * encoding. If the end-ptr is NULL, then the normal encoding functions do not
- * throw an error when the buffer limits are exceeded. */
+ * The following methods compute the length of a datum in binary encoding
+ * without running the encoder. Types with a fixed encoding length are summed
+ * up without looking at the content. So arrays of such types are sized in
+ * O(1). The sizing fails (returns zero) in the cases where the encoding would
+ * fail as well. */
+
+typedef struct {
+    size_t size;
+    u16 depth;
+} SizeCtx;
+
+typedef status
+(*calcSizeBinarySignature)(const void *UA_RESTRICT src, const UA_DataType *type,
+                           SizeCtx *UA_RESTRICT ctx);
+#define CALCSIZE_BINARY(TYPE) static status                             \
+    TYPE##_calcSizeBinary(const UA_##TYPE *UA_RESTRICT src,             \
+                          const UA_DataType *type, SizeCtx *UA_RESTRICT ctx)
+#define CALCSIZE_DIRECT(SRC, TYPE) TYPE##_calcSizeBinary((const UA_##TYPE*)SRC, NULL, ctx)
+
+extern const calcSizeBinarySignature calcSizeBinaryJumpTable[UA_DATATYPEKINDS];
+
+/* Encoding length of the builtin types with a fixed size. Zero otherwise. */
+static const u8 fixedSizeBinary[UA_DATATYPEKINDS] = {
+    1, 1, 1, 2, 2, 4, 4, 8, 8, /* Boolean to UInt64 */
+    4, 8, 0, 8, 16, 0, 0, /* Float, Double, String, DateTime, Guid, ByteString,
+                           * XmlElement */
+    0, 0, 4, 0, 0, /* NodeId, ExpandedNodeId, StatusCode, QualifiedName,
+                    * LocalizedText */
+    0, 0, 0, 0, 0, /* ExtensionObject, DataValue, Variant, DiagnosticInfo, Decimal */
+    4, 0, 0, 0, 0 /* Enumeration, Structure, Structure with optional fields,
+                   * Union, BitfieldCluster */
+};
+
+/* Returns the fixed encoding length of the type or zero if the length depends
+ * on the content. The overlayable types are encoded as they are in memory.
+ * Structures without pointers (flagged as pointerFree by the type generator)
+ * sum up their member sizes. */
+static size_t
+fixedSize(const UA_DataType *type) {
+    if(type->overlayable)
+        return type->memSize;
+    size_t size = fixedSizeBinary[type->typeKind];
+    if(size > 0 || !type->pointerFree ||
+       (type->typeKind != UA_DATATYPEKIND_STRUCTURE &&
+        type->typeKind != UA_DATATYPEKIND_BITFIELDCLUSTER))
+        return size;
+    for(size_t i = 0; i < type->membersSize; i++) {
+        size_t memberSize = fixedSize(type->members[i].memberType);
+        if(memberSize == 0)
+            return 0;
+        size += memberSize;
+    }
+    return size;
+}
+
+static status
+Array_calcSizeBinary(const void *src, size_t length, const UA_DataType *type,
+                     SizeCtx *ctx) {
+    UA_CHECK(length <= UA_INT32_MAX, return UA_STATUSCODE_BADINTERNALERROR);
+    ctx->size += 4; /* Array length */
+    if(length == 0)
+        return UA_STATUSCODE_GOOD;
+
+    /* Fixed size elements */
+    size_t elementSize = fixedSize(type);
+    if(elementSize > 0) {
+        ctx->size += length * elementSize;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Size every element */
+    uintptr_t ptr = (uintptr_t)src;
+    for(size_t i = 0; i < length; ++i) {
+        status ret = calcSizeBinaryJumpTable[type->typeKind]((const void*)ptr, type, ctx);
+        UA_CHECK_STATUS(ret, return ret);
+        ptr += type->memSize;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static status
+calcSizeBinaryFixed(const void *src, const UA_DataType *type, SizeCtx *ctx) {
+    (void)src;
+    ctx->size += fixedSizeBinary[type->typeKind];
+    return UA_STATUSCODE_GOOD;
+}
+
+CALCSIZE_BINARY(String) {
+    UA_CHECK(src->length <= UA_INT32_MAX, return UA_STATUSCODE_BADINTERNALERROR);
+    ctx->size += 4 + src->length;
+    return UA_STATUSCODE_GOOD;
+}
+
+CALCSIZE_BINARY(NodeId) {
+    switch(src->identifierType) {
+    case UA_NODEIDTYPE_NUMERIC:
+        if(src->identifier.numeric > UA_UINT16_MAX || src->namespaceIndex > UA_BYTE_MAX)
+            ctx->size += 7; /* Complete */
+        else if(src->identifier.numeric > UA_BYTE_MAX || src->namespaceIndex > 0)
+            ctx->size += 4; /* Four-byte */
+        else
+            ctx->size += 2; /* Two-byte */
+        return UA_STATUSCODE_GOOD;
+    case UA_NODEIDTYPE_STRING:
+    case UA_NODEIDTYPE_BYTESTRING:
+        ctx->size += 3; /* Encoding byte and namespace index */
+        return CALCSIZE_DIRECT(&src->identifier.string, String);
+    case UA_NODEIDTYPE_GUID:
+        ctx->size += 3 + 16;
+        return UA_STATUSCODE_GOOD;
+    default:
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+}
+
+CALCSIZE_BINARY(ExpandedNodeId) {
+    status ret = CALCSIZE_DIRECT(&src->nodeId, NodeId);
+    UA_CHECK_STATUS(ret, return ret);
+    if((void*)src->namespaceUri.data > UA_EMPTY_ARRAY_SENTINEL) {
+        ret = CALCSIZE_DIRECT(&src->namespaceUri, String);
+        UA_CHECK_STATUS(ret, return ret);
+    }
+    if(src->serverIndex > 0)
+        ctx->size += 4;
+    return UA_STATUSCODE_GOOD;
+}
+
+CALCSIZE_BINARY(QualifiedName) {
+    ctx->size += 2; /* Namespace index */
+    return CALCSIZE_DIRECT(&src->name, String);
+}
+
+CALCSIZE_BINARY(LocalizedText) {
+    ctx->size += 1; /* Encoding byte */
+    status ret = UA_STATUSCODE_GOOD;
+    if(src->locale.data)
+        ret |= CALCSIZE_DIRECT(&src->locale, String);
+    if(src->text.data)
+        ret |= CALCSIZE_DIRECT(&src->text, String);
+    return ret;
+}
+
+CALCSIZE_BINARY(ExtensionObject) {
+    /* No content or already encoded content */
+    if(src->encoding <= UA_EXTENSIONOBJECT_ENCODED_XML) {
+        status ret = CALCSIZE_DIRECT(&src->content.encoded.typeId, NodeId);
+        UA_CHECK_STATUS(ret, return ret);
+        ctx->size += 1; /* Encoding byte */
+        if(src->encoding == UA_EXTENSIONOBJECT_ENCODED_NOBODY)
+            return UA_STATUSCODE_GOOD;
+        return CALCSIZE_DIRECT(&src->content.encoded.body, String);
+    }
+
+    /* Cannot encode with no data or no type description */
+    const UA_DataType *contentType = src->content.decoded.type;
+    if(!contentType || !src->content.decoded.data)
+        return UA_STATUSCODE_BADENCODINGERROR;
+
+    /* Binary encoding id, encoding byte and content length */
+    status ret = CALCSIZE_DIRECT(&contentType->binaryEncodingId, NodeId);
+    UA_CHECK_STATUS(ret, return ret);
+    ctx->size += 1 + 4;
+    return calcSizeBinaryJumpTable[contentType->typeKind](src->content.decoded.data,
+                                                          contentType, ctx);
+}
+
+/* Every element is wrapped in an ExtensionObject with the encoding id, encoding
+ * byte and length in front */
+static status
+Variant_calcSizeBinaryWrapExtensionObject(const UA_Variant *src,
+                                          const UA_Boolean isArray, SizeCtx *ctx) {
+    size_t length = 1;
+    if(isArray) {
+        UA_CHECK(src->arrayLength <= UA_INT32_MAX,
+                 return UA_STATUSCODE_BADENCODINGERROR);
+        length = src->arrayLength;
+        ctx->size += 4; /* Array length */
+    }
+
+    const UA_DataType *type = src->type;
+    SizeCtx header = {1 + 4, 0};
+    status ret = NodeId_calcSizeBinary(&type->binaryEncodingId, NULL, &header);
+    UA_CHECK_STATUS(ret, return ret);
+
+    size_t elementSize = fixedSize(type);
+    if(elementSize > 0) {
+        ctx->size += length * (header.size + elementSize);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    uintptr_t ptr = (uintptr_t)src->data;
+    for(size_t i = 0; i < length; ++i) {
+        ctx->size += header.size;
+        ret = calcSizeBinaryJumpTable[type->typeKind]((const void*)ptr, type, ctx);
+        UA_CHECK_STATUS(ret, return ret);
+        ptr += type->memSize;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+CALCSIZE_BINARY(Variant) {
+    /* The pre-encoded Variant is copied including the encoding byte */
+    if(src->type == &UA_PREENCODEDVARIANT) {
+        ctx->size += ((const UA_ByteString*)src->data)->length;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    ctx->size += 1; /* Encoding byte */
+    if(!src->type)
+        return UA_STATUSCODE_GOOD;
+
+    const UA_Boolean isBuiltin = (src->type->typeKind <= UA_DATATYPEKIND_DIAGNOSTICINFO);
+    const UA_Boolean isEnum = (src->type->typeKind == UA_DATATYPEKIND_ENUM);
+    const UA_Boolean isArray = src->arrayLength > 0 || src->data <= UA_EMPTY_ARRAY_SENTINEL;
+    const UA_Boolean hasDimensions = isArray && src->arrayDimensionsSize > 0;
+    if(hasDimensions) {
+        size_t totalRequiredSize = 1;
+        for(size_t i = 0; i < src->arrayDimensionsSize; ++i)
+            totalRequiredSize *= src->arrayDimensions[i];
+        if(totalRequiredSize != src->arrayLength)
+            return UA_STATUSCODE_BADENCODINGERROR;
+    }
+
+    /* Size the content */
+    status ret;
+    if(!isBuiltin && !isEnum)
+        ret = Variant_calcSizeBinaryWrapExtensionObject(src, isArray, ctx);
+    else if(!isArray)
+        ret = calcSizeBinaryJumpTable[src->type->typeKind](src->data, src->type, ctx);
+    else
+        ret = Array_calcSizeBinary(src->data, src->arrayLength, src->type, ctx);
+    UA_CHECK_STATUS(ret, return ret);
+
+    /* Size the array dimensions */
+    if(hasDimensions)
+        ret = Array_calcSizeBinary(src->arrayDimensions, src->arrayDimensionsSize,
+                                   &UA_TYPES[UA_TYPES_INT32], ctx);
+    return ret;
+}
+
+CALCSIZE_BINARY(DataValue) {
+    ctx->size += 1; /* Encoding byte */
+    if(src->hasValue) {
+        status ret = CALCSIZE_DIRECT(&src->value, Variant);
+        UA_CHECK_STATUS(ret, return ret);
+    }
+    if(src->hasStatus)
+        ctx->size += 4;
+    if(src->hasSourceTimestamp)
+        ctx->size += 8;
+    if(src->hasSourcePicoseconds)
+        ctx->size += 2;
+    if(src->hasServerTimestamp)
+        ctx->size += 8;
+    if(src->hasServerPicoseconds)
+        ctx->size += 2;
+    return UA_STATUSCODE_GOOD;
+}
+
+CALCSIZE_BINARY(DiagnosticInfo) {
+    ctx->size += 1; /* Encoding byte */
+    if(src->hasSymbolicId)
+        ctx->size += 4;
+    if(src->hasNamespaceUri)
+        ctx->size += 4;
+    if(src->hasLocalizedText)
+        ctx->size += 4;
+    if(src->hasLocale)
+        ctx->size += 4;
+    if(src->hasAdditionalInfo) {
+        status ret = CALCSIZE_DIRECT(&src->additionalInfo, String);
+        UA_CHECK_STATUS(ret, return ret);
+    }
+    if(src->hasInnerStatusCode)
+        ctx->size += 4;
+    if(src->hasInnerDiagnosticInfo)
+        return CALCSIZE_DIRECT(src->innerDiagnosticInfo, DiagnosticInfo);
+    return UA_STATUSCODE_GOOD;
+}
+
+static status
+calcSizeBinaryStruct(const void *src, const UA_DataType *type, SizeCtx *ctx) {
+    /* Fixed size without looking at the content */
+    size_t size = fixedSize(type);
+    if(size > 0) {
+        ctx->size += size;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Check the recursion limit */
+    UA_CHECK(ctx->depth <= UA_ENCODING_MAX_RECURSION,
+             return UA_STATUSCODE_BADENCODINGERROR);
+    ctx->depth++;
+
+#ifdef UA_ENABLE_BINARY_CODEC
+    /* Use the generated routine */
+    if(type->binaryCodec) {
+        status res = type->binaryCodec->calcSizeBinary(src, ctx);
+        ctx->depth--;
+        return res;
+    }
+#endif
+
+    /* Loop over members */
+    uintptr_t ptr = (uintptr_t)src;
+    status ret = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < type->membersSize && ret == UA_STATUSCODE_GOOD; ++i) {
+        const UA_DataTypeMember *m = &type->members[i];
+        const UA_DataType *mt = m->memberType;
+        ptr += m->padding;
+        if(m->isArray) {
+            const size_t length = *((const size_t*)ptr);
+            ptr += sizeof(size_t);
+            ret = Array_calcSizeBinary(*(void *UA_RESTRICT const *)ptr, length, mt, ctx);
+            ptr += sizeof(void*);
+            continue;
+        }
+        ret = calcSizeBinaryJumpTable[mt->typeKind]((const void*)ptr, mt, ctx);
+        ptr += mt->memSize;
+    }
+
+    ctx->depth--;
+    return ret;
+}
+
+static status
+calcSizeBinaryStructWithOptFields(const void *src, const UA_DataType *type,
+                                  SizeCtx *ctx) {
+    /* Check the recursion limit */
+    UA_CHECK(ctx->depth <= UA_ENCODING_MAX_RECURSION,
+             return UA_STATUSCODE_BADENCODINGERROR);
+    ctx->depth++;
+
+    ctx->size += 4; /* Encoding mask */
+
+    /* Loop over members. Optional members are skipped if not contained. */
+    uintptr_t ptr = (uintptr_t)src;
+    status ret = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < type->membersSize && ret == UA_STATUSCODE_GOOD; ++i) {
+        const UA_DataTypeMember *m = &type->members[i];
+        const UA_DataType *mt = m->memberType;
+        ptr += m->padding;
+        if(m->isArray) {
+            const size_t length = *((const size_t*)ptr);
+            ptr += sizeof(size_t);
+            const void *data = *(void *UA_RESTRICT const *)ptr;
+            if(!m->isOptional || data)
+                ret = Array_calcSizeBinary(data, length, mt, ctx);
+            ptr += sizeof(void*);
+        } else if(m->isOptional) {
+            const void *data = *(void* const*)ptr;
+            if(data)
+                ret = calcSizeBinaryJumpTable[mt->typeKind](data, mt, ctx);
+            ptr += sizeof(void*);
+        } else {
+            ret = calcSizeBinaryJumpTable[mt->typeKind]((const void*)ptr, mt, ctx);
+            ptr += mt->memSize;
+        }
+    }
+
+    ctx->depth--;
+    return ret;
+}
+
+static status
+calcSizeBinaryUnion(const void *src, const UA_DataType *type, SizeCtx *ctx) {
+    /* Check the recursion limit */
+    UA_CHECK(ctx->depth <= UA_ENCODING_MAX_RECURSION,
+             return UA_STATUSCODE_BADENCODINGERROR);
+
+    ctx->size += 4; /* Selection */
+    const UA_UInt32 selection = *(const UA_UInt32*)src;
+    if(selection == 0)
+        return UA_STATUSCODE_GOOD;
+    UA_CHECK(selection <= type->membersSize, return UA_STATUSCODE_BADENCODINGERROR);
+
+    /* Size the selected member */
+    const UA_DataTypeMember *m = &type->members[selection-1];
+    const UA_DataType *mt = m->memberType;
+    uintptr_t ptr = ((uintptr_t)src) + m->padding; /* includes the switchfield length */
+    ctx->depth++;
+    status ret;
+    if(!m->isArray) {
+        ret = calcSizeBinaryJumpTable[mt->typeKind]((const void*)ptr, mt, ctx);
+    } else {
+        const size_t length = *((const size_t*)ptr);
+        ptr += sizeof(size_t);
+        ret = Array_calcSizeBinary(*(void *UA_RESTRICT const *)ptr, length, mt, ctx);
+    }
+    ctx->depth--;
+    return ret;
+}
+
+static status
+calcSizeBinaryNotImplemented(const void *src, const UA_DataType *type, SizeCtx *ctx) {
+    (void)src, (void)type, (void)ctx;
+    return UA_STATUSCODE_BADNOTIMPLEMENTED;
+}
+
+const calcSizeBinarySignature calcSizeBinaryJumpTable[UA_DATATYPEKINDS] = {
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Boolean */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* SByte */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Byte */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Int16 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* UInt16 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Int32 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* UInt32 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Int64 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* UInt64 */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Float */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Double */
+    (calcSizeBinarySignature)String_calcSizeBinary,
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* DateTime */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Guid */
+    (calcSizeBinarySignature)String_calcSizeBinary, /* ByteString */
+    (calcSizeBinarySignature)String_calcSizeBinary, /* XmlElement */
+    (calcSizeBinarySignature)NodeId_calcSizeBinary,
+    (calcSizeBinarySignature)ExpandedNodeId_calcSizeBinary,
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* StatusCode */
+    (calcSizeBinarySignature)QualifiedName_calcSizeBinary,
+    (calcSizeBinarySignature)LocalizedText_calcSizeBinary,
+    (calcSizeBinarySignature)ExtensionObject_calcSizeBinary,
+    (calcSizeBinarySignature)DataValue_calcSizeBinary,
+    (calcSizeBinarySignature)Variant_calcSizeBinary,
+    (calcSizeBinarySignature)DiagnosticInfo_calcSizeBinary,
+    (calcSizeBinarySignature)calcSizeBinaryNotImplemented, /* Decimal */
+    (calcSizeBinarySignature)calcSizeBinaryFixed, /* Enumeration */
+    (calcSizeBinarySignature)calcSizeBinaryStruct,
+    (calcSizeBinarySignature)calcSizeBinaryStructWithOptFields, /* Structure with Optional Fields */
+    (calcSizeBinarySignature)calcSizeBinaryUnion, /* Union */
+    (calcSizeBinarySignature)calcSizeBinaryStruct /* BitfieldCluster */
+};
+
+#ifdef UA_ENABLE_BINARY_CODEC
+
+UA_STATIC_ASSERT(offsetof(SizeCtx, size) == offsetof(UA_BinaryCodecSize, size),
+                 codec_size_must_match_the_context);
+
+UA_StatusCode
+UA_calcSizeBinaryMember(const void *src, const UA_DataType *type, void *ctx) {
+    return calcSizeBinaryJumpTable[type->typeKind](src, type, (SizeCtx*)ctx);
+}
+
+UA_StatusCode
+UA_calcSizeBinaryMemberArray(const void *src, size_t size,
+                             const UA_DataType *type, void *ctx) {
+    return Array_calcSizeBinary(src, size, type, (SizeCtx*)ctx);
+}
+
+#endif /* UA_ENABLE_BINARY_CODEC */
 
 size_t
 UA_calcSizeBinary(const void *p, const UA_DataType *type) {
-    u8 *pos = NULL;
-    const u8 *posEnd = NULL;
-    UA_StatusCode res = UA_encodeBinaryInternal(p, type, &pos, &posEnd, NULL, NULL);
+    if(!type || !p)
+        return 0;
+    SizeCtx ctx = {0, 0};
+    status res = calcSizeBinaryJumpTable[type->typeKind](p, type, &ctx);
     if(res != UA_STATUSCODE_GOOD)
         return 0;
-    return (size_t)(uintptr_t)pos;
+    return ctx.size;
 }
@@ -67,9 +67,46 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
                         const UA_DataTypeArray *customTypes)
     UA_FUNC_ATTR_WARN_UNUSED_RESULT;
 
+/* Bump allocator for transient decoded values. Allocations that don't fit are
+ * taken from the heap. Resetting pos releases all allocations at once. */
+typedef struct {
+    UA_Byte *data;
+    size_t size;
+    size_t pos;
+} UA_DecodeArena;
+
+/* Strings and overlayable arrays of the decoded value point into src. The
+ * other allocations are taken from the arena if it is non-NULL. Clean up with
+ * UA_clearBorrowedArena before the arena is reset. */
+UA_StatusCode
+UA_decodeBinaryBorrowed(const UA_ByteString *src, size_t *offset,
+                        void *dst, const UA_DataType *type,
+                        const UA_DataTypeArray *customTypes,
+                        UA_DecodeArena *arena)
+    UA_FUNC_ATTR_WARN_UNUSED_RESULT;
+
+/* Frees only the heap-allocated members. The arena can be NULL. */
+void
+UA_clearBorrowedArena(void *p, const UA_DataType *type,
+                      const UA_ByteString *src, const UA_DecodeArena *arena);
+
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId);
 
+/* Reverses the byte order of count numerics with the given width (2, 4 or 8
+ * byte). dst and src are either identical or do not overlap. Uses the SIMD
+ * instructions (SSSE3, NEON) that are available at runtime. */
+void
+UA_byteSwapArray(void *dst, const void *src, size_t count, size_t width);
+
+/* Marker type for a Variant whose data is a UA_ByteString with the complete
+ * binary encoding of another Variant. The bytes are copied into the output
+ * buffer instead of encoding the Variant again. This is used internally by the
+ * server to encode frequently read values only once. Such Variants must have
+ * the UA_VARIANT_DATA_NODELETE storage type and are only valid for the binary
+ * encoding. */
+extern const UA_DataType UA_PREENCODEDVARIANT;
+
 _UA_END_DECLS
 
 #endif /* UA_TYPES_ENCODING_BINARY_H_ */
@@ -90,7 +90,8 @@ static const struct urlSchema schemas[] = {
     {"opc.tcp://"},
     {"opc.udp://"},
     {"opc.eth://"},
-    {"opc.mqtt://"}
+    {"opc.mqtt://"},
+    {"opc.mem://"}
 };
 
 static const unsigned scNumSchemas = sizeof(schemas) / sizeof(schemas[0]);
@@ -205,6 +206,14 @@ UA_parseEndpointUrl(const UA_String *endpointUrl, UA_String *outHostname,
     return UA_STATUSCODE_GOOD;
 }
 
+UA_String
+getEndpointUrlProtocol(const UA_String *endpointUrl) {
+    if(endpointUrl->length >= 10 &&
+       strncmp((const char*)endpointUrl->data, "opc.mem://", 10) == 0)
+        return UA_STRING("mem");
+    return UA_STRING("tcp");
+}
+
 UA_StatusCode
 UA_parseEndpointUrlEthernet(const UA_String *endpointUrl, UA_String *target,
                             UA_UInt16 *vid, UA_Byte *pcp) {
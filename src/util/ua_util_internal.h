@@ -228,6 +228,10 @@ UA_dump_hex_pkg(UA_Byte* buffer, size_t bufferLen);
  * certificates */
 UA_ByteString getLeafCertificate(UA_ByteString chain);
 
+/* Protocol of the ConnectionManager for the EndpointUrl. Returns "mem" for
+ * opc.mem:// urls and "tcp" otherwise. */
+UA_String getEndpointUrlProtocol(const UA_String *endpointUrl);
+
 /* Unions that represent any of the supported request or response message */
 typedef union {
     UA_RequestHeader requestHeader;
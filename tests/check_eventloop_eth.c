@@ -16,6 +16,7 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 #define ETHERNET_INTERFACE "lo" /* use the loopback interface for testing */
 #define MULTICAST_MAC_ADDRESS "00-00-00-00-00-00"
@@ -63,6 +64,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -197,11 +199,184 @@ START_TEST(connectETH) {
     el = NULL;
 } END_TEST
 
+START_TEST(connectETHRing) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("ethCM"));
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    UA_String interface = UA_STRING(ETHERNET_INTERFACE);
+    UA_String address = UA_STRING(MULTICAST_MAC_ADDRESS);
+    UA_Boolean listen = true;
+    UA_Boolean packetMmap = true;
+    UA_UInt32 ringSize = 0; /* Default size */
+    UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
+
+    UA_KeyValuePair params[5];
+    params[0].key = UA_QUALIFIEDNAME(0, "interface");
+    UA_Variant_setScalar(&params[0].value, &interface, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "ethertype");
+    UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+    params[2].key = UA_QUALIFIEDNAME(0, "packet-mmap");
+    UA_Variant_setScalar(&params[2].value, &packetMmap, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[3].key = UA_QUALIFIEDNAME(0, "ring-size");
+    UA_Variant_setScalar(&params[3].value, &ringSize, &UA_TYPES[UA_TYPES_UINT32]);
+    params[4].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[4].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    TestContext testContext;
+    testContext.connCount = 0;
+
+    /* Listen with a receive ring */
+    UA_KeyValueMap kvm = {5, params};
+    UA_StatusCode retval =
+        cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    size_t listenSockets = testContext.connCount;
+
+    /* Send with a send ring of a single block. Replace the listen parameter by
+     * the address. */
+    ringSize = 1;
+    params[4].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[4].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+    clientId = 0;
+    retval = cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(clientId != 0);
+    ck_assert_uint_eq(testContext.connCount, listenSockets + 1);
+
+    /* Send more frames than the send ring holds. Every frame is received from
+     * the receive ring. */
+    received = false;
+    receivedCount = 0;
+    size_t sendCount = 100;
+    for(size_t i = 0; i < sendCount; i++) {
+        UA_ByteString snd;
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        if(i % 25 == 24) {
+            UA_DateTime next = el->run(el, 10);
+            UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        }
+    }
+
+    for(size_t i = 0; i < 100 && receivedCount < sendCount; i++) {
+        UA_DateTime next = el->run(el, 100);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(receivedCount, sendCount);
+
+    /* Stop the EventLoop */
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    ck_assert_uint_eq(testContext.connCount, 0);
+    el->free(el);
+    el = NULL;
+} END_TEST
+
+START_TEST(connectETHXDP) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("ethCM"));
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    UA_String interface = UA_STRING(ETHERNET_INTERFACE);
+    UA_String address = UA_STRING("01-00-5E-00-00-01"); /* Multicast */
+    UA_Boolean listen = true;
+    UA_Boolean xdp = true;
+    UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
+
+    UA_KeyValuePair params[5];
+    params[0].key = UA_QUALIFIEDNAME(0, "interface");
+    UA_Variant_setScalar(&params[0].value, &interface, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "ethertype");
+    UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+    params[2].key = UA_QUALIFIEDNAME(0, "xdp");
+    UA_Variant_setScalar(&params[2].value, &xdp, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[3].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[3].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[4].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[4].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+
+    TestContext testContext;
+    testContext.connCount = 0;
+
+    /* Listen with an AF_XDP socket and register for the multicast address. The
+     * loopback interface has no native XDP support and falls back to the
+     * generic mode. */
+    UA_KeyValueMap kvm = {5, params};
+    UA_StatusCode retval =
+        cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    size_t listenSockets = testContext.connCount;
+
+    /* Send with a regular socket. Replace the listen parameter by the address. */
+    params[3].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[3].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+    kvm.mapSize = 4;
+    clientId = 0;
+    retval = cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(clientId != 0);
+    ck_assert_uint_eq(testContext.connCount, listenSockets + 1);
+
+    /* Send more frames than the UMEM holds. The frames are returned to the
+     * kernel after processing. */
+    receivedCount = 0;
+    size_t sendCount = 1000;
+    for(size_t i = 0; i < sendCount; i++) {
+        UA_ByteString snd;
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        if(i % 50 == 49) {
+            UA_DateTime next = el->run(el, 10);
+            UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        }
+    }
+
+    for(size_t i = 0; i < 100 && receivedCount < sendCount; i++) {
+        UA_DateTime next = el->run(el, 100);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(receivedCount, sendCount);
+
+    /* Stop the EventLoop */
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    ck_assert_uint_eq(testContext.connCount, 0);
+    el->free(el);
+    el = NULL;
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test ETH EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenETH);
     tcase_add_test(tc, connectETH);
+    tcase_add_test(tc, connectETHRing);
+    tcase_add_test(tc, connectETHXDP);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -0,0 +1,236 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/eventloop.h>
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/server_config_default.h>
+
+#include "test_helpers.h"
+#include "testing_clock.h"
+#include "thread_wrapper.h"
+#include <stdlib.h>
+#include <check.h>
+
+#define MSGSIZE 1000
+#define MSGCOUNT 20
+
+static UA_EventLoop *el;
+static unsigned connCount;
+static uintptr_t clientId;
+static uintptr_t serverId;
+static size_t receivedBytes;
+static UA_Boolean orderOk;
+
+static void
+connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                   void *application, void **connectionContext,
+                   UA_ConnectionState status,
+                   const UA_KeyValueMap *params,
+                   UA_ByteString msg) {
+    if(status == UA_CONNECTIONSTATE_CLOSING) {
+        connCount--;
+        return;
+    }
+
+    if(msg.length == 0) {
+        if(status != UA_CONNECTIONSTATE_ESTABLISHED)
+            return;
+        connCount++;
+        if(*connectionContext == (void*)0x01)
+            clientId = connectionId;
+        else
+            serverId = connectionId;
+        return;
+    }
+
+    /* The bytes of the messages count upwards (mod 256). Messages can be
+     * delivered in several pieces if the ring wraps around. */
+    for(size_t i = 0; i < msg.length; i++) {
+        if(msg.data[i] != (UA_Byte)(receivedBytes + i))
+            orderOk = false;
+    }
+    receivedBytes += msg.length;
+}
+
+static void
+iterate(size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+}
+
+static UA_ConnectionManager *
+startMemCM(UA_UInt32 ringSize) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_Memory(UA_STRING("memCM"));
+    UA_KeyValueMap_setScalar(&cm->eventSource.params, UA_QUALIFIEDNAME(0, "ring-size"),
+                             &ringSize, &UA_TYPES[UA_TYPES_UINT32]);
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+    return cm;
+}
+
+static void
+stopEventLoop(void) {
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED && iteration < 10) {
+        iterate(1);
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+}
+
+static UA_StatusCode
+openMem(UA_ConnectionManager *cm, const char *name,
+        UA_Boolean listen, void *context) {
+    UA_String address = UA_STRING((char*)(uintptr_t)name);
+    UA_KeyValuePair params[2];
+    params[0].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[0].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    UA_KeyValueMap paramsMap = {2, params};
+    return cm->openConnection(cm, &paramsMap, NULL, context, connectionCallback);
+}
+
+START_TEST(listenMem) {
+    UA_ConnectionManager *cm = startMemCM(0);
+    connCount = 0;
+
+    /* The listen-connection is announced right away */
+    UA_StatusCode res = openMem(cm, "listen", true, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(connCount, 1);
+
+    /* The name is taken */
+    res = openMem(cm, "listen", true, NULL);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+
+    /* Nobody listens */
+    res = openMem(cm, "other", false, (void*)0x01);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADCONNECTIONREJECTED);
+
+    iterate(2);
+    stopEventLoop();
+    ck_assert_uint_eq(connCount, 0);
+} END_TEST
+
+START_TEST(connectMem) {
+    /* Small rings so that the messages wrap around and overflow */
+    UA_ConnectionManager *cm = startMemCM(3000);
+    connCount = 0;
+    clientId = 0;
+    serverId = 0;
+
+    UA_StatusCode res = openMem(cm, "connect", true, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    uintptr_t listenId = serverId;
+    res = openMem(cm, "connect", false, (void*)0x01);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    iterate(2);
+    ck_assert(clientId != 0);
+    ck_assert(serverId != listenId);
+    ck_assert_uint_eq(connCount, 3);
+
+    /* Send more than fits into the ring without processing in between */
+    receivedBytes = 0;
+    orderOk = true;
+    for(size_t i = 0; i < MSGCOUNT; i++) {
+        UA_ByteString snd;
+        res = cm->allocNetworkBuffer(cm, clientId, &snd, MSGSIZE);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        for(size_t j = 0; j < MSGSIZE; j++)
+            snd.data[j] = (UA_Byte)(i * MSGSIZE + j);
+        res = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    iterate(20);
+    ck_assert_uint_eq(receivedBytes, MSGSIZE * MSGCOUNT);
+    ck_assert(orderOk);
+
+    /* Closing one side also closes the other */
+    res = cm->closeConnection(cm, clientId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    iterate(3);
+    ck_assert_uint_eq(connCount, 1);
+
+    /* Send to a closed connection */
+    UA_ByteString snd = UA_BYTESTRING_NULL;
+    res = cm->sendWithConnection(cm, serverId, NULL, &snd);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADCONNECTIONCLOSED);
+
+    stopEventLoop();
+    ck_assert_uint_eq(connCount, 0);
+} END_TEST
+
+/* The full client/server stack over an in-memory connection */
+
+static UA_Server *server;
+static volatile UA_Boolean running;
+static THREAD_HANDLE server_thread;
+
+THREAD_CALLBACK(serverloop) {
+    while(running)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+START_TEST(clientServerMem) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    UA_String url = UA_STRING("opc.mem://server");
+    UA_StatusCode res =
+        UA_Array_appendCopy((void**)&config->serverUrls, &config->serverUrlsSize,
+                            &url, &UA_TYPES[UA_TYPES_STRING]);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_run_startup(server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    res = UA_Client_connect(client, "opc.mem://server");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Variant val;
+    UA_Variant_init(&val);
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE);
+    res = UA_Client_readValueAttribute(client, nodeId, &val);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&val, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)val.data, UA_SERVERSTATE_RUNNING);
+    UA_Variant_clear(&val);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+} END_TEST
+
+int main(void) {
+    Suite *s  = suite_create("Test In-Memory EventLoop");
+    TCase *tc = tcase_create("test cases");
+    tcase_add_test(tc, listenMem);
+    tcase_add_test(tc, connectMem);
+    tcase_add_test(tc, clientServerMem);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all (sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,6 +16,7 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 typedef struct TestContext {
     unsigned connCount;
@@ -62,6 +63,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -517,6 +519,93 @@ START_TEST(udpTalkerAndListenerDifferentDestination) {
     ck_assert_uint_eq(testContext.connCount, 0);
 } END_TEST
 
+/* Several datagrams sent with one call and received in batches */
+START_TEST(udpSegmentsAndBatches) {
+    UA_EventLoop *elListener = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    UA_ConnectionManager *cmListener = UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udpCM"));
+    UA_UInt16 batch = 4;
+    UA_KeyValueMap_setScalar(&cmListener->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "recv-batch"),
+                             &batch, &UA_TYPES[UA_TYPES_UINT16]);
+    elListener->registerEventSource(elListener, &cmListener->eventSource);
+    elListener->start(elListener);
+
+    UA_EventLoop *elTalker = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    UA_ConnectionManager *cmTalker = UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udpCM"));
+    elTalker->registerEventSource(elTalker, &cmTalker->eventSource);
+    elTalker->start(elTalker);
+
+    /* Open a listener connection */
+    UA_UInt16 port = 30000;
+    UA_Boolean listen = true;
+    UA_String targetHost = UA_STRING("127.0.0.1");
+    UA_KeyValuePair params[3];
+    UA_KeyValueMap paramsMap = {3, params};
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &targetHost, &UA_TYPES[UA_TYPES_STRING]);
+
+    TestContext testContext;
+    testContext.connCount = 0;
+    UA_StatusCode retval =
+        cmListener->openConnection(cmListener, &paramsMap, NULL, &testContext,
+                                   connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Open a talker connection */
+    clientId = 0;
+    listen = false;
+    retval = cmTalker->openConnection(cmTalker, &paramsMap, NULL, &testContext,
+                                      connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_ne(clientId, 0);
+
+    /* Send ten datagrams with one call. Repeat with the fallback to sendmmsg
+     * and a full batch of GSO segments. */
+    received = false;
+    receivedCount = 0;
+    size_t msgLen = strlen(testMsg);
+    UA_UInt16 segmentSize = (UA_UInt16)msgLen;
+    UA_KeyValuePair sendParam;
+    sendParam.key = UA_QUALIFIEDNAME(0, "segment-size");
+    UA_Variant_setScalar(&sendParam.value, &segmentSize, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap sendParams = {1, &sendParam};
+    size_t counts[2] = {10, 100};
+    size_t total = 0;
+    for(size_t c = 0; c < 2; c++) {
+        UA_ByteString snd;
+        retval = cmTalker->allocNetworkBuffer(cmTalker, clientId, &snd,
+                                              msgLen * counts[c]);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        for(size_t i = 0; i < counts[c]; i++)
+            memcpy(&snd.data[i * msgLen], testMsg, msgLen);
+        retval = cmTalker->sendWithConnection(cmTalker, clientId, &sendParams, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        total += counts[c];
+    }
+    for(size_t i = 0; i < 100 && receivedCount < total; i++) {
+        UA_DateTime next = elListener->run(elListener, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(receivedCount, total);
+
+    /* Stop the EventLoops */
+    elTalker->stop(elTalker);
+    for(size_t i = 0; i < 10 && elTalker->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elTalker->run(elTalker, 1);
+    ck_assert_int_eq(elTalker->state, UA_EVENTLOOPSTATE_STOPPED);
+    elTalker->free(elTalker);
+    elListener->stop(elListener);
+    for(size_t i = 0; i < 10 && elListener->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elListener->run(elListener, 1);
+    ck_assert_int_eq(elListener->state, UA_EVENTLOOPSTATE_STOPPED);
+    elListener->free(elListener);
+    ck_assert_uint_eq(testContext.connCount, 0);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test UDP EventLoop");
     TCase *tc = tcase_create("test cases");
@@ -526,6 +615,7 @@ int main(void) {
     tcase_add_test(tc, connectUDPValidationSucceeds);
     tcase_add_test(tc, udpTalkerAndListener);
     tcase_add_test(tc, udpTalkerAndListenerDifferentDestination);
+    tcase_add_test(tc, udpSegmentsAndBatches);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
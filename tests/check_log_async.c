@@ -0,0 +1,201 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_async.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+
+#define THREADS 4
+#define MESSAGES 1000
+
+static UA_Logger *logger;
+
+static void
+logMessages(size_t t) {
+    for(size_t i = 0; i < MESSAGES; i++)
+        UA_LOG_INFO(logger, UA_LOGCATEGORY_USERLAND,
+                    "msg %u from thread %u", (unsigned)i, (unsigned)t);
+}
+
+static UA_THREAD_FUNCTION(logThread, context) {
+    logMessages((size_t)(uintptr_t)context);
+    UA_THREAD_RETURN;
+}
+
+static UA_THREAD_FUNCTION(logThreadRelease, context) {
+    logMessages((size_t)(uintptr_t)context);
+    UA_Log_Async_releaseThread(logger);
+    UA_THREAD_RETURN;
+}
+
+static size_t
+countLines(FILE *f, const char *needle) {
+    rewind(f);
+    size_t count = 0;
+    char line[1024];
+    while(fgets(line, sizeof(line), f)) {
+        if(strstr(line, needle))
+            count++;
+    }
+    return count;
+}
+
+START_TEST(logFromThreads) {
+    FILE *out = tmpfile();
+    ck_assert_ptr_ne(out, NULL);
+    UA_LogAsyncConfig config;
+    memset(&config, 0, sizeof(UA_LogAsyncConfig));
+    config.minLevel = UA_LOGLEVEL_INFO;
+    config.recordsPerThread = 2 * MESSAGES;
+    config.output = out;
+    logger = UA_Log_Async_new(&config);
+    ck_assert_ptr_ne(logger, NULL);
+
+    /* Below the min level */
+    UA_LOG_DEBUG(logger, UA_LOGCATEGORY_USERLAND, "msg filtered");
+
+    UA_Thread threads[THREADS];
+    for(size_t i = 0; i < THREADS; i++)
+        UA_THREAD_CREATE(&threads[i], logThread, (void*)(uintptr_t)i);
+    for(size_t i = 0; i < THREADS; i++)
+        UA_THREAD_JOIN(&threads[i]);
+
+    UA_Log_Async_flush(logger);
+    ck_assert_uint_eq(UA_Log_Async_getDropped(logger), 0);
+    ck_assert_uint_eq(countLines(out, "info/userland\tmsg "), THREADS * MESSAGES);
+    ck_assert_uint_eq(countLines(out, "msg 999 from thread 3"), 1);
+    ck_assert_uint_eq(countLines(out, "msg filtered"), 0);
+
+    logger->clear(logger);
+    fclose(out);
+} END_TEST
+
+/* With a small ring buffer messages are dropped. But every message is either
+ * written or counted. */
+START_TEST(logDropped) {
+    FILE *out = tmpfile();
+    ck_assert_ptr_ne(out, NULL);
+    UA_LogAsyncConfig config;
+    memset(&config, 0, sizeof(UA_LogAsyncConfig));
+    config.minLevel = UA_LOGLEVEL_INFO;
+    config.recordsPerThread = 2;
+    config.output = out;
+    logger = UA_Log_Async_new(&config);
+    ck_assert_ptr_ne(logger, NULL);
+
+    logMessages(0);
+
+    UA_Log_Async_flush(logger);
+    UA_UInt64 dropped = UA_Log_Async_getDropped(logger);
+    logger->clear(logger); /* Writes the last report of dropped messages */
+
+    size_t written = countLines(out, "info/userland\tmsg ");
+    ck_assert_uint_eq(written + dropped, MESSAGES);
+    if(dropped > 0)
+        ck_assert_uint_gt(countLines(out, "Async logger dropped"), 0);
+    fclose(out);
+} END_TEST
+
+/* More threads than ring buffers. The threads without their own ring buffer
+ * share one. Released ring buffers are reused by the next threads. */
+START_TEST(logMaxThreads) {
+    FILE *out = tmpfile();
+    ck_assert_ptr_ne(out, NULL);
+    UA_LogAsyncConfig config;
+    memset(&config, 0, sizeof(UA_LogAsyncConfig));
+    config.minLevel = UA_LOGLEVEL_INFO;
+    config.recordsPerThread = THREADS * MESSAGES;
+    config.maxThreads = 1;
+    config.output = out;
+    logger = UA_Log_Async_new(&config);
+    ck_assert_ptr_ne(logger, NULL);
+
+    UA_Thread threads[THREADS];
+    for(size_t i = 0; i < THREADS; i++)
+        UA_THREAD_CREATE(&threads[i], logThread, (void*)(uintptr_t)i);
+    for(size_t i = 0; i < THREADS; i++)
+        UA_THREAD_JOIN(&threads[i]);
+    UA_Log_Async_flush(logger);
+
+    /* One after the other with releasing */
+    for(size_t i = 0; i < THREADS; i++) {
+        UA_THREAD_CREATE(&threads[i], logThreadRelease,
+                         (void*)(uintptr_t)(THREADS + i));
+        UA_THREAD_JOIN(&threads[i]);
+    }
+
+    UA_Log_Async_flush(logger);
+    ck_assert_uint_eq(UA_Log_Async_getDropped(logger), 0);
+    ck_assert_uint_eq(countLines(out, "info/userland\tmsg "), 2 * THREADS * MESSAGES);
+    ck_assert_uint_eq(countLines(out, "msg 999 from thread 7"), 1);
+
+    logger->clear(logger);
+    fclose(out);
+} END_TEST
+
+static UA_UInt64
+decodeLE(const UA_Byte *buf, size_t bytes) {
+    UA_UInt64 v = 0;
+    for(size_t i = 0; i < bytes; i++)
+        v |= ((UA_UInt64)buf[i]) << (8 * i);
+    return v;
+}
+
+START_TEST(logBinary) {
+    FILE *out = tmpfile();
+    ck_assert_ptr_ne(out, NULL);
+    UA_LogAsyncConfig config;
+    memset(&config, 0, sizeof(UA_LogAsyncConfig));
+    config.minLevel = UA_LOGLEVEL_TRACE;
+    config.binary = true;
+    config.output = out;
+    logger = UA_Log_Async_new(&config);
+    ck_assert_ptr_ne(logger, NULL);
+
+    UA_LOG_WARNING(logger, UA_LOGCATEGORY_NETWORK, "first %d", 1);
+    UA_LOG_ERROR(logger, UA_LOGCATEGORY_SERVER, "second");
+    UA_Log_Async_flush(logger);
+    logger->clear(logger);
+
+    rewind(out);
+    UA_Byte header[16];
+    char msg[64];
+
+    ck_assert_uint_eq(fread(header, 1, 16, out), 16);
+    ck_assert_uint_eq(decodeLE(&header[8], 2), UA_LOGLEVEL_WARNING);
+    ck_assert_uint_eq(decodeLE(&header[10], 2), UA_LOGCATEGORY_NETWORK);
+    ck_assert_uint_eq(decodeLE(&header[12], 4), 7);
+    ck_assert_uint_eq(fread(msg, 1, 7, out), 7);
+    ck_assert(memcmp(msg, "first 1", 7) == 0);
+
+    ck_assert_uint_eq(fread(header, 1, 16, out), 16);
+    ck_assert_uint_eq(decodeLE(&header[8], 2), UA_LOGLEVEL_ERROR);
+    ck_assert_uint_eq(decodeLE(&header[10], 2), UA_LOGCATEGORY_SERVER);
+    ck_assert_uint_eq(decodeLE(&header[12], 4), 6);
+    ck_assert_uint_eq(fread(msg, 1, 6, out), 6);
+    ck_assert(memcmp(msg, "second", 6) == 0);
+
+    ck_assert_uint_eq(fread(header, 1, 1, out), 0);
+    fclose(out);
+} END_TEST
+
+int main(void) {
+    Suite *s  = suite_create("Async Logger");
+    TCase *tc = tcase_create("Core");
+    tcase_add_test(tc, logFromThreads);
+    tcase_add_test(tc, logDropped);
+    tcase_add_test(tc, logMaxThreads);
+    tcase_add_test(tc, logBinary);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,13 +3,16 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "../plugins/eventloop/eventloop_timer.h"
+#include "../plugins/eventloop/eventloop_timer_wheel.h"
 
 #include <check.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
+#include <string.h>
 
 #define N_EVENTS 10000
+#define N_MONITOREDITEMS 1000
 
 size_t count = 0;
 
@@ -52,10 +55,266 @@ START_TEST(benchmarkTimer) {
     UA_Timer_clear(&timer);
 } END_TEST
 
+/* Both timer implementations fire the same number of callbacks for the
+ * typical sampling intervals of MonitoredItems */
+static const UA_Double samplingIntervals[4] = {100.0, 250.0, 500.0, 1000.0};
+
+START_TEST(timerWheelMonitoredItems) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    for(size_t i = 0; i < N_MONITOREDITEMS; i++) {
+        UA_StatusCode retval =
+            UA_Timer_addRepeatedCallback(&timer, timerCallback, NULL, NULL,
+                                         samplingIntervals[i % 4], (UA_DateTime)i, NULL,
+                                         UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME, NULL);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    count = 0;
+    for(UA_DateTime now = 0; now < 10 * UA_DATETIME_SEC; now += 10 * UA_DATETIME_MSEC)
+        UA_Timer_process(&timer, now);
+    size_t timerCount = count;
+    UA_Timer_clear(&timer);
+
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    for(size_t i = 0; i < N_MONITOREDITEMS; i++) {
+        UA_StatusCode retval =
+            UA_TimerWheel_addRepeatedCallback(&wheel, timerCallback, NULL, NULL,
+                                              samplingIntervals[i % 4], (UA_DateTime)i, NULL,
+                                              UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME, NULL);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    count = 0;
+    for(UA_DateTime now = 0; now < 10 * UA_DATETIME_SEC; now += 10 * UA_DATETIME_MSEC)
+        UA_TimerWheel_process(&wheel, now);
+    UA_TimerWheel_clear(&wheel);
+
+    ck_assert_uint_eq(count, timerCount);
+} END_TEST
+
+START_TEST(benchmarkTimerWheel) {
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    for(size_t i = 0; i < N_EVENTS; i++) {
+        UA_StatusCode retval =
+            UA_TimerWheel_addRepeatedCallback(&wheel, timerCallback, NULL, NULL,
+                                              (UA_Double)i+1, 0, NULL,
+                                              UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME, NULL);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    count = 0;
+    clock_t begin = clock();
+    UA_DateTime now = 0;
+    for(size_t i = 0; i < 1000; i++) {
+        UA_DateTime next = UA_TimerWheel_process(&wheel, now);
+        /* At least 100 msec distance between _process */
+        now = next + (UA_DATETIME_MSEC * 100);
+        if(next > now)
+            now = next;
+    }
+
+    clock_t finish = clock();
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    printf("duration was %f s\n", time_spent);
+    printf("%lu callbacks\n", (unsigned long)count);
+
+    UA_TimerWheel_clear(&wheel);
+} END_TEST
+
+START_TEST(timerWheelTimedCallback) {
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    count = 0;
+
+    UA_StatusCode retval =
+        UA_TimerWheel_addTimedCallback(&wheel, timerCallback, NULL, NULL,
+                                       5 * UA_DATETIME_SEC, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_TimerWheel_nextRepeatedTime(&wheel), 5 * UA_DATETIME_SEC);
+
+    UA_TimerWheel_process(&wheel, 5 * UA_DATETIME_SEC - 1);
+    ck_assert_uint_eq(count, 0);
+    UA_DateTime next = UA_TimerWheel_process(&wheel, 5 * UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, UA_INT64_MAX);
+    UA_TimerWheel_process(&wheel, 10 * UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 1);
+
+    /* Already due when added */
+    retval = UA_TimerWheel_addTimedCallback(&wheel, timerCallback, NULL, NULL,
+                                            UA_DATETIME_SEC, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_TimerWheel_nextRepeatedTime(&wheel), UA_DATETIME_SEC);
+    UA_TimerWheel_process(&wheel, 10 * UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 2);
+
+    UA_TimerWheel_clear(&wheel);
+} END_TEST
+
+START_TEST(timerWheelCycleMiss) {
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    count = 0;
+
+    UA_DateTime baseTime = 0;
+    UA_StatusCode retval =
+        UA_TimerWheel_addRepeatedCallback(&wheel, timerCallback, NULL, NULL, 10.0, 0,
+                                          NULL, UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                          NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_DateTime next = UA_TimerWheel_process(&wheel, 35 * UA_DATETIME_MSEC);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, 45 * UA_DATETIME_MSEC);
+    UA_TimerWheel_clear(&wheel);
+
+    UA_TimerWheel_init(&wheel);
+    retval = UA_TimerWheel_addRepeatedCallback(&wheel, timerCallback, NULL, NULL, 10.0, 0,
+                                               &baseTime,
+                                               UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME,
+                                               NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    next = UA_TimerWheel_process(&wheel, 35 * UA_DATETIME_MSEC);
+    ck_assert_uint_eq(count, 2);
+    ck_assert_int_eq(next, 40 * UA_DATETIME_MSEC);
+    UA_TimerWheel_clear(&wheel);
+} END_TEST
+
+typedef struct {
+    UA_TimerWheel *wheel;
+    UA_UInt64 id;
+} RemoveContext;
+
+static void
+removeCallback(void *application, void *data) {
+    RemoveContext *ctx = (RemoveContext*)data;
+    count++;
+    UA_TimerWheel_removeCallback(ctx->wheel, ctx->id);
+}
+
+START_TEST(timerWheelRemoveDuringProcess) {
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    count = 0;
+
+    RemoveContext ctx;
+    ctx.wheel = &wheel;
+    UA_StatusCode retval =
+        UA_TimerWheel_addRepeatedCallback(&wheel, removeCallback, NULL, &ctx, 10.0, 0,
+                                          NULL, UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                          &ctx.id);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DateTime next = UA_TimerWheel_process(&wheel, UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, UA_INT64_MAX);
+    UA_TimerWheel_process(&wheel, 2 * UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 1);
+
+    /* The identifier is not reused */
+    UA_UInt64 id2 = 0;
+    retval = UA_TimerWheel_addRepeatedCallback(&wheel, timerCallback, NULL, NULL, 10.0,
+                                               2 * UA_DATETIME_SEC, NULL,
+                                               UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                               &id2);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(id2 != ctx.id);
+    retval = UA_TimerWheel_changeRepeatedCallback(&wheel, ctx.id, 20.0, 0, NULL,
+                                                  UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADNOTFOUND);
+
+    UA_TimerWheel_clear(&wheel);
+} END_TEST
+
+/* Random operations on both implementations must have the same result */
+static size_t wheelCounts[64];
+static size_t timerCounts[64];
+
+static void
+countingCallback(void *application, void *data) {
+    size_t *counts = (size_t*)application;
+    counts[(uintptr_t)data]++;
+}
+
+START_TEST(timerWheelCompareTimer) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    UA_TimerWheel wheel;
+    UA_TimerWheel_init(&wheel);
+    memset(wheelCounts, 0, sizeof(wheelCounts));
+    memset(timerCounts, 0, sizeof(timerCounts));
+
+    UA_UInt64 timerIds[64];
+    UA_UInt64 wheelIds[64];
+    UA_Boolean active[64];
+    memset(active, 0, sizeof(active));
+
+    UA_UInt32 rnd = 42;
+    UA_DateTime now = 0;
+    for(size_t i = 0; i < 20000; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        UA_UInt32 r = rnd >> 8;
+        uintptr_t slot = r % 64;
+        UA_Double interval = (UA_Double)(1 + (r >> 6) % 5000) / 10.0;
+        UA_TimerPolicy policy = ((r >> 20) & 1) ?
+            UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME :
+            UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME;
+        switch((r >> 21) % 4) {
+        case 0:
+            if(active[slot])
+                break;
+            UA_Timer_addRepeatedCallback(&timer, countingCallback, timerCounts,
+                                         (void*)slot, interval, now, NULL, policy,
+                                         &timerIds[slot]);
+            UA_TimerWheel_addRepeatedCallback(&wheel, countingCallback, wheelCounts,
+                                              (void*)slot, interval, now, NULL, policy,
+                                              &wheelIds[slot]);
+            active[slot] = true;
+            break;
+        case 1:
+            if(!active[slot])
+                break;
+            UA_Timer_removeCallback(&timer, timerIds[slot]);
+            UA_TimerWheel_removeCallback(&wheel, wheelIds[slot]);
+            active[slot] = false;
+            break;
+        case 2:
+            if(!active[slot])
+                break;
+            UA_Timer_changeRepeatedCallback(&timer, timerIds[slot], interval,
+                                            now, &now, policy);
+            UA_TimerWheel_changeRepeatedCallback(&wheel, wheelIds[slot], interval,
+                                                 now, &now, policy);
+            break;
+        default: {
+            now += (UA_DateTime)((r >> 2) % (200 * UA_DATETIME_MSEC));
+            UA_DateTime nextTimer = UA_Timer_process(&timer, now);
+            UA_DateTime nextWheel = UA_TimerWheel_process(&wheel, now);
+            ck_assert_int_eq(nextTimer, nextWheel);
+            break;
+        }
+        }
+    }
+
+    for(size_t i = 0; i < 64; i++)
+        ck_assert_uint_eq(wheelCounts[i], timerCounts[i]);
+
+    UA_Timer_clear(&timer);
+    UA_TimerWheel_clear(&wheel);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test Event Timer");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, benchmarkTimer);
+    tcase_add_test(tc, benchmarkTimerWheel);
+    tcase_add_test(tc, timerWheelMonitoredItems);
+    tcase_add_test(tc, timerWheelTimedCallback);
+    tcase_add_test(tc, timerWheelCycleMiss);
+    tcase_add_test(tc, timerWheelRemoveDuringProcess);
+    tcase_add_test(tc, timerWheelCompareTimer);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
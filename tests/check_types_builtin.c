@@ -8,6 +8,7 @@
 #include <open62541/util.h>
 
 #include "util/ua_util_internal.h"
+#include "ua_types_encoding_binary.h"
 
 #include <stdlib.h>
 #include <check.h>
@@ -406,6 +407,107 @@ START_TEST(UA_String_decodeWithZeroSizeShallNotAllocateMemoryAndNullPtr) {
 }
 END_TEST
 
+START_TEST(UA_String_decodeBorrowedShallPointIntoBuffer) {
+    // given
+    UA_Byte data[] =
+    { 0x08, 0x00, 0x00, 0x00, 'A', 'C', 'P', 'L', 'T', ' ', 'U', 'A', 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    UA_ByteString src = { 12, data };
+    UA_String dst;
+    UA_DecodeBinaryOptions options;
+    memset(&options, 0, sizeof(UA_DecodeBinaryOptions));
+    options.borrowBuffer = true;
+    // when
+    UA_StatusCode retval = UA_decodeBinary(&src, &dst, &UA_TYPES[UA_TYPES_STRING], &options);
+    // then
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(dst.length, 8);
+    ck_assert_ptr_eq(dst.data, &data[4]);
+    // finally
+    UA_clearBorrowed(&dst, &UA_TYPES[UA_TYPES_STRING], &src);
+    ck_assert_ptr_eq(dst.data, NULL);
+}
+END_TEST
+
+START_TEST(UA_ReadRequest_decodeBorrowedShallRoundtrip) {
+    // given
+    UA_ReadValueId rvi[2];
+    UA_ReadValueId_init(&rvi[0]);
+    rvi[0].nodeId = UA_NODEID_STRING(1, "the.answer");
+    rvi[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    rvi[0].indexRange = UA_STRING("1:2");
+    UA_ReadValueId_init(&rvi[1]);
+    rvi[1].nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    rvi[1].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+    rvi[1].dataEncoding = UA_QUALIFIEDNAME(0, "Default Binary");
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = rvi;
+    request.nodesToReadSize = 2;
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(&request, &UA_TYPES[UA_TYPES_READREQUEST], &buf);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_DecodeBinaryOptions options;
+    memset(&options, 0, sizeof(UA_DecodeBinaryOptions));
+    options.borrowBuffer = true;
+    // when
+    UA_ReadRequest dst;
+    retval = UA_decodeBinary(&buf, &dst, &UA_TYPES[UA_TYPES_READREQUEST], &options);
+    // then
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(&request, &dst, &UA_TYPES[UA_TYPES_READREQUEST]) == UA_ORDER_EQ);
+    UA_Byte *str = dst.nodesToRead[0].nodeId.identifier.string.data;
+    ck_assert(str > buf.data && str < &buf.data[buf.length]);
+    // finally
+    UA_clearBorrowed(&dst, &UA_TYPES[UA_TYPES_READREQUEST], &buf);
+
+    // A truncated message is cleaned up without freeing the borrowed members
+    UA_ByteString truncated = {buf.length - 4, buf.data};
+    retval = UA_decodeBinary(&truncated, &dst, &UA_TYPES[UA_TYPES_READREQUEST], &options);
+    ck_assert_int_ne(retval, UA_STATUSCODE_GOOD);
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
+START_TEST(UA_BrowseRequest_decodeArenaShallRoundtrip) {
+    // given
+    UA_BrowseDescription bd[4];
+    for(size_t i = 0; i < 4; i++) {
+        UA_BrowseDescription_init(&bd[i]);
+        bd[i].nodeId = UA_NODEID_STRING(1, "some.node");
+        bd[i].referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_REFERENCES);
+        bd[i].resultMask = UA_BROWSERESULTMASK_ALL;
+    }
+    UA_BrowseRequest request;
+    UA_BrowseRequest_init(&request);
+    request.requestHeader.auditEntryId = UA_STRING("audit");
+    request.nodesToBrowse = bd;
+    request.nodesToBrowseSize = 4;
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(&request, &UA_TYPES[UA_TYPES_BROWSEREQUEST], &buf);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    // when the arena is large enough and when it overflows to the heap
+    UA_Byte arenaData[512];
+    size_t arenaSizes[2] = {sizeof(arenaData), 64};
+    for(size_t i = 0; i < 2; i++) {
+        UA_DecodeArena arena = {arenaData, arenaSizes[i], 0};
+        UA_BrowseRequest dst;
+        size_t offset = 0;
+        retval = UA_decodeBinaryBorrowed(&buf, &offset, &dst,
+                                         &UA_TYPES[UA_TYPES_BROWSEREQUEST],
+                                         NULL, &arena);
+        // then
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert(UA_order(&request, &dst, &UA_TYPES[UA_TYPES_BROWSEREQUEST]) == UA_ORDER_EQ);
+        ck_assert(arena.pos <= arena.size);
+        ck_assert_int_eq(((uintptr_t)dst.nodesToBrowse == (uintptr_t)arenaData), i == 0);
+        // finally
+        UA_clearBorrowedArena(&dst, &UA_TYPES[UA_TYPES_BROWSEREQUEST], &buf, &arena);
+    }
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
 START_TEST(UA_NodeId_decodeTwoByteShallReadTwoBytesAndSetNamespaceToZero) {
     // given
     size_t pos = 0;
@@ -1711,6 +1813,82 @@ START_TEST(UA_StatusCode_utils) {
 
 } END_TEST
 
+START_TEST(UA_byteSwapArray_shallReverseEveryElement) {
+    UA_Byte src[8 * 40 + 1], dst[8 * 40 + 1];
+    for(size_t i = 0; i < sizeof(src); i++)
+        src[i] = (UA_Byte)i;
+    for(size_t width = 2; width <= 8; width *= 2) {
+        for(size_t count = 0; count < 40; count++) {
+            /* Misaligned */
+            UA_byteSwapArray(&dst[1], &src[1], count, width);
+            for(size_t i = 0; i < count; i++) {
+                for(size_t j = 0; j < width; j++)
+                    ck_assert_uint_eq(dst[1 + i*width + j],
+                                      src[1 + i*width + width - 1 - j]);
+            }
+            /* In place and back */
+            UA_byteSwapArray(&dst[1], &dst[1], count, width);
+            ck_assert(memcmp(&dst[1], &src[1], count * width) == 0);
+        }
+    }
+}
+END_TEST
+
+typedef struct {
+    UA_Byte data[1024];
+} ChunkedBuffer;
+
+static UA_StatusCode
+exchangeSmallChunk(void *handle, UA_Byte **bufPos, const UA_Byte **bufEnd) {
+    ChunkedBuffer *cb = (ChunkedBuffer*)handle;
+    const UA_Byte *end = &cb->data[sizeof(cb->data)];
+    *bufEnd = (*bufPos + 7 < end) ? *bufPos + 7 : end;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Numeric arrays that are not overlayable (big-endian hosts) are converted in
+ * bulk. Force that path by clearing the overlayable flag. Small chunks split
+ * the elements across buffer exchanges. */
+START_TEST(UA_Array_encodeNonOverlayableNumericsShallMatch) {
+    const size_t typeIndices[4] = {UA_TYPES_UINT16, UA_TYPES_INT32,
+                                   UA_TYPES_DOUBLE, UA_TYPES_DATETIME};
+    for(size_t t = 0; t < 4; t++) {
+        UA_DataType *type = &UA_TYPES[typeIndices[t]];
+        UA_Byte data[8 * 37];
+        for(size_t i = 0; i < sizeof(data); i++)
+            data[i] = (UA_Byte)(i * 7);
+        UA_Variant v;
+        UA_Variant_setArray(&v, data, sizeof(data) / type->memSize, type);
+
+        UA_ByteString ref = UA_BYTESTRING_NULL;
+        UA_StatusCode res = UA_encodeBinary(&v, &UA_TYPES[UA_TYPES_VARIANT], &ref);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+        UA_Boolean overlayable = type->overlayable;
+        type->overlayable = false;
+
+        ChunkedBuffer cb;
+        UA_Byte *pos = cb.data;
+        const UA_Byte *end = &cb.data[7];
+        res = UA_encodeBinaryInternal(&v, &UA_TYPES[UA_TYPES_VARIANT], &pos, &end,
+                                      exchangeSmallChunk, &cb);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq((size_t)(pos - cb.data), ref.length);
+        ck_assert(memcmp(cb.data, ref.data, ref.length) == 0);
+
+        UA_Variant out;
+        res = UA_decodeBinary(&ref, &out, &UA_TYPES[UA_TYPES_VARIANT], NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(out.arrayLength, v.arrayLength);
+        ck_assert(memcmp(out.data, data, sizeof(data)) == 0);
+        UA_Variant_clear(&out);
+
+        type->overlayable = overlayable;
+        UA_ByteString_clear(&ref);
+    }
+}
+END_TEST
+
 static Suite *testSuite_builtin(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Table 1");
 
@@ -1734,6 +1912,9 @@ static Suite *testSuite_builtin(void) {
     tcase_add_test(tc_decode, UA_String_decodeShallAllocateMemoryAndCopyString);
     tcase_add_test(tc_decode, UA_String_decodeWithNegativeSizeShallNotAllocateMemoryAndNullPtr);
     tcase_add_test(tc_decode, UA_String_decodeWithZeroSizeShallNotAllocateMemoryAndNullPtr);
+    tcase_add_test(tc_decode, UA_String_decodeBorrowedShallPointIntoBuffer);
+    tcase_add_test(tc_decode, UA_ReadRequest_decodeBorrowedShallRoundtrip);
+    tcase_add_test(tc_decode, UA_BrowseRequest_decodeArenaShallRoundtrip);
     tcase_add_test(tc_decode, UA_NodeId_decodeTwoByteShallReadTwoBytesAndSetNamespaceToZero);
     tcase_add_test(tc_decode, UA_NodeId_decodeFourByteShallReadFourBytesAndRespectNamespace);
     tcase_add_test(tc_decode, UA_NodeId_decodeStringShallAllocateMemory);
@@ -1767,6 +1948,8 @@ static Suite *testSuite_builtin(void) {
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsWithUnknownType);
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsXmlEncoded);
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsNoBody);
+    tcase_add_test(tc_encode, UA_byteSwapArray_shallReverseEveryElement);
+    tcase_add_test(tc_encode, UA_Array_encodeNonOverlayableNumericsShallMatch);
     suite_add_tcase(s, tc_encode);
 
     TCase *tc_convert = tcase_create("convert");
@@ -0,0 +1,241 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Compares the binary en/decoding of common service messages with the
+ * generated UA_DataTypeBinaryCodec routines (UA_ENABLE_BINARY_CODEC) against
+ * the generic interpretation of the member descriptions. And the dedicated
+ * size calculation against running the encoder without a buffer. */
+
+#include <open62541/types.h>
+#include <open62541/types_generated_handling.h>
+
+#include "ua_types_encoding_binary.h"
+
+#include <check.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ELEMENTS 1000
+#define ITERATIONS 100
+
+#ifdef UA_ENABLE_BINARY_CODEC
+static const UA_DataTypeBinaryCodec *codecs[UA_TYPES_COUNT];
+
+static void
+disableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        codecs[i] = UA_TYPES[i].binaryCodec;
+        UA_TYPES[i].binaryCodec = NULL;
+    }
+}
+
+static void
+enableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++)
+        UA_TYPES[i].binaryCodec = codecs[i];
+}
+#endif
+
+static double
+benchmark(const void *p, const UA_DataType *type, UA_ByteString *encoded) {
+    UA_StatusCode res = UA_encodeBinary(p, type, encoded);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < ITERATIONS; i++) {
+        UA_ByteString buf = UA_BYTESTRING_NULL;
+        res |= UA_encodeBinary(p, type, &buf);
+        UA_ByteString_clear(&buf);
+    }
+    for(size_t i = 0; i < ITERATIONS; i++) {
+        void *dst = UA_new(type);
+        res |= UA_decodeBinary(encoded, dst, type, NULL);
+        UA_delete(dst, type);
+    }
+    for(size_t i = 0; i < ITERATIONS; i++)
+        res |= (UA_calcSizeBinary(p, type) == encoded->length) ?
+            UA_STATUSCODE_GOOD : UA_STATUSCODE_BADINTERNALERROR;
+    clock_t finish = clock();
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return (double)(finish - begin) / CLOCKS_PER_SEC;
+}
+
+/* The size calculation without the encoder gives the same result as the
+ * encoding with a NULL end pointer that was used before */
+static void
+compareCalcSize(const char *name, const void *p, const UA_DataType *type) {
+    size_t size = 0, encodedSize = 0;
+    clock_t begin = clock();
+    for(size_t i = 0; i < ITERATIONS; i++)
+        size = UA_calcSizeBinary(p, type);
+    clock_t finish = clock();
+    double calcSizeTime = (double)(finish - begin) / CLOCKS_PER_SEC;
+
+    begin = clock();
+    for(size_t i = 0; i < ITERATIONS; i++) {
+        UA_Byte *pos = NULL;
+        const UA_Byte *end = NULL;
+        UA_StatusCode res = UA_encodeBinaryInternal(p, type, &pos, &end, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        encodedSize = (size_t)(uintptr_t)pos;
+    }
+    finish = clock();
+    double encodeTime = (double)(finish - begin) / CLOCKS_PER_SEC;
+
+    printf("%s: calcSize %f s, encode without buffer %f s\n",
+           name, calcSizeTime, encodeTime);
+    ck_assert_uint_ne(size, 0);
+    ck_assert_uint_eq(size, encodedSize);
+}
+
+/* Both routines produce the same encoding and the decoded value roundtrips.
+ * Without UA_ENABLE_BINARY_CODEC the generic routines are compared with
+ * themselves. */
+static void
+compare(const char *name, const void *p, const UA_DataType *type) {
+    UA_ByteString generic = UA_BYTESTRING_NULL;
+    UA_ByteString generated = UA_BYTESTRING_NULL;
+#ifdef UA_ENABLE_BINARY_CODEC
+    disableCodecs();
+#endif
+    double genericTime = benchmark(p, type, &generic);
+#ifdef UA_ENABLE_BINARY_CODEC
+    enableCodecs();
+#endif
+    double generatedTime = benchmark(p, type, &generated);
+
+    printf("%s: generic %f s, generated %f s\n", name, genericTime, generatedTime);
+
+    ck_assert(UA_ByteString_equal(&generic, &generated));
+    void *dst = UA_new(type);
+    UA_StatusCode res = UA_decodeBinary(&generated, dst, type, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(p, dst, type) == UA_ORDER_EQ);
+    UA_delete(dst, type);
+
+    UA_ByteString_clear(&generic);
+    UA_ByteString_clear(&generated);
+}
+
+START_TEST(readResponseSpeed) {
+    UA_ReadResponse resp;
+    UA_ReadResponse_init(&resp);
+    resp.results = (UA_DataValue*)
+        UA_Array_new(ELEMENTS, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    resp.resultsSize = ELEMENTS;
+    for(size_t i = 0; i < ELEMENTS; i++) {
+        UA_Int32 v = (UA_Int32)i;
+        UA_Variant_setScalarCopy(&resp.results[i].value, &v, &UA_TYPES[UA_TYPES_INT32]);
+        resp.results[i].hasValue = true;
+        resp.results[i].sourceTimestamp = UA_DateTime_now();
+        resp.results[i].hasSourceTimestamp = true;
+    }
+    compare("ReadResponse", &resp, &UA_TYPES[UA_TYPES_READRESPONSE]);
+    compareCalcSize("ReadResponse", &resp, &UA_TYPES[UA_TYPES_READRESPONSE]);
+    UA_ReadResponse_clear(&resp);
+} END_TEST
+
+START_TEST(publishResponseSpeed) {
+    UA_DataChangeNotification *dcn = UA_DataChangeNotification_new();
+    dcn->monitoredItems = (UA_MonitoredItemNotification*)
+        UA_Array_new(ELEMENTS, &UA_TYPES[UA_TYPES_MONITOREDITEMNOTIFICATION]);
+    dcn->monitoredItemsSize = ELEMENTS;
+    for(size_t i = 0; i < ELEMENTS; i++) {
+        UA_Double v = (UA_Double)i;
+        dcn->monitoredItems[i].clientHandle = (UA_UInt32)i;
+        UA_Variant_setScalarCopy(&dcn->monitoredItems[i].value.value, &v,
+                                 &UA_TYPES[UA_TYPES_DOUBLE]);
+        dcn->monitoredItems[i].value.hasValue = true;
+    }
+
+    UA_PublishResponse resp;
+    UA_PublishResponse_init(&resp);
+    resp.subscriptionId = 1;
+    resp.notificationMessage.sequenceNumber = 1;
+    resp.notificationMessage.notificationData = UA_ExtensionObject_new();
+    resp.notificationMessage.notificationDataSize = 1;
+    UA_ExtensionObject_setValue(resp.notificationMessage.notificationData, dcn,
+                                &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    compare("PublishResponse", &resp, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+    compareCalcSize("PublishResponse", &resp, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+    UA_PublishResponse_clear(&resp);
+} END_TEST
+
+START_TEST(writeRequestSpeed) {
+    UA_WriteRequest req;
+    UA_WriteRequest_init(&req);
+    req.nodesToWrite = (UA_WriteValue*)
+        UA_Array_new(ELEMENTS, &UA_TYPES[UA_TYPES_WRITEVALUE]);
+    req.nodesToWriteSize = ELEMENTS;
+    for(size_t i = 0; i < ELEMENTS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "Variable %u", (unsigned)i);
+        req.nodesToWrite[i].nodeId = UA_NODEID_STRING_ALLOC(1, name);
+        req.nodesToWrite[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        UA_String s = UA_STRING(name);
+        UA_Variant_setScalarCopy(&req.nodesToWrite[i].value.value, &s,
+                                 &UA_TYPES[UA_TYPES_STRING]);
+        req.nodesToWrite[i].value.hasValue = true;
+    }
+    compare("WriteRequest", &req, &UA_TYPES[UA_TYPES_WRITEREQUEST]);
+    compareCalcSize("WriteRequest", &req, &UA_TYPES[UA_TYPES_WRITEREQUEST]);
+    UA_WriteRequest_clear(&req);
+} END_TEST
+
+START_TEST(createMonitoredItemsSpeed) {
+    UA_CreateMonitoredItemsRequest req;
+    UA_CreateMonitoredItemsRequest_init(&req);
+    req.subscriptionId = 1;
+    req.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    req.itemsToCreate = (UA_MonitoredItemCreateRequest*)
+        UA_Array_new(ELEMENTS, &UA_TYPES[UA_TYPES_MONITOREDITEMCREATEREQUEST]);
+    req.itemsToCreateSize = ELEMENTS;
+    for(size_t i = 0; i < ELEMENTS; i++) {
+        UA_MonitoredItemCreateRequest *item = &req.itemsToCreate[i];
+        item->itemToMonitor.nodeId = UA_NODEID_NUMERIC(1, (UA_UInt32)i);
+        item->itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+        item->monitoringMode = UA_MONITORINGMODE_REPORTING;
+        item->requestedParameters.clientHandle = (UA_UInt32)i;
+        item->requestedParameters.samplingInterval = 250.0;
+        item->requestedParameters.queueSize = 1;
+        item->requestedParameters.discardOldest = true;
+    }
+    compare("CreateMonitoredItemsRequest", &req,
+            &UA_TYPES[UA_TYPES_CREATEMONITOREDITEMSREQUEST]);
+    UA_CreateMonitoredItemsRequest_clear(&req);
+
+    UA_CreateMonitoredItemsResponse resp;
+    UA_CreateMonitoredItemsResponse_init(&resp);
+    resp.results = (UA_MonitoredItemCreateResult*)
+        UA_Array_new(ELEMENTS, &UA_TYPES[UA_TYPES_MONITOREDITEMCREATERESULT]);
+    resp.resultsSize = ELEMENTS;
+    for(size_t i = 0; i < ELEMENTS; i++) {
+        resp.results[i].monitoredItemId = (UA_UInt32)i + 1;
+        resp.results[i].revisedSamplingInterval = 250.0;
+        resp.results[i].revisedQueueSize = 1;
+    }
+    compare("CreateMonitoredItemsResponse", &resp,
+            &UA_TYPES[UA_TYPES_CREATEMONITOREDITEMSRESPONSE]);
+    compareCalcSize("CreateMonitoredItemsResponse", &resp,
+                    &UA_TYPES[UA_TYPES_CREATEMONITOREDITEMSRESPONSE]);
+    UA_CreateMonitoredItemsResponse_clear(&resp);
+} END_TEST
+
+int main(void) {
+    Suite *s = suite_create("Binary Codec Speed");
+    TCase *tc = tcase_create("speed");
+    tcase_add_test(tc, readResponseSpeed);
+    tcase_add_test(tc, publishResponseSpeed);
+    tcase_add_test(tc, writeRequestSpeed);
+    tcase_add_test(tc, createMonitoredItemsSpeed);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -226,6 +226,42 @@ START_TEST(calcSizeBinaryShallBeCorrect) {
 }
 END_TEST
 
+/* The size calculation without the encoder matches the actual encoding for
+ * the content decoded from random buffers */
+START_TEST(calcSizeBinaryOfRandomContentShallBeCorrect) {
+    UA_ByteString msg1;
+    UA_UInt32 buflen = 256;
+    UA_StatusCode retval = UA_ByteString_allocBuffer(&msg1, buflen);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+#ifdef _WIN32
+    srand(42);
+#else
+    srandom(42);
+#endif
+    for(int n = 0; n < RANDOM_TESTS; n++) {
+        for(UA_UInt32 i = 0; i < buflen; i++) {
+#ifdef _WIN32
+            msg1.data[i] = (UA_Byte)rand();
+#else
+            msg1.data[i] = (UA_Byte)random();
+#endif
+        }
+        size_t pos = 0;
+        void *obj1 = UA_new(&UA_TYPES[_i]);
+        retval = UA_decodeBinaryInternal(&msg1, &pos, obj1, &UA_TYPES[_i], NULL);
+        if(retval == UA_STATUSCODE_GOOD) {
+            UA_ByteString msg2 = UA_BYTESTRING_NULL;
+            retval = UA_encodeBinary(obj1, &UA_TYPES[_i], &msg2);
+            if(retval == UA_STATUSCODE_GOOD)
+                ck_assert_uint_eq(UA_calcSizeBinary(obj1, &UA_TYPES[_i]), msg2.length);
+            UA_ByteString_clear(&msg2);
+        }
+        UA_delete(obj1, &UA_TYPES[_i]);
+    }
+    UA_ByteString_clear(&msg1);
+}
+END_TEST
+
 int main(void) {
     int number_failed = 0;
     SRunner *sr;
@@ -250,6 +286,8 @@ int main(void) {
 
     tc = tcase_create("Test calcSizeBinary");
     tcase_add_loop_test(tc, calcSizeBinaryShallBeCorrect, UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
+    tcase_add_loop_test(tc, calcSizeBinaryOfRandomContentShallBeCorrect,
+                        UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
     suite_add_tcase(s, tc);
 
     sr = srunner_create(s);
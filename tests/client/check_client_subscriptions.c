@@ -1024,6 +1024,366 @@ START_TEST(Client_subscription_statusChange) {
 END_TEST
 
 /* Write to the variable that is being monitored at a high rate */
+START_TEST(Client_subscription_republish) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    UA_CreateSubscriptionResponse response = UA_Client_Subscriptions_create(client, request,
+                                                                            NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    UA_MonitoredItemCreateRequest monRequest =
+        UA_MonitoredItemCreateRequest_default(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE));
+    UA_MonitoredItemCreateResult monResponse =
+        UA_Client_MonitoredItems_createDataChange(client, response.subscriptionId,
+                                                  UA_TIMESTAMPSTORETURN_BOTH,
+                                                  monRequest, NULL, dataChangeHandler, NULL);
+    ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+
+    /* manually control the server thread */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    UA_Server_run_iterate(server, true);
+    retval = UA_Client_run_iterate(client, 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+
+    notificationReceived = false;
+    UA_Server_run_iterate(server, true);
+    retval = UA_Client_run_iterate(client, 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(notificationReceived, true);
+
+    /* The sent NotificationMessage is retained in encoded form. The client
+     * acknowledgement has not been processed yet. */
+    UA_LOCK(&server->serviceMutex);
+    UA_Subscription *sub = getSubscriptionById(server, response.subscriptionId);
+    ck_assert(sub != NULL);
+    ck_assert_uint_eq(sub->retransmissionQueueSize, 1);
+    UA_NotificationMessageEntry *entry = TAILQ_FIRST(&sub->retransmissionQueue);
+    ck_assert_uint_eq(sub->retransmissionQueueBytes, entry->memSize);
+    ck_assert_uint_eq(sub->session->totalRetransmissionQueueBytes, entry->memSize);
+    ck_assert_uint_eq(server->retransmissionQueueBytes, entry->memSize);
+
+    /* Republish the message */
+    UA_RepublishRequest repRequest;
+    UA_RepublishRequest_init(&repRequest);
+    repRequest.subscriptionId = response.subscriptionId;
+    repRequest.retransmitSequenceNumber = entry->sequenceNumber;
+    UA_RepublishResponse repResponse;
+    UA_RepublishResponse_init(&repResponse);
+    Service_Republish(server, sub->session, &repRequest, &repResponse);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(repResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    /* The client sees the same DataChangeNotification */
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    retval = UA_encodeBinary(&repResponse, &UA_TYPES[UA_TYPES_REPUBLISHRESPONSE], &buf);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_RepublishResponse_clear(&repResponse);
+    retval = UA_decodeBinary(&buf, &repResponse, &UA_TYPES[UA_TYPES_REPUBLISHRESPONSE], NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_ByteString_clear(&buf);
+    ck_assert_uint_eq(repResponse.notificationMessage.notificationDataSize, 1);
+    UA_ExtensionObject *eo = &repResponse.notificationMessage.notificationData[0];
+    ck_assert_uint_eq(eo->encoding, UA_EXTENSIONOBJECT_DECODED);
+    ck_assert(eo->content.decoded.type == &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    UA_DataChangeNotification *dcn = (UA_DataChangeNotification*)eo->content.decoded.data;
+    ck_assert_uint_eq(dcn->monitoredItemsSize, 1);
+    ck_assert_uint_eq(dcn->monitoredItems[0].clientHandle, monResponse.monitoredItemId);
+    UA_RepublishResponse_clear(&repResponse);
+
+    /* The acknowledgement releases the memory */
+    UA_Server_run_iterate(server, true);
+    UA_LOCK(&server->serviceMutex);
+    ck_assert_uint_eq(sub->retransmissionQueueSize, 0);
+    ck_assert_uint_eq(sub->retransmissionQueueBytes, 0);
+    ck_assert_uint_eq(server->retransmissionQueueBytes, 0);
+    UA_UNLOCK(&server->serviceMutex);
+
+    /* run the server in an independent thread again */
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
+static UA_Double lastDoubleValue;
+
+static void
+doubleChangeHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                    UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    notificationReceived = true;
+    if(UA_Variant_hasScalarType(&value->value, &UA_TYPES[UA_TYPES_DOUBLE]))
+        lastDoubleValue = *(UA_Double*)value->value.data;
+}
+
+START_TEST(Client_subscription_notificationPool) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Double myDouble = 1.5;
+    UA_Variant_setScalar(&attr.value, &myDouble, &UA_TYPES[UA_TYPES_DOUBLE]);
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_NodeId myDoubleNodeId = UA_NODEID_STRING(1, "the.double");
+    UA_StatusCode retval =
+        UA_Server_addVariableNode(server, myDoubleNodeId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "the double"),
+                                  UA_NODEID_NULL, attr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    UA_CreateSubscriptionResponse response = UA_Client_Subscriptions_create(client, request,
+                                                                            NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    UA_MonitoredItemCreateRequest monRequest =
+        UA_MonitoredItemCreateRequest_default(myDoubleNodeId);
+    monRequest.requestedParameters.samplingInterval = 0.0; /* sample on write */
+    monRequest.requestedParameters.queueSize = 10;
+    UA_MonitoredItemCreateResult monResponse =
+        UA_Client_MonitoredItems_createDataChange(client, response.subscriptionId,
+                                                  UA_TIMESTAMPSTORETURN_BOTH,
+                                                  monRequest, NULL, doubleChangeHandler, NULL);
+    ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+
+    /* manually control the server thread */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    /* Queue notifications with values stored inline */
+    UA_ServerStatistics before = UA_Server_getStatistics(server);
+    for(size_t i = 0; i < 5; i++) {
+        myDouble += 1.0;
+        retval = UA_Server_writeValue(server, myDoubleNodeId, attr.value);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    UA_ServerStatistics stats = UA_Server_getStatistics(server);
+    ck_assert_uint_ge(stats.nps.slabCount, 1);
+    ck_assert_uint_ge(stats.nps.capacity, stats.nps.inUse);
+    ck_assert_uint_ge(stats.nps.inUse, 5);
+    ck_assert_uint_ge(stats.nps.peakInUse, stats.nps.inUse);
+    ck_assert_uint_ge(stats.nps.inlineValueCount, before.nps.inlineValueCount + 5);
+
+    /* Publish. The inline values are encoded before the notifications are
+     * returned to the pool. */
+    UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+    notificationReceived = false;
+    UA_Server_run_iterate(server, true);
+    retval = UA_Client_run_iterate(client, 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(notificationReceived, true);
+    ck_assert(lastDoubleValue == myDouble);
+
+    /* The notifications are kept in the pool for reuse */
+    UA_ServerStatistics after = UA_Server_getStatistics(server);
+    ck_assert_uint_lt(after.nps.inUse, stats.nps.inUse);
+    ck_assert_uint_eq(after.nps.capacity, stats.nps.capacity);
+
+    /* run the server in an independent thread again */
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
+static size_t lastByteStringLength;
+
+static void
+byteStringChangeHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                        UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    notificationReceived = true;
+    if(UA_Variant_hasScalarType(&value->value, &UA_TYPES[UA_TYPES_BYTESTRING]))
+        lastByteStringLength = ((UA_ByteString*)value->value.data)->length;
+}
+
+START_TEST(Client_subscription_streamedPublish) {
+    /* Without the retransmission queue, the notifications are encoded directly
+     * into the chunks of the SecureChannel */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->enableRetransmissionQueue = false;
+
+    /* The value does not fit into a single chunk */
+    UA_ByteString bigValue;
+    UA_StatusCode retval = UA_ByteString_allocBuffer(&bigValue, 200000);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    memset(bigValue.data, 'a', bigValue.length);
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setScalar(&attr.value, &bigValue, &UA_TYPES[UA_TYPES_BYTESTRING]);
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_NodeId bigNodeId = UA_NODEID_STRING(1, "the.big.value");
+    retval = UA_Server_addVariableNode(server, bigNodeId,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                       UA_QUALIFIEDNAME(1, "the big value"),
+                                       UA_NODEID_NULL, attr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    UA_CreateSubscriptionResponse response = UA_Client_Subscriptions_create(client, request,
+                                                                            NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    UA_MonitoredItemCreateRequest monRequest =
+        UA_MonitoredItemCreateRequest_default(bigNodeId);
+    UA_MonitoredItemCreateResult monResponse =
+        UA_Client_MonitoredItems_createDataChange(client, response.subscriptionId,
+                                                  UA_TIMESTAMPSTORETURN_BOTH,
+                                                  monRequest, NULL,
+                                                  byteStringChangeHandler, NULL);
+    ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+
+    /* manually control the server thread */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    notificationReceived = false;
+    lastByteStringLength = 0;
+    UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+    for(size_t i = 0; i < 20 && !notificationReceived; i++) {
+        UA_Server_run_iterate(server, false);
+        retval = UA_Client_run_iterate(client, 10);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_uint_eq(notificationReceived, true);
+    ck_assert_uint_eq(lastByteStringLength, bigValue.length);
+
+    /* Nothing was retained for republishing */
+    UA_LOCK(&server->serviceMutex);
+    UA_Subscription *sub = getSubscriptionById(server, response.subscriptionId);
+    ck_assert(sub != NULL);
+    ck_assert_uint_eq(sub->retransmissionQueueSize, 0);
+    UA_UNLOCK(&server->serviceMutex);
+
+    /* run the server in an independent thread again */
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+    UA_ByteString_clear(&bigValue);
+}
+END_TEST
+
+static size_t
+countPublishSlots(void) {
+    size_t count = 0;
+    UA_PublishSlot *slot;
+    LIST_FOREACH(slot, &server->publishSlots, listEntry)
+        count++;
+    return count;
+}
+
+START_TEST(Client_subscription_alignedPublish) {
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->alignPublishingIntervals = true;
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Three Subscriptions share the slot for the default interval. One has its
+     * own slot. */
+    UA_UInt32 subIds[4];
+    for(size_t i = 0; i < 4; i++) {
+        UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+        if(i == 3)
+            request.requestedPublishingInterval = publishingInterval / 2;
+        UA_CreateSubscriptionResponse response =
+            UA_Client_Subscriptions_create(client, request, NULL, NULL, NULL);
+        ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+        subIds[i] = response.subscriptionId;
+
+        UA_MonitoredItemCreateRequest monRequest =
+            UA_MonitoredItemCreateRequest_default(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE));
+        UA_MonitoredItemCreateResult monResponse =
+            UA_Client_MonitoredItems_createDataChange(client, subIds[i],
+                                                      UA_TIMESTAMPSTORETURN_BOTH,
+                                                      monRequest, NULL,
+                                                      dataChangeHandler, NULL);
+        ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+    }
+
+    /* manually control the server thread */
+    running = false;
+    THREAD_JOIN(server_thread);
+    ck_assert_uint_eq(countPublishSlots(), 2);
+
+    /* Every Subscription sends its initial notification */
+    countNotificationReceived = 0;
+    for(size_t i = 0; i < 10 && countNotificationReceived < 4; i++) {
+        UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+        UA_Server_run_iterate(server, true);
+        retval = UA_Client_run_iterate(client, 1);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_uint_eq(countNotificationReceived, 4);
+
+    /* Move a Subscription to the other slot */
+    UA_ModifySubscriptionRequest modifyRequest;
+    UA_ModifySubscriptionRequest_init(&modifyRequest);
+    modifyRequest.subscriptionId = subIds[0];
+    modifyRequest.requestedPublishingInterval = publishingInterval / 2;
+    modifyRequest.requestedLifetimeCount = 10000;
+    modifyRequest.requestedMaxKeepAliveCount = 10;
+    UA_ModifySubscriptionResponse modifyResponse;
+    UA_ModifySubscriptionResponse_init(&modifyResponse);
+    retval = UA_Client_Subscriptions_modify_async(client, modifyRequest,
+                                                  modifySubscriptionCallback,
+                                                  &modifyResponse, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    while(modifyResponse.responseHeader.timestamp == 0) {
+        UA_Server_run_iterate(server, true);
+        UA_Client_run_iterate(client, 1);
+    }
+    ck_assert_uint_eq(modifyResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_ModifySubscriptionResponse_clear(&modifyResponse);
+    ck_assert_uint_eq(countPublishSlots(), 2);
+    UA_PublishSlot *slot;
+    LIST_FOREACH(slot, &server->publishSlots, listEntry) {
+        size_t subs = 0;
+        UA_Subscription *sub;
+        LIST_FOREACH(sub, &slot->subscriptions, publishSlotEntry)
+            subs++;
+        ck_assert_uint_eq(subs, 2);
+    }
+
+    /* run the server in an independent thread again */
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    for(size_t i = 0; i < 4; i++) {
+        retval = UA_Client_Subscriptions_deleteSingle(client, subIds[i]);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    running = false;
+    THREAD_JOIN(server_thread);
+    ck_assert_uint_eq(countPublishSlots(), 0);
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+}
+END_TEST
+
 START_TEST(Client_subscription_writeBurst) {
     /* add a variable node to the address space */
     UA_VariableAttributes attr = UA_VariableAttributes_default;
@@ -1670,7 +2030,11 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_client, Client_subscription_reconnect);
     tcase_add_test(tc_client, Client_subscription_server_disappears);
     tcase_add_test(tc_client, Client_subscription_transfer);
+    tcase_add_test(tc_client, Client_subscription_republish);
     tcase_add_test(tc_client, Client_subscription_writeBurst);
+    tcase_add_test(tc_client, Client_subscription_alignedPublish);
+    tcase_add_test(tc_client, Client_subscription_notificationPool);
+    tcase_add_test(tc_client, Client_subscription_streamedPublish);
     suite_add_tcase(s,tc_client);
 
 #ifdef UA_ENABLE_METHODCALLS
@@ -0,0 +1,175 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/client_subscriptions.h>
+#include <check.h>
+#include <stdlib.h>
+
+#include "test_helpers.h"
+#include "thread_wrapper.h"
+#include "mt_testing.h"
+
+#define NUMBER_OF_REACTORS 2
+#define NUMBER_OF_CLIENTS 8
+#define ITERATIONS_PER_CLIENT 20
+
+UA_NodeId varId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
+
+static void
+addVariableNode(void) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 42;
+    UA_Variant_setScalar(&attr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","Temperature");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(tc.server, varId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Temperature"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+}
+
+static void setup(void) {
+    tc.running = true;
+    tc.server = UA_Server_newForUnitTest();
+    ck_assert(tc.server != NULL);
+    UA_StatusCode res =
+        UA_ServerConfig_addReactorEventLoops(UA_Server_getConfig(tc.server),
+                                             NUMBER_OF_REACTORS);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    addVariableNode();
+    res = UA_Server_run_startup(tc.server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+static void
+client_readValueAttribute(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+    UA_Variant val;
+    UA_StatusCode retval =
+        UA_Client_readValueAttribute(tc.clients[tmp.index], varId, &val);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(42, *(UA_Int32 *)val.data);
+    UA_Variant_clear(&val);
+}
+
+/* The main EventLoop has no server socket. All clients are served by the
+ * reactor EventLoops. */
+START_TEST(readFromReactors) {
+    for(size_t i = 0; i < tc.numberofClients; i++)
+        setThreadContext(&tc.clientContext[i], i, ITERATIONS_PER_CLIENT,
+                         client_readValueAttribute);
+    startMultithreading();
+} END_TEST
+
+#define WRITE_ITERATIONS 200
+
+THREAD_CALLBACK_PARAM(writeLoop, val) {
+    UA_Int32 myInteger = 42;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    for(size_t i = 0; i < WRITE_ITERATIONS; i++) {
+        UA_StatusCode res = UA_Server_writeValue(tc.server, varId, v);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    return 0;
+}
+
+/* The reactor threads encode the cached value into the response after the
+ * server lock is released. Concurrent writes from another thread replace the
+ * cached encoding. */
+START_TEST(readCachedWhileWriting) {
+    UA_StatusCode res =
+        UA_Server_setVariableNode_encodedValueCache(tc.server, varId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < tc.numberofClients; i++)
+        setThreadContext(&tc.clientContext[i], i, ITERATIONS_PER_CLIENT,
+                         client_readValueAttribute);
+    THREAD_HANDLE writer;
+    THREAD_CREATE_PARAM(writer, writeLoop, tc);
+    startMultithreading();
+    THREAD_JOIN(writer);
+} END_TEST
+
+static UA_Boolean notificationReceived;
+
+static void
+dataChangeHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                  UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    notificationReceived = true;
+}
+
+/* The PublishResponses are sent from the main EventLoop on a SecureChannel of
+ * a reactor EventLoop */
+START_TEST(publishToReactorChannel) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    request.requestedPublishingInterval = 10.0;
+    UA_CreateSubscriptionResponse response =
+        UA_Client_Subscriptions_create(client, request, NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    UA_MonitoredItemCreateRequest item = UA_MonitoredItemCreateRequest_default(varId);
+    UA_MonitoredItemCreateResult result =
+        UA_Client_MonitoredItems_createDataChange(client, response.subscriptionId,
+                                                  UA_TIMESTAMPSTORETURN_BOTH, item,
+                                                  NULL, dataChangeHandler, NULL);
+    ck_assert_uint_eq(result.statusCode, UA_STATUSCODE_GOOD);
+
+    notificationReceived = false;
+    for(size_t i = 0; i < 100 && !notificationReceived; i++) {
+        UA_fakeSleep(10);
+        UA_Client_run_iterate(client, 10);
+    }
+    ck_assert(notificationReceived);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+static void teardownServer(void) {
+    tc.running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(tc.server);
+    UA_Server_delete(tc.server);
+}
+
+static Suite *testSuite_reactors(void) {
+    Suite *s = suite_create("Reactor EventLoops");
+    TCase *tc_read = tcase_create("Read");
+    tcase_add_checked_fixture(tc_read, setup, teardown);
+    tcase_add_test(tc_read, readFromReactors);
+    tcase_add_test(tc_read, readCachedWhileWriting);
+    suite_add_tcase(s, tc_read);
+    TCase *tc_publish = tcase_create("Publish");
+    tcase_add_checked_fixture(tc_publish, setup, teardownServer);
+    tcase_add_test(tc_publish, publishToReactorChannel);
+    suite_add_tcase(s, tc_publish);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_reactors();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    createThreadContext(0, NUMBER_OF_CLIENTS, NULL);
+    srunner_run_all(sr, CK_NORMAL);
+    deleteThreadContext();
+
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -213,6 +213,45 @@ START_TEST(GetMaximalConnectionConfigurationAndCompareValues){
     UA_PubSubConnectionConfig_clear(&connectionConfig);
 } END_TEST
 
+/* The XDP properties are forwarded to the Ethernet ConnectionManager. The
+ * xdpbindflag is set as UInt16 like in the TSN examples. */
+START_TEST(AddConnectionWithXdpProperties){
+    UA_NetworkAddressUrlDataType networkAddressUrlData = {UA_STRING(ETHERNET_INTERFACE), UA_STRING(MULTICAST_MAC_ADDRESS)};
+    UA_Variant address;
+    UA_Variant_setScalar(&address, &networkAddressUrlData, &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    UA_KeyValuePair connectionOptions[4];
+    connectionOptions[0].key = UA_QUALIFIEDNAME(0, "enableXdpSocket");
+    UA_Boolean enableXdp = UA_FALSE;
+    UA_Variant_setScalar(&connectionOptions[0].value, &enableXdp, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    connectionOptions[1].key = UA_QUALIFIEDNAME(0, "xdpflag");
+    UA_UInt32 flags = 0;
+    UA_Variant_setScalar(&connectionOptions[1].value, &flags, &UA_TYPES[UA_TYPES_UINT32]);
+    connectionOptions[2].key = UA_QUALIFIEDNAME(0, "hwreceivequeue");
+    UA_UInt32 rxqueue = 0;
+    UA_Variant_setScalar(&connectionOptions[2].value, &rxqueue, &UA_TYPES[UA_TYPES_UINT32]);
+    connectionOptions[3].key = UA_QUALIFIEDNAME(0, "xdpbindflag");
+    UA_UInt16 bindflags = 0;
+    UA_Variant_setScalar(&connectionOptions[3].value, &bindflags, &UA_TYPES[UA_TYPES_UINT16]);
+
+    UA_PubSubConnectionConfig connectionConf;
+    memset(&connectionConf, 0, sizeof(UA_PubSubConnectionConfig));
+    connectionConf.name = UA_STRING("Ethernet Connection");
+    connectionConf.transportProfileUri = UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-eth-uadp");
+    connectionConf.enabled = true;
+    connectionConf.publisherIdType = UA_PUBLISHERIDTYPE_UINT32;
+    connectionConf.publisherId.uint32 = 223344;
+    connectionConf.connectionProperties.map = connectionOptions;
+    connectionConf.connectionProperties.mapSize = 4;
+    connectionConf.address = address;
+    UA_NodeId connection;
+    UA_StatusCode retVal = UA_Server_addPubSubConnection(server, &connectionConf, &connection);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+    UA_PubSubConnection *c = UA_PubSubConnection_findConnectionbyId(server, connection);
+    ck_assert(c != NULL);
+    ck_assert_int_ne(c->state, UA_PUBSUBSTATE_ERROR);
+} END_TEST
+
 int main(void) {
     if(SKIP_ETHERNET && strlen(SKIP_ETHERNET) > 0)
         return EXIT_SUCCESS;
@@ -233,6 +272,7 @@ int main(void) {
     tcase_add_checked_fixture(tc_add_pubsub_connections_maximal_config, setup, teardown);
     tcase_add_test(tc_add_pubsub_connections_maximal_config, AddSingleConnectionWithMaximalConfiguration);
     tcase_add_test(tc_add_pubsub_connections_maximal_config, GetMaximalConnectionConfigurationAndCompareValues);
+    tcase_add_test(tc_add_pubsub_connections_maximal_config, AddConnectionWithXdpProperties);
 
     Suite *s = suite_create("PubSub Ethernet connection creation");
     suite_add_tcase(s, tc_add_pubsub_connections_minimal_config);
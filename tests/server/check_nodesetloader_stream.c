@@ -0,0 +1,269 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodesetloader.h>
+#include "test_helpers.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NODESET_FILE "check_nodesetloader_stream.xml"
+
+/* The Machine object references the Speed variable before it is defined */
+static const char *nodeset =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    "<UANodeSet xmlns=\"http://opcfoundation.org/UA/2011/03/UANodeSet.xsd\">\n"
+    "  <NamespaceUris>\n"
+    "    <Uri>http://example.org/stream/</Uri>\n"
+    "  </NamespaceUris>\n"
+    "  <Aliases>\n"
+    "    <Alias Alias=\"Int32\">i=6</Alias>\n"
+    "    <Alias Alias=\"String\">i=12</Alias>\n"
+    "    <Alias Alias=\"Organizes\">i=35</Alias>\n"
+    "    <Alias Alias=\"HasComponent\">i=47</Alias>\n"
+    "    <Alias Alias=\"HasSubtype\">i=45</Alias>\n"
+    "    <Alias Alias=\"HasTypeDefinition\">i=40</Alias>\n"
+    "  </Aliases>\n"
+    "  <UAReferenceType NodeId=\"ns=1;i=3000\" BrowseName=\"1:Drives\">\n"
+    "    <DisplayName>Drives</DisplayName>\n"
+    "    <InverseName>DrivenBy</InverseName>\n"
+    "    <References>\n"
+    "      <Reference ReferenceType=\"HasSubtype\" IsForward=\"false\">i=32</Reference>\n"
+    "    </References>\n"
+    "  </UAReferenceType>\n"
+    "  <UAObject NodeId=\"ns=1;i=1000\" BrowseName=\"1:Machine\">\n"
+    "    <DisplayName Locale=\"en-US\">Machine</DisplayName>\n"
+    "    <Description>A machine</Description>\n"
+    "    <References>\n"
+    "      <Reference ReferenceType=\"HasTypeDefinition\">i=58</Reference>\n"
+    "      <Reference ReferenceType=\"Organizes\" IsForward=\"false\">i=85</Reference>\n"
+    "      <Reference ReferenceType=\"HasComponent\">ns=1;i=1001</Reference>\n"
+    "      <Reference ReferenceType=\"ns=1;i=3000\">ns=1;i=1001</Reference>\n"
+    "    </References>\n"
+    "  </UAObject>\n"
+    "  <UAVariable NodeId=\"ns=1;i=1001\" BrowseName=\"1:Speed\" DataType=\"Int32\""
+    " AccessLevel=\"3\">\n"
+    "    <DisplayName>Speed</DisplayName>\n"
+    "    <References>\n"
+    "      <Reference ReferenceType=\"HasTypeDefinition\">i=63</Reference>\n"
+    "    </References>\n"
+    "    <Value>\n"
+    "      <Int32 xmlns=\"http://opcfoundation.org/UA/2008/02/Types.xsd\">42</Int32>\n"
+    "    </Value>\n"
+    "  </UAVariable>\n"
+    "  <UAVariable NodeId=\"ns=1;s=Names\" BrowseName=\"1:Names\" DataType=\"String\""
+    " ValueRank=\"1\" ArrayDimensions=\"2\" ParentNodeId=\"ns=1;i=1000\">\n"
+    "    <References>\n"
+    "      <Reference ReferenceType=\"HasTypeDefinition\">i=63</Reference>\n"
+    "      <Reference ReferenceType=\"HasComponent\" IsForward=\"false\">ns=1;i=1000</Reference>\n"
+    "    </References>\n"
+    "    <Value>\n"
+    "      <ListOfString xmlns=\"http://opcfoundation.org/UA/2008/02/Types.xsd\">\n"
+    "        <String>first</String>\n"
+    "        <String>second</String>\n"
+    "      </ListOfString>\n"
+    "    </Value>\n"
+    "  </UAVariable>\n"
+    "  <UAVariable NodeId=\"ns=1;i=1002\" BrowseName=\"1:Label\" DataType=\"i=21\">\n"
+    "    <References>\n"
+    "      <Reference ReferenceType=\"HasComponent\" IsForward=\"false\">ns=1;i=1000</Reference>\n"
+    "    </References>\n"
+    "    <Value>\n"
+    "      <LocalizedText xmlns=\"http://opcfoundation.org/UA/2008/02/Types.xsd\">\n"
+    "        <Locale>en</Locale>\n"
+    "        <Text>Hello</Text>\n"
+    "      </LocalizedText>\n"
+    "    </Value>\n"
+    "  </UAVariable>\n"
+    "</UANodeSet>\n";
+
+static UA_Server *server;
+static UA_UInt16 nsIndex;
+static UA_NodesetStreamOptions options;
+
+static void
+writeFile(const char *path, const char *content) {
+    FILE *f = fopen(path, "wb");
+    ck_assert(f != NULL);
+    fputs(content, f);
+    fclose(f);
+}
+
+static void
+load(void) {
+    writeFile(NODESET_FILE, nodeset);
+    UA_StatusCode res = UA_Server_loadNodesetStream(server, NODESET_FILE, &options);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    size_t index = 0;
+    res = UA_Server_getNamespaceByName(server, UA_STRING("http://example.org/stream/"),
+                                       &index);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    nsIndex = (UA_UInt16)index;
+}
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    memset(&options, 0, sizeof(UA_NodesetStreamOptions));
+}
+
+static void teardown(void) {
+    UA_Server_delete(server);
+    remove(NODESET_FILE);
+}
+
+static UA_Boolean
+hasReference(const UA_NodeId source, const UA_NodeId refType,
+             UA_BrowseDirection direction, const UA_NodeId target) {
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = source;
+    bd.referenceTypeId = refType;
+    bd.includeSubtypes = true;
+    bd.browseDirection = direction;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        if(UA_NodeId_equal(&br.references[i].nodeId.nodeId, &target))
+            found = true;
+    }
+    UA_BrowseResult_clear(&br);
+    return found;
+}
+
+static void
+checkNodes(void) {
+    UA_Variant value;
+    UA_StatusCode res =
+        UA_Server_readValue(server, UA_NODEID_NUMERIC(nsIndex, 1001), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)value.data, 42);
+    UA_Variant_clear(&value);
+
+    res = UA_Server_readValue(server, UA_NODEID_STRING(nsIndex, "Names"), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasArrayType(&value, &UA_TYPES[UA_TYPES_STRING]));
+    ck_assert_uint_eq(value.arrayLength, 2);
+    UA_String second = UA_STRING("second");
+    ck_assert(UA_String_equal(&((UA_String*)value.data)[1], &second));
+    UA_Variant_clear(&value);
+
+    res = UA_Server_readValue(server, UA_NODEID_NUMERIC(nsIndex, 1002), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]));
+    UA_LocalizedText label = UA_LOCALIZEDTEXT("en", "Hello");
+    ck_assert(UA_String_equal(&((UA_LocalizedText*)value.data)->text, &label.text));
+    ck_assert(UA_String_equal(&((UA_LocalizedText*)value.data)->locale, &label.locale));
+    UA_Variant_clear(&value);
+
+    UA_QualifiedName bn;
+    res = UA_Server_readBrowseName(server, UA_NODEID_NUMERIC(nsIndex, 1000), &bn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_QualifiedName expected = UA_QUALIFIEDNAME(nsIndex, "Machine");
+    ck_assert(UA_QualifiedName_equal(&bn, &expected));
+    UA_QualifiedName_clear(&bn);
+
+    UA_LocalizedText dn;
+    res = UA_Server_readDisplayName(server, UA_NODEID_NUMERIC(nsIndex, 1000), &dn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_LocalizedText expectedDn = UA_LOCALIZEDTEXT("en-US", "Machine");
+    ck_assert(UA_String_equal(&dn.text, &expectedDn.text));
+    ck_assert(UA_String_equal(&dn.locale, &expectedDn.locale));
+    UA_LocalizedText_clear(&dn);
+
+    /* Both directions of the references are present. Also for the reference
+     * to the Speed variable that is defined after the Machine object. */
+    const UA_NodeId machine = UA_NODEID_NUMERIC(nsIndex, 1000);
+    const UA_NodeId speed = UA_NODEID_NUMERIC(nsIndex, 1001);
+    ck_assert(hasReference(UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                           UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                           UA_BROWSEDIRECTION_FORWARD, machine));
+    ck_assert(hasReference(speed, UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                           UA_BROWSEDIRECTION_INVERSE, machine));
+    ck_assert(hasReference(machine, UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                           UA_BROWSEDIRECTION_FORWARD,
+                           UA_NODEID_STRING(nsIndex, "Names")));
+
+    /* The new ReferenceType is known as a subtype of its supertypes */
+    ck_assert(hasReference(machine,
+                           UA_NODEID_NUMERIC(0, UA_NS0ID_NONHIERARCHICALREFERENCES),
+                           UA_BROWSEDIRECTION_FORWARD, speed));
+    ck_assert(hasReference(speed, UA_NODEID_NUMERIC(nsIndex, 3000),
+                           UA_BROWSEDIRECTION_INVERSE, machine));
+}
+
+START_TEST(loadNodeset) {
+    load();
+    checkNodes();
+} END_TEST
+
+START_TEST(loadNodesetInline) {
+    /* Parse in the calling thread with many small batches */
+    options.parseInline = true;
+    options.batchSize = 1;
+    load();
+    checkNodes();
+} END_TEST
+
+START_TEST(loadNodesetSmallBatches) {
+    options.batchSize = 2;
+    load();
+    checkNodes();
+} END_TEST
+
+START_TEST(loadMissingFile) {
+    UA_StatusCode res =
+        UA_Server_loadNodesetStream(server, "does_not_exist.xml", NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNOTFOUND);
+} END_TEST
+
+START_TEST(loadMalformed) {
+    writeFile(NODESET_FILE,
+              "<UANodeSet><UAObject NodeId=\"i=1\" BrowseName=\"x\"></UANodeSet>");
+    UA_StatusCode res = UA_Server_loadNodesetStream(server, NODESET_FILE, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADDECODINGERROR);
+} END_TEST
+
+START_TEST(loadUnknownNamespace) {
+    /* Namespace index 2 is not defined in the NamespaceUris */
+    writeFile(NODESET_FILE,
+              "<UANodeSet><UAObject NodeId=\"ns=2;i=1\" BrowseName=\"x\"/></UANodeSet>");
+    UA_StatusCode res = UA_Server_loadNodesetStream(server, NODESET_FILE, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDINVALID);
+} END_TEST
+
+START_TEST(loadAfterStartup) {
+    writeFile(NODESET_FILE, nodeset);
+    UA_StatusCode res = UA_Server_run_startup(server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_loadNodesetStream(server, NODESET_FILE, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADINVALIDSTATE);
+    UA_Server_run_shutdown(server);
+} END_TEST
+
+int main(void) {
+    Suite *s = suite_create("Streaming Nodeset Loader");
+    TCase *tc = tcase_create("Load");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, loadNodeset);
+    tcase_add_test(tc, loadNodesetInline);
+    tcase_add_test(tc, loadNodesetSmallBatches);
+    tcase_add_test(tc, loadMissingFile);
+    tcase_add_test(tc, loadMalformed);
+    tcase_add_test(tc, loadUnknownNamespace);
+    tcase_add_test(tc, loadAfterStartup);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,150 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodesetloader.h>
+#include "test_helpers.h"
+
+#include <check.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Synthetic model: Objects with a number of variables each */
+#define NODESET_FILE "check_nodesetloader_stream_speed.xml"
+#define OBJECTS 5000
+#define VARIABLES 9
+
+static UA_Server *server;
+
+static void
+writeNodeset(void) {
+    FILE *f = fopen(NODESET_FILE, "wb");
+    ck_assert(f != NULL);
+    fprintf(f, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+            "<UANodeSet xmlns=\"http://opcfoundation.org/UA/2011/03/UANodeSet.xsd\">\n"
+            "<NamespaceUris><Uri>http://example.org/speed/</Uri></NamespaceUris>\n"
+            "<Aliases><Alias Alias=\"Double\">i=11</Alias>"
+            "<Alias Alias=\"Organizes\">i=35</Alias>"
+            "<Alias Alias=\"HasComponent\">i=47</Alias>"
+            "<Alias Alias=\"HasTypeDefinition\">i=40</Alias></Aliases>\n");
+    for(int o = 0; o < OBJECTS; o++) {
+        int objId = 100000 + o * (VARIABLES + 1);
+        fprintf(f, "<UAObject NodeId=\"ns=1;i=%d\" BrowseName=\"1:Object%d\">"
+                "<DisplayName>Object%d</DisplayName><References>"
+                "<Reference ReferenceType=\"HasTypeDefinition\">i=58</Reference>"
+                "<Reference ReferenceType=\"Organizes\" IsForward=\"false\">i=85"
+                "</Reference></References></UAObject>\n", objId, o, o);
+        for(int v = 1; v <= VARIABLES; v++) {
+            fprintf(f, "<UAVariable NodeId=\"ns=1;i=%d\" BrowseName=\"1:Variable%d\" "
+                    "DataType=\"Double\" ParentNodeId=\"ns=1;i=%d\">"
+                    "<DisplayName>Variable%d</DisplayName><References>"
+                    "<Reference ReferenceType=\"HasTypeDefinition\">i=63</Reference>"
+                    "<Reference ReferenceType=\"HasComponent\" IsForward=\"false\">"
+                    "ns=1;i=%d</Reference></References><Value>"
+                    "<Double xmlns=\"http://opcfoundation.org/UA/2008/02/Types.xsd\">"
+                    "%d.5</Double></Value></UAVariable>\n",
+                    objId + v, v, objId, v, objId, v);
+        }
+    }
+    fprintf(f, "</UANodeSet>\n");
+    fclose(f);
+}
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    writeNodeset();
+}
+
+static void teardown(void) {
+    UA_Server_delete(server);
+    remove(NODESET_FILE);
+}
+
+static void
+checkLastVariable(UA_UInt16 nsIndex) {
+    UA_Variant value;
+    UA_NodeId last = UA_NODEID_NUMERIC(nsIndex, 100000 +
+                                       (OBJECTS - 1) * (VARIABLES + 1) + VARIABLES);
+    UA_StatusCode res = UA_Server_readValue(server, last, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_DOUBLE]));
+    ck_assert(*(UA_Double*)value.data == VARIABLES + 0.5);
+    UA_Variant_clear(&value);
+}
+
+static void
+loadStream(UA_Boolean parseInline) {
+    UA_NodesetStreamOptions options;
+    memset(&options, 0, sizeof(UA_NodesetStreamOptions));
+    options.parseInline = parseInline;
+
+    /* Measure the wall time. clock() adds up the time of both threads. */
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    UA_StatusCode res = UA_Server_loadNodesetStream(server, NODESET_FILE, &options);
+    UA_DateTime finish = UA_DateTime_nowMonotonic();
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    printf("%i nodes (streaming loader%s):\t Duration was %f s\n",
+           OBJECTS * (VARIABLES + 1), parseInline ? ", inline" : "",
+           (double)(finish - begin) / UA_DATETIME_SEC);
+
+    size_t nsIndex = 0;
+    res = UA_Server_getNamespaceByName(server, UA_STRING("http://example.org/speed/"),
+                                       &nsIndex);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    checkLastVariable((UA_UInt16)nsIndex);
+}
+
+START_TEST(loadStreamThreaded) {
+    loadStream(false);
+} END_TEST
+
+START_TEST(loadStreamInline) {
+    loadStream(true);
+} END_TEST
+
+/* The same file loaded with the existing nodeset loader as the baseline */
+#ifdef UA_ENABLE_NODESETLOADER
+START_TEST(loadNodesetLoader) {
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    UA_StatusCode res = UA_Server_loadNodeset(server, NODESET_FILE, NULL);
+    UA_DateTime finish = UA_DateTime_nowMonotonic();
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    printf("%i nodes (UA_Server_loadNodeset):\t Duration was %f s\n",
+           OBJECTS * (VARIABLES + 1), (double)(finish - begin) / UA_DATETIME_SEC);
+
+    size_t nsIndex = 0;
+    res = UA_Server_getNamespaceByName(server, UA_STRING("http://example.org/speed/"),
+                                       &nsIndex);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    checkLastVariable((UA_UInt16)nsIndex);
+} END_TEST
+#endif
+
+static Suite * nodeset_speed_suite (void) {
+    Suite *s = suite_create ("Nodeset Loader Speed");
+
+    TCase* tc_load = tcase_create ("Load");
+    tcase_add_checked_fixture(tc_load, setup, teardown);
+    tcase_add_test(tc_load, loadStreamThreaded);
+    tcase_add_test(tc_load, loadStreamInline);
+#ifdef UA_ENABLE_NODESETLOADER
+    tcase_add_test(tc_load, loadNodesetLoader);
+#endif
+    suite_add_tcase(s, tc_load);
+
+    return s;
+}
+
+int main (void) {
+    int number_failed = 0;
+    Suite *s = nodeset_speed_suite();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr,CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed += srunner_ntests_failed (sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
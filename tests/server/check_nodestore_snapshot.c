@@ -0,0 +1,237 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "check.h"
+
+#define SNAPSHOT_FILE "check_nodestore_snapshot.bin"
+
+static const UA_NodeId machineId = {1, UA_NODEIDTYPE_NUMERIC, {1000}};
+static const UA_NodeId speedId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
+static const UA_NodeId drivesId = {1, UA_NODEIDTYPE_NUMERIC, {1002}};
+
+static UA_Server *server = NULL;
+
+static void
+populate(UA_Server *s) {
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    oAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Machine");
+    UA_StatusCode res =
+        UA_Server_addObjectNode(s, machineId, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Machine"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    UA_Int32 speed = 42;
+    UA_Variant_setScalar(&vAttr.value, &speed, &UA_TYPES[UA_TYPES_INT32]);
+    vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Speed");
+    vAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    res = UA_Server_addVariableNode(s, speedId, machineId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                    UA_QUALIFIEDNAME(1, "Speed"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    vAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_ReferenceTypeAttributes rAttr = UA_ReferenceTypeAttributes_default;
+    rAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Drives");
+    rAttr.inverseName = UA_LOCALIZEDTEXT("en-US", "DrivenBy");
+    res = UA_Server_addReferenceTypeNode(s, drivesId,
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_NONHIERARCHICALREFERENCES),
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                         UA_QUALIFIEDNAME(1, "Drives"), rAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_ExpandedNodeId target = UA_EXPANDEDNODEID_NUMERIC(1, 1001);
+    res = UA_Server_addReference(s, machineId, drivesId, target, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void setup(void) {
+    UA_Server *s = UA_Server_new();
+    ck_assert(s != NULL);
+    populate(s);
+    UA_ServerConfig *sc = UA_Server_getConfig(s);
+    UA_StatusCode res = UA_Nodestore_saveSnapshot(&sc->nodestore, SNAPSHOT_FILE);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Server_delete(s);
+
+    /* Restart from the snapshot */
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    res = UA_Nodestore_HashMap(&config.nodestore);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Nodestore_loadSnapshot(&config.nodestore, SNAPSHOT_FILE, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_ServerConfig_setDefault(&config);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    server = UA_Server_newWithConfig(&config);
+    ck_assert(server != NULL);
+}
+
+static void teardown(void) {
+    UA_Server_delete(server);
+    remove(SNAPSHOT_FILE);
+}
+
+START_TEST(readRestoredValue) {
+    UA_Variant value;
+    UA_StatusCode res = UA_Server_readValue(server, speedId, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)value.data, 42);
+    UA_Variant_clear(&value);
+
+    UA_QualifiedName bn;
+    res = UA_Server_readBrowseName(server, machineId, &bn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_QualifiedName expected = UA_QUALIFIEDNAME(1, "Machine");
+    ck_assert(UA_QualifiedName_equal(&bn, &expected));
+    UA_QualifiedName_clear(&bn);
+} END_TEST
+
+START_TEST(writeRestoredValue) {
+    UA_Variant value;
+    UA_Int32 speed = 43;
+    UA_Variant_setScalar(&value, &speed, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res = UA_Server_writeValue(server, speedId, value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Server_readValue(server, speedId, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)value.data, 43);
+    UA_Variant_clear(&value);
+} END_TEST
+
+START_TEST(browseFromNs0) {
+    /* The reference from the ObjectsFolder is patched into ns0 */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        if(UA_NodeId_equal(&br.references[i].nodeId.nodeId, &machineId))
+            found = true;
+    }
+    ck_assert(found);
+    UA_BrowseResult_clear(&br);
+} END_TEST
+
+START_TEST(browseCustomReferenceType) {
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = machineId;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_NONHIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        if(UA_NodeId_equal(&br.references[i].referenceTypeId, &drivesId) &&
+           UA_NodeId_equal(&br.references[i].nodeId.nodeId, &speedId))
+            found = true;
+    }
+    ck_assert(found);
+    UA_BrowseResult_clear(&br);
+} END_TEST
+
+START_TEST(addAndRemoveAfterRestore) {
+    /* Existing NodeIds from the snapshot are rejected */
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, machineId, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Machine"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDEXISTS);
+
+    /* Random NodeIds do not collide with the snapshot */
+    UA_NodeId newId;
+    res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 0),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Other"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                  oAttr, NULL, &newId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(!UA_NodeId_equal(&newId, &machineId));
+
+    res = UA_Server_deleteNode(server, machineId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_QualifiedName bn;
+    res = UA_Server_readBrowseName(server, machineId, &bn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+} END_TEST
+
+START_TEST(readdMaterializedNode) {
+    /* Reading materializes the node from the image */
+    UA_Variant value;
+    UA_StatusCode res = UA_Server_readValue(server, speedId, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Variant_clear(&value);
+
+    res = UA_Server_deleteNode(server, speedId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Add a new node with the same NodeId */
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    UA_Int32 speed = 7;
+    UA_Variant_setScalar(&vAttr.value, &speed, &UA_TYPES[UA_TYPES_INT32]);
+    vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Speed");
+    res = UA_Server_addVariableNode(server, speedId, machineId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                    UA_QUALIFIEDNAME(1, "Speed"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    vAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Server_readValue(server, speedId, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)value.data, 7);
+    UA_Variant_clear(&value);
+
+    /* Delete again. The image must not resurrect the old node. */
+    res = UA_Server_deleteNode(server, speedId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_readValue(server, speedId, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+} END_TEST
+
+int main(void) {
+    Suite *s = suite_create("Nodestore Snapshot");
+
+    TCase *tc = tcase_create("Warm restart");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, readRestoredValue);
+    tcase_add_test(tc, writeRestoredValue);
+    tcase_add_test(tc, browseFromNs0);
+    tcase_add_test(tc, browseCustomReferenceType);
+    tcase_add_test(tc, addAndRemoveAfterRestore);
+    tcase_add_test(tc, readdMaterializedNode);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
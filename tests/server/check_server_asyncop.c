@@ -8,6 +8,7 @@
 #include <open62541/server.h>
 #include <open62541/client.h>
 #include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
 #include <open62541/client_highlevel_async.h>
 #include <open62541/plugin/log_stdout.h>
 
@@ -40,12 +41,54 @@ clientReceiveCallback(UA_Client *client, void *userdata,
     clientCounter++;
 }
 
+static UA_Int32 dataSourceValue;
+static UA_ReadResponse readResponse;
+static UA_Boolean adminSessionUsed;
+
+static void
+checkSession(const UA_NodeId *sessionId) {
+    UA_Guid adminGuid = {1, 0, 0, {0}};
+    UA_NodeId adminSessionId = UA_NODEID_GUID(0, adminGuid);
+    if(UA_NodeId_equal(sessionId, &adminSessionId))
+        adminSessionUsed = true;
+}
+
+static UA_StatusCode
+readDataSource(UA_Server *serverArg, const UA_NodeId *sessionId, void *sessionContext,
+               const UA_NodeId *nodeId, void *nodeContext, UA_Boolean includeSourceTimeStamp,
+               const UA_NumericRange *range, UA_DataValue *value) {
+    checkSession(sessionId);
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &dataSourceValue,
+                                    &UA_TYPES[UA_TYPES_INT32]);
+}
+
+static UA_StatusCode
+writeDataSource(UA_Server *serverArg, const UA_NodeId *sessionId, void *sessionContext,
+                const UA_NodeId *nodeId, void *nodeContext, const UA_NumericRange *range,
+                const UA_DataValue *value) {
+    checkSession(sessionId);
+    if(!value->hasValue || !UA_Variant_hasScalarType(&value->value, &UA_TYPES[UA_TYPES_INT32]))
+        return UA_STATUSCODE_BADTYPEMISMATCH;
+    dataSourceValue = *(UA_Int32*)value->value.data;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+clientReadCallback(UA_Client *client, void *userdata,
+                   UA_UInt32 requestId, UA_ReadResponse *rr) {
+    UA_ReadResponse_copy(rr, &readResponse);
+    clientCounter++;
+}
+
 THREAD_CALLBACK(serverloop) {
     while(running)
         UA_Server_run_iterate(server, true);
     return 0;
 }
 
+static UA_UInt16 workers = 0;
+
 static void setup(void) {
     clientCounter = 0;
     running = true;
@@ -53,6 +96,7 @@ static void setup(void) {
     ck_assert(server != NULL);
     UA_ServerConfig *config = UA_Server_getConfig(server);
     config->asyncOperationTimeout = 2000.0; /* 2 seconds */
+    config->asyncOperationWorkers = workers;
 
     UA_MethodAttributes methodAttr = UA_MethodAttributes_default;
     methodAttr.executable = true;
@@ -79,6 +123,23 @@ static void setup(void) {
     res = UA_Server_setMethodNodeAsync(server, UA_NODEID_STRING(1, "asyncMethod"), true);
     ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
 
+    /* Asynchronous DataSource variable */
+    dataSourceValue = 0;
+    UA_VariableAttributes varAttr = UA_VariableAttributes_default;
+    varAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    varAttr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    varAttr.valueRank = UA_VALUERANK_SCALAR;
+    UA_DataSource dataSource = {readDataSource, writeDataSource};
+    res = UA_Server_addDataSourceVariableNode(server, UA_NODEID_STRING(1, "asyncVariable"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "asyncVariable"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                varAttr, dataSource, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_setVariableNodeAsync(server, UA_NODEID_STRING(1, "asyncVariable"), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
     UA_Server_run_startup(server);
     THREAD_CREATE(server_thread, serverloop);
 }
@@ -90,6 +151,16 @@ static void teardown(void) {
     UA_Server_delete(server);
 }
 
+static void setupWorkers(void) {
+    workers = 2;
+    setup();
+}
+
+static void teardownWorkers(void) {
+    teardown();
+    workers = 0;
+}
+
 START_TEST(Async_call) {
     UA_Client *client = UA_Client_newForUnitTest();
     UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
@@ -301,6 +372,144 @@ START_TEST(Async_timeout_worker) {
     UA_Client_delete(client);
 } END_TEST
 
+/* Read an async DataSource variable together with a synchronous attribute.
+ * The response is sent when the worker has returned the value. */
+START_TEST(Async_read) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Stop the server thread. Iterate manually from now on */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    UA_ReadValueId rvi[2];
+    UA_ReadValueId_init(&rvi[0]);
+    rvi[0].nodeId = UA_NODEID_STRING(1, "asyncVariable");
+    rvi[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadValueId_init(&rvi[1]);
+    rvi[1].nodeId = UA_NODEID_STRING(1, "asyncVariable");
+    rvi[1].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+
+    UA_ReadRequest rreq;
+    UA_ReadRequest_init(&rreq);
+    rreq.nodesToRead = rvi;
+    rreq.nodesToReadSize = 2;
+    rreq.timestampsToReturn = UA_TIMESTAMPSTORETURN_SERVER;
+    UA_ReadResponse_init(&readResponse);
+    retval = __UA_Client_AsyncService(client,
+                                      &rreq, &UA_TYPES[UA_TYPES_READREQUEST],
+                                      (UA_ClientAsyncServiceCallback)clientReadCallback,
+                                      &UA_TYPES[UA_TYPES_READRESPONSE], NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* The response is held back */
+    UA_Server_run_iterate(server, true);
+    UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(clientCounter, 0);
+
+    /* Process the async read for the server */
+    UA_AsyncOperationType aot;
+    const UA_AsyncOperationRequest *request;
+    void *context = NULL;
+    UA_Boolean haveAsync =
+        UA_Server_getAsyncOperationNonBlocking(server, &aot, &request, &context, NULL);
+    ck_assert_uint_eq(haveAsync, true);
+    ck_assert_int_eq(aot, UA_ASYNCOPERATIONTYPE_READ);
+    ck_assert(UA_NodeId_equal(&request->readValueId.nodeId, &rvi[0].nodeId));
+
+    UA_Int32 value = 42;
+    UA_AsyncOperationResponse response;
+    UA_DataValue_init(&response.readResult);
+    UA_Variant_setScalar(&response.readResult.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    response.readResult.hasValue = true;
+    response.readResult.hasSourceTimestamp = true; /* Removed by the server */
+    UA_Server_setAsyncOperationResult(server, &response, context);
+
+    /* Iterate and pick up the async response to be sent out */
+    UA_Server_run_iterate(server, true);
+    for(size_t i = 0; i < 10 && clientCounter == 0; i++)
+        UA_Client_run_iterate(client, 10);
+    ck_assert_uint_eq(clientCounter, 1);
+
+    ck_assert_uint_eq(readResponse.resultsSize, 2);
+    ck_assert(readResponse.results[0].hasValue);
+    ck_assert(UA_Variant_hasScalarType(&readResponse.results[0].value,
+                                       &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)readResponse.results[0].value.data, 42);
+    ck_assert(readResponse.results[0].hasServerTimestamp);
+    ck_assert(!readResponse.results[0].hasSourceTimestamp);
+    ck_assert(readResponse.results[1].hasValue);
+    ck_assert(UA_Variant_hasScalarType(&readResponse.results[1].value,
+                                       &UA_TYPES[UA_TYPES_QUALIFIEDNAME]));
+    UA_ReadResponse_clear(&readResponse);
+
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+/* The built-in workers execute the method and the response is sent without
+ * further action from the application */
+START_TEST(Async_builtinWorkers) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    for(size_t i = 0; i < 10; i++) {
+        retval = UA_Client_call_async(client,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_STRING(1, "asyncMethod"),
+                                      0, NULL, clientReceiveCallback, NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    for(size_t i = 0; i < 100 && clientCounter < 10; i++)
+        UA_Client_run_iterate(client, 100);
+    ck_assert_uint_eq(clientCounter, 10);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+/* The built-in workers call the DataSource of async variables with the
+ * session of the client */
+START_TEST(Async_builtinWorkersReadWrite) {
+    adminSessionUsed = false;
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Int32 value = 7;
+    UA_Variant var;
+    UA_Variant_setScalar(&var, &value, &UA_TYPES[UA_TYPES_INT32]);
+    retval = UA_Client_writeValueAttribute(client, UA_NODEID_STRING(1, "asyncVariable"),
+                                           &var);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(dataSourceValue, 7);
+
+    /* The type is checked by the worker */
+    UA_Double wrongType = 1.0;
+    UA_Variant_setScalar(&var, &wrongType, &UA_TYPES[UA_TYPES_DOUBLE]);
+    retval = UA_Client_writeValueAttribute(client, UA_NODEID_STRING(1, "asyncVariable"),
+                                           &var);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADTYPEMISMATCH);
+
+    UA_Variant_init(&var);
+    retval = UA_Client_readValueAttribute(client, UA_NODEID_STRING(1, "asyncVariable"),
+                                          &var);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&var, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)var.data, 7);
+    UA_Variant_clear(&var);
+    ck_assert(!adminSessionUsed);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
 static Suite* method_async_suite(void) {
     /* set up unit test for internal data structures */
     Suite *s = suite_create("Async Method");
@@ -312,8 +521,15 @@ static Suite* method_async_suite(void) {
     tcase_add_test(tc_manager, Async_cancel);
     tcase_add_test(tc_manager, Async_cancel_multiple);
     tcase_add_test(tc_manager, Async_timeout_worker);
+    tcase_add_test(tc_manager, Async_read);
     suite_add_tcase(s, tc_manager);
 
+    TCase* tc_workers = tcase_create("AsyncMethodWorkers");
+    tcase_add_checked_fixture(tc_workers, setupWorkers, teardownWorkers);
+    tcase_add_test(tc_workers, Async_builtinWorkers);
+    tcase_add_test(tc_workers, Async_builtinWorkersReadWrite);
+    suite_add_tcase(s, tc_workers);
+
     return s;
 }
 
@@ -0,0 +1,575 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Records the binary protocol messages of a client session and replays them at
+ * full speed against an in-process server. The replay feeds the chunks directly
+ * into the network callback of the server with the test ConnectionManager. So
+ * no sockets are involved and the measurement covers only the SecureChannel,
+ * the session handling and the services. Reported are a latency histogram per
+ * service, the throughput and the allocations per request. Allocations are only
+ * counted if UA_ENABLE_MALLOC_SINGLETON is defined.
+ *
+ * The capture file is a sequence of [UInt32 little-endian length][bytes]
+ * records with the buffers sent by the client. If the environment variable
+ * UA_REPLAY_CAPTURE points to an existing file, that capture is replayed.
+ * Otherwise a new session is recorded and stored in the file (if the variable
+ * is set). */
+
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/server_config_default.h>
+
+#include "ua_server_internal.h"
+#include "ua_types_encoding_binary.h"
+
+#include <check.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test_helpers.h"
+#include "testing_networklayers.h"
+#include "thread_wrapper.h"
+
+#define WORKLOAD_READS 100
+#define WORKLOAD_BROWSES 20
+#define WORKLOAD_WRITES 20
+#define REPLAY_ROUNDS 20
+#define MAX_CATEGORIES 32
+#define HISTOGRAM_BUCKETS 16
+
+static UA_Server *server;
+static UA_Boolean running;
+static THREAD_HANDLE server_thread;
+static UA_NodeId varId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
+
+THREAD_CALLBACK(serverloop) {
+    while(running)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 42;
+    UA_Variant_setScalar(&attr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", "Temperature");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, varId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Temperature"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Server_run_startup(server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void teardown(void) {
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+/***********/
+/* Capture */
+/***********/
+
+typedef struct {
+    UA_ByteString *chunks;
+    size_t chunksSize;
+} Capture;
+
+static FILE *recordFile;
+static UA_StatusCode
+(*recordSend)(UA_ConnectionManager *cm, uintptr_t connectionId,
+              const UA_KeyValueMap *params, UA_ByteString *buf);
+
+static void
+writeUInt32(UA_Byte *pos, UA_UInt32 v) {
+    pos[0] = (UA_Byte)v;
+    pos[1] = (UA_Byte)(v >> 8);
+    pos[2] = (UA_Byte)(v >> 16);
+    pos[3] = (UA_Byte)(v >> 24);
+}
+
+static UA_UInt32
+readUInt32(const UA_Byte *pos) {
+    return (UA_UInt32)pos[0] | ((UA_UInt32)pos[1] << 8) |
+        ((UA_UInt32)pos[2] << 16) | ((UA_UInt32)pos[3] << 24);
+}
+
+/* Store every buffer before it goes out on the socket */
+static UA_StatusCode
+recordingSend(UA_ConnectionManager *cm, uintptr_t connectionId,
+              const UA_KeyValueMap *params, UA_ByteString *buf) {
+    UA_Byte len[4];
+    writeUInt32(len, (UA_UInt32)buf->length);
+    ck_assert_uint_eq(fwrite(len, 4, 1, recordFile), 1);
+    ck_assert_uint_eq(fwrite(buf->data, buf->length, 1, recordFile), 1);
+    return recordSend(cm, connectionId, params, buf);
+}
+
+static UA_ConnectionManager *
+findTcpConnectionManager(UA_EventLoop *el) {
+    UA_String tcpString = UA_STRING("tcp");
+    for(UA_EventSource *es = el->eventSources; es != NULL; es = es->next) {
+        if(es->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
+            continue;
+        UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
+        if(UA_String_equal(&tcpString, &cm->protocol))
+            return cm;
+    }
+    return NULL;
+}
+
+/* A client session with the typical mix of services */
+static void
+runWorkload(UA_Client *client) {
+    UA_StatusCode res = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    for(size_t i = 0; i < WORKLOAD_READS; i++) {
+        UA_Variant val;
+        res = UA_Client_readValueAttribute(client, varId, &val);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        UA_Variant_clear(&val);
+    }
+
+    /* Read several attributes at once */
+    UA_ReadValueId rvi[4];
+    for(size_t i = 0; i < 4; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = varId;
+    }
+    rvi[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    rvi[1].attributeId = UA_ATTRIBUTEID_DISPLAYNAME;
+    rvi[2].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+    rvi[3].attributeId = UA_ATTRIBUTEID_DATATYPE;
+    UA_ReadRequest rr;
+    UA_ReadRequest_init(&rr);
+    rr.nodesToRead = rvi;
+    rr.nodesToReadSize = 4;
+    UA_ReadResponse rresp = UA_Client_Service_read(client, rr);
+    ck_assert_uint_eq(rresp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_ReadResponse_clear(&rresp);
+
+    for(size_t i = 0; i < WORKLOAD_BROWSES; i++) {
+        UA_BrowseDescription bd;
+        UA_BrowseDescription_init(&bd);
+        bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+        bd.resultMask = UA_BROWSERESULTMASK_ALL;
+        UA_BrowseRequest br;
+        UA_BrowseRequest_init(&br);
+        br.nodesToBrowse = &bd;
+        br.nodesToBrowseSize = 1;
+        UA_BrowseResponse bresp = UA_Client_Service_browse(client, br);
+        ck_assert_uint_eq(bresp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+        UA_BrowseResponse_clear(&bresp);
+    }
+
+    for(size_t i = 0; i < WORKLOAD_WRITES; i++) {
+        UA_Int32 v = (UA_Int32)i;
+        UA_Variant val;
+        UA_Variant_setScalar(&val, &v, &UA_TYPES[UA_TYPES_INT32]);
+        res = UA_Client_writeValueAttribute(client, varId, &val);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    UA_Client_disconnect(client);
+}
+
+static void
+recordSession(FILE *f) {
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+    UA_ConnectionManager *cm =
+        findTcpConnectionManager(UA_Client_getConfig(client)->eventLoop);
+    ck_assert(cm != NULL);
+    recordFile = f;
+    recordSend = cm->sendWithConnection;
+    cm->sendWithConnection = recordingSend;
+
+    runWorkload(client);
+
+    cm->sendWithConnection = recordSend;
+    recordFile = NULL;
+    UA_Client_delete(client);
+
+    running = false;
+    THREAD_JOIN(server_thread);
+}
+
+static void
+loadCapture(FILE *f, Capture *c) {
+    memset(c, 0, sizeof(Capture));
+    UA_Byte len[4];
+    while(fread(len, 4, 1, f) == 1) {
+        UA_ByteString chunk;
+        UA_StatusCode res = UA_ByteString_allocBuffer(&chunk, readUInt32(len));
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(fread(chunk.data, chunk.length, 1, f), 1);
+        res = UA_Array_appendCopy((void**)&c->chunks, &c->chunksSize, &chunk,
+                                  &UA_TYPES[UA_TYPES_BYTESTRING]);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        UA_ByteString_clear(&chunk);
+    }
+}
+
+/**********/
+/* Replay */
+/**********/
+
+typedef struct {
+    char name[64];
+    size_t count;
+    UA_DateTime duration;
+    size_t allocations;
+    size_t histogram[HISTOGRAM_BUCKETS]; /* log2 of the microseconds */
+} ReplayStats;
+
+typedef struct {
+    UA_ServerComponent *bpm;
+    void *listenContext;
+    UA_ByteString lastSent;
+    UA_NodeId recordedToken;
+    UA_NodeId liveToken;
+    UA_Boolean inMessage; /* The last MSG chunk was not final */
+    ReplayStats stats[MAX_CATEGORIES];
+    size_t statsSize;
+} Replay;
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+static size_t allocations;
+static void * (*origMalloc)(size_t size);
+static void * (*origCalloc)(size_t nelem, size_t elsize);
+static void * (*origRealloc)(void *ptr, size_t size);
+
+static void *
+countingMalloc(size_t size) {
+    allocations++;
+    return origMalloc(size);
+}
+
+static void *
+countingCalloc(size_t nelem, size_t elsize) {
+    allocations++;
+    return origCalloc(nelem, elsize);
+}
+
+static void *
+countingRealloc(void *ptr, size_t size) {
+    allocations++;
+    return origRealloc(ptr, size);
+}
+#endif
+
+static ReplayStats *
+getStats(Replay *r, const char *name) {
+    for(size_t i = 0; i < r->statsSize; i++) {
+        if(strcmp(r->stats[i].name, name) == 0)
+            return &r->stats[i];
+    }
+    ck_assert_uint_lt(r->statsSize, MAX_CATEGORIES);
+    ReplayStats *s = &r->stats[r->statsSize++];
+    memset(s, 0, sizeof(ReplayStats));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    return s;
+}
+
+/* The service request type of a MSG chunk that starts a new message */
+static const UA_DataType *
+requestType(const UA_ByteString *chunk, size_t *offset) {
+    UA_NodeId typeId;
+    *offset = 24; /* Message header, channelId, tokenId, sequence header */
+    UA_StatusCode res = UA_decodeBinaryInternal(chunk, offset, &typeId,
+                                                &UA_TYPES[UA_TYPES_NODEID], NULL);
+    if(res != UA_STATUSCODE_GOOD)
+        return NULL;
+    const UA_DataType *type = UA_findDataTypeByBinary(&typeId);
+    UA_NodeId_clear(&typeId);
+    return type;
+}
+
+static void
+categoryName(const UA_ByteString *buf, char *name, size_t nameSize) {
+    if(buf->length < 8 || memcmp(buf->data, "MSG", 3) != 0) {
+        snprintf(name, nameSize, "%.3s", (const char*)buf->data);
+        return;
+    }
+    size_t offset;
+    const UA_DataType *type = requestType(buf, &offset);
+    if(!type) {
+        snprintf(name, nameSize, "MSG (continued)");
+        return;
+    }
+#ifdef UA_ENABLE_TYPEDESCRIPTION
+    snprintf(name, nameSize, "%s", type->typeName);
+#else
+    snprintf(name, nameSize, "ns=0;i=%u", (unsigned)type->typeId.identifier.numeric);
+#endif
+}
+
+/* Adjust the recorded chunks to the live SecureChannel and Session. The
+ * SecureChannel identifiers are in the symmetric security header. The
+ * authentication token follows the type NodeId in the RequestHeader. */
+static void
+patchChunks(Replay *r, UA_ByteString *buf, const UA_SecureChannel *channel) {
+    size_t pos = 0;
+    while(pos + 24 <= buf->length) {
+        UA_Byte *chunk = &buf->data[pos];
+        size_t chunkLength = readUInt32(&chunk[4]);
+        if(chunkLength < 24 || pos + chunkLength > buf->length)
+            break;
+        UA_Boolean msg = (memcmp(chunk, "MSG", 3) == 0);
+        if(msg || memcmp(chunk, "CLO", 3) == 0) {
+            writeUInt32(&chunk[8], channel->securityToken.channelId);
+            writeUInt32(&chunk[12], channel->securityToken.tokenId);
+        }
+
+        if(msg && !r->inMessage) {
+            UA_ByteString c = {chunkLength, chunk};
+            size_t offset;
+            requestType(&c, &offset);
+            size_t tokenOffset = offset;
+            UA_NodeId token;
+            UA_StatusCode res =
+                UA_decodeBinaryInternal(&c, &offset, &token,
+                                        &UA_TYPES[UA_TYPES_NODEID], NULL);
+            if(res == UA_STATUSCODE_GOOD && !UA_NodeId_isNull(&token)) {
+                /* The first non-null token is the recorded session */
+                if(UA_NodeId_isNull(&r->recordedToken))
+                    UA_NodeId_copy(&token, &r->recordedToken);
+                if(UA_NodeId_equal(&token, &r->recordedToken) &&
+                   UA_calcSizeBinary(&r->liveToken, &UA_TYPES[UA_TYPES_NODEID]) ==
+                   offset - tokenOffset) {
+                    UA_Byte *p = &chunk[tokenOffset];
+                    const UA_Byte *end = &chunk[offset];
+                    res = UA_encodeBinaryInternal(&r->liveToken,
+                                                  &UA_TYPES[UA_TYPES_NODEID],
+                                                  &p, &end, NULL, NULL);
+                    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+                }
+            }
+            UA_NodeId_clear(&token);
+        }
+        if(msg)
+            r->inMessage = (chunk[3] == 'C');
+        pos += chunkLength;
+    }
+}
+
+/* Every service response is good. Remember the authentication token of a new
+ * session. */
+static void
+checkResponse(Replay *r, const UA_ByteString *request) {
+    if(memcmp(request->data, "CLO", 3) == 0 || r->inMessage)
+        return;
+    ck_assert_uint_ge(r->lastSent.length, 24);
+    if(memcmp(request->data, "HEL", 3) == 0) {
+        ck_assert(memcmp(r->lastSent.data, "ACK", 3) == 0);
+        return;
+    }
+    if(memcmp(request->data, "OPN", 3) == 0) {
+        ck_assert(memcmp(r->lastSent.data, "OPN", 3) == 0);
+        return;
+    }
+
+    ck_assert(memcmp(r->lastSent.data, "MSG", 3) == 0);
+    size_t offset;
+    const UA_DataType *type = requestType(&r->lastSent, &offset);
+    ck_assert(type != NULL);
+    if(type == &UA_TYPES[UA_TYPES_CREATESESSIONRESPONSE]) {
+        UA_CreateSessionResponse csr;
+        UA_StatusCode res = UA_decodeBinaryInternal(&r->lastSent, &offset, &csr,
+                                                    type, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(csr.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+        UA_NodeId_clear(&r->liveToken);
+        UA_NodeId_copy(&csr.authenticationToken, &r->liveToken);
+        UA_CreateSessionResponse_clear(&csr);
+        return;
+    }
+
+    UA_ResponseHeader rh;
+    UA_StatusCode res = UA_decodeBinaryInternal(&r->lastSent, &offset, &rh,
+                                                &UA_TYPES[UA_TYPES_RESPONSEHEADER],
+                                                NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(rh.serviceResult, UA_STATUSCODE_GOOD);
+    UA_ResponseHeader_clear(&rh);
+}
+
+static void
+replayRound(Replay *r, const Capture *c, uintptr_t connectionId) {
+    /* A new connection on the server socket creates the SecureChannel */
+    void *ctx = r->listenContext;
+    serverNetworkCallback(&testConnectionManagerTCP, connectionId, r->bpm, &ctx,
+                          UA_CONNECTIONSTATE_ESTABLISHED, &UA_KEYVALUEMAP_NULL,
+                          UA_BYTESTRING_NULL);
+    ck_assert(ctx != r->listenContext);
+    UA_SecureChannel *channel = (UA_SecureChannel*)ctx;
+
+    UA_NodeId_clear(&r->recordedToken);
+    UA_NodeId_clear(&r->liveToken);
+    r->inMessage = false;
+
+    for(size_t i = 0; i < c->chunksSize; i++) {
+        char name[64];
+        categoryName(&c->chunks[i], name, sizeof(name));
+        ReplayStats *s = getStats(r, name);
+
+        UA_ByteString msg;
+        UA_StatusCode res = UA_ByteString_copy(&c->chunks[i], &msg);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        patchChunks(r, &msg, channel);
+        UA_ByteString_clear(&r->lastSent);
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+        size_t allocsBefore = allocations;
+#endif
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        serverNetworkCallback(&testConnectionManagerTCP, connectionId, r->bpm,
+                              &ctx, UA_CONNECTIONSTATE_ESTABLISHED,
+                              &UA_KEYVALUEMAP_NULL, msg);
+        UA_DateTime duration = UA_DateTime_nowMonotonic() - begin;
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+        s->allocations += allocations - allocsBefore;
+#endif
+
+        s->count++;
+        s->duration += duration;
+        UA_DateTime us = duration / UA_DATETIME_USEC;
+        size_t bucket = 0;
+        while(us > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        s->histogram[bucket]++;
+
+        checkResponse(r, &msg);
+        UA_ByteString_clear(&msg);
+    }
+
+    /* Close the connection. This removes the SecureChannel. */
+    serverNetworkCallback(&testConnectionManagerTCP, connectionId, r->bpm, &ctx,
+                          UA_CONNECTIONSTATE_CLOSING, &UA_KEYVALUEMAP_NULL,
+                          UA_BYTESTRING_NULL);
+    UA_Server_run_iterate(server, false);
+}
+
+static void
+printStats(const Replay *r, UA_DateTime total) {
+    size_t requests = 0;
+    for(size_t i = 0; i < r->statsSize; i++) {
+        const ReplayStats *s = &r->stats[i];
+        requests += s->count;
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+        printf("%-28s %6lu req %10.2f us mean %8.1f allocs/req\n", s->name,
+               (unsigned long)s->count,
+               (double)s->duration / (double)s->count / UA_DATETIME_USEC,
+               (double)s->allocations / (double)s->count);
+#else
+        printf("%-28s %6lu req %10.2f us mean      n/a allocs/req\n", s->name,
+               (unsigned long)s->count,
+               (double)s->duration / (double)s->count / UA_DATETIME_USEC);
+#endif
+        printf("   ");
+        for(size_t b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            if(s->histogram[b] > 0)
+                printf(" <%luus:%lu", 1ul << b, (unsigned long)s->histogram[b]);
+        }
+        printf("\n");
+    }
+    printf("%lu requests in %f s (%.0f req/s)\n", (unsigned long)requests,
+           (double)total / UA_DATETIME_SEC,
+           (double)requests * UA_DATETIME_SEC / (double)total);
+}
+
+START_TEST(replaySession) {
+    /* Load the capture. Record a new session if required. */
+    const char *path = getenv("UA_REPLAY_CAPTURE");
+    FILE *f = (path) ? fopen(path, "rb") : NULL;
+    if(!f) {
+        f = (path) ? fopen(path, "w+b") : tmpfile();
+        ck_assert(f != NULL);
+        recordSession(f);
+        rewind(f);
+    }
+    Capture c;
+    loadCapture(f, &c);
+    fclose(f);
+    ck_assert_uint_gt(c.chunksSize, 0);
+
+    /* Register the replay "server socket" in the BinaryProtocolManager */
+    Replay *r = (Replay*)UA_calloc(1, sizeof(Replay));
+    ck_assert(r != NULL);
+    r->bpm = getServerComponentByName(server, UA_STRING("binary"));
+    ck_assert(r->bpm != NULL);
+    UA_LOCK(&server->serviceMutex);
+    serverNetworkCallback(&testConnectionManagerTCP, 1, r->bpm, &r->listenContext,
+                          UA_CONNECTIONSTATE_ESTABLISHED, &UA_KEYVALUEMAP_NULL,
+                          UA_BYTESTRING_NULL);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert(r->listenContext != NULL);
+    testConnectionLastSentBuf = &r->lastSent;
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+    origMalloc = UA_mallocSingleton;
+    origCalloc = UA_callocSingleton;
+    origRealloc = UA_reallocSingleton;
+    UA_mallocSingleton = countingMalloc;
+    UA_callocSingleton = countingCalloc;
+    UA_reallocSingleton = countingRealloc;
+#endif
+
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < REPLAY_ROUNDS; i++)
+        replayRound(r, &c, 2 + i);
+    UA_DateTime total = UA_DateTime_nowMonotonic() - begin;
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+    UA_mallocSingleton = origMalloc;
+    UA_callocSingleton = origCalloc;
+    UA_reallocSingleton = origRealloc;
+#endif
+
+    printStats(r, total);
+
+    /* Remove the replay server socket */
+    serverNetworkCallback(&testConnectionManagerTCP, 1, r->bpm, &r->listenContext,
+                          UA_CONNECTIONSTATE_CLOSING, &UA_KEYVALUEMAP_NULL,
+                          UA_BYTESTRING_NULL);
+
+    testConnectionLastSentBuf = NULL;
+    UA_ByteString_clear(&r->lastSent);
+    UA_NodeId_clear(&r->recordedToken);
+    UA_NodeId_clear(&r->liveToken);
+    UA_free(r);
+    UA_Array_delete(c.chunks, c.chunksSize, &UA_TYPES[UA_TYPES_BYTESTRING]);
+} END_TEST
+
+int main(void) {
+    Suite *s = suite_create("Server Replay");
+    TCase *tc = tcase_create("replay");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, replaySession);
+    tcase_set_timeout(tc, 60);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
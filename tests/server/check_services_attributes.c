@@ -624,6 +624,171 @@ START_TEST(ReadSingleDataSourceAttributeValueWithoutTimestamp) {
     UA_DataValue_clear(&resp);
 } END_TEST
 
+START_TEST(ReadSingleSharedMemoryAttributeValue) {
+    /* Set up the region as the producer process would */
+    UA_UInt64 region[64];
+    UA_StatusCode retval = UA_SharedMemory_init(region, sizeof(region), 2);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_UInt32 entry = 0;
+    retval = UA_SharedMemory_addEntry(region, &UA_TYPES[UA_TYPES_DOUBLE],
+                                      false, 1, &entry);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_Double d = 3.5;
+    retval = UA_SharedMemory_write(region, sizeof(region), entry, &d,
+                                   UA_STATUSCODE_GOOD, 1337);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Strings are not pointer-free */
+    retval = UA_SharedMemory_addEntry(region, &UA_TYPES[UA_TYPES_STRING],
+                                      false, 1, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADINVALIDARGUMENT);
+
+    /* Add the variable and connect the backend */
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    vattr.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    vattr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_NodeId nodeId = UA_NODEID_STRING(1, "shm.value");
+    retval = UA_Server_addVariableNode(server, nodeId,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                       UA_QUALIFIEDNAME(1, "shm value"),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                       vattr, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_ValueBackend backend;
+    memset(&backend, 0, sizeof(UA_ValueBackend));
+    backend.backendType = UA_VALUEBACKENDTYPE_SHAREDMEMORY;
+    backend.backend.sharedMemory.region = region;
+    backend.backend.sharedMemory.regionSize = sizeof(region);
+    backend.backend.sharedMemory.entry = entry;
+    retval = UA_Server_setVariableNode_valueBackend(server, nodeId, backend);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Read the value */
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = nodeId;
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_DataValue resp = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_SOURCE);
+    ck_assert_int_eq(resp.status, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&resp.value, &UA_TYPES[UA_TYPES_DOUBLE]));
+    ck_assert(*(UA_Double*)resp.value.data == 3.5);
+    ck_assert_int_eq(resp.sourceTimestamp, 1337);
+    UA_DataValue_clear(&resp);
+
+    /* The producer updates the value */
+    d = 4.5;
+    retval = UA_SharedMemory_write(region, sizeof(region), entry, &d,
+                                   UA_STATUSCODE_GOOD, 1338);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    resp = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_SOURCE);
+    ck_assert(*(UA_Double*)resp.value.data == 4.5);
+    UA_DataValue_clear(&resp);
+
+    /* The region size in the header is not trusted. The entry is checked
+     * against the size of the mapping in the server. */
+    UA_SharedMemoryHeader *header = (UA_SharedMemoryHeader*)region;
+    UA_SharedMemoryEntry *e = (UA_SharedMemoryEntry*)(header + 1);
+    UA_UInt64 offset = e->offset[1];
+    header->regionSize = 1 << 30;
+    e->offset[1] = sizeof(region);
+    resp = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_SOURCE);
+    ck_assert_int_eq(resp.status, UA_STATUSCODE_BADCONFIGURATIONERROR);
+    UA_DataValue_clear(&resp);
+    e->offset[1] = offset;
+    header->regionSize = sizeof(region);
+
+    /* Writing is done only by the producer */
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+    retval = UA_Server_writeValue(server, nodeId, v);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADWRITENOTSUPPORTED);
+
+    /* Remove the node before the region goes out of scope */
+    retval = UA_Server_deleteNode(server, nodeId, true);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+} END_TEST
+
+static void
+readEncodedResponse(UA_ReadRequest *request, UA_ReadResponse *decoded) {
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+    UA_LOCK(&server->serviceMutex);
+    Service_Read(server, &server->adminSession, request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+
+    /* Encode and decode as the client would */
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    UA_StatusCode retval =
+        UA_encodeBinary(&response, &UA_TYPES[UA_TYPES_READRESPONSE], &buf);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_ReadResponse_clear(&response);
+    retval = UA_decodeBinary(&buf, decoded, &UA_TYPES[UA_TYPES_READRESPONSE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_ByteString_clear(&buf);
+}
+
+START_TEST(ReadSingleAttributeValueEncodedCache) {
+    UA_NodeId nodeId = UA_NODEID_STRING(1, "the.answer");
+    UA_StatusCode retval =
+        UA_Server_setVariableNode_encodedValueCache(server, nodeId, true);
+#ifdef UA_ENABLE_IMMUTABLE_NODES
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADNOTSUPPORTED);
+    return;
+#endif
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = nodeId;
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = &rvi;
+    request.nodesToReadSize = 1;
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+
+    /* The encoding is cached on the first read and used for the second */
+    for(size_t i = 0; i < 2; i++) {
+        UA_ReadResponse resp;
+        UA_ReadResponse_init(&resp);
+        readEncodedResponse(&request, &resp);
+        ck_assert_uint_eq(resp.resultsSize, 1);
+        ck_assert(resp.results[0].hasValue);
+        ck_assert(resp.results[0].hasServerTimestamp);
+        ck_assert(UA_Variant_hasScalarType(&resp.results[0].value,
+                                           &UA_TYPES[UA_TYPES_INT32]));
+        ck_assert_int_eq(*(UA_Int32*)resp.results[0].value.data, 42);
+        UA_ReadResponse_clear(&resp);
+    }
+
+    const UA_Node *node = UA_NODESTORE_GET(server, &nodeId);
+    ck_assert(node->variableNode.encodedValue != NULL);
+    UA_NODESTORE_RELEASE(server, node);
+
+    /* Writing invalidates the cache */
+    UA_Int32 myInteger = 43;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    retval = UA_Server_writeValue(server, nodeId, v);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    node = UA_NODESTORE_GET(server, &nodeId);
+    ck_assert(node->variableNode.encodedValue == NULL);
+    UA_NODESTORE_RELEASE(server, node);
+
+    UA_ReadResponse resp;
+    UA_ReadResponse_init(&resp);
+    readEncodedResponse(&request, &resp);
+    ck_assert_int_eq(*(UA_Int32*)resp.results[0].value.data, 43);
+    UA_ReadResponse_clear(&resp);
+
+    /* Local reads are not affected */
+    UA_DataValue dv = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+    ck_assert(UA_Variant_hasScalarType(&dv.value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)dv.value.data, 43);
+    UA_DataValue_clear(&dv);
+} END_TEST
+
 START_TEST(ReadSingleDataSourceAttributeDataTypeWithoutTimestamp) {
     UA_ReadValueId rvi;
     UA_ReadValueId_init(&rvi);
@@ -835,6 +1000,40 @@ START_TEST(WriteSingleAttributeValue) {
     UA_DataValue_clear(&resp);
 } END_TEST
 
+START_TEST(WriteSingleAttributeValueMove) {
+    UA_WriteValue wValue;
+    UA_WriteValue_init(&wValue);
+    UA_Int32 myInteger = 21;
+    UA_Variant_setScalarCopy(&wValue.value.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    wValue.value.hasValue = true;
+    wValue.nodeId = UA_NODEID_STRING(1, "the.answer");
+    wValue.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_StatusCode retval = UA_Server_writeMove(server, &wValue);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* The value was moved into the node */
+    ck_assert(!wValue.value.hasValue);
+    ck_assert_ptr_eq(wValue.value.value.data, NULL);
+    UA_DataValue_clear(&wValue.value);
+
+    UA_Variant value;
+    retval = UA_Server_readValue(server, UA_NODEID_STRING(1, "the.answer"), &value);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(21, *(UA_Int32*)value.data);
+    UA_Variant_clear(&value);
+
+    /* The value is not moved if the write fails */
+    UA_WriteValue_init(&wValue);
+    UA_Variant_setScalarCopy(&wValue.value.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    wValue.value.hasValue = true;
+    wValue.nodeId = UA_NODEID_STRING(1, "not.existing");
+    wValue.attributeId = UA_ATTRIBUTEID_VALUE;
+    retval = UA_Server_writeMove(server, &wValue);
+    ck_assert_int_ne(retval, UA_STATUSCODE_GOOD);
+    ck_assert(wValue.value.hasValue);
+    UA_DataValue_clear(&wValue.value);
+} END_TEST
+
 /* The ServerTimestamp during a Write Request shall be ignored. Instead the
  * server uses its own current time. */
 START_TEST(WriteSingleAttributeValueWithServerTimestamp) {
@@ -1151,6 +1350,8 @@ static Suite * testSuite_services_attributes(void) {
     tcase_add_test(tc_readSingleAttributes, ReadSingleAttributeExecutableWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleAttributeUserExecutableWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeValueWithoutTimestamp);
+    tcase_add_test(tc_readSingleAttributes, ReadSingleSharedMemoryAttributeValue);
+    tcase_add_test(tc_readSingleAttributes, ReadSingleAttributeValueEncodedCache);
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeValueEmptyWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeDataTypeWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeArrayDimensionsWithoutTimestamp);
@@ -1172,6 +1373,7 @@ static Suite * testSuite_services_attributes(void) {
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeContainsNoLoops);
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeEventNotifier);
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeValue);
+    tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeValueMove);
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeValueWithServerTimestamp);
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeValueEnum);
     tcase_add_test(tc_writeSingleAttributes, WriteSingleAttributeDataType);
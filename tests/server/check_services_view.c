@@ -71,6 +71,81 @@ START_TEST(Service_Browse_CheckSubTypes) {
 }
 END_TEST
 
+static UA_Boolean
+isSubtype(UA_Server *server, UA_NodeId leaf, UA_NodeId type) {
+    return isNodeInTree_singleRef(server, &leaf, &type,
+                                  UA_REFERENCETYPEINDEX_HASSUBTYPE);
+}
+
+/* The subtype checks are cached. Changing the hierarchy invalidates the cache. */
+START_TEST(Service_Browse_SubtypeCache) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    UA_NodeId baseObjectType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE);
+    UA_NodeId folderType = UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE);
+    UA_NodeId hasSubtype = UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE);
+    UA_NodeId typeA = UA_NODEID_NUMERIC(1, 7000);
+    UA_NodeId typeB = UA_NODEID_NUMERIC(1, 7001);
+
+    UA_ObjectTypeAttributes attr = UA_ObjectTypeAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectTypeNode(server, typeA, baseObjectType, hasSubtype,
+                                    UA_QUALIFIEDNAME(1, "TypeA"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addObjectTypeNode(server, typeB, typeA, hasSubtype,
+                                      UA_QUALIFIEDNAME(1, "TypeB"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    ck_assert(isSubtype(server, typeB, typeB));
+    ck_assert(isSubtype(server, typeB, typeA));
+    ck_assert(isSubtype(server, typeB, baseObjectType));
+    ck_assert(!isSubtype(server, typeA, typeB));
+    ck_assert(!isSubtype(server, typeB, folderType));
+    ck_assert(!isSubtype(server, typeB, UA_NODEID_NUMERIC(1, 7002)));
+
+    /* Move TypeB below FolderType */
+    UA_ExpandedNodeId expB = UA_EXPANDEDNODEID_NUMERIC(1, 7001);
+    res = UA_Server_deleteReference(server, typeA, hasSubtype, true, expB, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(!isSubtype(server, typeB, typeA));
+    res = UA_Server_addReference(server, folderType, hasSubtype, expB, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtype(server, typeB, folderType));
+    ck_assert(isSubtype(server, typeB, baseObjectType));
+    ck_assert(!isSubtype(server, typeB, typeA));
+
+    /* Two supertypes */
+    res = UA_Server_addReference(server, typeA, hasSubtype, expB, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtype(server, typeB, typeA));
+    ck_assert(isSubtype(server, typeB, folderType));
+
+    /* Edit the node directly in the nodestore (as the nodeset loader does).
+     * Add FolderType as a second supertype of the cached TypeA. */
+    ck_assert(!isSubtype(server, typeA, folderType));
+    UA_Nodestore *ns = &UA_Server_getConfig(server)->nodestore;
+    UA_Node *node = NULL;
+    res = ns->getNodeCopy(ns->context, &typeA, &node);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_ExpandedNodeId expFolder = UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE);
+    res = UA_Node_addReference(node, UA_REFERENCETYPEINDEX_HASSUBTYPE,
+                               false, &expFolder, 0);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = ns->replaceNode(ns->context, node);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtype(server, typeA, folderType));
+
+    /* Delete the subtype */
+    res = UA_Server_deleteNode(server, typeB, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(!isSubtype(server, typeB, folderType));
+    ck_assert(isSubtype(server, typeA, baseObjectType));
+
+    UA_Server_delete(server);
+}
+END_TEST
+
 static size_t
 browseWithMaxResults(UA_Server *server, UA_NodeId nodeId, UA_UInt32 maxResults) {
     UA_BrowseDescription bd;
@@ -497,6 +572,7 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     Suite *s = suite_create("Service_TranslateBrowsePathsToNodeIds");
     TCase *tc_browse = tcase_create("Browse Service");
     tcase_add_test(tc_browse, Service_Browse_CheckSubTypes);
+    tcase_add_test(tc_browse, Service_Browse_SubtypeCache);
     tcase_add_test(tc_browse, Service_Browse_WithBrowseName);
     tcase_add_test(tc_browse, Service_Browse_ClassMask);
     tcase_add_test(tc_browse, Service_Browse_ReferenceTypes);
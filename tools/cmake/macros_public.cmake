@@ -171,6 +171,11 @@ function(ua_generate_datatypes)
         set(UA_GEN_DT_INTERNAL_ARG "--internal")
     endif()
 
+    set(UA_GEN_DT_BINARY_CODEC_ARG "")
+    if (UA_ENABLE_BINARY_CODEC)
+        set(UA_GEN_DT_BINARY_CODEC_ARG "--binary-codec")
+    endif()
+
     set(SELECTED_TYPES_TMP "")
     foreach(f ${UA_GEN_DT_FILES_SELECTED})
         set(SELECTED_TYPES_TMP ${SELECTED_TYPES_TMP} "--selected-types=${f}")
@@ -219,6 +224,7 @@ function(ua_generate_datatypes)
         --type-csv=${UA_GEN_DT_FILE_CSV}
         ${UA_GEN_DT_NO_BUILTIN}
         ${UA_GEN_DT_INTERNAL_ARG}
+        ${UA_GEN_DT_BINARY_CODEC_ARG}
         ${UA_GEN_DT_OUTPUT_DIR}/${UA_GEN_DT_NAME}
         DEPENDS ${open62541_TOOLS_DIR}/generate_datatypes.py
                 ${open62541_TOOLS_DIR}/nodeset_compiler/backend_open62541_typedefinitions.py
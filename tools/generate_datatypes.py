@@ -65,6 +65,11 @@ parser.add_argument('--internal',
                     dest="internal",
                     help='Given bsd are internal types which do not have any .csv file')
 
+parser.add_argument('--binary-codec',
+                    action='store_true',
+                    dest="binary_codec",
+                    help='Generate specialized binary en/decoding routines for the structures')
+
 parser.add_argument('-t', '--type-bsd',
                     metavar="<typeBsds>",
                     type=argparse.FileType('r'),
@@ -102,5 +107,6 @@ parser = CSVBSDTypeParser(args.opaque_map, args.selected_types, args.no_builtin,
                           args.type_bsd, args.type_csv, args.type_xml, namespaceMap)
 parser.create_types()
 
-generator = backend.CGenerator(parser, inname, args.outfile, args.internal, namespaceMap)
+generator = backend.CGenerator(parser, inname, args.outfile, args.internal, namespaceMap,
+                               args.binary_codec)
 generator.write_definitions()
@@ -34,6 +34,28 @@ builtin_overlayable = {"SByte": "true",
                                "offsetof(UA_Guid, data3) == (sizeof(UA_UInt16) + sizeof(UA_UInt32)) && " +
                                "offsetof(UA_Guid, data4) == (2*sizeof(UA_UInt32)))"}
 
+# Encoding length of the builtin types that the generated binary codec copies
+# inline. Only used if integers and floats are overlayable.
+builtin_fixed_size = {"Boolean": 1,
+                      "SByte": 1,
+                      "Byte": 1,
+                      "Int16": 2,
+                      "UInt16": 2,
+                      "Int32": 4,
+                      "UInt32": 4,
+                      "StatusCode": 4,
+                      "Float": 4,
+                      "Int64": 8,
+                      "UInt64": 8,
+                      "DateTime": 8,
+                      "Double": 8}
+
+enum_fixed_size = {"UA_Int32": 4,
+                   "UA_Byte": 1,
+                   "UA_UInt16": 2,
+                   "UA_UInt32": 4,
+                   "UA_UInt64": 8}
+
 whitelistFuncAttrWarnUnusedResult = []  # for instances [ "String", "ByteString", "LocalizedText" ]
 
 
@@ -62,13 +84,15 @@ def getNodeidTypeAndId(nodeId):
         return "UA_NODEIDTYPE_STRING, {{ .string = UA_STRING_STATIC(\"{id}\") }}".format(id=strId.replace("\"", "\\\""))
 
 class CGenerator(object):
-    def __init__(self, parser, inname, outfile, is_internal_types, namespaceMap):
+    def __init__(self, parser, inname, outfile, is_internal_types, namespaceMap,
+                 binary_codec=False):
         self.parser = parser
         self.inname = inname
         self.outfile = outfile
         self.is_internal_types = is_internal_types
         self.filtered_types = None
         self.namespaceMap = namespaceMap
+        self.binary_codec = binary_codec
         self.fh = None
         self.ff = None
         self.fc = None
@@ -143,9 +167,150 @@ class CGenerator(object):
                "    " + pointerfree + ", /* .pointerFree */\n" + \
                "    " + self.get_type_overlayable(datatype) + ", /* .overlayable */\n" + \
                "    " + str(len(datatype.members)) + ", /* .membersSize */\n" + \
-               "    %s_members" % idName + "  /* .members */\n" + \
+               self.print_datatype_members(idName) + \
                "}"
 
+    def print_datatype_members(self, idName):
+        if not self.binary_codec:
+            return "    %s_members" % idName + "  /* .members */\n"
+        return "    %s_members" % idName + ", /* .members */\n" + \
+               "#ifdef UA_ENABLE_BINARY_CODEC\n" + \
+               "    %s_binaryCodec" % idName + "  /* .binaryCodec */\n" + \
+               "#endif\n"
+
+    @staticmethod
+    def print_member_type(member):
+        if not member.member_type.members and isinstance(member.member_type, StructType):
+            type_name = "ExtensionObject"
+        else:
+            type_name = member.member_type.name
+        return "&UA_%s[UA_%s_%s]" % (
+            member.member_type.outname.upper(), member.member_type.outname.upper(),
+            makeCIdentifier(type_name.upper()))
+
+    @staticmethod
+    def get_fixed_size(member):
+        # Encoding length of a scalar member that is copied inline. Zero
+        # otherwise. Returns (size, isBoolean).
+        if member.is_array or member.is_optional:
+            return 0, False
+        mt = member.member_type
+        if isinstance(mt, EnumerationType):
+            return enum_fixed_size.get(mt.strDataType, 0), False
+        name = mt.base_type if isinstance(mt, OpaqueType) else mt.name
+        if isinstance(mt, BuiltinType) or isinstance(mt, OpaqueType):
+            return builtin_fixed_size.get(name, 0), name == "Boolean"
+        return 0, False
+
+    def print_binary_codec(self, datatype):
+        # Straight-line en/decoding and sizing for plain structures. Runs of
+        # consecutive fixed-size members are copied inline with a single bounds
+        # check. The other members use the generic member routines. Structures
+        # with optional fields and unions use the generic routines.
+        if not self.binary_codec:
+            return ""
+        idName = makeCIdentifier(datatype.name)
+        if not isinstance(datatype, StructType) or len(datatype.members) == 0 or \
+           self.get_type_kind(datatype) != "UA_DATATYPEKIND_STRUCTURE":
+            return "#ifdef UA_ENABLE_BINARY_CODEC\n" + \
+                "#define %s_binaryCodec NULL\n" % idName + "#endif"
+
+        # Group the members into runs of fixed-size members
+        runs = []
+        run = None
+        for member in datatype.members:
+            size, isBoolean = CGenerator.get_fixed_size(member)
+            if size == 0:
+                runs.append((0, [member]))
+                run = None
+                continue
+            if run is None:
+                run = [0, []]
+                runs.append(run)
+            run[0] += size
+            run[1].append((member, size, isBoolean))
+        hasFixed = any(r[0] > 0 for r in runs)
+        hasGeneric = any(r[0] == 0 for r in runs)
+
+        check = "    if(ret != UA_STATUSCODE_GOOD)\n        return ret;\n"
+        enc = "static UA_StatusCode\n%s_encodeBinaryCodec(const void *src, void *ctx) {\n" % idName
+        enc += "    const UA_%s *p = (const UA_%s*)src;\n" % (idName, idName)
+        dec = "static UA_StatusCode\n%s_decodeBinaryCodec(void *dst, void *ctx) {\n" % idName
+        dec += "    UA_%s *p = (UA_%s*)dst;\n" % (idName, idName)
+        size = "static UA_StatusCode\n%s_calcSizeBinaryCodec(const void *src, void *ctx) {\n" % idName
+        if hasGeneric:
+            size += "    const UA_%s *p = (const UA_%s*)src;\n" % (idName, idName)
+        else:
+            size += "    (void)src;\n"
+        if hasFixed:
+            enc += "    UA_BinaryCodecBuffer *c = (UA_BinaryCodecBuffer*)ctx;\n"
+            dec += "    UA_BinaryCodecBuffer *c = (UA_BinaryCodecBuffer*)ctx;\n"
+            size += "    ((UA_BinaryCodecSize*)ctx)->size += %d;\n" % \
+                sum(r[0] for r in runs)
+        enc += "    UA_StatusCode ret;\n"
+        if hasGeneric:
+            dec += "    UA_StatusCode ret;\n"
+            size += "    UA_StatusCode ret;\n"
+
+        for r in runs:
+            if r[0] == 0:
+                member = r[1][0]
+                name = makeCIdentifier(member.name)
+                mt = self.print_member_type(member)
+                if member.is_array:
+                    enc += "    ret = UA_encodeBinaryMemberArray(p->%s, p->%sSize, %s, ctx);\n" % \
+                        (name, name, mt)
+                    dec += "    ret = UA_decodeBinaryMemberArray((void**)&p->%s, &p->%sSize, %s, ctx);\n" % \
+                        (name, name, mt)
+                    size += "    ret = UA_calcSizeBinaryMemberArray(p->%s, p->%sSize, %s, ctx);\n" % \
+                        (name, name, mt)
+                else:
+                    enc += "    ret = UA_encodeBinaryMember(&p->%s, %s, ctx);\n" % (name, mt)
+                    dec += "    ret = UA_decodeBinaryMember(&p->%s, %s, ctx);\n" % (name, mt)
+                    size += "    ret = UA_calcSizeBinaryMember(&p->%s, %s, ctx);\n" % (name, mt)
+                enc += check
+                dec += check
+                size += check
+                continue
+
+            # Copy the run inline if the buffer is large enough. Otherwise
+            # encode member by member to exchange the buffer when it is full.
+            enc += "    if(c->pos + %d <= c->end) {\n" % r[0]
+            fallback = ""
+            dec += "    if(c->pos + %d > c->end)\n" % r[0]
+            dec += "        return UA_STATUSCODE_BADDECODINGERROR;\n"
+            offset = 0
+            for (member, msize, isBoolean) in r[1]:
+                name = makeCIdentifier(member.name)
+                pos = "c->pos + %d" % offset if offset > 0 else "c->pos"
+                enc += "        memcpy(%s, &p->%s, %d);\n" % (pos, name, msize)
+                if isBoolean:
+                    dec += "    p->%s = (c->pos[%d] != 0);\n" % (name, offset)
+                else:
+                    dec += "    memcpy(&p->%s, %s, %d);\n" % (name, pos, msize)
+                fallback += "        ret = UA_encodeBinaryMember(&p->%s, %s, ctx);\n" % \
+                    (name, self.print_member_type(member))
+                fallback += "        if(ret != UA_STATUSCODE_GOOD)\n            return ret;\n"
+                offset += msize
+            enc += "        c->pos += %d;\n" % r[0]
+            enc += "    } else {\n" + fallback + "    }\n"
+            dec += "    c->pos += %d;\n" % r[0]
+
+        enc += "    return UA_STATUSCODE_GOOD;\n}\n\n"
+        dec += "    return UA_STATUSCODE_GOOD;\n}\n\n"
+        size += "    return UA_STATUSCODE_GOOD;\n}\n\n"
+        codec = "static const UA_DataTypeBinaryCodec %s_binaryCodecStatic = {\n" % idName
+        codec += "    %s_encodeBinaryCodec,\n    %s_decodeBinaryCodec,\n" % (idName, idName)
+        codec += "    %s_calcSizeBinaryCodec\n};\n" % idName
+        codec += "#define %s_binaryCodec &%s_binaryCodecStatic\n" % (idName, idName)
+        out = "#ifdef UA_ENABLE_BINARY_CODEC\n"
+        if hasFixed:
+            out += "#if UA_BINARY_OVERLAYABLE_INTEGER && UA_BINARY_OVERLAYABLE_FLOAT\n"
+        out += enc + dec + size + codec
+        if hasFixed:
+            out += "#else\n#define %s_binaryCodec NULL\n#endif\n" % idName
+        return out + "#endif"
+
     @staticmethod
     def print_members(datatype, namespaceMap):
         idName = makeCIdentifier(datatype.name)
@@ -503,6 +668,8 @@ _UA_END_DECLS
                 self.printc("")
                 self.printc("/* " + t.name + " */")
                 self.printc(CGenerator.print_members(t, self.namespaceMap))
+                if self.binary_codec:
+                    self.printc(self.print_binary_codec(t))
 
         if totalCount > 0:
             self.printc(